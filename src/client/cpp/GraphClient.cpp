@@ -89,5 +89,59 @@ cpp2::ErrorCode GraphClient::execute(folly::StringPiece stmt,
     return resp.get_error_code();
 }
 
+cpp2::ErrorCode GraphClient::prepare(folly::StringPiece stmt,
+                                     cpp2::PrepareResponse& resp) {
+    if (!client_) {
+        LOG(ERROR) << "Disconnected from the server";
+        return cpp2::ErrorCode::E_DISCONNECTED;
+    }
+
+    try {
+        client_->sync_prepare(resp, sessionId_, stmt.toString());
+    } catch (const std::exception& ex) {
+        LOG(ERROR) << "Thrift rpc call failed: " << ex.what();
+        return cpp2::ErrorCode::E_RPC_FAILURE;
+    }
+
+    return resp.get_error_code();
+}
+
+
+cpp2::ErrorCode GraphClient::executePrepared(int64_t statementId,
+                                             const std::vector<cpp2::ColumnValue>& params,
+                                             cpp2::ExecutionResponse& resp) {
+    if (!client_) {
+        LOG(ERROR) << "Disconnected from the server";
+        return cpp2::ErrorCode::E_DISCONNECTED;
+    }
+
+    try {
+        client_->sync_executePrepared(resp, sessionId_, statementId, params);
+    } catch (const std::exception& ex) {
+        LOG(ERROR) << "Thrift rpc call failed: " << ex.what();
+        return cpp2::ErrorCode::E_RPC_FAILURE;
+    }
+
+    return resp.get_error_code();
+}
+
+
+cpp2::ErrorCode GraphClient::unprepare(int64_t statementId) {
+    if (!client_) {
+        LOG(ERROR) << "Disconnected from the server";
+        return cpp2::ErrorCode::E_DISCONNECTED;
+    }
+
+    try {
+        client_->sync_unprepare(sessionId_, statementId);
+    } catch (const std::exception& ex) {
+        LOG(ERROR) << "Thrift rpc call failed: " << ex.what();
+        return cpp2::ErrorCode::E_RPC_FAILURE;
+    }
+
+    // The call is oneway, nothing more is known about it
+    return cpp2::ErrorCode::SUCCEEDED;
+}
+
 }  // namespace graph
 }  // namespace nebula
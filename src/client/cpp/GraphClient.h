@@ -26,6 +26,18 @@ public:
     cpp2::ErrorCode execute(folly::StringPiece stmt,
                             cpp2::ExecutionResponse& resp);
 
+    // Prepare a statement with the placeholders $1, $2, ...
+    // The statement id is returned in the response
+    cpp2::ErrorCode prepare(folly::StringPiece stmt,
+                            cpp2::PrepareResponse& resp);
+
+    // Execute a prepared statement, $N is bound to params[N - 1]
+    cpp2::ErrorCode executePrepared(int64_t statementId,
+                                    const std::vector<cpp2::ColumnValue>& params,
+                                    cpp2::ExecutionResponse& resp);
+
+    cpp2::ErrorCode unprepare(int64_t statementId);
+
 private:
     std::unique_ptr<cpp2::GraphServiceAsyncClient> client_;
     const std::string addr_;
@@ -0,0 +1,825 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "filter/CompiledExpression.h"
+
+namespace nebula {
+
+namespace {
+
+template <typename T>
+bool compare(const T &left, const T &right, RelationalExpression::Operator op) {
+    switch (op) {
+        case RelationalExpression::LT:
+            return left < right;
+        case RelationalExpression::LE:
+            return left <= right;
+        case RelationalExpression::GT:
+            return left > right;
+        case RelationalExpression::GE:
+            return left >= right;
+        case RelationalExpression::EQ:
+            return left == right;
+        case RelationalExpression::NE:
+            return left != right;
+    }
+    DCHECK(false);
+    return false;
+}
+
+template <typename T>
+T arith(T left, T right, ArithmeticExpression::Operator op) {
+    switch (op) {
+        case ArithmeticExpression::ADD:
+            return left + right;
+        case ArithmeticExpression::SUB:
+            return left - right;
+        case ArithmeticExpression::MUL:
+            return left * right;
+        case ArithmeticExpression::DIV:
+            return left / right;
+        default:
+            DCHECK(false);
+    }
+    return left;
+}
+
+bool isArithmetic(CompiledExpression::Type type) {
+    return type == CompiledExpression::Type::INT || type == CompiledExpression::Type::DOUBLE;
+}
+
+// The kernels below are plain loops over dense arrays, which could be vectorized
+
+template <typename T, typename F>
+void compareColumn(const std::vector<T> &left,
+                   const std::vector<T> &right,
+                   std::vector<uint8_t> &result,
+                   size_t size,
+                   F cmp) {
+    result.resize(size);
+    for (auto i = 0UL; i < size; i++) {
+        result[i] = cmp(left[i], right[i]);
+    }
+}
+
+template <typename T>
+void compareColumn(const std::vector<T> &left,
+                   const std::vector<T> &right,
+                   std::vector<uint8_t> &result,
+                   size_t size,
+                   RelationalExpression::Operator op) {
+    switch (op) {
+        case RelationalExpression::LT:
+            compareColumn(left, right, result, size, std::less<T>());
+            break;
+        case RelationalExpression::LE:
+            compareColumn(left, right, result, size, std::less_equal<T>());
+            break;
+        case RelationalExpression::GT:
+            compareColumn(left, right, result, size, std::greater<T>());
+            break;
+        case RelationalExpression::GE:
+            compareColumn(left, right, result, size, std::greater_equal<T>());
+            break;
+        case RelationalExpression::EQ:
+            compareColumn(left, right, result, size, std::equal_to<T>());
+            break;
+        case RelationalExpression::NE:
+            compareColumn(left, right, result, size, std::not_equal_to<T>());
+            break;
+    }
+}
+
+template <typename T, typename F>
+void arithColumn(std::vector<T> &left, const std::vector<T> &right, size_t size, F fun) {
+    for (auto i = 0UL; i < size; i++) {
+        left[i] = fun(left[i], right[i]);
+    }
+}
+
+template <typename T>
+void arithColumn(std::vector<T> &left,
+                 const std::vector<T> &right,
+                 size_t size,
+                 ArithmeticExpression::Operator op) {
+    switch (op) {
+        case ArithmeticExpression::ADD:
+            arithColumn(left, right, size, std::plus<T>());
+            break;
+        case ArithmeticExpression::SUB:
+            arithColumn(left, right, size, std::minus<T>());
+            break;
+        case ArithmeticExpression::MUL:
+            arithColumn(left, right, size, std::multiplies<T>());
+            break;
+        case ArithmeticExpression::DIV:
+            arithColumn(left, right, size, std::divides<T>());
+            break;
+        default:
+            DCHECK(false);
+    }
+}
+
+}   // Anonymous namespace
+
+
+constexpr size_t CompiledExpression::kMaxDepth;
+constexpr size_t CompiledExpression::kBatchSize;
+
+
+// static
+StatusOr<std::unique_ptr<CompiledExpression>>
+CompiledExpression::compile(const Expression *expr, const Resolver &resolver) {
+    std::unique_ptr<CompiledExpression> compiled(new CompiledExpression());
+    std::vector<Type> types;
+    auto status = compiled->emit(expr, resolver, types);
+    if (!status.ok()) {
+        return status;
+    }
+    if (compiled->maxDepth_ > kMaxDepth) {
+        return Status::Error("Expression `%s' is too deep to compile", expr->toString().c_str());
+    }
+    DCHECK_EQ(types.size(), 1UL);
+    compiled->type_ = types.back();
+    return std::move(compiled);
+}
+
+
+// static
+bool CompiledExpression::isConstant(const Expression *expr) {
+    switch (expr->kind()) {
+        case Expression::kPrimary:
+        case Expression::kParameter:
+        // The name of the edge, which is the alias
+        case Expression::kEdgeType:
+            return true;
+        case Expression::kUnary:
+            return isConstant(static_cast<const UnaryExpression*>(expr)->operand());
+        case Expression::kArithmetic: {
+            auto *arith = static_cast<const ArithmeticExpression*>(expr);
+            return isConstant(arith->left()) && isConstant(arith->right());
+        }
+        case Expression::kRelational: {
+            auto *rel = static_cast<const RelationalExpression*>(expr);
+            return isConstant(rel->left()) && isConstant(rel->right());
+        }
+        case Expression::kLogical: {
+            auto *logic = static_cast<const LogicalExpression*>(expr);
+            return isConstant(logic->left()) && isConstant(logic->right());
+        }
+        default:
+            return false;
+    }
+}
+
+
+Status CompiledExpression::emitConstant(const Expression *expr, std::vector<Type> &types) {
+    auto result = expr->eval();
+    if (!result.ok()) {
+        return result.status();
+    }
+    auto &variant = result.value();
+    Value value;
+    switch (variant.which()) {
+        case VAR_INT64:
+            value.type = Type::INT;
+            value.i = boost::get<int64_t>(variant);
+            break;
+        case VAR_DOUBLE:
+            value.type = Type::DOUBLE;
+            value.d = boost::get<double>(variant);
+            break;
+        case VAR_BOOL:
+            value.type = Type::BOOL;
+            value.b = boost::get<bool>(variant);
+            break;
+        case VAR_STR:
+            value.type = Type::STRING;
+            strings_.emplace_back(boost::get<std::string>(variant));
+            value.s = strings_.back();
+            break;
+        default:
+            return Status::Error("Unknown VariantType: %d", variant.which());
+    }
+    append(OpCode::PUSH, constants_.size());
+    constants_.emplace_back(value);
+    types.emplace_back(value.type);
+    maxDepth_ = std::max(maxDepth_, types.size());
+    return Status::OK();
+}
+
+
+Status CompiledExpression::emit(const Expression *expr,
+                                const Resolver &resolver,
+                                std::vector<Type> &types) {
+    if (isConstant(expr)) {
+        return emitConstant(expr, types);
+    }
+
+    switch (expr->kind()) {
+        case Expression::kUnary: {
+            auto *unary = static_cast<const UnaryExpression*>(expr);
+            auto status = emit(unary->operand(), resolver, types);
+            if (!status.ok()) {
+                return status;
+            }
+            switch (unary->op()) {
+                case UnaryExpression::PLUS:
+                    return Status::OK();
+                case UnaryExpression::NEGATE:
+                    if (types.back() == Type::INT) {
+                        append(OpCode::NEG_INT);
+                        return Status::OK();
+                    }
+                    if (types.back() == Type::DOUBLE) {
+                        append(OpCode::NEG_DOUBLE);
+                        return Status::OK();
+                    }
+                    return Status::Error("Could not negate `%s'", expr->toString().c_str());
+                case UnaryExpression::NOT:
+                    append(OpCode::NOT);
+                    types.back() = Type::BOOL;
+                    return Status::OK();
+            }
+            break;
+        }
+        case Expression::kArithmetic: {
+            auto *arith = static_cast<const ArithmeticExpression*>(expr);
+            auto status = emit(arith->left(), resolver, types);
+            if (!status.ok()) {
+                return status;
+            }
+            status = emit(arith->right(), resolver, types);
+            if (!status.ok()) {
+                return status;
+            }
+            auto right = types.back();
+            types.pop_back();
+            auto left = types.back();
+            auto op = arith->op();
+            if (op == ArithmeticExpression::MOD) {
+                if (left != Type::INT || right != Type::INT) {
+                    break;
+                }
+                append(OpCode::ARITH_INT, op);
+                return Status::OK();
+            }
+            // String concatenation is left to Expression::eval()
+            if (!isArithmetic(left) || !isArithmetic(right)) {
+                break;
+            }
+            if (left == Type::INT && right == Type::INT) {
+                append(OpCode::ARITH_INT, op);
+                return Status::OK();
+            }
+            if (left == Type::INT) {
+                append(OpCode::I2D, 1);
+            }
+            if (right == Type::INT) {
+                append(OpCode::I2D, 0);
+            }
+            append(OpCode::ARITH_DOUBLE, op);
+            types.back() = Type::DOUBLE;
+            return Status::OK();
+        }
+        case Expression::kRelational: {
+            auto *rel = static_cast<const RelationalExpression*>(expr);
+            auto status = emit(rel->left(), resolver, types);
+            if (!status.ok()) {
+                return status;
+            }
+            status = emit(rel->right(), resolver, types);
+            if (!status.ok()) {
+                return status;
+            }
+            auto right = types.back();
+            types.pop_back();
+            auto left = types.back();
+            auto op = rel->op();
+            types.back() = Type::BOOL;
+            if (left == right) {
+                switch (left) {
+                    case Type::INT:
+                        append(OpCode::CMP_INT, op);
+                        break;
+                    case Type::DOUBLE:
+                        append(OpCode::CMP_DOUBLE, op);
+                        break;
+                    case Type::BOOL:
+                        append(OpCode::CMP_BOOL, op);
+                        break;
+                    case Type::STRING:
+                        append(OpCode::CMP_STRING, op);
+                        break;
+                }
+                return Status::OK();
+            }
+            // Values of different types are ordered by their types in Expression::eval(),
+            // only the equality of integers and doubles compares the values.
+            if (isArithmetic(left) && isArithmetic(right)
+                    && (op == RelationalExpression::EQ || op == RelationalExpression::NE)) {
+                append(OpCode::I2D, left == Type::INT ? 1 : 0);
+                append(OpCode::CMP_DOUBLE, op);
+                return Status::OK();
+            }
+            break;
+        }
+        case Expression::kLogical: {
+            auto *logic = static_cast<const LogicalExpression*>(expr);
+            auto status = emit(logic->left(), resolver, types);
+            if (!status.ok()) {
+                return status;
+            }
+            status = emit(logic->right(), resolver, types);
+            if (!status.ok()) {
+                return status;
+            }
+            types.pop_back();
+            types.back() = Type::BOOL;
+            append(logic->op() == LogicalExpression::AND ? OpCode::AND : OpCode::OR);
+            return Status::OK();
+        }
+        case Expression::kFunctionCall:
+        case Expression::kTypeCasting:
+            break;
+        default: {
+            auto slot = resolver(expr);
+            if (!slot.ok()) {
+                return slot.status();
+            }
+            append(OpCode::LOAD, slots_.size());
+            slots_.emplace_back(slot.value());
+            names_.emplace_back(expr->toString());
+            types.emplace_back(slots_.back().type);
+            maxDepth_ = std::max(maxDepth_, types.size());
+            return Status::OK();
+        }
+    }
+    return Status::Error("Could not compile `%s'", expr->toString().c_str());
+}
+
+
+Status CompiledExpression::eval(const Reader* const *readers, Value &result) const {
+    Value stack[kMaxDepth];
+    size_t top = 0;
+    for (auto &inst : program_) {
+        switch (inst.code) {
+            case OpCode::PUSH:
+                stack[top++] = constants_[inst.operand];
+                break;
+            case OpCode::LOAD: {
+                auto &slot = slots_[inst.operand];
+                auto &value = stack[top++];
+                value.type = slot.type;
+                if (!readers[slot.source]->read(slot.index, value)) {
+                    return Status::Error("Failed to read `%s'", names_[inst.operand].c_str());
+                }
+                break;
+            }
+            case OpCode::I2D: {
+                auto &value = stack[top - 1 - inst.operand];
+                value.d = static_cast<double>(value.i);
+                value.type = Type::DOUBLE;
+                break;
+            }
+            case OpCode::NEG_INT:
+                stack[top - 1].i = -stack[top - 1].i;
+                break;
+            case OpCode::NEG_DOUBLE:
+                stack[top - 1].d = -stack[top - 1].d;
+                break;
+            case OpCode::NOT: {
+                auto &value = stack[top - 1];
+                value.b = !asBool(value);
+                value.type = Type::BOOL;
+                break;
+            }
+            case OpCode::ARITH_INT: {
+                auto &left = stack[top - 2];
+                auto &right = stack[top - 1];
+                auto op = static_cast<ArithmeticExpression::Operator>(inst.operand);
+                if ((op == ArithmeticExpression::DIV || op == ArithmeticExpression::MOD)
+                        && right.i == 0) {
+                    return Status::Error("Division by zero");
+                }
+                if (op == ArithmeticExpression::MOD) {
+                    left.i = left.i % right.i;
+                } else {
+                    left.i = arith(left.i, right.i, op);
+                }
+                --top;
+                break;
+            }
+            case OpCode::ARITH_DOUBLE: {
+                auto &left = stack[top - 2];
+                auto &right = stack[top - 1];
+                auto op = static_cast<ArithmeticExpression::Operator>(inst.operand);
+                left.d = arith(left.d, right.d, op);
+                --top;
+                break;
+            }
+            case OpCode::CMP_INT: {
+                auto &left = stack[top - 2];
+                auto op = static_cast<RelationalExpression::Operator>(inst.operand);
+                left.b = compare(left.i, stack[top - 1].i, op);
+                left.type = Type::BOOL;
+                --top;
+                break;
+            }
+            case OpCode::CMP_DOUBLE: {
+                auto &left = stack[top - 2];
+                auto &right = stack[top - 1];
+                auto op = static_cast<RelationalExpression::Operator>(inst.operand);
+                if (op == RelationalExpression::EQ) {
+                    left.b = Expression::almostEqual(left.d, right.d);
+                } else if (op == RelationalExpression::NE) {
+                    left.b = !Expression::almostEqual(left.d, right.d);
+                } else {
+                    left.b = compare(left.d, right.d, op);
+                }
+                left.type = Type::BOOL;
+                --top;
+                break;
+            }
+            case OpCode::CMP_BOOL: {
+                auto &left = stack[top - 2];
+                auto op = static_cast<RelationalExpression::Operator>(inst.operand);
+                left.b = compare(left.b, stack[top - 1].b, op);
+                left.type = Type::BOOL;
+                --top;
+                break;
+            }
+            case OpCode::CMP_STRING: {
+                auto &left = stack[top - 2];
+                auto op = static_cast<RelationalExpression::Operator>(inst.operand);
+                left.b = compare(left.s, stack[top - 1].s, op);
+                left.type = Type::BOOL;
+                --top;
+                break;
+            }
+            case OpCode::AND: {
+                auto &left = stack[top - 2];
+                left.b = asBool(left) && asBool(stack[top - 1]);
+                left.type = Type::BOOL;
+                --top;
+                break;
+            }
+            case OpCode::OR: {
+                auto &left = stack[top - 2];
+                left.b = asBool(left) || asBool(stack[top - 1]);
+                left.type = Type::BOOL;
+                --top;
+                break;
+            }
+        }
+    }
+    DCHECK_EQ(top, 1UL);
+    result = stack[0];
+    return Status::OK();
+}
+
+
+StatusOr<bool> CompiledExpression::evalBool(const Reader* const *readers) const {
+    Value value;
+    auto status = eval(readers, value);
+    if (!status.ok()) {
+        return status;
+    }
+    return asBool(value);
+}
+
+
+void CompiledExpression::setupColumns(Batch &batch) const {
+    if (batch.columns_.size() != slots_.size()) {
+        batch.columns_.resize(slots_.size());
+        for (auto i = 0UL; i < slots_.size(); i++) {
+            batch.columns_[i].type = slots_[i].type;
+        }
+    }
+}
+
+
+void CompiledExpression::appendRow(const Reader* const *readers, Batch &batch) const {
+    setupColumns(batch);
+    auto row = batch.size_++;
+    batch.failed_.emplace_back(0);
+    for (auto i = 0UL; i < slots_.size(); i++) {
+        auto &slot = slots_[i];
+        Value value;
+        value.type = slot.type;
+        if (!readers[slot.source]->read(slot.index, value)) {
+            batch.fail(row, Status::Error("Failed to read `%s'", names_[i].c_str()));
+        }
+        auto &column = batch.columns_[i];
+        switch (slot.type) {
+            case Type::INT:
+                column.ints.emplace_back(value.i);
+                break;
+            case Type::DOUBLE:
+                column.doubles.emplace_back(value.d);
+                break;
+            case Type::BOOL:
+                column.bools.emplace_back(value.b);
+                break;
+            case Type::STRING:
+                column.strings.emplace_back(value.s);
+                break;
+        }
+    }
+}
+
+
+void CompiledExpression::evalBatch(Batch &batch) const {
+    using Column = Batch::Column;
+    // Even for an empty batch, the slots are loaded as empty columns
+    setupColumns(batch);
+    auto size = batch.size_;
+    auto &stack = batch.stack_;
+    if (stack.size() < maxDepth_) {
+        stack.resize(maxDepth_);
+    }
+
+    auto toBool = [size] (Column &column) {
+        auto &bools = column.bools;
+        bools.resize(size);
+        switch (column.type) {
+            case Type::INT:
+                for (auto i = 0UL; i < size; i++) {
+                    bools[i] = column.ints[i] != 0;
+                }
+                break;
+            case Type::DOUBLE:
+                for (auto i = 0UL; i < size; i++) {
+                    bools[i] = column.doubles[i] != 0.0;
+                }
+                break;
+            case Type::BOOL:
+                break;
+            case Type::STRING:
+                // The same as Expression::asBool()
+                for (auto i = 0UL; i < size; i++) {
+                    bools[i] = column.strings[i].empty();
+                }
+                break;
+        }
+        column.type = Type::BOOL;
+    };
+
+    size_t top = 0;
+    for (auto &inst : program_) {
+        switch (inst.code) {
+            case OpCode::PUSH: {
+                auto &value = constants_[inst.operand];
+                auto &column = stack[top++];
+                column.type = value.type;
+                switch (value.type) {
+                    case Type::INT:
+                        column.ints.assign(size, value.i);
+                        break;
+                    case Type::DOUBLE:
+                        column.doubles.assign(size, value.d);
+                        break;
+                    case Type::BOOL:
+                        column.bools.assign(size, value.b);
+                        break;
+                    case Type::STRING:
+                        column.strings.assign(size, value.s);
+                        break;
+                }
+                break;
+            }
+            case OpCode::LOAD:
+                stack[top++] = batch.columns_[inst.operand];
+                break;
+            case OpCode::I2D: {
+                auto &column = stack[top - 1 - inst.operand];
+                column.doubles.resize(size);
+                for (auto i = 0UL; i < size; i++) {
+                    column.doubles[i] = static_cast<double>(column.ints[i]);
+                }
+                column.type = Type::DOUBLE;
+                break;
+            }
+            case OpCode::NEG_INT: {
+                auto &ints = stack[top - 1].ints;
+                for (auto i = 0UL; i < size; i++) {
+                    ints[i] = -ints[i];
+                }
+                break;
+            }
+            case OpCode::NEG_DOUBLE: {
+                auto &doubles = stack[top - 1].doubles;
+                for (auto i = 0UL; i < size; i++) {
+                    doubles[i] = -doubles[i];
+                }
+                break;
+            }
+            case OpCode::NOT: {
+                auto &column = stack[top - 1];
+                toBool(column);
+                for (auto i = 0UL; i < size; i++) {
+                    column.bools[i] = !column.bools[i];
+                }
+                break;
+            }
+            case OpCode::ARITH_INT: {
+                auto &left = stack[top - 2].ints;
+                auto &right = stack[top - 1].ints;
+                auto op = static_cast<ArithmeticExpression::Operator>(inst.operand);
+                if (op == ArithmeticExpression::DIV || op == ArithmeticExpression::MOD) {
+                    for (auto i = 0UL; i < size; i++) {
+                        if (right[i] == 0) {
+                            batch.fail(i, Status::Error("Division by zero"));
+                            left[i] = 0;
+                        } else if (op == ArithmeticExpression::DIV) {
+                            left[i] = left[i] / right[i];
+                        } else {
+                            left[i] = left[i] % right[i];
+                        }
+                    }
+                } else {
+                    arithColumn(left, right, size, op);
+                }
+                --top;
+                break;
+            }
+            case OpCode::ARITH_DOUBLE: {
+                auto op = static_cast<ArithmeticExpression::Operator>(inst.operand);
+                arithColumn(stack[top - 2].doubles, stack[top - 1].doubles, size, op);
+                --top;
+                break;
+            }
+            case OpCode::CMP_INT: {
+                auto &left = stack[top - 2];
+                auto op = static_cast<RelationalExpression::Operator>(inst.operand);
+                compareColumn(left.ints, stack[top - 1].ints, left.bools, size, op);
+                left.type = Type::BOOL;
+                --top;
+                break;
+            }
+            case OpCode::CMP_DOUBLE: {
+                auto &left = stack[top - 2];
+                auto &right = stack[top - 1];
+                auto op = static_cast<RelationalExpression::Operator>(inst.operand);
+                if (op == RelationalExpression::EQ) {
+                    compareColumn(left.doubles, right.doubles, left.bools, size,
+                                  &Expression::almostEqual);
+                } else if (op == RelationalExpression::NE) {
+                    compareColumn(left.doubles, right.doubles, left.bools, size,
+                                  [] (double l, double r) {
+                                      return !Expression::almostEqual(l, r);
+                                  });
+                } else {
+                    compareColumn(left.doubles, right.doubles, left.bools, size, op);
+                }
+                left.type = Type::BOOL;
+                --top;
+                break;
+            }
+            case OpCode::CMP_BOOL: {
+                auto &left = stack[top - 2];
+                auto op = static_cast<RelationalExpression::Operator>(inst.operand);
+                compareColumn(left.bools, stack[top - 1].bools, left.bools, size, op);
+                --top;
+                break;
+            }
+            case OpCode::CMP_STRING: {
+                auto &left = stack[top - 2];
+                auto op = static_cast<RelationalExpression::Operator>(inst.operand);
+                compareColumn(left.strings, stack[top - 1].strings, left.bools, size, op);
+                left.type = Type::BOOL;
+                --top;
+                break;
+            }
+            case OpCode::AND:
+            case OpCode::OR: {
+                auto &left = stack[top - 2];
+                auto &right = stack[top - 1];
+                toBool(left);
+                toBool(right);
+                if (inst.code == OpCode::AND) {
+                    for (auto i = 0UL; i < size; i++) {
+                        left.bools[i] = left.bools[i] & right.bools[i];
+                    }
+                } else {
+                    for (auto i = 0UL; i < size; i++) {
+                        left.bools[i] = left.bools[i] | right.bools[i];
+                    }
+                }
+                --top;
+                break;
+            }
+        }
+    }
+    DCHECK_EQ(top, 1UL);
+}
+
+
+CompiledExpression::Value CompiledExpression::Batch::result(size_t row) const {
+    auto &column = stack_.front();
+    Value value;
+    value.type = column.type;
+    switch (column.type) {
+        case Type::INT:
+            value.i = column.ints[row];
+            break;
+        case Type::DOUBLE:
+            value.d = column.doubles[row];
+            break;
+        case Type::BOOL:
+            value.b = column.bools[row];
+            break;
+        case Type::STRING:
+            value.s = column.strings[row];
+            break;
+    }
+    return value;
+}
+
+
+void CompiledExpression::Batch::clear() {
+    size_ = 0;
+    for (auto &column : columns_) {
+        column.ints.clear();
+        column.doubles.clear();
+        column.bools.clear();
+        column.strings.clear();
+    }
+    failed_.clear();
+    error_ = Status::OK();
+}
+
+
+// static
+bool CompiledExpression::asBool(const Value &value) {
+    switch (value.type) {
+        case Type::INT:
+            return value.i != 0;
+        case Type::DOUBLE:
+            return value.d != 0.0;
+        case Type::BOOL:
+            return value.b;
+        case Type::STRING:
+            // The same as Expression::asBool()
+            return value.s.empty();
+    }
+    return false;
+}
+
+
+// static
+VariantType CompiledExpression::toVariant(const Value &value) {
+    switch (value.type) {
+        case Type::INT:
+            return value.i;
+        case Type::DOUBLE:
+            return value.d;
+        case Type::BOOL:
+            return value.b;
+        case Type::STRING:
+            return value.s.str();
+    }
+    return false;
+}
+
+
+
+bool VariantRowReader::read(int32_t index, CompiledExpression::Value &value) const {
+    if (row_ == nullptr || index >= static_cast<int32_t>(row_->size())) {
+        return false;
+    }
+    auto &column = (*row_)[index];
+    switch (value.type) {
+        case CompiledExpression::Type::INT:
+            if (column.which() != VAR_INT64) {
+                return false;
+            }
+            value.i = boost::get<int64_t>(column);
+            return true;
+        case CompiledExpression::Type::DOUBLE:
+            if (column.which() != VAR_DOUBLE) {
+                return false;
+            }
+            value.d = boost::get<double>(column);
+            return true;
+        case CompiledExpression::Type::BOOL:
+            if (column.which() != VAR_BOOL) {
+                return false;
+            }
+            value.b = boost::get<bool>(column);
+            return true;
+        case CompiledExpression::Type::STRING:
+            if (column.which() != VAR_STR) {
+                return false;
+            }
+            value.s = boost::get<std::string>(column);
+            return true;
+    }
+    return false;
+}
+
+}   // namespace nebula
@@ -0,0 +1,220 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+#ifndef COMMON_FILTER_COMPILEDEXPRESSION_H_
+#define COMMON_FILTER_COMPILEDEXPRESSION_H_
+
+#include "base/Base.h"
+#include "base/StatusOr.h"
+#include "base/Status.h"
+#include "filter/Expressions.h"
+
+namespace nebula {
+
+/**
+ * CompiledExpression is an expression tree flattened into a postfix program.
+ *
+ * Every property reference is resolved by the caller into a typed slot once,
+ * and the constant subtrees are folded, so that evaluating one row neither
+ * looks up a property by name nor allocates. The values are read through the
+ * Readers passed in, which are indexed by Slot::source.
+ *
+ * The results are the same as Expression::eval(). Expressions that could not
+ * be evaluated without allocating, e.g. string concatenation, function calls,
+ * or whose result depends on the runtime types, fail to compile, and the
+ * caller should fall back to Expression::eval().
+ */
+class CompiledExpression final {
+public:
+    enum class Type : uint8_t {
+        INT, DOUBLE, BOOL, STRING,
+    };
+
+    struct Value {
+        Value() : i(0) {}
+
+        Type                    type{Type::INT};
+        union {
+            int64_t             i;
+            double              d;
+            bool                b;
+        };
+        // Valid as long as the row read from
+        folly::StringPiece      s;
+    };
+
+    struct Slot {
+        uint8_t                 source{0};
+        int32_t                 index{0};
+        Type                    type{Type::INT};
+    };
+
+    class Reader {
+    public:
+        virtual ~Reader() = default;
+
+        // Read the field at `index' into `value', whose type is already set
+        virtual bool read(int32_t index, Value &value) const = 0;
+    };
+
+    // Resolve a property expression to the slot it is read from
+    using Resolver = std::function<StatusOr<Slot>(const Expression*)>;
+
+    static StatusOr<std::unique_ptr<CompiledExpression>>
+    compile(const Expression *expr, const Resolver &resolver);
+
+    Type type() const {
+        return type_;
+    }
+
+    // `readers' are indexed by the source of the slots
+    Status MUST_USE_RESULT eval(const Reader* const *readers, Value &result) const;
+
+    StatusOr<bool> evalBool(const Reader* const *readers) const;
+
+    // Rows evaluated in one batch
+    static constexpr size_t kBatchSize = 1024;
+
+    /**
+     * A batch of rows, decoded into one column per slot, to be evaluated
+     * column by column in tight loops rather than row by row.
+     *
+     * The buffers are kept across batches, so a Batch is supposed to be reused,
+     * with the same CompiledExpression.
+     */
+    class Batch final {
+    public:
+        size_t size() const {
+            return size_;
+        }
+
+        // Whether row `row' failed to be decoded or evaluated
+        bool failed(size_t row) const {
+            return failed_[row] != 0;
+        }
+
+        // Why the first failed row failed
+        const Status& error() const {
+            return error_;
+        }
+
+        // The result of row `row', after CompiledExpression::evalBatch()
+        Value result(size_t row) const;
+
+        void clear();
+
+    private:
+        friend class CompiledExpression;
+
+        // Only the values of `type' are used
+        struct Column {
+            Type                                type{Type::INT};
+            std::vector<int64_t>                ints;
+            std::vector<double>                 doubles;
+            std::vector<uint8_t>                bools;
+            std::vector<folly::StringPiece>     strings;
+        };
+
+        void fail(size_t row, Status status) {
+            failed_[row] = 1;
+            if (error_.ok()) {
+                error_ = std::move(status);
+            }
+        }
+
+        size_t                                  size_{0};
+        // One for each slot
+        std::vector<Column>                     columns_;
+        std::vector<uint8_t>                    failed_;
+        Status                                  error_;
+        // The columns being evaluated
+        std::vector<Column>                     stack_;
+    };
+
+    // Decode the slots of one row and append it to `batch'
+    void appendRow(const Reader* const *readers, Batch &batch) const;
+
+    // Evaluate all the rows in `batch'
+    void evalBatch(Batch &batch) const;
+
+    static bool asBool(const Value &value);
+
+    static VariantType toVariant(const Value &value);
+
+private:
+    enum class OpCode : uint8_t {
+        PUSH,
+        LOAD,
+        // Convert an integer at `operand' below the top into double
+        I2D,
+        NEG_INT,
+        NEG_DOUBLE,
+        NOT,
+        // `operand' is ArithmeticExpression::Operator
+        ARITH_INT,
+        ARITH_DOUBLE,
+        // `operand' is RelationalExpression::Operator
+        CMP_INT,
+        CMP_DOUBLE,
+        CMP_BOOL,
+        CMP_STRING,
+        AND,
+        OR,
+    };
+
+    struct Instruction {
+        OpCode                  code;
+        uint32_t                operand;
+    };
+
+    static constexpr size_t kMaxDepth = 64;
+
+    CompiledExpression() = default;
+
+    // Emit the program of `expr', and push the type of its result to `types'
+    Status emit(const Expression *expr, const Resolver &resolver, std::vector<Type> &types);
+
+    Status emitConstant(const Expression *expr, std::vector<Type> &types);
+
+    // One column for each slot in `batch'
+    void setupColumns(Batch &batch) const;
+
+    void append(OpCode code, uint32_t operand = 0) {
+        program_.emplace_back(Instruction{code, operand});
+    }
+
+    static bool isConstant(const Expression *expr);
+
+private:
+    std::vector<Instruction>                    program_;
+    std::vector<Value>                          constants_;
+    // To hold the string constants referred to by `constants_'
+    std::list<std::string>                      strings_;
+    std::vector<Slot>                           slots_;
+    // The property expressions of `slots_', for error messages
+    std::vector<std::string>                    names_;
+    Type                                        type_{Type::INT};
+    size_t                                      maxDepth_{0};
+};
+
+
+/**
+ * Read the values of a row of VariantType by index, e.g. an input row.
+ */
+class VariantRowReader final : public CompiledExpression::Reader {
+public:
+    void reset(const std::vector<VariantType> *row) {
+        row_ = row;
+    }
+
+    bool read(int32_t index, CompiledExpression::Value &value) const override;
+
+private:
+    const std::vector<VariantType>             *row_{nullptr};
+};
+
+}   // namespace nebula
+
+#endif  // COMMON_FILTER_COMPILEDEXPRESSION_H_
@@ -545,11 +545,67 @@ const char* PrimaryExpression::decode(const char *pos, const char *end) {
 }
 
 
+std::string ParameterExpression::toString() const {
+    return folly::stringPrintf("$%ld", index_);
+}
+
+
+OptVariantType ParameterExpression::eval() const {
+    if (value_ == nullptr) {
+        return Status::Error("Parameter `$%ld' is not bound", index_);
+    }
+    return value_->eval();
+}
+
+
+Status ParameterExpression::prepare() {
+    if (value_ == nullptr) {
+        return Status::Error("Parameter `$%ld' is not bound", index_);
+    }
+    return Status::OK();
+}
+
+
+void ParameterExpression::bind(const VariantType &value) {
+    switch (value.which()) {
+        case VAR_INT64:
+            value_ = std::make_unique<PrimaryExpression>(boost::get<int64_t>(value));
+            break;
+        case VAR_DOUBLE:
+            value_ = std::make_unique<PrimaryExpression>(boost::get<double>(value));
+            break;
+        case VAR_BOOL:
+            value_ = std::make_unique<PrimaryExpression>(boost::get<bool>(value));
+            break;
+        case VAR_STR:
+            value_ = std::make_unique<PrimaryExpression>(boost::get<std::string>(value));
+            break;
+        default:
+            DCHECK(false);
+    }
+}
+
+
+void ParameterExpression::encode(Cord &cord) const {
+    // prepare() has made sure the parameter is bound
+    DCHECK(value_ != nullptr);
+    static_cast<const Expression*>(value_.get())->encode(cord);
+}
+
+
+const char* ParameterExpression::decode(const char *, const char *) {
+    throw Status::Error("Parameters are encoded as their bound values");
+}
+
+
 std::string FunctionCallExpression::toString() const {
     std::string buf;
     buf.reserve(256);
     buf += *name_;
     buf += "(";
+    if (star_) {
+        buf += "*";
+    }
     for (auto &arg : args_) {
         buf += arg->toString();
         buf += ",";
@@ -578,6 +634,10 @@ OptVariantType FunctionCallExpression::eval() const {
 }
 
 Status FunctionCallExpression::prepare() {
+    if (star_) {
+        // Only aggregated by GROUP BY
+        return Status::Error("`%s' is not a function", toString().c_str());
+    }
     auto result = FunctionManager::get(*name_, args_.size());
     if (!result.ok()) {
         return std::move(result).status();
@@ -226,6 +226,7 @@ public:
         kVariableProp,
         kDestProp,
         kInputProp,
+        kParameter,
 
         kMax,
     };
@@ -265,6 +266,7 @@ private:
     friend class EdgePropertyExpression;
     friend class VariablePropertyExpression;
     friend class InputPropertyExpression;
+    friend class ParameterExpression;
 
     virtual void encode(Cord &cord) const = 0;
     /*
@@ -563,6 +565,47 @@ private:
 };
 
 
+// $1, $2, ..., the placeholders of a prepared statement.
+// It is encoded as the bound literal, so the storage side never sees it.
+class ParameterExpression final : public Expression {
+public:
+    ParameterExpression() {
+        kind_ = kParameter;
+    }
+
+    explicit ParameterExpression(int64_t index) {
+        kind_ = kParameter;
+        index_ = index;
+    }
+
+    std::string toString() const override;
+
+    OptVariantType eval() const override;
+
+    Status MUST_USE_RESULT prepare() override;
+
+    // The placeholder $N refers to the Nth parameter, starting from 1
+    int64_t index() const {
+        return index_;
+    }
+
+    void bind(const VariantType &value);
+
+    void unbind() {
+        value_.reset();
+    }
+
+private:
+    void encode(Cord &cord) const override;
+
+    const char* decode(const char *pos, const char *end) override;
+
+private:
+    int64_t                                     index_{0};
+    std::unique_ptr<PrimaryExpression>          value_;
+};
+
+
 class ArgumentList final {
 public:
     void addArgument(Expression *arg) {
@@ -593,6 +636,13 @@ public:
         }
     }
 
+    // name(*), i.e. COUNT(*)
+    explicit FunctionCallExpression(std::string *name) {
+        kind_ = kFunctionCall;
+        name_.reset(name);
+        star_ = true;
+    }
+
     std::string toString() const override;
 
     OptVariantType eval() const override;
@@ -606,6 +656,18 @@ public:
         }
     }
 
+    const std::string* name() const {
+        return name_.get();
+    }
+
+    const std::vector<std::unique_ptr<Expression>>& args() const {
+        return args_;
+    }
+
+    bool isStar() const {
+        return star_;
+    }
+
 private:
     void encode(Cord &cord) const override;
 
@@ -614,6 +676,7 @@ private:
 private:
     std::unique_ptr<std::string>                name_;
     std::vector<std::unique_ptr<Expression>>    args_;
+    bool                                        star_{false};
     std::function<VariantType(const std::vector<VariantType>&)> function_;
 };
 
@@ -651,6 +714,10 @@ public:
         return operand_.get();
     }
 
+    Operator op() const {
+        return op_;
+    }
+
 private:
     void encode(Cord &cord) const override;
 
@@ -744,6 +811,10 @@ public:
         return right_.get();
     }
 
+    Operator op() const {
+        return op_;
+    }
+
 private:
     void encode(Cord &cord) const override;
 
@@ -795,6 +866,10 @@ public:
         return right_.get();
     }
 
+    Operator op() const {
+        return op_;
+    }
+
 private:
     void encode(Cord &cord) const override;
 
@@ -847,6 +922,10 @@ public:
         return right_.get();
     }
 
+    Operator op() const {
+        return op_;
+    }
+
 private:
     void encode(Cord &cord) const override;
 
@@ -6,9 +6,16 @@
 #include "base/Base.h"
 #include <folly/Benchmark.h>
 #include "filter/Expressions.h"
+#include "filter/CompiledExpression.h"
 #include "parser/GQLParser.h"
 
 using nebula::Expression;
+using nebula::ExpressionContext;
+using nebula::CompiledExpression;
+using nebula::VariantRowReader;
+using nebula::VariantType;
+using nebula::OptVariantType;
+using nebula::AliasPropertyExpression;
 using nebula::GQLParser;
 using nebula::SequentialSentences;
 using nebula::GoSentence;
@@ -70,6 +77,134 @@ size_t Decode(size_t iters, std::string query) {
     return iters * ops;
 }
 
+// alias.prop1 ... alias.prop6 are 1 ... 6
+static std::vector<VariantType> makeRow() {
+    std::vector<VariantType> row;
+    for (auto i = 1L; i <= 6L; i++) {
+        row.emplace_back(i);
+    }
+    return row;
+}
+
+size_t Eval(size_t iters, std::string query) {
+    constexpr size_t ops = 1000000UL;
+
+    query = "GO FROM 1 AS p OVER q WHERE " + query;
+    Expression *expr;
+    StatusOr<std::unique_ptr<SequentialSentences>> result;
+    auto ctx = std::make_unique<ExpressionContext>();
+    auto row = makeRow();
+    BENCHMARK_SUSPEND {
+        GQLParser parser;
+        result = parser.parse(query);
+        if (!result.ok()) {
+             return 0;
+        }
+        expr = getFilterExpr(result.value().get());
+        ctx->getters().getAliasProp = [&] (const std::string&,
+                                           const std::string &prop) -> OptVariantType {
+            return row[prop.back() - '1'];
+        };
+        expr->setContext(ctx.get());
+    }
+
+    auto i = 0UL;
+    while (i++ < ops * iters) {
+        auto value = expr->eval();
+        folly::doNotOptimizeAway(i);
+        folly::doNotOptimizeAway(value);
+    }
+
+    return iters * ops;
+}
+
+size_t CompiledEval(size_t iters, std::string query) {
+    constexpr size_t ops = 1000000UL;
+
+    query = "GO FROM 1 AS p OVER q WHERE " + query;
+    std::unique_ptr<CompiledExpression> compiled;
+    auto row = makeRow();
+    BENCHMARK_SUSPEND {
+        GQLParser parser;
+        auto result = parser.parse(query);
+        if (!result.ok()) {
+             return 0;
+        }
+        auto *expr = getFilterExpr(result.value().get());
+        auto resolver = [] (const Expression *e) -> StatusOr<CompiledExpression::Slot> {
+            auto *prop = static_cast<const AliasPropertyExpression*>(e)->prop();
+            CompiledExpression::Slot slot;
+            slot.index = prop->back() - '1';
+            slot.type = CompiledExpression::Type::INT;
+            return slot;
+        };
+        auto ret = CompiledExpression::compile(expr, resolver);
+        if (!ret.ok()) {
+             return 0;
+        }
+        compiled = std::move(ret).value();
+    }
+
+    VariantRowReader reader;
+    reader.reset(&row);
+    const CompiledExpression::Reader *readers[] = {&reader};
+    auto i = 0UL;
+    while (i++ < ops * iters) {
+        CompiledExpression::Value value;
+        auto status = compiled->eval(readers, value);
+        folly::doNotOptimizeAway(i);
+        folly::doNotOptimizeAway(status);
+        folly::doNotOptimizeAway(value.b);
+    }
+
+    return iters * ops;
+}
+
+size_t BatchEval(size_t iters, std::string query) {
+    constexpr size_t ops = 1000000UL;
+
+    query = "GO FROM 1 AS p OVER q WHERE " + query;
+    std::unique_ptr<CompiledExpression> compiled;
+    auto row = makeRow();
+    BENCHMARK_SUSPEND {
+        GQLParser parser;
+        auto result = parser.parse(query);
+        if (!result.ok()) {
+             return 0;
+        }
+        auto *expr = getFilterExpr(result.value().get());
+        auto resolver = [] (const Expression *e) -> StatusOr<CompiledExpression::Slot> {
+            auto *prop = static_cast<const AliasPropertyExpression*>(e)->prop();
+            CompiledExpression::Slot slot;
+            slot.index = prop->back() - '1';
+            slot.type = CompiledExpression::Type::INT;
+            return slot;
+        };
+        auto ret = CompiledExpression::compile(expr, resolver);
+        if (!ret.ok()) {
+             return 0;
+        }
+        compiled = std::move(ret).value();
+    }
+
+    VariantRowReader reader;
+    reader.reset(&row);
+    const CompiledExpression::Reader *readers[] = {&reader};
+    CompiledExpression::Batch batch;
+    auto i = 0UL;
+    while (i < ops * iters) {
+        batch.clear();
+        for (auto j = 0UL; j < CompiledExpression::kBatchSize; j++) {
+            compiled->appendRow(readers, batch);
+        }
+        compiled->evalBatch(batch);
+        folly::doNotOptimizeAway(batch.result(0).b);
+        i += CompiledExpression::kBatchSize;
+    }
+
+    return iters * ops;
+}
+
 auto simpleQuery =  "123 + 123 - 123 * 123 / 123";
 auto complexQuery =  "alias.prop1 + alias.prop2 * alias.prop3 > alias.prop4 && "
                      "alias.prop5 == alias.prop6";
@@ -82,6 +217,16 @@ BENCHMARK_DRAW_LINE();
 BENCHMARK_NAMED_PARAM_MULTI(Decode, Simple, simpleQuery);
 BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(Decode, Complex, complexQuery);
 
+BENCHMARK_DRAW_LINE();
+
+// Evaluating the expression tree, with the props read through the getters,
+// against the compiled program, with the props read from slots.
+BENCHMARK_NAMED_PARAM_MULTI(Eval, Simple, simpleQuery);
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(CompiledEval, Simple, simpleQuery);
+BENCHMARK_NAMED_PARAM_MULTI(Eval, Complex, complexQuery);
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(CompiledEval, Complex, complexQuery);
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(BatchEval, Complex, complexQuery);
+
 int
 main(int argc, char **argv) {
     gflags::ParseCommandLineFlags(&argc, &argv, true);
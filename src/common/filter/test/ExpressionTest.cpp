@@ -7,6 +7,7 @@
 #include "base/Base.h"
 #include <gtest/gtest.h>
 #include "filter/FunctionManager.h"
+#include "filter/CompiledExpression.h"
 #include "parser/GQLParser.h"
 #include "parser/SequentialSentences.h"
 
@@ -539,6 +540,208 @@ TEST_F(ExpressionTest, EdgeReference) {
 }
 
 
+TEST_F(ExpressionTest, CompiledExpression) {
+    GQLParser parser;
+    std::vector<std::string> props = {"age", "weight", "flag", "name"};
+    std::vector<CompiledExpression::Type> types = {
+        CompiledExpression::Type::INT,
+        CompiledExpression::Type::DOUBLE,
+        CompiledExpression::Type::BOOL,
+        CompiledExpression::Type::STRING,
+    };
+    std::vector<VariantType> row = {5L, 2.5, true, std::string("dutor")};
+    auto resolver = [&] (const Expression *expr) -> StatusOr<CompiledExpression::Slot> {
+        if (expr->kind() != Expression::kAliasProp) {
+            return Status::Error("Not an edge prop");
+        }
+        auto *prop = static_cast<const AliasPropertyExpression*>(expr)->prop();
+        auto iter = std::find(props.begin(), props.end(), *prop);
+        if (iter == props.end()) {
+            return Status::Error("Unknown prop");
+        }
+        CompiledExpression::Slot slot;
+        slot.index = iter - props.begin();
+        slot.type = types[slot.index];
+        return slot;
+    };
+    auto ctx = std::make_unique<ExpressionContext>();
+    ctx->getters().getAliasProp = [&] (auto &, auto &prop) -> OptVariantType {
+        auto iter = std::find(props.begin(), props.end(), prop);
+        return row[iter - props.begin()];
+    };
+    VariantRowReader reader;
+    reader.reset(&row);
+    const CompiledExpression::Reader *readers[] = {&reader};
+
+#define TEST_EXPR(expr_arg)                                                     \
+    do {                                                                        \
+        std::string query = "GO FROM 1 OVER follow WHERE " #expr_arg;           \
+        auto parsed = parser.parse(query);                                      \
+        ASSERT_TRUE(parsed.ok()) << parsed.status();                            \
+        auto *expr = getFilterExpr(parsed.value().get());                       \
+        ASSERT_NE(nullptr, expr);                                               \
+        expr->setContext(ctx.get());                                            \
+        auto expected = expr->eval();                                           \
+        ASSERT_TRUE(expected.ok()) << expected.status();                        \
+        auto compiled = CompiledExpression::compile(expr, resolver);            \
+        ASSERT_TRUE(compiled.ok()) << compiled.status();                        \
+        CompiledExpression::Value value;                                        \
+        auto status = compiled.value()->eval(readers, value);                   \
+        ASSERT_TRUE(status.ok()) << status;                                     \
+        ASSERT_EQ(expected.value(), CompiledExpression::toVariant(value))       \
+            << #expr_arg;                                                       \
+    } while (false)
+
+    TEST_EXPR(follow.age);
+    TEST_EXPR(follow.name);
+    TEST_EXPR(follow.age + 1 > 5);
+    TEST_EXPR(follow.age * follow.weight);
+    TEST_EXPR(follow.age / 2 - 3.0);
+    TEST_EXPR(follow.age % 3 == 2);
+    TEST_EXPR(-follow.weight + 1);
+    TEST_EXPR(+follow.age);
+    TEST_EXPR(follow.age == 5.0);
+    TEST_EXPR(follow.weight != 2.5);
+    TEST_EXPR(follow.weight == 2.5 && follow.flag);
+    TEST_EXPR(follow.flag != false || follow.age > 10);
+    TEST_EXPR(!follow.name);
+    TEST_EXPR(!follow.age);
+    TEST_EXPR(follow.name == "dutor");
+    TEST_EXPR(follow.name > "abc" && follow.name <= "e");
+    TEST_EXPR((1 + 2) * follow.age / 3);
+    TEST_EXPR("a" + "b" == follow.name);
+    TEST_EXPR(follow.age >= 1 + 2 * 2);
+#undef TEST_EXPR
+
+    // Left to Expression::eval()
+#define TEST_EXPR(expr_arg)                                                     \
+    do {                                                                        \
+        std::string query = "GO FROM 1 OVER follow WHERE " #expr_arg;           \
+        auto parsed = parser.parse(query);                                      \
+        ASSERT_TRUE(parsed.ok()) << parsed.status();                            \
+        auto *expr = getFilterExpr(parsed.value().get());                       \
+        ASSERT_NE(nullptr, expr);                                               \
+        auto compiled = CompiledExpression::compile(expr, resolver);            \
+        ASSERT_FALSE(compiled.ok()) << #expr_arg;                               \
+    } while (false)
+
+    TEST_EXPR(follow.name + "a");
+    TEST_EXPR(follow.age < 2.5);
+    TEST_EXPR(follow.name == 1);
+    TEST_EXPR(-follow.name);
+    TEST_EXPR(follow.weight % 2);
+    TEST_EXPR(follow.unknown > 1);
+    TEST_EXPR($-.age > 1);
+    TEST_EXPR(abs(follow.age) > 1);
+#undef TEST_EXPR
+
+    {
+        std::string query = "GO FROM 1 OVER follow WHERE follow.age / (follow.age - 5)";
+        auto parsed = parser.parse(query);
+        ASSERT_TRUE(parsed.ok()) << parsed.status();
+        auto compiled = CompiledExpression::compile(getFilterExpr(parsed.value().get()),
+                                                    resolver);
+        ASSERT_TRUE(compiled.ok()) << compiled.status();
+        CompiledExpression::Value value;
+        ASSERT_FALSE(compiled.value()->eval(readers, value).ok());
+    }
+    {
+        // The value read is not of the type resolved
+        std::string query = "GO FROM 1 OVER follow WHERE follow.age > 1";
+        auto parsed = parser.parse(query);
+        ASSERT_TRUE(parsed.ok()) << parsed.status();
+        auto compiled = CompiledExpression::compile(getFilterExpr(parsed.value().get()),
+                                                    resolver);
+        ASSERT_TRUE(compiled.ok()) << compiled.status();
+        std::vector<VariantType> another = {std::string("5")};
+        VariantRowReader anotherReader;
+        anotherReader.reset(&another);
+        const CompiledExpression::Reader *anotherReaders[] = {&anotherReader};
+        ASSERT_FALSE(compiled.value()->evalBool(anotherReaders).ok());
+        auto matched = compiled.value()->evalBool(readers);
+        ASSERT_TRUE(matched.ok()) << matched.status();
+        ASSERT_TRUE(matched.value());
+    }
+}
+
+
+TEST_F(ExpressionTest, CompiledExpressionBatch) {
+    GQLParser parser;
+    std::vector<std::string> props = {"age", "weight", "flag", "name"};
+    std::vector<CompiledExpression::Type> types = {
+        CompiledExpression::Type::INT,
+        CompiledExpression::Type::DOUBLE,
+        CompiledExpression::Type::BOOL,
+        CompiledExpression::Type::STRING,
+    };
+    auto resolver = [&] (const Expression *expr) -> StatusOr<CompiledExpression::Slot> {
+        auto *prop = static_cast<const AliasPropertyExpression*>(expr)->prop();
+        auto iter = std::find(props.begin(), props.end(), *prop);
+        if (iter == props.end()) {
+            return Status::Error("Unknown prop");
+        }
+        CompiledExpression::Slot slot;
+        slot.index = iter - props.begin();
+        slot.type = types[slot.index];
+        return slot;
+    };
+    std::vector<std::vector<VariantType>> rows;
+    for (auto i = 0L; i < 100L; i++) {
+        rows.emplace_back(std::vector<VariantType>{
+            i, i / 4.0, i % 3 == 0, std::string(i % 5 == 0 ? "" : "name") + std::to_string(i)});
+    }
+
+#define TEST_EXPR(expr_arg)                                                     \
+    do {                                                                        \
+        std::string query = "GO FROM 1 OVER follow WHERE " #expr_arg;           \
+        auto parsed = parser.parse(query);                                      \
+        ASSERT_TRUE(parsed.ok()) << parsed.status();                            \
+        auto *expr = getFilterExpr(parsed.value().get());                       \
+        auto compiled = CompiledExpression::compile(expr, resolver);            \
+        ASSERT_TRUE(compiled.ok()) << compiled.status();                        \
+        CompiledExpression::Batch batch;                                        \
+        VariantRowReader reader;                                                \
+        const CompiledExpression::Reader *readers[] = {&reader};                \
+        /* Twice, to evaluate a reused batch */                                 \
+        for (auto round = 0; round < 2; round++) {                              \
+            batch.clear();                                                      \
+            for (auto &row : rows) {                                            \
+                reader.reset(&row);                                             \
+                compiled.value()->appendRow(readers, batch);                    \
+            }                                                                   \
+            compiled.value()->evalBatch(batch);                                 \
+            ASSERT_EQ(rows.size(), batch.size());                               \
+            for (auto i = 0UL; i < rows.size(); i++) {                          \
+                reader.reset(&rows[i]);                                         \
+                CompiledExpression::Value expected;                             \
+                auto status = compiled.value()->eval(readers, expected);        \
+                ASSERT_EQ(!status.ok(), batch.failed(i)) << #expr_arg;          \
+                if (!status.ok()) {                                             \
+                    continue;                                                   \
+                }                                                               \
+                ASSERT_EQ(CompiledExpression::toVariant(expected),              \
+                          CompiledExpression::toVariant(batch.result(i)))       \
+                    << #expr_arg << ", row " << i;                              \
+            }                                                                   \
+        }                                                                       \
+    } while (false)
+
+    TEST_EXPR(follow.age);
+    TEST_EXPR(follow.name);
+    TEST_EXPR(follow.age > 50);
+    TEST_EXPR(follow.age * follow.weight - 1 >= 100);
+    TEST_EXPR(follow.age % 7 == 3 || follow.flag);
+    TEST_EXPR(follow.weight == 2.5 && !follow.flag);
+    TEST_EXPR(follow.age == 10.0);
+    TEST_EXPR(-follow.age + 3 < 0);
+    TEST_EXPR(!follow.name);
+    TEST_EXPR(follow.name >= "name5" && follow.flag != true);
+    TEST_EXPR(100 / (follow.age - 10) > 1);
+    TEST_EXPR(1 + 2);
+#undef TEST_EXPR
+}
+
+
 TEST_F(ExpressionTest, FunctionCall) {
     GQLParser parser;
 #define TEST_EXPR(expected, op, expr_arg, type)                         \
@@ -13,6 +13,10 @@
 namespace nebula {
 namespace thrift {
 
+/**
+ * Up to `poolSize' clients are kept to each host for each IO thread,
+ * which are handed out in turn.
+ */
 template<class ClientType>
 class ThriftClientManager final {
 public:
@@ -25,16 +29,23 @@ public:
         VLOG(3) << "~ThriftClientManager";
     }
 
-    ThriftClientManager() {
+    explicit ThriftClientManager(size_t poolSize = 1)
+            : poolSize_(std::max<size_t>(poolSize, 1)) {
         VLOG(3) << "ThriftClientManager";
     }
 
 private:
+    struct ClientPool {
+        std::vector<std::shared_ptr<ClientType>>    clients;  // Async thrift clients
+        size_t                                      next{0};
+    };
+
     using ClientMap = std::unordered_map<
         std::pair<HostAddr, folly::EventBase*>,     // <ip, port> pair
-        std::shared_ptr<ClientType>                 // Async thrift client
+        ClientPool
     >;
 
+    const size_t poolSize_;
     folly::ThreadLocal<ClientMap> clientMap_;
 };
 
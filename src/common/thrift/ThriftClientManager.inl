@@ -26,15 +26,15 @@ std::shared_ptr<ClientType> ThriftClientManager<ClientType>::client(
         evb = folly::EventBaseManager::get()->getEventBase();
     }
 
-    auto it = clientMap_->find(std::make_pair(host, evb));
-    if (it != clientMap_->end()) {
-        return it->second;
+    auto& pool = (*clientMap_)[std::make_pair(host, evb)];
+    if (pool.clients.size() >= poolSize_) {
+        return pool.clients[pool.next++ % pool.clients.size()];
     }
 
     // Need to create a new client
     auto ipAddr = network::NetworkUtils::intToIPv4(host.first);
     auto port = host.second;
-    VLOG(2) << "There is no existing client to "
+    VLOG(2) << "There are not enough clients to "
             << ipAddr << ":" << port
             << ", trying to create one";
     auto channel = apache::thrift::ReconnectingRequestChannel::newChannel(
@@ -63,7 +63,7 @@ std::shared_ptr<ClientType> ThriftClientManager<ClientType>::client(
             delete p;
         });
     });
-    clientMap_->emplace(std::make_pair(host, evb), client);
+    pool.clients.emplace_back(client);
     return client;
 }
 
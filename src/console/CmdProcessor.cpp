@@ -320,6 +320,17 @@ bool CmdProcessor::processClientCmd(folly::StringPiece cmd,
         readyToExit = false;
     }
 
+    if (cmd.removePrefix(":prepare ")) {
+        processPrepareCmd(cmd);
+        return true;
+    } else if (cmd.removePrefix(":execute ")) {
+        processExecuteCmd(cmd);
+        return true;
+    } else if (cmd.removePrefix(":unprepare ")) {
+        processUnprepareCmd(cmd);
+        return true;
+    }
+
     // TODO(sye) Check for all client commands
 
     return false;
@@ -330,6 +341,121 @@ void CmdProcessor::processServerCmd(folly::StringPiece cmd) {
     time::Duration dur;
     cpp2::ExecutionResponse resp;
     cpp2::ErrorCode res = client_->execute(cmd, resp);
+    printResponse(cmd, res, resp, dur);
+}
+
+
+void CmdProcessor::processPrepareCmd(folly::StringPiece stmt) {
+    cpp2::PrepareResponse resp;
+    auto res = client_->prepare(folly::trimWhitespace(stmt), resp);
+    if (res == cpp2::ErrorCode::SUCCEEDED) {
+        std::cout << "Prepared statement " << *resp.get_statement_id()
+                  << " with " << *resp.get_num_parameters() << " parameters\n";
+        std::cout << std::endl;
+    } else {
+        auto msg = resp.get_error_msg();
+        std::cout << "[ERROR (" << static_cast<int32_t>(res)
+                  << ")]: " << (msg != nullptr ? *msg : "")
+                  << "\n";
+    }
+}
+
+
+namespace {
+
+// Parse the comma separated literals, i.e. integers, doubles,
+// true/false and quoted strings
+bool parseParameters(folly::StringPiece args, std::vector<cpp2::ColumnValue>& params) {
+    std::vector<std::string> items;
+    std::string item;
+    char quote = '\0';
+    for (auto c : args) {
+        if (quote != '\0') {
+            item.push_back(c);
+            if (c == quote) {
+                quote = '\0';
+            }
+        } else if (c == ',') {
+            items.emplace_back(std::move(item));
+            item.clear();
+        } else {
+            if (c == '"' || c == '\'') {
+                quote = c;
+            }
+            item.push_back(c);
+        }
+    }
+    if (quote != '\0') {
+        return false;
+    }
+    items.emplace_back(std::move(item));
+
+    for (auto& it : items) {
+        auto value = folly::trimWhitespace(it);
+        if (value.empty()) {
+            return false;
+        }
+        cpp2::ColumnValue param;
+        if (value.size() >= 2
+                && (value.front() == '"' || value.front() == '\'')
+                && value.back() == value.front()) {
+            param.set_str(value.subpiece(1, value.size() - 2).str());
+        } else if (value == "true" || value == "false") {
+            param.set_bool_val(value == "true");
+        } else if (auto i = folly::tryTo<int64_t>(value)) {
+            param.set_integer(i.value());
+        } else if (auto d = folly::tryTo<double>(value)) {
+            param.set_double_precision(d.value());
+        } else {
+            return false;
+        }
+        params.emplace_back(std::move(param));
+    }
+    return true;
+}
+
+}  // Anonymous namespace
+
+
+void CmdProcessor::processExecuteCmd(folly::StringPiece args) {
+    args = folly::trimWhitespace(args);
+    auto pos = args.find(' ');
+    auto id = folly::tryTo<int64_t>(args.subpiece(0, pos));
+    if (!id.hasValue()) {
+        std::cout << "[ERROR]: Bad statement id `" << args.subpiece(0, pos) << "'\n";
+        return;
+    }
+    std::vector<cpp2::ColumnValue> params;
+    if (pos != folly::StringPiece::npos && !parseParameters(args.subpiece(pos + 1), params)) {
+        std::cout << "[ERROR]: Bad parameters `" << args.subpiece(pos + 1) << "'\n";
+        return;
+    }
+
+    time::Duration dur;
+    cpp2::ExecutionResponse resp;
+    auto res = client_->executePrepared(id.value(), params, resp);
+    printResponse(args, res, resp, dur);
+}
+
+
+void CmdProcessor::processUnprepareCmd(folly::StringPiece args) {
+    auto id = folly::tryTo<int64_t>(folly::trimWhitespace(args));
+    if (!id.hasValue()) {
+        std::cout << "[ERROR]: Bad statement id `" << args << "'\n";
+        return;
+    }
+    auto res = client_->unprepare(id.value());
+    if (res != cpp2::ErrorCode::SUCCEEDED) {
+        std::cout << "[ERROR (" << static_cast<int32_t>(res) << ")]: "
+                  << "Failed to unprepare statement " << id.value() << "\n";
+    }
+}
+
+
+void CmdProcessor::printResponse(folly::StringPiece cmd,
+                                 cpp2::ErrorCode res,
+                                 cpp2::ExecutionResponse& resp,
+                                 const time::Duration& dur) {
     if (res == cpp2::ErrorCode::SUCCEEDED) {
         // Succeeded
         auto *spaceName = resp.get_space_name();
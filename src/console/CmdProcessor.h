@@ -9,6 +9,7 @@
 
 #include "base/Base.h"
 #include "client/cpp/GraphClient.h"
+#include "time/Duration.h"
 
 namespace nebula {
 namespace graph {
@@ -38,6 +39,18 @@ private:
 
     void processServerCmd(folly::StringPiece cmd);
 
+    // :prepare <statement>
+    // :execute <statement id> [param1, param2, ...]
+    // :unprepare <statement id>
+    void processPrepareCmd(folly::StringPiece stmt);
+    void processExecuteCmd(folly::StringPiece args);
+    void processUnprepareCmd(folly::StringPiece args);
+
+    void printResponse(folly::StringPiece cmd,
+                       cpp2::ErrorCode res,
+                       cpp2::ExecutionResponse& resp,
+                       const time::Duration& dur);
+
     void calColumnWidths(const cpp2::ExecutionResponse& resp,
                          std::vector<size_t>& widths,
                          std::vector<std::string>& formats) const;
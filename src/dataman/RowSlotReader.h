@@ -0,0 +1,91 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef DATAMAN_ROWSLOTREADER_H_
+#define DATAMAN_ROWSLOTREADER_H_
+
+#include "base/Base.h"
+#include "dataman/RowReader.h"
+#include "filter/CompiledExpression.h"
+
+namespace nebula {
+
+/**
+ * Read the fields of a row by index, for CompiledExpression.
+ *
+ * The row could be replaced before every evaluation, without allocating.
+ */
+class RowSlotReader final : public CompiledExpression::Reader {
+public:
+    static StatusOr<CompiledExpression::Type> toSlotType(nebula::cpp2::SupportedType type) {
+        using nebula::cpp2::SupportedType;
+        switch (type) {
+            case SupportedType::BOOL:
+                return CompiledExpression::Type::BOOL;
+            case SupportedType::INT:
+            case SupportedType::VID:
+                return CompiledExpression::Type::INT;
+            case SupportedType::FLOAT:
+            case SupportedType::DOUBLE:
+                return CompiledExpression::Type::DOUBLE;
+            case SupportedType::STRING:
+                return CompiledExpression::Type::STRING;
+            default:
+                return Status::Error("Type not supported yet: %d", static_cast<int32_t>(type));
+        }
+    }
+
+    void reset(const RowReader *reader) {
+        reader_ = reader;
+    }
+
+    bool read(int32_t index, CompiledExpression::Value &value) const override {
+        if (reader_ == nullptr) {
+            return false;
+        }
+        auto &vType = reader_->getSchema()->getFieldType(index);
+        // The row may be of another version of the schema
+        auto type = toSlotType(vType.get_type());
+        if (!type.ok() || type.value() != value.type) {
+            return false;
+        }
+        ResultType ret;
+        using nebula::cpp2::SupportedType;
+        switch (vType.get_type()) {
+            case SupportedType::BOOL:
+                ret = reader_->getBool(index, value.b);
+                break;
+            case SupportedType::INT:
+                ret = reader_->getInt(index, value.i);
+                break;
+            case SupportedType::VID:
+                ret = reader_->getVid(index, value.i);
+                break;
+            case SupportedType::FLOAT: {
+                float f;
+                ret = reader_->getFloat(index, f);
+                value.d = f;
+                break;
+            }
+            case SupportedType::DOUBLE:
+                ret = reader_->getDouble(index, value.d);
+                break;
+            case SupportedType::STRING:
+                ret = reader_->getString(index, value.s);
+                break;
+            default:
+                return false;
+        }
+        return ret == ResultType::SUCCEEDED;
+    }
+
+private:
+    const RowReader                            *reader_{nullptr};
+};
+
+}  // namespace nebula
+
+#endif  // DATAMAN_ROWSLOTREADER_H_
@@ -28,11 +28,18 @@ Status AssignmentExecutor::prepare() {
         onError_(std::move(s));
     };
     auto onFinish = [this] () {
+        if (!batches_.empty()) {
+            ectx()->variableHolder()->add(*var_, InterimResult::merge(std::move(batches_)));
+        }
         DCHECK(onFinish_);
         onFinish_();
     };
     auto onResult = [this] (std::unique_ptr<InterimResult> result) {
-        ectx()->variableHolder()->add(*var_, std::move(result));
+        // Kept in the variable till the end of the query
+        if (result != nullptr) {
+            ectx()->trackResult(*result);
+        }
+        batches_.emplace_back(std::move(result));
     };
     executor_->setOnError(onError);
     executor_->setOnFinish(onFinish);
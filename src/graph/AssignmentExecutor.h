@@ -9,6 +9,7 @@
 
 #include "base/Base.h"
 #include "graph/Executor.h"
+#include "graph/InterimResult.h"
 
 namespace nebula {
 namespace graph {
@@ -30,6 +31,8 @@ private:
     AssignmentSentence                         *sentence_{nullptr};
     std::unique_ptr<TraverseExecutor>           executor_;
     const std::string                          *var_{nullptr};
+    // Batches of the results of `executor_', merged into the variable in the end
+    std::vector<std::unique_ptr<InterimResult>> batches_;
 };
 
 
@@ -6,6 +6,7 @@
 
 #include "base/Base.h"
 #include "graph/ClientSession.h"
+#include "graph/GraphFlags.h"
 
 
 namespace nebula {
@@ -13,6 +14,25 @@ namespace graph {
 
 ClientSession::ClientSession(int64_t id) {
     id_ = id;
+    auto status = setReadMode(FLAGS_storage_read_mode);
+    if (!status.ok()) {
+        LOG(WARNING) << status << ", read from the leaders";
+    }
+    status = setMaxStalenessMs(FLAGS_storage_max_staleness_ms);
+    if (!status.ok()) {
+        LOG(WARNING) << status;
+    }
+    status = setQueryTimeoutMs(FLAGS_query_timeout_ms);
+    if (!status.ok()) {
+        LOG(WARNING) << status << ", no timeout";
+    }
+    status = setQueryMemoryLimitBytes(FLAGS_query_memory_limit_bytes);
+    if (!status.ok()) {
+        LOG(WARNING) << status << ", no memory limit";
+    }
+    memory_ = std::make_shared<MemoryTracker>(folly::stringPrintf("session %ld", id),
+                                              std::max(FLAGS_session_memory_limit_bytes, 0L),
+                                              0);
 }
 
 std::shared_ptr<ClientSession> ClientSession::create(int64_t id) {
@@ -25,9 +45,80 @@ void ClientSession::charge() {
     idleDuration_.reset();
 }
 
+storage::cpp2::ReadOptions ClientSession::readOptions() const {
+    std::lock_guard<std::mutex> g(optionsLock_);
+    return readOptions_;
+}
+
 uint64_t ClientSession::idleSeconds() const {
     return idleDuration_.elapsedInSec();
 }
 
+Status ClientSession::setReadMode(const std::string &mode) {
+    auto lower = mode;
+    folly::toLowerAscii(lower);
+    std::lock_guard<std::mutex> g(optionsLock_);
+    if (lower == "leader") {
+        readOptions_.set_mode(storage::cpp2::ReadMode::LEADER);
+    } else if (lower == "read_index") {
+        readOptions_.set_mode(storage::cpp2::ReadMode::READ_INDEX);
+    } else if (lower == "bounded_staleness") {
+        readOptions_.set_mode(storage::cpp2::ReadMode::BOUNDED_STALENESS);
+    } else {
+        return Status::Error("Unknown read mode `%s'", mode.c_str());
+    }
+    return Status::OK();
+}
+
+Status ClientSession::setMaxStalenessMs(int64_t ms) {
+    if (ms <= 0 || ms > std::numeric_limits<int32_t>::max()) {
+        return Status::Error("Invalid max staleness `%ld'", ms);
+    }
+    std::lock_guard<std::mutex> g(optionsLock_);
+    readOptions_.set_max_staleness_ms(ms);
+    return Status::OK();
+}
+
+Status ClientSession::setQueryTimeoutMs(int64_t ms) {
+    if (ms < 0) {
+        return Status::Error("Invalid query timeout `%ld'", ms);
+    }
+    queryTimeoutMs_ = ms;
+    return Status::OK();
+}
+
+Status ClientSession::setQueryMemoryLimitBytes(int64_t bytes) {
+    if (bytes < 0) {
+        return Status::Error("Invalid query memory limit `%ld'", bytes);
+    }
+    queryMemoryLimitBytes_ = bytes;
+    return Status::OK();
+}
+
+StatusOr<int64_t> ClientSession::addStatement(std::string stmt) {
+    std::lock_guard<std::mutex> g(statementsLock_);
+    if (statements_.size() >= static_cast<size_t>(FLAGS_max_prepared_statements_per_session)) {
+        return Status::Error("Too many prepared statements in the session, the limit is %d",
+                             FLAGS_max_prepared_statements_per_session);
+    }
+    auto id = nextStatementId_++;
+    statements_.emplace(id, std::move(stmt));
+    return id;
+}
+
+StatusOr<std::string> ClientSession::findStatement(int64_t id) const {
+    std::lock_guard<std::mutex> g(statementsLock_);
+    auto it = statements_.find(id);
+    if (it == statements_.end()) {
+        return Status::Error("Prepared statement `%ld' not found", id);
+    }
+    return it->second;
+}
+
+void ClientSession::removeStatement(int64_t id) {
+    std::lock_guard<std::mutex> g(statementsLock_);
+    statements_.erase(id);
+}
+
 }   // namespace graph
 }   // namespace nebula
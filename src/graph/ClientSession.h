@@ -8,7 +8,11 @@
 #define GRAPH_CLIENTSESSION_H_
 
 #include "base/Base.h"
+#include "base/Status.h"
+#include "base/StatusOr.h"
 #include "time/Duration.h"
+#include "gen-cpp2/storage_types.h"
+#include "graph/MemoryTracker.h"
 
 /**
  * A ClientSession holds the context informations of a session opened by a client.
@@ -52,6 +56,52 @@ public:
 
     void charge();
 
+    // How the queries of this session read from the storage replicas.
+    // A copy, since SET SESSION could change them meanwhile
+    storage::cpp2::ReadOptions readOptions() const;
+
+    // mode is one of "leader", "read_index" and "bounded_staleness"
+    Status setReadMode(const std::string &mode);
+
+    Status setMaxStalenessMs(int64_t ms);
+
+    // Whether the queries of this session could read the vertex props cached
+    // by graphd, turned off for strong consistency
+    bool vertexCacheEnabled() const {
+        return vertexCacheEnabled_;
+    }
+
+    void setVertexCacheEnabled(bool enabled) {
+        vertexCacheEnabled_ = enabled;
+    }
+
+    // How long a query of this session could run, 0 for no limit
+    int64_t queryTimeoutMs() const {
+        return queryTimeoutMs_;
+    }
+
+    Status setQueryTimeoutMs(int64_t ms);
+
+    // How many bytes of results a query of this session could keep, 0 for no limit
+    int64_t queryMemoryLimitBytes() const {
+        return queryMemoryLimitBytes_;
+    }
+
+    Status setQueryMemoryLimitBytes(int64_t bytes);
+
+    // Charged by the running queries of this session, nullptr if not tracked
+    const std::shared_ptr<MemoryTracker>& memory() const {
+        return memory_;
+    }
+
+    // Register a prepared statement, returns its id
+    StatusOr<int64_t> addStatement(std::string stmt);
+
+    // Returns the text of the prepared statement
+    StatusOr<std::string> findStatement(int64_t id) const;
+
+    void removeStatement(int64_t id);
+
 private:
     // ClientSession could only be created via SessionManager
     friend class SessionManager;
@@ -67,6 +117,17 @@ private:
     time::Duration      idleDuration_;
     std::string         spaceName_;
     std::string         user_;
+    // Guarded by optionsLock_
+    mutable std::mutex  optionsLock_;
+    storage::cpp2::ReadOptions readOptions_;
+    bool                vertexCacheEnabled_{true};
+    int64_t             queryTimeoutMs_{0};
+    int64_t             queryMemoryLimitBytes_{0};
+    std::shared_ptr<MemoryTracker> memory_;
+    // Prepared statements, guarded by statementsLock_
+    mutable std::mutex  statementsLock_;
+    int64_t             nextStatementId_{1};
+    std::unordered_map<int64_t, std::string> statements_;
 };
 
 }   // namespace graph
@@ -0,0 +1,433 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/ColumnBatch.h"
+
+namespace nebula {
+namespace graph {
+
+using nebula::cpp2::SupportedType;
+
+StatusOr<ColumnBatch::Column::Storage>
+ColumnBatch::Column::toStorage(SupportedType type) {
+    switch (type) {
+        case SupportedType::INT:
+        case SupportedType::VID:
+        case SupportedType::TIMESTAMP:
+            return Storage::INT;
+        case SupportedType::FLOAT:
+        case SupportedType::DOUBLE:
+            return Storage::DOUBLE;
+        case SupportedType::BOOL:
+            return Storage::BOOL;
+        case SupportedType::STRING:
+            return Storage::STRING;
+        default:
+            return Status::Error("Type not supported yet: %d", static_cast<int32_t>(type));
+    }
+}
+
+
+VariantType ColumnBatch::Column::getVariant(size_t row) const {
+    switch (storage_) {
+        case Storage::INT:
+            return ints_[row];
+        case Storage::DOUBLE:
+            return doubles_[row];
+        case Storage::BOOL:
+            return bools_[row] != 0;
+        case Storage::STRING:
+            return getString(row);
+    }
+    LOG(FATAL) << "Unknown storage: " << static_cast<int32_t>(storage_);
+    return VariantType();
+}
+
+
+cpp2::ColumnValue ColumnBatch::Column::getColumnValue(size_t row) const {
+    cpp2::ColumnValue value;
+    switch (storage_) {
+        case Storage::INT:
+            value.set_integer(ints_[row]);
+            break;
+        case Storage::DOUBLE:
+            value.set_double_precision(doubles_[row]);
+            break;
+        case Storage::BOOL:
+            value.set_bool_val(bools_[row] != 0);
+            break;
+        case Storage::STRING:
+            value.set_str(getString(row));
+            break;
+    }
+    return value;
+}
+
+
+cpp2::RowValue ColumnBatch::getRow(size_t row) const {
+    std::vector<cpp2::ColumnValue> columns;
+    columns.reserve(columns_.size());
+    for (auto &column : columns_) {
+        columns.emplace_back(column.getColumnValue(row));
+    }
+    cpp2::RowValue rowValue;
+    rowValue.set_columns(std::move(columns));
+    return rowValue;
+}
+
+
+std::shared_ptr<const ColumnBatch>
+ColumnBatch::select(const std::vector<uint32_t> &rows) const {
+    auto batch = std::make_shared<ColumnBatch>();
+    batch->numRows_ = rows.size();
+    batch->columns_.reserve(columns_.size());
+    for (auto &from : columns_) {
+        batch->columns_.emplace_back();
+        auto &to = batch->columns_.back();
+        to.type_ = from.type_;
+        to.storage_ = from.storage_;
+        to.dict_ = from.dict_;
+        switch (from.storage_) {
+            case Column::Storage::INT:
+                to.ints_.reserve(rows.size());
+                for (auto row : rows) {
+                    to.ints_.emplace_back(from.ints_[row]);
+                }
+                break;
+            case Column::Storage::DOUBLE:
+                to.doubles_.reserve(rows.size());
+                for (auto row : rows) {
+                    to.doubles_.emplace_back(from.doubles_[row]);
+                }
+                break;
+            case Column::Storage::BOOL:
+                to.bools_.reserve(rows.size());
+                for (auto row : rows) {
+                    to.bools_.emplace_back(from.bools_[row]);
+                }
+                break;
+            case Column::Storage::STRING:
+                to.codes_.reserve(rows.size());
+                for (auto row : rows) {
+                    to.codes_.emplace_back(from.codes_[row]);
+                }
+                break;
+        }
+    }
+    return batch;
+}
+
+
+std::shared_ptr<const ColumnBatch> ColumnBatch::slice(size_t offset, size_t count) const {
+    std::vector<uint32_t> rows;
+    if (offset < numRows_) {
+        auto end = std::min(numRows_, offset + std::min(count, numRows_));
+        rows.reserve(end - offset);
+        for (auto row = offset; row < end; row++) {
+            rows.emplace_back(row);
+        }
+    }
+    return select(rows);
+}
+
+
+size_t ColumnBatch::memoryBytes() const {
+    auto bytes = columnBytes();
+    for (auto &dict : dictionaries()) {
+        bytes += dict->memoryBytes();
+    }
+    return bytes;
+}
+
+
+size_t ColumnBatch::columnBytes() const {
+    auto bytes = sizeof(ColumnBatch);
+    for (auto &column : columns_) {
+        bytes += sizeof(Column);
+        bytes += column.ints_.capacity() * sizeof(int64_t);
+        bytes += column.doubles_.capacity() * sizeof(double);
+        bytes += column.bools_.capacity() * sizeof(uint8_t);
+        bytes += column.codes_.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+
+std::vector<std::shared_ptr<const ColumnBatch::Dictionary>> ColumnBatch::dictionaries() const {
+    std::vector<std::shared_ptr<const Dictionary>> dicts;
+    for (auto &column : columns_) {
+        if (column.dict_ != nullptr) {
+            dicts.emplace_back(column.dict_);
+        }
+    }
+    return dicts;
+}
+
+
+ColumnBatch::Builder::Builder(std::shared_ptr<const meta::SchemaProviderIf> schema) {
+    batch_ = std::make_shared<ColumnBatch>();
+    auto numFields = schema->getNumFields();
+    batch_->columns_.resize(numFields);
+    dicts_.resize(numFields);
+    codes_.resize(numFields);
+    for (auto i = 0UL; i < numFields; i++) {
+        auto &column = batch_->columns_[i];
+        column.type_ = schema->getFieldType(i).get_type();
+        auto storage = Column::toStorage(column.type_);
+        if (!storage.ok()) {
+            // Stored as integers, so that the other columns are still usable
+            LOG(ERROR) << storage.status();
+            if (status_.ok()) {
+                status_ = storage.status();
+            }
+            continue;
+        }
+        column.storage_ = storage.value();
+        if (column.storage_ == Column::Storage::STRING) {
+            dicts_[i] = std::make_shared<Dictionary>();
+            column.dict_ = dicts_[i];
+        }
+    }
+}
+
+
+void ColumnBatch::Builder::append(const RowReader &row) {
+    auto &columns = batch_->columns_;
+    for (auto i = 0UL; i < columns.size(); i++) {
+        auto ret = ResultType::E_DATA_INVALID;
+        switch (columns[i].type_) {
+            case SupportedType::INT: {
+                int64_t v;
+                ret = row.getInt(i, v);
+                if (ret == ResultType::SUCCEEDED) {
+                    appendInt(i, v);
+                }
+                break;
+            }
+            case SupportedType::VID: {
+                int64_t v;
+                ret = row.getVid(i, v);
+                if (ret == ResultType::SUCCEEDED) {
+                    appendInt(i, v);
+                }
+                break;
+            }
+            case SupportedType::TIMESTAMP: {
+                int64_t v;
+                ret = row.getTimestamp(i, v);
+                if (ret == ResultType::SUCCEEDED) {
+                    appendInt(i, v);
+                }
+                break;
+            }
+            case SupportedType::FLOAT: {
+                float v;
+                ret = row.getFloat(i, v);
+                if (ret == ResultType::SUCCEEDED) {
+                    appendDouble(i, v);
+                }
+                break;
+            }
+            case SupportedType::DOUBLE: {
+                double v;
+                ret = row.getDouble(i, v);
+                if (ret == ResultType::SUCCEEDED) {
+                    appendDouble(i, v);
+                }
+                break;
+            }
+            case SupportedType::BOOL: {
+                bool v;
+                ret = row.getBool(i, v);
+                if (ret == ResultType::SUCCEEDED) {
+                    appendBool(i, v);
+                }
+                break;
+            }
+            case SupportedType::STRING: {
+                folly::StringPiece v;
+                ret = row.getString(i, v);
+                if (ret == ResultType::SUCCEEDED) {
+                    appendString(i, v);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        if (ret != ResultType::SUCCEEDED) {
+            LOG(ERROR) << "Failed to decode column " << i << ": " << static_cast<int32_t>(ret);
+            appendDefault(i);
+        }
+    }
+    batch_->numRows_++;
+}
+
+
+void ColumnBatch::Builder::append(const std::vector<cpp2::ColumnValue> &row) {
+    auto &columns = batch_->columns_;
+    DCHECK_EQ(columns.size(), row.size());
+    for (auto i = 0UL; i < columns.size(); i++) {
+        auto &value = row[i];
+        switch (value.getType()) {
+            case cpp2::ColumnValue::Type::integer:
+                appendInt(i, value.get_integer());
+                break;
+            case cpp2::ColumnValue::Type::double_precision:
+                appendDouble(i, value.get_double_precision());
+                break;
+            case cpp2::ColumnValue::Type::bool_val:
+                appendBool(i, value.get_bool_val());
+                break;
+            case cpp2::ColumnValue::Type::str:
+                appendString(i, value.get_str());
+                break;
+            default:
+                LOG(ERROR) << "Type not supported yet: " << static_cast<int32_t>(value.getType());
+                if (status_.ok()) {
+                    status_ = Status::Error("Type not supported yet");
+                }
+                appendDefault(i);
+                break;
+        }
+    }
+    batch_->numRows_++;
+}
+
+
+void ColumnBatch::Builder::append(const std::vector<VariantType> &row) {
+    auto &columns = batch_->columns_;
+    DCHECK_EQ(columns.size(), row.size());
+    for (auto i = 0UL; i < columns.size(); i++) {
+        auto &value = row[i];
+        switch (value.which()) {
+            case VAR_INT64:
+                appendInt(i, boost::get<int64_t>(value));
+                break;
+            case VAR_DOUBLE:
+                appendDouble(i, boost::get<double>(value));
+                break;
+            case VAR_BOOL:
+                appendBool(i, boost::get<bool>(value));
+                break;
+            case VAR_STR:
+                appendString(i, boost::get<std::string>(value));
+                break;
+            default:
+                LOG(FATAL) << "Unknown VariantType: " << value.which();
+        }
+    }
+    batch_->numRows_++;
+}
+
+
+void ColumnBatch::Builder::append(const ColumnBatch &batch, size_t row) {
+    auto &columns = batch_->columns_;
+    DCHECK_EQ(columns.size(), batch.numColumns());
+    for (auto i = 0UL; i < columns.size(); i++) {
+        auto &from = batch.columns_[i];
+        switch (from.storage_) {
+            case Column::Storage::INT:
+                appendInt(i, from.getInt(row));
+                break;
+            case Column::Storage::DOUBLE:
+                appendDouble(i, from.getDouble(row));
+                break;
+            case Column::Storage::BOOL:
+                appendBool(i, from.getBool(row));
+                break;
+            case Column::Storage::STRING:
+                appendString(i, from.getString(row));
+                break;
+        }
+    }
+    batch_->numRows_++;
+}
+
+
+std::shared_ptr<const ColumnBatch> ColumnBatch::Builder::finish() {
+    codes_.clear();
+    dicts_.clear();
+    return std::move(batch_);
+}
+
+
+void ColumnBatch::Builder::appendInt(size_t col, int64_t value) {
+    auto &column = batch_->columns_[col];
+    if (column.storage_ != Column::Storage::INT) {
+        LOG(ERROR) << "Incompatible value type \"int\"";
+        appendDefault(col);
+        return;
+    }
+    column.ints_.emplace_back(value);
+}
+
+
+void ColumnBatch::Builder::appendDouble(size_t col, double value) {
+    auto &column = batch_->columns_[col];
+    if (column.storage_ != Column::Storage::DOUBLE) {
+        LOG(ERROR) << "Incompatible value type \"double\"";
+        appendDefault(col);
+        return;
+    }
+    column.doubles_.emplace_back(value);
+}
+
+
+void ColumnBatch::Builder::appendBool(size_t col, bool value) {
+    auto &column = batch_->columns_[col];
+    if (column.storage_ != Column::Storage::BOOL) {
+        LOG(ERROR) << "Incompatible value type \"bool\"";
+        appendDefault(col);
+        return;
+    }
+    column.bools_.emplace_back(value);
+}
+
+
+void ColumnBatch::Builder::appendString(size_t col, folly::StringPiece value) {
+    auto &column = batch_->columns_[col];
+    if (column.storage_ != Column::Storage::STRING) {
+        LOG(ERROR) << "Incompatible value type \"string\"";
+        appendDefault(col);
+        return;
+    }
+    auto &codes = codes_[col];
+    auto iter = codes.find(value);
+    if (iter != codes.end()) {
+        column.codes_.emplace_back(iter->second);
+        return;
+    }
+    auto &dict = *dicts_[col];
+    auto code = static_cast<uint32_t>(dict.size());
+    dict.strings_.emplace_back(value.str());
+    dict.bytes_ += sizeof(std::string) + value.size();
+    codes.emplace(folly::StringPiece(dict.strings_.back()), code);
+    column.codes_.emplace_back(code);
+}
+
+
+void ColumnBatch::Builder::appendDefault(size_t col) {
+    auto &column = batch_->columns_[col];
+    switch (column.storage_) {
+        case Column::Storage::INT:
+            column.ints_.emplace_back(0);
+            break;
+        case Column::Storage::DOUBLE:
+            column.doubles_.emplace_back(0.0);
+            break;
+        case Column::Storage::BOOL:
+            column.bools_.emplace_back(0);
+            break;
+        case Column::Storage::STRING:
+            appendString(col, "");
+            break;
+    }
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -0,0 +1,200 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_COLUMNBATCH_H_
+#define GRAPH_COLUMNBATCH_H_
+
+#include "base/Base.h"
+#include "base/StatusOr.h"
+#include "base/MurmurHash2.h"
+#include "gen-cpp2/GraphService.h"
+#include "meta/SchemaProviderIf.h"
+#include "dataman/RowReader.h"
+
+namespace nebula {
+namespace graph {
+
+/**
+ * Rows stored column by column, each column being a vector of its own type.
+ *
+ * The strings are dictionary encoded, and the dictionaries are shared between
+ * the batches derived from one another, e.g. by LIMIT or ORDER BY, so deriving
+ * a batch copies neither the strings nor the untouched columns.
+ *
+ * A batch is immutable once built, and is supposed to be held by shared_ptr.
+ */
+class ColumnBatch final {
+public:
+    class Builder;
+
+    /**
+     * The distinct strings of a column, which might be shared by several batches.
+     *
+     * Its bytes are counted as the strings are added, so that it could be charged
+     * once for all the batches holding it, without walking it.
+     */
+    class Dictionary final {
+    public:
+        const std::string& operator[](size_t code) const {
+            return strings_[code];
+        }
+
+        size_t size() const {
+            return strings_.size();
+        }
+
+        size_t memoryBytes() const {
+            return bytes_;
+        }
+
+    private:
+        friend class Builder;
+        // The deque never moves its elements, so the pieces pointing to them stay valid
+        std::deque<std::string>                     strings_;
+        size_t                                      bytes_{sizeof(Dictionary)};
+    };
+
+    class Column final {
+    public:
+        nebula::cpp2::SupportedType type() const {
+            return type_;
+        }
+
+        // Integers are for INT, VID and TIMESTAMP, and doubles for FLOAT and DOUBLE
+        int64_t getInt(size_t row) const {
+            return ints_[row];
+        }
+
+        double getDouble(size_t row) const {
+            return doubles_[row];
+        }
+
+        bool getBool(size_t row) const {
+            return bools_[row] != 0;
+        }
+
+        const std::string& getString(size_t row) const {
+            return (*dict_)[codes_[row]];
+        }
+
+        // The code of the string, equal codes for equal strings within a column
+        uint32_t getCode(size_t row) const {
+            return codes_[row];
+        }
+
+        const std::vector<int64_t>& ints() const {
+            return ints_;
+        }
+
+        VariantType getVariant(size_t row) const;
+
+        cpp2::ColumnValue getColumnValue(size_t row) const;
+
+    private:
+        friend class ColumnBatch;
+        friend class Builder;
+
+        enum class Storage : uint8_t {
+            INT, DOUBLE, BOOL, STRING,
+        };
+
+        static StatusOr<Storage> toStorage(nebula::cpp2::SupportedType type);
+
+        nebula::cpp2::SupportedType                 type_{nebula::cpp2::SupportedType::UNKNOWN};
+        Storage                                     storage_{Storage::INT};
+        // Only the vector of `storage_' is used
+        std::vector<int64_t>                        ints_;
+        std::vector<double>                         doubles_;
+        std::vector<uint8_t>                        bools_;
+        std::vector<uint32_t>                       codes_;
+        std::shared_ptr<const Dictionary>           dict_;
+    };
+
+    /**
+     * Build a batch row by row, with the columns typed by `schema'.
+     *
+     * A value of another type is converted the way RowWriter does, i.e. an error
+     * is logged and the default value of the column is appended instead.
+     */
+    class Builder final {
+    public:
+        explicit Builder(std::shared_ptr<const meta::SchemaProviderIf> schema);
+
+        // Whether every field of the schema, and every value appended, could be stored
+        const Status& status() const {
+            return status_;
+        }
+
+        void append(const RowReader &row);
+
+        void append(const std::vector<cpp2::ColumnValue> &row);
+
+        void append(const std::vector<VariantType> &row);
+
+        // Row `row' of `batch', whose columns are in the same order
+        void append(const ColumnBatch &batch, size_t row);
+
+        std::shared_ptr<const ColumnBatch> finish();
+
+    private:
+        struct PieceHash {
+            size_t operator()(folly::StringPiece piece) const {
+                return MurmurHash2()(piece.data(), piece.size());
+            }
+        };
+
+        void appendInt(size_t col, int64_t value);
+        void appendDouble(size_t col, double value);
+        void appendBool(size_t col, bool value);
+        void appendString(size_t col, folly::StringPiece value);
+        void appendDefault(size_t col);
+
+    private:
+        Status                                      status_;
+        std::shared_ptr<ColumnBatch>                batch_;
+        // Dictionaries being built, one for each string column
+        std::vector<std::shared_ptr<Dictionary>>    dicts_;
+        std::vector<std::unordered_map<folly::StringPiece, uint32_t, PieceHash>> codes_;
+    };
+
+    size_t numRows() const {
+        return numRows_;
+    }
+
+    size_t numColumns() const {
+        return columns_.size();
+    }
+
+    const Column& column(size_t col) const {
+        return columns_[col];
+    }
+
+    cpp2::RowValue getRow(size_t row) const;
+
+    // A batch of the rows at `rows' of this one, in that order
+    std::shared_ptr<const ColumnBatch> select(const std::vector<uint32_t> &rows) const;
+
+    // At most `count' rows from `offset'
+    std::shared_ptr<const ColumnBatch> slice(size_t offset, size_t count) const;
+
+    // A rough estimation of the memory taken, the dictionaries included
+    size_t memoryBytes() const;
+
+    // The same without the dictionaries, which might be shared with other batches
+    size_t columnBytes() const;
+
+    // The dictionaries of the string columns
+    std::vector<std::shared_ptr<const Dictionary>> dictionaries() const;
+
+private:
+    size_t                                          numRows_{0};
+    std::vector<Column>                             columns_;
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_COLUMNBATCH_H_
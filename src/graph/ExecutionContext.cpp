@@ -6,6 +6,7 @@
 
 #include "base/Base.h"
 #include "graph/ExecutionContext.h"
+#include "graph/InterimResult.h"
 
 namespace nebula {
 namespace graph {
@@ -28,5 +29,76 @@ ExecutionContext::~ExecutionContext() {
     }
 }
 
+
+storage::cpp2::ReadOptions ExecutionContext::readOptions() const {
+    auto options = rctx_->session()->readOptions();
+    if (query_ != nullptr) {
+        options.set_timeout_ms(query_->timeLeftMs());
+        options.set_query_token(query_->token());
+    }
+    return options;
+}
+
+
+Status ExecutionContext::trackMemory(int64_t bytes) {
+    if (query_ == nullptr) {
+        return Status::OK();
+    }
+    auto status = query_->memory()->consume(bytes);
+    if (!status.ok()) {
+        query_->abort(status);
+    }
+    return status;
+}
+
+
+void ExecutionContext::untrackMemory(int64_t bytes) {
+    if (query_ != nullptr) {
+        query_->memory()->release(bytes);
+    }
+}
+
+
+Status ExecutionContext::trackResult(InterimResult &result) {
+    if (query_ == nullptr) {
+        return Status::OK();
+    }
+    auto bytes = static_cast<int64_t>(result.columnBytes());
+    auto status = trackMemory(bytes);
+    if (!status.ok()) {
+        return status;
+    }
+    std::vector<std::shared_ptr<const MemoryCharge>> charges;
+    charges.emplace_back(std::make_shared<MemoryCharge>(query_->memory(), bytes));
+    if (result.batch() != nullptr) {
+        std::lock_guard<std::mutex> g(dictChargesLock_);
+        for (auto &dict : result.batch()->dictionaries()) {
+            // The charge is shared by the results holding the dictionary, and
+            // released along with the last of them
+            auto iter = dictCharges_.find(dict.get());
+            if (iter != dictCharges_.end() && !iter->second.dict.expired()) {
+                auto charge = iter->second.charge.lock();
+                if (charge != nullptr) {
+                    charges.emplace_back(std::move(charge));
+                    continue;
+                }
+            }
+            auto dictBytes = static_cast<int64_t>(dict->memoryBytes());
+            status = trackMemory(dictBytes);
+            if (!status.ok()) {
+                // The charges made so far are released along with `charges'
+                return status;
+            }
+            auto charge = std::make_shared<MemoryCharge>(query_->memory(), dictBytes);
+            dictCharges_[dict.get()] = DictionaryCharge{dict, charge};
+            charges.emplace_back(std::move(charge));
+        }
+    }
+    for (auto &charge : charges) {
+        result.addCharge(std::move(charge));
+    }
+    return Status::OK();
+}
+
 }   // namespace graph
 }   // namespace nebula
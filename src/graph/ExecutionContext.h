@@ -15,6 +15,10 @@
 #include "meta/ClientBasedGflagsManager.h"
 #include "graph/VariableHolder.h"
 #include "meta/client/MetaClient.h"
+#include "graph/VertexCache.h"
+#include "graph/SpaceStatsCache.h"
+#include "graph/QueryManager.h"
+#include "graph/ColumnBatch.h"
 
 /**
  * ExecutionContext holds context infos in the execution process, e.g. clients of storage or meta services.
@@ -26,6 +30,8 @@ class StorageClient;
 }   // namespace storage
 namespace graph {
 
+class InterimResult;
+
 class ExecutionContext final : public cpp::NonCopyable, public cpp::NonMovable {
 public:
     using RequestContextPtr = std::unique_ptr<RequestContext<cpp2::ExecutionResponse>>;
@@ -33,12 +39,18 @@ public:
                      meta::SchemaManager *sm,
                      meta::ClientBasedGflagsManager *gflagsManager,
                      storage::StorageClient *storage,
-                     meta::MetaClient *metaClient) {
+                     meta::MetaClient *metaClient,
+                     VertexCache *vertexCache = nullptr,
+                     SpaceStatsCache *spaceStats = nullptr,
+                     QueryManager *queries = nullptr) {
         rctx_ = std::move(rctx);
         sm_ = sm;
         gflagsManager_ = gflagsManager;
         storage_ = storage;
         metaClient_ = metaClient;
+        vertexCache_ = vertexCache;
+        spaceStats_ = spaceStats;
+        queries_ = queries;
         variableHolder_ = std::make_unique<VariableHolder>();
     }
 
@@ -68,13 +80,75 @@ public:
         return metaClient_;
     }
 
+    // nullptr if the vertex props are not cached
+    VertexCache* vertexCache() const {
+        return vertexCache_;
+    }
+
+    // nullptr if the queries are planned without the stats
+    SpaceStatsCache* spaceStats() const {
+        return spaceStats_;
+    }
+
+    // nullptr if the queries are not tracked
+    QueryManager* queries() const {
+        return queries_;
+    }
+
+    void setQuery(std::shared_ptr<RunningQuery> query) {
+        query_ = std::move(query);
+    }
+
+    // nullptr if the query is not tracked
+    RunningQuery* query() const {
+        return query_.get();
+    }
+
+    // OK unless the query has been killed or has timed out, checked between the steps
+    Status checkCancelled() const {
+        return query_ == nullptr ? Status::OK() : query_->check();
+    }
+
+    // The read options of the session, with the time left and the token of the query
+    storage::cpp2::ReadOptions readOptions() const;
+
+    // nullptr if the query is not tracked
+    MemoryTracker* memory() const {
+        return query_ == nullptr ? nullptr : query_->memory().get();
+    }
+
+    /**
+     * Charge the `bytes' of the results kept by the query. Beyond the hard limits,
+     * nothing is charged and the query is aborted, to fail at its next check.
+     */
+    Status trackMemory(int64_t bytes);
+
+    void untrackMemory(int64_t bytes);
+
+    /**
+     * Charge the bytes of `result' till it is dropped, along with the results derived from it.
+     * A dictionary shared by several results is charged only once, by the first of them.
+     */
+    Status trackResult(InterimResult &result);
+
 private:
     RequestContextPtr                           rctx_;
     meta::SchemaManager                        *sm_{nullptr};
     meta::ClientBasedGflagsManager             *gflagsManager_{nullptr};
     storage::StorageClient                     *storage_{nullptr};
     meta::MetaClient                           *metaClient_{nullptr};
+    VertexCache                                *vertexCache_{nullptr};
+    SpaceStatsCache                            *spaceStats_{nullptr};
+    QueryManager                               *queries_{nullptr};
+    std::shared_ptr<RunningQuery>               query_;
     std::unique_ptr<VariableHolder>             variableHolder_;
+    struct DictionaryCharge {
+        // To tell whether the address has been taken by another dictionary
+        std::weak_ptr<const ColumnBatch::Dictionary>    dict;
+        std::weak_ptr<const MemoryCharge>               charge;
+    };
+    std::mutex                                  dictChargesLock_;
+    std::unordered_map<const ColumnBatch::Dictionary*, DictionaryCharge> dictCharges_;
 };
 
 }   // namespace graph
@@ -8,9 +8,16 @@
 #include "graph/ExecutionEngine.h"
 #include "graph/ExecutionContext.h"
 #include "graph/ExecutionPlan.h"
+#include "parser/GQLParser.h"
 #include "storage/client/StorageClient.h"
 
 DECLARE_string(meta_server_addrs);
+DECLARE_int32(plan_cache_capacity);
+DECLARE_int64(vertex_cache_capacity_bytes);
+DECLARE_int32(vertex_cache_ttl_ms);
+DECLARE_int32(space_stats_ttl_secs);
+DECLARE_int32(space_stats_timeout_ms);
+DECLARE_int32(space_stats_retry_secs);
 
 namespace nebula {
 namespace graph {
@@ -43,6 +50,20 @@ Status ExecutionEngine::init(std::shared_ptr<folly::IOThreadPoolExecutor> ioExec
     gflagsManager_->init();
 
     storage_ = std::make_unique<storage::StorageClient>(ioExecutor, metaClient_.get());
+
+    if (FLAGS_plan_cache_capacity > 0) {
+        planCache_ = std::make_unique<PlanCache>(FLAGS_plan_cache_capacity);
+    }
+    if (FLAGS_vertex_cache_capacity_bytes > 0) {
+        vertexCache_ = std::make_unique<VertexCache>(FLAGS_vertex_cache_capacity_bytes,
+                                                     FLAGS_vertex_cache_ttl_ms);
+    }
+    if (FLAGS_space_stats_ttl_secs > 0) {
+        spaceStats_ = std::make_unique<SpaceStatsCache>(FLAGS_space_stats_ttl_secs,
+                                                        FLAGS_space_stats_timeout_ms,
+                                                        FLAGS_space_stats_retry_secs);
+    }
+    queries_ = std::make_unique<QueryManager>();
     return Status::OK();
 }
 
@@ -51,12 +72,54 @@ void ExecutionEngine::execute(RequestContextPtr rctx) {
                                                    schemaManager_.get(),
                                                    gflagsManager_.get(),
                                                    storage_.get(),
-                                                   metaClient_.get());
-    // TODO(dutor) add support to plan cache
-    auto plan = new ExecutionPlan(std::move(ectx));
+                                                   metaClient_.get(),
+                                                   vertexCache_.get(),
+                                                   spaceStats_.get(),
+                                                   queries_.get());
+    auto plan = new ExecutionPlan(std::move(ectx), planCache_.get());
 
     plan->execute();
 }
 
+
+void ExecutionEngine::prepare(PrepareContextPtr rctx) {
+    auto &resp = rctx->resp();
+    auto *session = rctx->session();
+    do {
+        auto result = GQLParser().parse(rctx->query());
+        if (!result.ok()) {
+            auto status = std::move(result).status();
+            if (status.isSyntaxError()) {
+                resp.set_error_code(cpp2::ErrorCode::E_SYNTAX_ERROR);
+            } else {
+                resp.set_error_code(cpp2::ErrorCode::E_STATEMENT_EMTPY);
+            }
+            resp.set_error_msg(status.toString());
+            break;
+        }
+        auto sentences = std::move(result).value();
+
+        auto id = session->addStatement(rctx->query());
+        if (!id.ok()) {
+            resp.set_error_code(cpp2::ErrorCode::E_EXECUTION_ERROR);
+            resp.set_error_msg(id.status().toString());
+            break;
+        }
+        resp.set_error_code(cpp2::ErrorCode::SUCCEEDED);
+        resp.set_statement_id(id.value());
+        resp.set_num_parameters(sentences->numParameters());
+
+        if (planCache_ != nullptr) {
+            planCache_->put(session->space(),
+                            rctx->query(),
+                            metaClient_->schemaVersion(),
+                            std::move(sentences));
+        }
+    } while (false);
+
+    resp.set_latency_in_us(rctx->duration().elapsedInUSec());
+    rctx->finish();
+}
+
 }   // namespace graph
 }   // namespace nebula
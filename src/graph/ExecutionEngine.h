@@ -10,6 +10,10 @@
 #include "base/Base.h"
 #include "cpp/helpers.h"
 #include "graph/RequestContext.h"
+#include "graph/PlanCache.h"
+#include "graph/VertexCache.h"
+#include "graph/SpaceStatsCache.h"
+#include "graph/QueryManager.h"
 #include "gen-cpp2/GraphService.h"
 #include "meta/SchemaManager.h"
 #include "meta/ClientBasedGflagsManager.h"
@@ -19,8 +23,10 @@
 
 /**
  * ExecutionEngine is responsible to create and manage ExecutionPlan.
- * For the time being, we don't have the execution plan cache support,
- * instead we create a plan for each query, and destroy it upon finish.
+ * A plan is created for each query, and destroyed upon finish. The parsed
+ * sentences of recent queries are kept in the PlanCache, the vertex props
+ * recently read in the VertexCache, and the stats of the spaces in the SpaceStatsCache.
+ * The plans running are tracked by the QueryManager, to be timed out or killed.
  */
 
 namespace nebula {
@@ -40,11 +46,23 @@ public:
     using RequestContextPtr = std::unique_ptr<RequestContext<cpp2::ExecutionResponse>>;
     void execute(RequestContextPtr rctx);
 
+    /**
+     * Parse the statement and register it in the session.
+     * The parsed sentences are kept in the plan cache, so the executions
+     * of the prepared statement could skip the parser.
+     */
+    using PrepareContextPtr = std::unique_ptr<RequestContext<cpp2::PrepareResponse>>;
+    void prepare(PrepareContextPtr rctx);
+
 private:
     std::unique_ptr<meta::SchemaManager>              schemaManager_;
     std::unique_ptr<meta::ClientBasedGflagsManager>   gflagsManager_;
     std::unique_ptr<storage::StorageClient>           storage_;
     std::unique_ptr<meta::MetaClient>                 metaClient_;
+    std::unique_ptr<PlanCache>                        planCache_;
+    std::unique_ptr<VertexCache>                      vertexCache_;
+    std::unique_ptr<SpaceStatsCache>                  spaceStats_;
+    std::unique_ptr<QueryManager>                     queries_;
 };
 
 }   // namespace graph
@@ -12,22 +12,47 @@ namespace graph {
 
 void ExecutionPlan::execute() {
     auto *rctx = ectx()->rctx();
-    FLOG_INFO("Parsing query: %s", rctx->query().c_str());
+    space_ = rctx->session()->space();
+    if (planCache_ != nullptr) {
+        schemaVersion_ = ectx()->getMetaClient()->schemaVersion();
+        sentences_ = planCache_->get(space_, rctx->query(), schemaVersion_);
+    }
 
     Status status;
     do {
-        auto result = GQLParser().parse(rctx->query());
-        if (!result.ok()) {
-            status = std::move(result).status();
+        if (sentences_ == nullptr) {
+            FLOG_INFO("Parsing query: %s", rctx->query().c_str());
+            auto result = GQLParser().parse(rctx->query());
+            if (!result.ok()) {
+                status = std::move(result).status();
+                break;
+            }
+            sentences_ = std::move(result).value();
+        }
+
+        // The values of the placeholders, if it is a prepared statement
+        status = sentences_->bindParameters(rctx->parameters());
+        if (!status.ok()) {
             break;
         }
 
-        sentences_ = std::move(result).value();
+        // Tracked before the executors are prepared, some of which take its memory tracker
+        auto *queries = ectx()->queries();
+        if (queries != nullptr) {
+            // The timeout given ahead of the sentences overrides the session's
+            auto timeoutMs = sentences_->timeoutMs();
+            if (timeoutMs == 0) {
+                timeoutMs = rctx->session()->queryTimeoutMs();
+            }
+            ectx()->setQuery(queries->add(rctx->session(), rctx->query(), timeoutMs));
+        }
+
         executor_ = std::make_unique<SequentialExecutor>(sentences_.get(), ectx());
         status = executor_->prepare();
         if (!status.ok()) {
             break;
         }
+        cacheable_ = true;
     } while (false);
 
     // Prepare failed
@@ -51,12 +76,20 @@ void ExecutionPlan::execute() {
 
 
 void ExecutionPlan::onFinish() {
+    // Killed or aborted after the last check of the executors
+    auto status = ectx()->checkCancelled();
+    if (!status.ok()) {
+        onError(std::move(status));
+        return;
+    }
     auto *rctx = ectx()->rctx();
     executor_->setupResponse(rctx->resp());
     auto latency = rctx->duration().elapsedInUSec();
     rctx->resp().set_latency_in_us(latency);
     auto &spaceName = rctx->session()->spaceName();
     rctx->resp().set_space_name(spaceName);
+    releaseSentences();
+    untrack();
     rctx->finish();
 
     // The `ExecutionPlan' is the root node holding all resources during the execution.
@@ -79,9 +112,32 @@ void ExecutionPlan::onError(Status status) {
     rctx->resp().set_error_msg(status.toString());
     auto latency = rctx->duration().elapsedInUSec();
     rctx->resp().set_latency_in_us(latency);
+    releaseSentences();
+    untrack();
     rctx->finish();
     delete this;
 }
 
+
+void ExecutionPlan::untrack() {
+    auto *query = ectx()->query();
+    if (query != nullptr) {
+        ectx()->rctx()->resp().set_peak_memory_bytes(query->memory()->peak());
+        ectx()->queries()->remove(query->id());
+    }
+}
+
+
+void ExecutionPlan::releaseSentences() {
+    if (planCache_ == nullptr || !cacheable_) {
+        return;
+    }
+    // The executors refer to the sentences
+    executor_.reset();
+    // The values bound are of this execution only
+    sentences_->unbindParameters();
+    planCache_->put(space_, ectx()->rctx()->query(), schemaVersion_, std::move(sentences_));
+}
+
 }   // namespace graph
 }   // namespace nebula
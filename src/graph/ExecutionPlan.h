@@ -13,6 +13,7 @@
 #include "parser/GQLParser.h"
 #include "graph/ExecutionContext.h"
 #include "graph/SequentialExecutor.h"
+#include "graph/PlanCache.h"
 
 /**
  * ExecutionPlan coordinates the execution process,
@@ -25,8 +26,10 @@ namespace graph {
 
 class ExecutionPlan final : public cpp::NonCopyable, public cpp::NonMovable {
 public:
-    explicit ExecutionPlan(std::unique_ptr<ExecutionContext> ectx) {
+    explicit ExecutionPlan(std::unique_ptr<ExecutionContext> ectx,
+                           PlanCache *planCache = nullptr) {
         ectx_ = std::move(ectx);
+        planCache_ = planCache;
     }
 
     ~ExecutionPlan() = default;
@@ -51,6 +54,20 @@ public:
     }
 
 private:
+    /**
+     * Give the parsed sentences back to the plan cache once they are not
+     * used by the executors any more.
+     */
+    void releaseSentences();
+
+    // Remove the query from the QueryManager once it is done, reporting its peak memory
+    void untrack();
+
+private:
+    PlanCache                                  *planCache_{nullptr};
+    GraphSpaceID                                space_{-1};
+    int64_t                                     schemaVersion_{0};
+    bool                                        cacheable_{false};
     std::unique_ptr<SequentialSentences>        sentences_;
     std::unique_ptr<ExecutionContext>           ectx_;
     std::unique_ptr<SequentialExecutor>         executor_;
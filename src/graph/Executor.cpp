@@ -33,6 +33,8 @@
 #include "graph/YieldExecutor.h"
 #include "graph/DownloadExecutor.h"
 #include "graph/OrderByExecutor.h"
+#include "graph/LimitExecutor.h"
+#include "graph/GroupByExecutor.h"
 #include "graph/IngestExecutor.h"
 #include "graph/ConfigExecutor.h"
 #include "graph/FetchVerticesExecutor.h"
@@ -40,7 +42,11 @@
 #include "graph/ConfigExecutor.h"
 #include "graph/SetExecutor.h"
 #include "graph/FindExecutor.h"
+#include "graph/FindPathExecutor.h"
 #include "graph/MatchExecutor.h"
+#include "graph/SetSessionExecutor.h"
+#include "graph/KillQueryExecutor.h"
+#include "storage/client/StorageClient.h"
 
 namespace nebula {
 namespace graph {
@@ -118,6 +124,12 @@ std::unique_ptr<Executor> Executor::makeExecutor(Sentence *sentence) {
         case Sentence::Kind::kOrderBy:
             executor = std::make_unique<OrderByExecutor>(sentence, ectx());
             break;
+        case Sentence::Kind::kLimit:
+            executor = std::make_unique<LimitExecutor>(sentence, ectx());
+            break;
+        case Sentence::Kind::kGroupBy:
+            executor = std::make_unique<GroupByExecutor>(sentence, ectx());
+            break;
         case Sentence::Kind::kIngest:
             executor = std::make_unique<IngestExecutor>(sentence, ectx());
             break;
@@ -139,6 +151,15 @@ std::unique_ptr<Executor> Executor::makeExecutor(Sentence *sentence) {
         case Sentence::Kind::kFind:
             executor = std::make_unique<FindExecutor>(sentence, ectx());
             break;
+        case Sentence::Kind::kFindPath:
+            executor = std::make_unique<FindPathExecutor>(sentence, ectx());
+            break;
+        case Sentence::Kind::kSetSession:
+            executor = std::make_unique<SetSessionExecutor>(sentence, ectx());
+            break;
+        case Sentence::Kind::kKillQuery:
+            executor = std::make_unique<KillQueryExecutor>(sentence, ectx());
+            break;
         case Sentence::Kind::kUnknown:
             LOG(FATAL) << "Sentence kind unknown";
             break;
@@ -218,5 +239,40 @@ Status Executor::checkFieldName(std::shared_ptr<const meta::SchemaProviderIf> sc
     return Status::OK();
 }
 
+
+folly::Future<storage::StorageRpcResponse<storage::cpp2::QueryResponse>>
+Executor::getVertexProps(GraphSpaceID space,
+                         std::vector<VertexID> vertices,
+                         std::vector<storage::cpp2::PropDef> returnCols) {
+    auto *session = ectx()->rctx()->session();
+    auto *runner = ectx()->rctx()->runner();
+    auto *cache = ectx()->vertexCache();
+    if (cache != nullptr && session->vertexCacheEnabled()) {
+        return cache->getVertexProps(ectx()->storage(),
+                                     runner,
+                                     space,
+                                     std::move(vertices),
+                                     std::move(returnCols),
+                                     ectx()->readOptions(),
+                                     ectx()->getMetaClient()->schemaVersion());
+    }
+    return ectx()->storage()->getVertexProps(space,
+                                             std::move(vertices),
+                                             std::move(returnCols),
+                                             ectx()->readOptions()).via(runner);
+}
+
+
+// static
+size_t Executor::estimateSize(const storage::cpp2::QueryResponse &resp) {
+    auto bytes = sizeof(resp);
+    if (resp.get_vertices() != nullptr) {
+        for (auto &vdata : *resp.get_vertices()) {
+            bytes += sizeof(vdata) + vdata.vertex_data.size() + vdata.edge_data.size();
+        }
+    }
+    return bytes;
+}
+
 }   // namespace graph
 }   // namespace nebula
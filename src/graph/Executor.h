@@ -86,6 +86,16 @@ protected:
     Status checkFieldName(std::shared_ptr<const meta::SchemaProviderIf> schema,
                           std::vector<std::string*> props);
 
+    // Read the vertex props through the vertex cache, unless the cache is
+    // disabled for graphd or for the session
+    folly::Future<storage::StorageRpcResponse<storage::cpp2::QueryResponse>> getVertexProps(
+        GraphSpaceID space,
+        std::vector<VertexID> vertices,
+        std::vector<storage::cpp2::PropDef> returnCols);
+
+    // A rough estimation of the memory taken by a response of the storage
+    static size_t estimateSize(const storage::cpp2::QueryResponse &resp);
+
     Status checkIfGraphSpaceChosen() const {
         if (ectx()->rctx()->session()->space() == -1) {
             return Status::Error("Please choose a graph space with `USE spaceName' firstly");
@@ -0,0 +1,212 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/ExternalSorter.h"
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+namespace nebula {
+namespace graph {
+
+/**
+ * Reads the rows of a run one by one.
+ * A run is a sequence of <length (uint32), compact serialized row>.
+ */
+class ExternalSorter::RunReader final {
+public:
+    explicit RunReader(const char *path)
+        : in_(path, std::ios::in | std::ios::binary) {
+    }
+
+    bool ok() const {
+        return in_.is_open();
+    }
+
+    // Returns false when there are no more rows
+    bool next(Row &row) {
+        uint32_t len;
+        if (!in_.read(reinterpret_cast<char*>(&len), sizeof(len))) {
+            return false;
+        }
+        buf_.resize(len);
+        if (!in_.read(&buf_[0], len)) {
+            LOG(ERROR) << "The sorted run is truncated";
+            return false;
+        }
+        row = Row();
+        apache::thrift::CompactSerializer::deserialize(buf_, row);
+        return true;
+    }
+
+private:
+    std::ifstream                               in_;
+    std::string                                 buf_;
+};
+
+
+ExternalSorter::ExternalSorter(Comparator less,
+                               size_t memLimit,
+                               std::string spillDir,
+                               MemoryTracker *tracker)
+    : less_(std::move(less))
+    , memLimit_(memLimit)
+    , spillDir_(std::move(spillDir))
+    , tracker_(tracker) {
+}
+
+
+ExternalSorter::~ExternalSorter() {
+    if (tracker_ != nullptr) {
+        tracker_->release(bufferBytes_);
+    }
+}
+
+
+// static
+size_t ExternalSorter::estimateSize(const Row &row) {
+    auto size = sizeof(Row);
+    for (auto &col : row.get_columns()) {
+        size += sizeof(cpp2::ColumnValue);
+        if (col.getType() == cpp2::ColumnValue::Type::str) {
+            size += col.get_str().size();
+        }
+    }
+    return size;
+}
+
+
+Status ExternalSorter::add(Row row) {
+    auto size = estimateSize(row);
+    if (tracker_ != nullptr) {
+        auto status = tracker_->consume(size);
+        if (!status.ok()) {
+            // Make room by spilling the rows buffered, before giving up
+            status = spill();
+            if (status.ok()) {
+                status = tracker_->consume(size);
+            }
+            if (!status.ok()) {
+                return status;
+            }
+        }
+    }
+    bufferBytes_ += size;
+    buffer_.emplace_back(std::move(row));
+    if (bufferBytes_ > memLimit_
+            || (tracker_ != nullptr && tracker_->shouldSpill(bufferBytes_))) {
+        return spill();
+    }
+    return Status::OK();
+}
+
+
+Status ExternalSorter::spill() {
+    if (buffer_.empty()) {
+        return Status::OK();
+    }
+    std::stable_sort(buffer_.begin(), buffer_.end(), less_);
+
+    std::unique_ptr<fs::TempFile> file;
+    try {
+        auto path = folly::stringPrintf("%s/nebula-sort.XXXXXX", spillDir_.c_str());
+        file = std::make_unique<fs::TempFile>(path.c_str());
+    } catch (const std::exception &e) {
+        return Status::Error("Failed to create the sorted run: %s", e.what());
+    }
+
+    std::ofstream out(file->path(), std::ios::out | std::ios::binary | std::ios::trunc);
+    std::string buf;
+    for (auto &row : buffer_) {
+        buf.clear();
+        apache::thrift::CompactSerializer::serialize(row, &buf);
+        uint32_t len = buf.size();
+        out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        out.write(buf.data(), buf.size());
+    }
+    out.close();
+    if (!out) {
+        return Status::Error("Failed to write the sorted run `%s'", file->path());
+    }
+
+    VLOG(2) << "Spilled " << buffer_.size() << " rows to " << file->path();
+    runs_.emplace_back(std::move(file));
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    if (tracker_ != nullptr) {
+        tracker_->release(bufferBytes_);
+    }
+    bufferBytes_ = 0;
+    return Status::OK();
+}
+
+
+Status ExternalSorter::finish(std::function<void(Row&)> cb) {
+    if (runs_.empty()) {
+        std::stable_sort(buffer_.begin(), buffer_.end(), less_);
+        for (auto &row : buffer_) {
+            cb(row);
+        }
+        buffer_.clear();
+        if (tracker_ != nullptr) {
+            tracker_->release(bufferBytes_);
+        }
+        bufferBytes_ = 0;
+        return Status::OK();
+    }
+
+    auto status = spill();
+    if (!status.ok()) {
+        return status;
+    }
+    return merge(std::move(cb));
+}
+
+
+Status ExternalSorter::merge(std::function<void(Row&)> cb) {
+    std::vector<std::unique_ptr<RunReader>> readers;
+    readers.reserve(runs_.size());
+    for (auto &run : runs_) {
+        readers.emplace_back(std::make_unique<RunReader>(run->path()));
+        if (!readers.back()->ok()) {
+            return Status::Error("Failed to open the sorted run `%s'", run->path());
+        }
+    }
+
+    // The head row of each run
+    std::vector<Row> heads(readers.size());
+    // Whether run `a' should be popped after run `b'.
+    // Rows of the earlier runs are added earlier, so ties go to them to keep stable.
+    auto after = [this, &heads] (size_t a, size_t b) {
+        if (less_(heads[b], heads[a])) {
+            return true;
+        }
+        if (less_(heads[a], heads[b])) {
+            return false;
+        }
+        return a > b;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(after)> heap(after);
+    for (auto i = 0UL; i < readers.size(); i++) {
+        if (readers[i]->next(heads[i])) {
+            heap.push(i);
+        }
+    }
+
+    while (!heap.empty()) {
+        auto i = heap.top();
+        heap.pop();
+        cb(heads[i]);
+        if (readers[i]->next(heads[i])) {
+            heap.push(i);
+        }
+    }
+
+    runs_.clear();
+    return Status::OK();
+}
+
+}   // namespace graph
+}   // namespace nebula
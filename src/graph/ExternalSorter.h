@@ -0,0 +1,82 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_EXTERNALSORTER_H_
+#define GRAPH_EXTERNALSORTER_H_
+
+#include "base/Base.h"
+#include "base/Status.h"
+#include "gen-cpp2/GraphService.h"
+#include "fs/TempFile.h"
+#include "graph/MemoryTracker.h"
+
+/**
+ * ExternalSorter sorts rows which might not fit in memory.
+ *
+ * Rows are buffered until their estimated size exceeds the memory limit,
+ * then the buffer is sorted and written to a temporary file as a run.
+ * Finally, all the runs are merged with a heap. If nothing has been
+ * spilled, the rows are just sorted in memory.
+ *
+ * The rows buffered are charged to the query's MemoryTracker if given, and
+ * are spilled earlier once the query is beyond its soft limit.
+ *
+ * The sort is stable.
+ */
+
+namespace nebula {
+namespace graph {
+
+class ExternalSorter final {
+public:
+    using Row = cpp2::RowValue;
+    using Comparator = std::function<bool(const Row&, const Row&)>;
+
+    /**
+     * @less        the order of rows
+     * @memLimit    the max bytes of rows to buffer in memory
+     * @spillDir    where to put the runs
+     * @tracker     charged with the rows buffered, could be nullptr
+     */
+    ExternalSorter(Comparator less,
+                   size_t memLimit,
+                   std::string spillDir,
+                   MemoryTracker *tracker = nullptr);
+    ~ExternalSorter();
+
+    Status MUST_USE_RESULT add(Row row);
+
+    // Call `cb' on every row in the sorted order, could be called only once
+    Status MUST_USE_RESULT finish(std::function<void(Row&)> cb);
+
+    size_t numRuns() const {
+        return runs_.size();
+    }
+
+    // A rough estimation of the memory taken by a row
+    static size_t estimateSize(const Row &row);
+
+private:
+    class RunReader;
+
+    Status spill();
+
+    Status merge(std::function<void(Row&)> cb);
+
+private:
+    Comparator                                      less_;
+    size_t                                          memLimit_{0};
+    std::string                                     spillDir_;
+    std::vector<Row>                                buffer_;
+    size_t                                          bufferBytes_{0};
+    std::vector<std::unique_ptr<fs::TempFile>>      runs_;
+    MemoryTracker                                  *tracker_{nullptr};
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_EXTERNALSORTER_H_
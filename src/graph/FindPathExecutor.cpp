@@ -0,0 +1,304 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/FindPathExecutor.h"
+#include "graph/GraphFlags.h"
+#include "dataman/RowSetWriter.h"
+#include "dataman/SchemaWriter.h"
+
+namespace nebula {
+namespace graph {
+
+FindPathExecutor::FindPathExecutor(Sentence *sentence, ExecutionContext *ectx)
+        : TraverseExecutor(ectx) {
+    sentence_ = static_cast<FindPathSentence*>(sentence);
+}
+
+
+Status FindPathExecutor::prepare() {
+    return Status::OK();
+}
+
+
+Status FindPathExecutor::prepareClauses() {
+    DCHECK(sentence_ != nullptr);
+    Status status;
+    do {
+        status = checkIfGraphSpaceChosen();
+        if (!status.ok()) {
+            break;
+        }
+        isShortest_ = sentence_->isShortest();
+        steps_ = sentence_->stepClause()->steps();
+        status = prepareVids(sentence_->from(), from_);
+        if (!status.ok()) {
+            break;
+        }
+        status = prepareVids(sentence_->to(), to_);
+        if (!status.ok()) {
+            break;
+        }
+        status = prepareOver();
+        if (!status.ok()) {
+            break;
+        }
+    } while (false);
+    return status;
+}
+
+
+Status FindPathExecutor::prepareOver() {
+    auto *clause = sentence_->overClause();
+    auto spaceId = ectx()->rctx()->session()->space();
+    auto edgeStatus = ectx()->schemaManager()->toEdgeType(spaceId, *clause->edge());
+    if (!edgeStatus.ok()) {
+        return edgeStatus.status();
+    }
+    edgeType_ = edgeStatus.value();
+    reversely_ = clause->isReversely();
+    return Status::OK();
+}
+
+
+void FindPathExecutor::execute() {
+    FLOG_INFO("Executing FindPath: %s", sentence_->toString().c_str());
+    auto status = prepareClauses();
+    if (!status.ok()) {
+        DCHECK(onError_);
+        onError_(std::move(status));
+        return;
+    }
+
+    for (auto vid : from_) {
+        fwdDist_.emplace(vid, 0);
+    }
+    for (auto vid : to_) {
+        bwdDist_.emplace(vid, 0);
+        targets_.emplace(vid);
+        if (fwdDist_.count(vid) != 0) {
+            meet(0);
+        }
+    }
+    fwdFrontier_ = from_;
+    bwdFrontier_ = to_;
+    stepOut();
+}
+
+
+void FindPathExecutor::stepOut() {
+    if ((isShortest_ && meet_.hasValue())
+            || fwdSteps_ + bwdSteps_ >= steps_
+            || fwdFrontier_.empty()
+            || bwdFrontier_.empty()) {
+        // A shorter path would have been met in the previous steps. Otherwise,
+        // all the edges of the paths within the steps have been seen.
+        Status status;
+        if (!isShortest_) {
+            status = findPaths(steps_);
+        } else if (meet_.hasValue()) {
+            status = findPaths(meet_.value());
+        }
+        if (!status.ok()) {
+            DCHECK(onError_);
+            onError_(std::move(status));
+            return;
+        }
+        finishExecution();
+        return;
+    }
+
+    // Expand the smaller side, which is the cheaper one to step out
+    auto forward = fwdFrontier_.size() <= bwdFrontier_.size();
+    std::vector<VertexID> ids;
+    ids.swap(forward ? fwdFrontier_ : bwdFrontier_);
+    auto future = getNeighborIds(std::move(ids), edgeType_, forward != reversely_, "");
+    auto *runner = ectx()->rctx()->runner();
+    auto cb = [this, forward] (NeighborsResponse &&result) {
+        auto status = onStepOut(forward, std::move(result));
+        if (!status.ok()) {
+            DCHECK(onError_);
+            onError_(std::move(status));
+            return;
+        }
+        stepOut();
+    };
+    auto error = [this] (auto &&e) {
+        LOG(ERROR) << "Exception caught: " << e.what();
+        onError_(Status::Error("Internal error"));
+    };
+    std::move(future).via(runner).thenValue(cb).thenError(error);
+}
+
+
+Status FindPathExecutor::onStepOut(bool forward, NeighborsResponse &&result) {
+    auto &dist = forward ? fwdDist_ : bwdDist_;
+    auto &other = forward ? bwdDist_ : fwdDist_;
+    auto &frontier = forward ? fwdFrontier_ : bwdFrontier_;
+    auto &steps = forward ? fwdSteps_ : bwdSteps_;
+    auto status = forEachNeighbor(std::move(result), [&] (VertexID vid, VertexID dst) {
+        // Stepping in from the targets, `dst' comes before the vertex on the paths
+        if (forward) {
+            edges_[vid].emplace_back(dst);
+        } else {
+            edges_[dst].emplace_back(vid);
+        }
+        if (++numEdges_ > static_cast<size_t>(FLAGS_find_path_max_edges)) {
+            return Status::Error("Too many edges to find paths from, more than %ld",
+                                 FLAGS_find_path_max_edges);
+        }
+        if (!dist.emplace(dst, steps + 1).second) {
+            return Status::OK();
+        }
+        frontier.emplace_back(dst);
+        auto it = other.find(dst);
+        if (it != other.end()) {
+            meet(steps + 1 + it->second);
+        }
+        return Status::OK();
+    });
+    if (!status.ok()) {
+        return status;
+    }
+    steps++;
+    return Status::OK();
+}
+
+
+void FindPathExecutor::meet(uint32_t length) {
+    if (!meet_.hasValue() || length < meet_.value()) {
+        meet_ = length;
+    }
+}
+
+
+Status FindPathExecutor::findPaths(uint32_t maxLength) {
+    // The same edge might have been seen from both sides
+    for (auto &pair : edges_) {
+        auto &dsts = pair.second;
+        std::sort(dsts.begin(), dsts.end());
+        dsts.erase(std::unique(dsts.begin(), dsts.end()), dsts.end());
+    }
+    Status status;
+    std::vector<VertexID> path;
+    for (auto vid : from_) {
+        path.emplace_back(vid);
+        findPaths(path, maxLength, status);
+        path.pop_back();
+        if (!status.ok()) {
+            break;
+        }
+    }
+    return status;
+}
+
+
+void FindPathExecutor::findPaths(std::vector<VertexID> &path, uint32_t maxLength, Status &status) {
+    auto vid = path.back();
+    auto length = path.size() - 1;
+    if (targets_.count(vid) != 0 && (length > 0 || maxLength == 0)) {
+        if (paths_.size() >= static_cast<size_t>(FLAGS_find_path_max_paths)) {
+            status = Status::Error("Too many paths found, more than %ld",
+                                   FLAGS_find_path_max_paths);
+            return;
+        }
+        paths_.emplace_back(pathToString(path));
+    }
+    if (length >= maxLength) {
+        return;
+    }
+    auto it = edges_.find(vid);
+    if (it == edges_.end()) {
+        return;
+    }
+    for (auto next : it->second) {
+        if (length + 1 + stepsToTargets(next) > maxLength) {
+            continue;
+        }
+        // Paths with cycles are not taken
+        if (std::find(path.begin(), path.end(), next) != path.end()) {
+            continue;
+        }
+        path.emplace_back(next);
+        findPaths(path, maxLength, status);
+        path.pop_back();
+        if (!status.ok()) {
+            return;
+        }
+    }
+}
+
+
+uint32_t FindPathExecutor::stepsToTargets(VertexID vid) const {
+    auto it = bwdDist_.find(vid);
+    if (it != bwdDist_.end()) {
+        return it->second;
+    }
+    // All the vertices within `bwdSteps_' steps to the targets have been reached
+    return bwdSteps_ + 1;
+}
+
+
+std::string FindPathExecutor::pathToString(const std::vector<VertexID> &path) const {
+    auto *name = sentence_->overClause()->edge();
+    auto edge = reversely_ ? folly::stringPrintf(" <-%s- ", name->c_str())
+                           : folly::stringPrintf(" -%s-> ", name->c_str());
+    std::string buf;
+    buf.reserve(256);
+    for (auto vid : path) {
+        if (!buf.empty()) {
+            buf += edge;
+        }
+        buf += std::to_string(vid);
+    }
+    return buf;
+}
+
+
+void FindPathExecutor::finishExecution() {
+    if (onResult_) {
+        std::unique_ptr<InterimResult> outputs;
+        if (!paths_.empty()) {
+            auto schema = std::make_shared<SchemaWriter>();
+            schema->appendCol("_path_", nebula::cpp2::SupportedType::STRING);
+            auto rsWriter = std::make_unique<RowSetWriter>(schema);
+            for (auto &path : paths_) {
+                RowWriter writer(schema);
+                writer << path;
+                rsWriter->addRow(writer.encode());
+            }
+            outputs = std::make_unique<InterimResult>(std::move(rsWriter));
+        }
+        onResult_(std::move(outputs));
+    } else {
+        resp_ = std::make_unique<cpp2::ExecutionResponse>();
+        resp_->set_column_names({"_path_"});
+        std::vector<cpp2::RowValue> rows;
+        rows.reserve(paths_.size());
+        for (auto &path : paths_) {
+            std::vector<cpp2::ColumnValue> row(1);
+            row[0].set_str(std::move(path));
+            rows.emplace_back();
+            rows.back().set_columns(std::move(row));
+        }
+        if (!rows.empty()) {
+            resp_->set_rows(std::move(rows));
+        }
+    }
+    DCHECK(onFinish_);
+    onFinish_();
+}
+
+
+void FindPathExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
+    if (resp_ == nullptr) {
+        resp_ = std::make_unique<cpp2::ExecutionResponse>();
+    }
+    resp = std::move(*resp_);
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -0,0 +1,109 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_FINDPATHEXECUTOR_H_
+#define GRAPH_FINDPATHEXECUTOR_H_
+
+#include "base/Base.h"
+#include "graph/TraverseExecutor.h"
+#include "storage/client/StorageClient.h"
+
+/**
+ * FindPathExecutor finds the paths from a set of vertices to another set, along one
+ * type of edges, with a bidirectional BFS, i.e. stepping out from the sources and
+ * stepping in from the targets by turns, always the side with the smaller frontier,
+ * until the two meet, or the steps add up to the limit.
+ *
+ * All the edges seen are kept, so the paths are then enumerated from the sources
+ * over them, skipping the vertices already on the path, and the ones which could
+ * not reach the targets within the steps left.
+ */
+
+namespace nebula {
+namespace graph {
+
+class FindPathExecutor final : public TraverseExecutor {
+public:
+    FindPathExecutor(Sentence *sentence, ExecutionContext *ectx);
+
+    const char* name() const override {
+        return "FindPathExecutor";
+    }
+
+    Status MUST_USE_RESULT prepare() override;
+
+    void execute() override;
+
+    void feedResult(std::unique_ptr<InterimResult> result) override {
+        UNUSED(result);
+    }
+
+    void setupResponse(cpp2::ExecutionResponse &resp) override;
+
+private:
+    Status prepareClauses();
+
+    Status prepareOver();
+
+    /**
+     * To expand the smaller frontier by one step, or to finish the searching.
+     */
+    void stepOut();
+
+    /**
+     * To take the edges of one step, forward from the sources or backward from the targets.
+     */
+    Status onStepOut(bool forward, NeighborsResponse &&result);
+
+    /**
+     * The two sides have met, with a path of `length'.
+     */
+    void meet(uint32_t length);
+
+    /**
+     * To enumerate the paths no longer than `maxLength' over the edges kept.
+     */
+    Status findPaths(uint32_t maxLength);
+
+    void findPaths(std::vector<VertexID> &path, uint32_t maxLength, Status &status);
+
+    // The lower bound of the steps from `vid' to the targets
+    uint32_t stepsToTargets(VertexID vid) const;
+
+    std::string pathToString(const std::vector<VertexID> &path) const;
+
+    void finishExecution();
+
+private:
+    FindPathSentence                           *sentence_{nullptr};
+    bool                                        isShortest_{true};
+    uint32_t                                    steps_{1};
+    EdgeType                                    edgeType_{0};
+    bool                                        reversely_{false};
+    std::vector<VertexID>                       from_;
+    std::vector<VertexID>                       to_;
+    std::unordered_set<VertexID>                targets_;
+    // Steps taken from the sources and from the targets
+    uint32_t                                    fwdSteps_{0};
+    uint32_t                                    bwdSteps_{0};
+    // The vertices reached from either side, with the steps they are reached at
+    std::unordered_map<VertexID, uint32_t>      fwdDist_;
+    std::unordered_map<VertexID, uint32_t>      bwdDist_;
+    std::vector<VertexID>                       fwdFrontier_;
+    std::vector<VertexID>                       bwdFrontier_;
+    // The length of the shortest paths, once the two sides have met
+    folly::Optional<uint32_t>                   meet_;
+    // The edges seen, in the direction of the paths
+    std::unordered_map<VertexID, std::vector<VertexID>>     edges_;
+    size_t                                      numEdges_{0};
+    std::vector<std::string>                    paths_;
+    std::unique_ptr<cpp2::ExecutionResponse>    resp_;
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_FINDPATHEXECUTOR_H_
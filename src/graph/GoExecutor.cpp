@@ -8,6 +8,7 @@
 #include "graph/GoExecutor.h"
 #include "dataman/RowReader.h"
 #include "dataman/RowSetReader.h"
+#include "dataman/RowSlotReader.h"
 #include "dataman/ResultSchemaProvider.h"
 
 
@@ -17,6 +18,19 @@ namespace graph {
 using SchemaProps = std::unordered_map<std::string, std::vector<std::string>>;
 using nebula::cpp2::SupportedType;
 
+namespace {
+
+// Where the slots of the compiled expressions are read from
+enum SlotSource : uint8_t {
+    kEdgeSlot = 0,
+    kSrcSlot,
+    kDstSlot,
+    kInputSlot,
+    kNumSlotSources,
+};
+
+}   // Anonymous namespace
+
 GoExecutor::GoExecutor(Sentence *sentence, ExecutionContext *ectx) : TraverseExecutor(ectx) {
     // The RTTI is guaranteed by Sentence::Kind,
     // so we use `static_cast' instead of `dynamic_cast' for the sake of efficiency.
@@ -102,12 +116,37 @@ void GoExecutor::execute() {
         }
         starts_ = std::vector<VertexID>(uniqID.begin(), uniqID.end());
     }
-    stepOut();
+    status = prepareStepOut();
+    if (!status.ok()) {
+        onError_(std::move(status));
+        return;
+    }
+    addOngoing();
+    stepOut(1, std::move(starts_));
 }
 
 
 void GoExecutor::feedResult(std::unique_ptr<InterimResult> result) {
-    inputs_ = std::move(result);
+    if (result == nullptr || result->numRows() == 0 || !inputStatus_.ok()) {
+        return;
+    }
+    // The inputs are of no use unless stepped out from, i.e. `GO FROM $-.col'
+    auto *clause = sentence_->fromClause();
+    if (clause == nullptr || !clause->isRef() || !clause->ref()->isInputExpression()) {
+        return;
+    }
+    auto &colname = *static_cast<InputPropertyExpression*>(clause->ref())->prop();
+    // Only the ids and the index of each batch are kept, the batch itself is released
+    auto vids = result->getVIDs(colname);
+    if (!vids.ok()) {
+        inputStatus_ = std::move(vids).status();
+        return;
+    }
+    starts_.insert(starts_.end(), vids.value().begin(), vids.value().end());
+    if (!fed_ || index_ != nullptr) {
+        index_ = result->buildIndex(colname, std::move(index_));
+    }
+    fed_ = true;
 }
 
 
@@ -293,20 +332,18 @@ Status GoExecutor::prepareDistinct() {
 
 
 Status GoExecutor::setupStarts() {
-    // Literal vertex ids
-    if (!starts_.empty()) {
+    if (!inputStatus_.ok()) {
+        return inputStatus_;
+    }
+    // Literal vertex ids, or those of the inputs fed
+    if (!starts_.empty() || varname_ == nullptr) {
         return Status::OK();
     }
-    const auto *inputs = inputs_.get();
     // Take one column from a variable
-    if (varname_ != nullptr) {
-        bool existing = false;
-        auto *varInputs = ectx()->variableHolder()->get(*varname_, &existing);
-        if (varInputs == nullptr && !existing) {
-            return Status::Error("Variable `%s' not defined", varname_->c_str());
-        }
-        DCHECK(inputs == nullptr);
-        inputs = varInputs;
+    bool existing = false;
+    auto *inputs = ectx()->variableHolder()->get(*varname_, &existing);
+    if (inputs == nullptr && !existing) {
+        return Status::Error("Variable `%s' not defined", varname_->c_str());
     }
     // No error happened, but we are having empty inputs
     if (inputs == nullptr) {
@@ -331,127 +368,287 @@ void GoExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
 }
 
 
-void GoExecutor::stepOut() {
-    auto spaceId = ectx()->rctx()->session()->space();
-    auto status = getStepOutProps();
-    if (!status.ok()) {
-        DCHECK(onError_);
-        onError_(Status::Error("Get step out props failed"));
-        return;
+Status GoExecutor::prepareStepOut() {
+    auto props = getStepOutProps(false);
+    if (!props.ok()) {
+        return Status::Error("Get step out props failed");
     }
-    auto returns = status.value();
+    stepOutProps_ = std::move(props).value();
+    props = getStepOutProps(true);
+    if (!props.ok()) {
+        return Status::Error("Get step out props failed");
+    }
+    finalStepOutProps_ = std::move(props).value();
+    if (expCtx_->hasDstTagProp()) {
+        props = getDstProps();
+        if (!props.ok()) {
+            return Status::Error("Get dest props failed");
+        }
+        dstProps_ = std::move(props).value();
+    }
+    visited_.resize(steps_ + 1);
+    stepStates_.resize(steps_ + 1);
+    stepStates_[0].done = true;
+    return Status::OK();
+}
+
+
+void GoExecutor::stepOut(uint32_t step, std::vector<VertexID> ids) {
+    auto *session = ectx()->rctx()->session();
+    auto spaceId = session->space();
+    auto *runner = ectx()->rctx()->runner();
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (isFinalStep(step)) {
+            finalStepped_ = true;
+        } else if (visited_[step + 1] == nullptr) {
+            // The set is created once the step starts, instead of for all steps upfront
+            visited_[step + 1] = std::make_unique<ConcurrentVertexSet>();
+        }
+        stepStates_[step].pending++;
+    }
+    // Each host's response is processed as soon as it arrives,
+    // without waiting for the other hosts of the same step.
+    auto onResponse = [this, step, runner] (storage::cpp2::QueryResponse &&resp) {
+        addOngoing();
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            stepStates_[step].pending++;
+        }
+        // The response is charged while it waits to be processed, if the query fails
+        // to charge it, it fails at the processing
+        auto bytes = estimateSize(resp);
+        if (!ectx()->trackMemory(bytes).ok()) {
+            bytes = 0;
+        }
+        runner->add([this, step, bytes, resp = std::move(resp)] () mutable {
+            onStepOutResponse(step, std::move(resp));
+            ectx()->untrackMemory(bytes);
+            finishStepWork(step);
+            finishOngoing();
+        });
+    };
     auto future = ectx()->storage()->getNeighbors(spaceId,
-                                                  starts_,
+                                                  std::move(ids),
                                                   edgeType_,
                                                   !reversely_,
                                                   "",
-                                                  std::move(returns));
-    auto *runner = ectx()->rctx()->runner();
-    auto cb = [this] (auto &&result) {
-        auto completeness = result.completeness();
-        if (completeness == 0) {
-            DCHECK(onError_);
-            onError_(Status::Error("Get neighbors failed"));
-            return;
-        } else if (completeness != 100) {
-            // TODO(dutor) We ought to let the user know that the execution was partially
-            // performed, even in the case that this happened in the intermediate process.
-            // Or, make this case configurable at runtime.
-            // For now, we just do some logging and keep going.
-            LOG(INFO) << "Get neighbors partially failed: "  << completeness << "%";
+                                                  isFinalStep(step) ? finalStepOutProps_
+                                                                    : stepOutProps_,
+                                                  ectx()->readOptions(),
+                                                  nullptr,
+                                                  std::move(onResponse));
+    auto cb = [this, step] (auto &&result) {
+        if (result.retriedReqs() > 0) {
+            VLOG(1) << "Get neighbors retried " << result.retriedReqs() << " requests";
+        }
+        auto status = ectx()->checkCancelled();
+        if (!status.ok()) {
+            // The parts cut short by the storage are not to be taken as failed
+            fail(std::move(status));
+        } else {
+            // This is one of the requests of the step, which fails only if all of them do
+            {
+                std::lock_guard<std::mutex> guard(lock_);
+                stepStates_[step].reqs += result.totalReqsSent();
+                stepStates_[step].failedReqs += result.failedReqs();
+            }
             for (auto &error : result.failedParts()) {
                 LOG(ERROR) << "part: " << error.first
                            << "error code: " << static_cast<int>(error.second);
             }
         }
-        onStepOutResponse(std::move(result));
+        finishStepWork(step);
+        finishOngoing();
     };
-    auto error = [this] (auto &&e) {
+    auto error = [this, step] (auto &&e) {
         LOG(ERROR) << "Exception caught: " << e.what();
-        onError_(Status::Error("Internal error"));
+        fail(Status::Error("Internal error"));
+        finishStepWork(step);
+        finishOngoing();
     };
     std::move(future).via(runner).thenValue(cb).thenError(error);
 }
 
 
-void GoExecutor::onStepOutResponse(RpcResponse &&rpcResp) {
-    if (isFinalStep()) {
+void GoExecutor::onStepOutResponse(uint32_t step, storage::cpp2::QueryResponse &&resp) {
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (!status_.ok()) {
+            // Already failed, no need to go any further
+            return;
+        }
+    }
+    auto status = ectx()->checkCancelled();
+    if (!status.ok()) {
+        fail(std::move(status));
+        return;
+    }
+    if (isFinalStep(step)) {
         if (expCtx_->hasDstTagProp()) {
-            auto dstids = getDstIdsFromResp(rpcResp);
+            auto dstids = getDstIdsFromResp(resp, step);
             if (dstids.empty()) {
-                onEmptyInputs();
                 return;
             }
-            fetchVertexProps(std::move(dstids), std::move(rpcResp));
+            addOngoing();
+            fetchVertexProps(std::move(dstids), std::move(resp));
             return;
         }
-        finishExecution(std::move(rpcResp));
+        onFinalStepResponse(resp);
         return;
-    } else {
-        starts_ = getDstIdsFromResp(rpcResp);
-        if (starts_.empty()) {
-            onEmptyInputs();
+    }
+    auto dstids = getDstIdsFromResp(resp, step);
+    if (dstids.empty()) {
+        return;
+    }
+    addOngoing();
+    stepOut(step + 1, std::move(dstids));
+}
+
+
+void GoExecutor::addOngoing() {
+    std::lock_guard<std::mutex> guard(lock_);
+    ongoing_++;
+}
+
+
+void GoExecutor::finishOngoing() {
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        DCHECK_GT(ongoing_, 0u);
+        if (--ongoing_ > 0) {
             return;
         }
-        curStep_++;
-        stepOut();
     }
+    finishExecution();
 }
 
 
-void GoExecutor::onVertexProps(RpcResponse &&rpcResp) {
-    UNUSED(rpcResp);
+void GoExecutor::finishStepWork(uint32_t step) {
+    std::lock_guard<std::mutex> guard(lock_);
+    DCHECK_GT(stepStates_[step].pending, 0u);
+    stepStates_[step].pending--;
+    // A step is done once nothing of it is left and the steps before are done,
+    // i.e. no more requests would be sent for it
+    while (step <= steps_ && stepStates_[step].pending == 0 && stepStates_[step - 1].done) {
+        stepStates_[step].done = true;
+        // The dst ids reached at this step are not to be checked any more
+        if (step + 1 < visited_.size()) {
+            visited_[step + 1].reset();
+        }
+        step++;
+    }
 }
 
 
-std::vector<VertexID> GoExecutor::getDstIdsFromResp(RpcResponse &rpcResp) const {
-    std::unordered_set<VertexID> set;
-    for (auto &resp : rpcResp.responses()) {
-        auto *vertices = resp.get_vertices();
-        if (vertices == nullptr) {
+Status GoExecutor::checkCompleteness() const {
+    for (auto step = 1u; step <= steps_; step++) {
+        auto &state = stepStates_[step];
+        if (state.reqs == 0 || state.failedReqs == 0) {
             continue;
         }
-        auto schema = std::make_shared<ResultSchemaProvider>(resp.edge_schema);
-        for (auto &vdata : *vertices) {
-            RowSetReader rsReader(schema, vdata.edge_data);
-            auto iter = rsReader.begin();
-            while (iter) {
-                VertexID dst;
-                auto rc = iter->getVid("_dst", dst);
-                CHECK(rc == ResultType::SUCCEEDED);
-                if (!isFinalStep() && backTracker_ != nullptr) {
-                    backTracker_->add(vdata.get_vertex_id(), dst);
-                }
-                set.emplace(dst);
-                ++iter;
+        if (state.failedReqs == state.reqs) {
+            return Status::Error("Get neighbors failed");
+        }
+        // TODO(dutor) We ought to let the user know that the execution was partially
+        // performed, even in the case that this happened in the intermediate process.
+        // Or, make this case configurable at runtime.
+        // For now, we just do some logging and keep going.
+        LOG(INFO) << "Get neighbors partially failed at step " << step << ": "
+                  << (state.reqs - state.failedReqs) * 100 / state.reqs << "%";
+    }
+    return Status::OK();
+}
+
+
+void GoExecutor::fail(Status status) {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (status_.ok()) {
+        status_ = std::move(status);
+    }
+}
+
+
+std::vector<VertexID> GoExecutor::getDstIdsFromResp(const storage::cpp2::QueryResponse &resp,
+                                                   uint32_t step) {
+    auto *vertices = resp.get_vertices();
+    if (vertices == nullptr) {
+        return {};
+    }
+    // Pairs of src and dst
+    std::vector<std::pair<VertexID, VertexID>> edges;
+    auto schema = std::make_shared<ResultSchemaProvider>(resp.edge_schema);
+    for (auto &vdata : *vertices) {
+        RowSetReader rsReader(schema, vdata.edge_data);
+        auto iter = rsReader.begin();
+        while (iter) {
+            VertexID dst;
+            auto rc = iter->getVid("_dst", dst);
+            CHECK(rc == ResultType::SUCCEEDED);
+            edges.emplace_back(vdata.get_vertex_id(), dst);
+            ++iter;
+        }
+    }
+
+    std::vector<VertexID> dstids;
+    if (isFinalStep(step)) {
+        VertexSet set;
+        for (auto &edge : edges) {
+            if (set.insert(edge.second)) {
+                dstids.emplace_back(edge.second);
             }
         }
+        return dstids;
+    }
+    // The same dst might have been reached from the responses of other hosts,
+    // which are merged in parallel, shard by shard
+    if (backTracker_ != nullptr) {
+        backTracker_->add(edges);
     }
-    return std::vector<VertexID>(set.begin(), set.end());
+    dstids.reserve(edges.size());
+    for (auto &edge : edges) {
+        dstids.emplace_back(edge.second);
+    }
+    return visited_[step + 1]->insert(dstids);
 }
 
-void GoExecutor::finishExecution(RpcResponse &&rpcResp) {
-    std::unique_ptr<InterimResult> outputs;
 
-    if (!setupInterimResult(std::move(rpcResp), outputs)) {
+void GoExecutor::finishExecution() {
+    // Nothing is in flight any more, so there is no need to lock
+    if (status_.ok()) {
+        status_ = checkCompleteness();
+    }
+    if (!status_.ok()) {
+        DCHECK(onError_);
+        onError_(std::move(status_));
         return;
     }
     if (onResult_) {
-        onResult_(std::move(outputs));
+        if (!emitted_) {
+            onResult_(nullptr);
+        }
     } else {
         resp_ = std::make_unique<cpp2::ExecutionResponse>();
-        resp_->set_column_names(getResultColumnNames());
-
-        if (outputs != nullptr) {
-            auto rows = outputs->getRows();
-            resp_->set_rows(std::move(rows));
+        // The final step has not been reached if the stepping out reached the dead end
+        if (finalStepped_) {
+            resp_->set_column_names(getResultColumnNames());
+            std::vector<cpp2::RowValue> rows;
+            for (auto &output : outputs_) {
+                output->forEachRow([&] (cpp2::RowValue &row) {
+                    rows.emplace_back(std::move(row));
+                    return true;
+                });
+            }
+            if (!rows.empty()) {
+                resp_->set_rows(std::move(rows));
+            }
         }
     }
     DCHECK(onFinish_);
     onFinish_();
 }
 
-StatusOr<std::vector<storage::cpp2::PropDef>> GoExecutor::getStepOutProps() {
+StatusOr<std::vector<storage::cpp2::PropDef>> GoExecutor::getStepOutProps(bool isFinal) {
     std::vector<storage::cpp2::PropDef> props;
     {
         storage::cpp2::PropDef pd;
@@ -460,7 +657,7 @@ StatusOr<std::vector<storage::cpp2::PropDef>> GoExecutor::getStepOutProps() {
         props.emplace_back(std::move(pd));
     }
 
-    if (!isFinalStep()) {
+    if (!isFinal) {
         return props;
     }
 
@@ -528,22 +725,15 @@ StatusOr<std::vector<storage::cpp2::PropDef>> GoExecutor::getDstProps() {
 }
 
 
-void GoExecutor::fetchVertexProps(std::vector<VertexID> ids, RpcResponse &&rpcResp) {
+void GoExecutor::fetchVertexProps(std::vector<VertexID> ids, storage::cpp2::QueryResponse &&resp) {
     auto spaceId = ectx()->rctx()->session()->space();
-    auto status = getDstProps();
-    if (!status.ok()) {
-        DCHECK(onError_);
-        onError_(Status::Error("Get dest props failed"));
-        return;
-    }
-    auto returns = status.value();
-    auto future = ectx()->storage()->getVertexProps(spaceId, ids, returns);
+    auto future = getVertexProps(spaceId, std::move(ids), dstProps_);
     auto *runner = ectx()->rctx()->runner();
-    auto cb = [this, stepOutResp = std::move(rpcResp)] (auto &&result) mutable {
+    auto cb = [this, stepOutResp = std::move(resp)] (auto &&result) mutable {
         auto completeness = result.completeness();
         if (completeness == 0) {
-            DCHECK(onError_);
-            onError_(Status::Error("Get dest props failed"));
+            fail(Status::Error("Get dest props failed"));
+            finishOngoing();
             return;
         } else if (completeness != 100) {
             LOG(INFO) << "Get neighbors partially failed: "  << completeness << "%";
@@ -552,18 +742,30 @@ void GoExecutor::fetchVertexProps(std::vector<VertexID> ids, RpcResponse &&rpcRe
                            << "error code: " << static_cast<int>(error.second);
             }
         }
-        if (vertexHolder_ == nullptr) {
-            vertexHolder_ = std::make_unique<VertexHolder>();
+        for (auto &vresp : result.responses()) {
+            auto status = ectx()->trackMemory(estimateSize(vresp));
+            if (!status.ok()) {
+                fail(std::move(status));
+                finishOngoing();
+                return;
+            }
         }
-        for (auto &resp : result.responses()) {
-            vertexHolder_->add(resp);
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            if (vertexHolder_ == nullptr) {
+                vertexHolder_ = std::make_unique<VertexHolder>();
+            }
+            for (auto &vresp : result.responses()) {
+                vertexHolder_->add(vresp);
+            }
         }
-        finishExecution(std::move(stepOutResp));
-        return;
+        onFinalStepResponse(stepOutResp);
+        finishOngoing();
     };
     auto error = [this] (auto &&e) {
         LOG(ERROR) << "Exception caught: " << e.what();
-        onError_(Status::Error("Internal error"));
+        fail(Status::Error("Internal error"));
+        finishOngoing();
     };
     std::move(future).via(runner).thenValue(cb).thenError(error);
 }
@@ -582,14 +784,44 @@ std::vector<std::string> GoExecutor::getResultColumnNames() const {
     return result;
 }
 
-bool GoExecutor::setupInterimResult(RpcResponse &&rpcResp, std::unique_ptr<InterimResult> &result) {
+void GoExecutor::onFinalStepResponse(const storage::cpp2::QueryResponse &resp) {
+    // The expressions, the back tracker and the dst props are shared by all the responses
+    std::lock_guard<std::mutex> guard(lock_);
+    if (!status_.ok()) {
+        return;
+    }
+    std::unique_ptr<InterimResult> outputs;
+    auto status = setupInterimResult(resp, outputs);
+    if (!status.ok()) {
+        status_ = std::move(status);
+        return;
+    }
+    // No results populated
+    if (outputs == nullptr) {
+        return;
+    }
+    if (onResult_) {
+        // Charged by the executor it is fed to
+        emitted_ = true;
+        onResult_(std::move(outputs));
+    } else {
+        status = ectx()->trackMemory(outputs->memoryBytes());
+        if (!status.ok()) {
+            status_ = std::move(status);
+            return;
+        }
+        outputs_.emplace_back(std::move(outputs));
+    }
+}
+
+
+Status GoExecutor::setupInterimResult(const storage::cpp2::QueryResponse &resp,
+                                      std::unique_ptr<InterimResult> &result) {
     // Generic results
-    std::shared_ptr<SchemaWriter> schema;
-    std::unique_ptr<RowSetWriter> rsWriter;
-    auto uniqResult = std::make_unique<std::unordered_set<std::string>>();
-    auto cb = [&] (std::vector<VariantType> record) {
-        if (schema == nullptr) {
-            schema = std::make_shared<SchemaWriter>();
+    std::unique_ptr<ColumnBatch::Builder> builder;
+    Callback cb = [&] (std::vector<VariantType> record) {
+        if (resultSchema_ == nullptr) {
+            resultSchema_ = std::make_shared<SchemaWriter>();
             auto colnames = getResultColumnNames();
             for (auto i = 0u; i < record.size(); i++) {
                 SupportedType type;
@@ -610,49 +842,48 @@ bool GoExecutor::setupInterimResult(RpcResponse &&rpcResp, std::unique_ptr<Inter
                     default:
                         LOG(FATAL) << "Unknown VariantType: " << record[i].which();
                 }
-                schema->appendCol(colnames[i], type);
+                resultSchema_->appendCol(colnames[i], type);
             }  // for
-            rsWriter = std::make_unique<RowSetWriter>(schema);
         }  // if
+        if (builder == nullptr) {
+            builder = std::make_unique<ColumnBatch::Builder>(resultSchema_);
+        }
 
-        RowWriter writer(schema);
-        for (auto &column : record) {
-            switch (column.which()) {
-                case 0:
-                    writer << boost::get<int64_t>(column);
-                    break;
-                case 1:
-                    writer << boost::get<double>(column);
-                    break;
-                case 2:
-                    writer << boost::get<bool>(column);
-                    break;
-                case 3:
-                    writer << boost::get<std::string>(column);
-                    break;
-                default:
-                    LOG(FATAL) << "Unknown VariantType: " << column.which();
-            }
-        }
-        // TODO Consider float/double, and need to reduce mem copy.
-        std::string encode = writer.encode();
         if (distinct_) {
-            auto ret = uniqResult->emplace(encode);
-            if (ret.second) {
-                rsWriter->addRow(std::move(encode));
+            // The encoded row is only the key to deduplicate, across all the responses
+            RowWriter writer(resultSchema_);
+            for (auto &column : record) {
+                switch (column.which()) {
+                    case 0:
+                        writer << boost::get<int64_t>(column);
+                        break;
+                    case 1:
+                        writer << boost::get<double>(column);
+                        break;
+                    case 2:
+                        writer << boost::get<bool>(column);
+                        break;
+                    case 3:
+                        writer << boost::get<std::string>(column);
+                        break;
+                    default:
+                        LOG(FATAL) << "Unknown VariantType: " << column.which();
+                }
+            }
+            if (!uniqResult_.emplace(writer.encode()).second) {
+                return;
             }
-        } else {
-            rsWriter->addRow(std::move(encode));
         }
+        builder->append(record);
     };  // cb
-    if (!processFinalResult(rpcResp, cb)) {
-        return false;
+    auto status = processFinalResponse(resp, cb);
+    if (!status.ok()) {
+        return status;
     }
-    // No results populated
-    if (rsWriter != nullptr) {
-        result = std::make_unique<InterimResult>(std::move(rsWriter));
+    if (builder != nullptr) {
+        result = std::make_unique<InterimResult>(resultSchema_, builder->finish());
     }
-    return true;
+    return Status::OK();
 }
 
 
@@ -666,131 +897,372 @@ void GoExecutor::onEmptyInputs() {
 }
 
 
-bool GoExecutor::processFinalResult(RpcResponse &rpcResp, Callback cb) const {
-    auto all = rpcResp.responses();
-    for (auto &resp : all) {
-        if (resp.get_vertices() == nullptr) {
+Status GoExecutor::processFinalResponse(const storage::cpp2::QueryResponse &resp,
+                                        Callback &cb) const {
+    if (resp.get_vertices() == nullptr) {
+        return Status::OK();
+    }
+    std::shared_ptr<ResultSchemaProvider> vschema;
+    std::shared_ptr<ResultSchemaProvider> eschema;
+    if (resp.get_vertex_schema() != nullptr) {
+        vschema = std::make_shared<ResultSchemaProvider>(resp.vertex_schema);
+    }
+    if (resp.get_edge_schema() != nullptr) {
+        eschema = std::make_shared<ResultSchemaProvider>(resp.edge_schema);
+    }
+    std::unique_ptr<CompiledExprs> compiled;
+    if (eschema != nullptr) {
+        compiled = compileExprs(eschema.get(), vschema.get());
+    }
+
+    for (auto &vdata : resp.vertices) {
+        std::unique_ptr<RowReader> vreader;
+        // TODO(simon.liu) In issue #192, I will solve this problem for better.
+        if (!resp.__isset.vertices || resp.get_vertices() == nullptr) {
             continue;
         }
-        std::shared_ptr<ResultSchemaProvider> vschema;
-        std::shared_ptr<ResultSchemaProvider> eschema;
-        if (resp.get_vertex_schema() != nullptr) {
-            vschema = std::make_shared<ResultSchemaProvider>(resp.vertex_schema);
+
+        if (vschema != nullptr) {
+            DCHECK(vdata.__isset.vertex_data);
+            vreader = RowReader::getRowReader(vdata.vertex_data, vschema);
         }
-        if (resp.get_edge_schema() != nullptr) {
-            eschema = std::make_shared<ResultSchemaProvider>(resp.edge_schema);
+        DCHECK(vdata.__isset.edge_data);
+        DCHECK(eschema != nullptr);
+        RowSetReader rsReader(eschema, vdata.edge_data);
+        if (compiled != nullptr) {
+            auto status = processCompiled(*compiled, vdata.get_vertex_id(), vreader.get(),
+                                          rsReader, cb);
+            if (!status.ok()) {
+                return status;
+            }
+            continue;
         }
+        auto iter = rsReader.begin();
+        // The getters refer to `iter', so they are bound once for all the edges
+        auto &getters = expCtx_->getters();
+        getters.getAliasProp = [&](const std::string &,
+                                   const std::string &prop) -> OptVariantType {
+            auto res = RowReader::getPropByName(&*iter, prop);
+            if (ok(res)) {
+                return value(res);
+            }
+            return Status::Error("get edge prop failed");
+        };
+        getters.getSrcTagProp = [&](const std::string &tagName,
+                                    const std::string &prop) -> OptVariantType {
+            auto tagIter = this->srcTagProps_.find(std::make_pair(tagName, prop));
+            if (tagIter == this->srcTagProps_.end()) {
+                auto msg = folly::sformat(
+                    "Src tagName : {} , propName : {} is not exist", tagName, prop);
+                LOG(ERROR) << msg;
+                return Status::Error(msg);
+            }
+            auto index = tagIter->second;
+            const nebula::cpp2::ValueType &type = vschema->getFieldType(index);
+            if (type == CommonConstants::kInvalidValueType()) {
+                auto msg =
+                    folly::sformat("Tag: {} no schema for the index {}", tagName, index);
+                LOG(ERROR) << msg;
+                return Status::Error(msg);
+            }
+            auto res = RowReader::getPropByIndex(vreader.get(), index);
+            if (ok(res)) {
+                return value(std::move(res));
+            }
+            return Status::Error(folly::sformat("{}.{} was not exist", tagName, prop));
+        };
+        getters.getDstTagProp = [&](const std::string &tagName,
+                                    const std::string &prop) -> OptVariantType {
+            auto res = RowReader::getPropByName(&*iter, "_dst");
+            CHECK(ok(res));
+            auto dst = value(std::move(res));
+            auto tagIter = this->dstTagProps_.find(std::make_pair(tagName, prop));
+            if (tagIter == this->dstTagProps_.end()) {
+                auto msg = folly::sformat(
+                    "Src tagName : {} , propName : {} is not exist", tagName, prop);
+                LOG(ERROR) << msg;
+                return Status::Error(msg);
+            }
+            auto index = tagIter->second;
+            return vertexHolder_->get(boost::get<int64_t>(dst), index);
+        };
+        getters.getVariableProp = [&] (const std::string &prop) {
+            return getPropFromInterim(vdata.get_vertex_id(), prop);
+        };
+        getters.getInputProp = [&] (const std::string &prop) {
+            return getPropFromInterim(vdata.get_vertex_id(), prop);
+        };
+        while (iter) {
+            // Evaluate filter
+            if (filter_ != nullptr) {
+                auto value = filter_->eval();
+                if (!value.ok()) {
+                    return value.status();
+                }
+                if (!Expression::asBool(value.value())) {
+                    ++iter;
+                    continue;
+                }
+            }
+            std::vector<VariantType> record;
+            record.reserve(yields_.size());
+            for (auto *column : yields_) {
+                auto *expr = column->expr();
+                auto value = expr->eval();
+                if (!value.ok()) {
+                    return value.status();
+                }
+                record.emplace_back(std::move(value.value()));
+            }
+            cb(std::move(record));
+            ++iter;
+        }   // while `iter'
+    }   // for `vdata'
+    return Status::OK();
+}
 
-        for (auto &vdata : resp.vertices) {
-            std::unique_ptr<RowReader> vreader;
-            // TODO(simon.liu) In issue #192, I will solve this problem for better.
-            if (!resp.__isset.vertices || resp.get_vertices() == nullptr) {
-                continue;
+
+std::unique_ptr<GoExecutor::CompiledExprs>
+GoExecutor::compileExprs(const meta::SchemaProviderIf *eschema,
+                         const meta::SchemaProviderIf *vschema) const {
+    auto compiled = std::make_unique<CompiledExprs>();
+    auto resolver = [&] (const Expression *expr) {
+        return resolveSlot(expr, eschema, vschema);
+    };
+    if (filter_ != nullptr) {
+        auto result = CompiledExpression::compile(filter_, resolver);
+        if (!result.ok()) {
+            VLOG(2) << "Evaluate the filter directly: " << result.status();
+            return nullptr;
+        }
+        compiled->filter = std::move(result).value();
+    }
+    for (auto *column : yields_) {
+        auto result = CompiledExpression::compile(column->expr(), resolver);
+        if (!result.ok()) {
+            VLOG(2) << "Evaluate the yield columns directly: " << result.status();
+            return nullptr;
+        }
+        compiled->yields.emplace_back(std::move(result).value());
+    }
+    if (expCtx_->hasDstTagProp()) {
+        compiled->dstIndex = eschema->getFieldIndex("_dst");
+        if (compiled->dstIndex == -1) {
+            return nullptr;
+        }
+    }
+    return compiled;
+}
+
+
+StatusOr<CompiledExpression::Slot>
+GoExecutor::resolveSlot(const Expression *expr,
+                        const meta::SchemaProviderIf *eschema,
+                        const meta::SchemaProviderIf *vschema) const {
+    CompiledExpression::Slot slot;
+    const meta::SchemaProviderIf *schema = nullptr;
+    switch (expr->kind()) {
+        case Expression::kAliasProp:
+        case Expression::kEdgeDstId:
+        case Expression::kEdgeSrcId:
+        case Expression::kEdgeRank: {
+            auto *prop = static_cast<const AliasPropertyExpression*>(expr)->prop();
+            slot.source = kEdgeSlot;
+            slot.index = eschema->getFieldIndex(*prop);
+            schema = eschema;
+            break;
+        }
+        case Expression::kSourceProp: {
+            auto *aliasProp = static_cast<const AliasPropertyExpression*>(expr);
+            auto iter = srcTagProps_.find(std::make_pair(*aliasProp->alias(), *aliasProp->prop()));
+            if (iter == srcTagProps_.end()) {
+                break;
+            }
+            slot.source = kSrcSlot;
+            slot.index = iter->second;
+            schema = vschema;
+            break;
+        }
+        case Expression::kDestProp: {
+            auto *aliasProp = static_cast<const AliasPropertyExpression*>(expr);
+            auto iter = dstTagProps_.find(std::make_pair(*aliasProp->alias(), *aliasProp->prop()));
+            if (iter == dstTagProps_.end() || vertexHolder_ == nullptr) {
+                break;
             }
+            slot.source = kDstSlot;
+            slot.index = iter->second;
+            schema = vertexHolder_->schema();
+            break;
+        }
+        case Expression::kInputProp:
+        case Expression::kVariableProp: {
+            if (index_ == nullptr) {
+                break;
+            }
+            auto *prop = static_cast<const AliasPropertyExpression*>(expr)->prop();
+            auto index = index_->getColumnIndex(*prop);
+            if (index == -1) {
+                break;
+            }
+            auto type = RowSlotReader::toSlotType(index_->getColumnType(index));
+            if (!type.ok()) {
+                return type.status();
+            }
+            slot.source = kInputSlot;
+            slot.index = index;
+            slot.type = type.value();
+            return slot;
+        }
+        default:
+            break;
+    }
+    if (schema == nullptr || slot.index < 0) {
+        return Status::Error("Could not resolve `%s'", expr->toString().c_str());
+    }
+    auto type = RowSlotReader::toSlotType(schema->getFieldType(slot.index).get_type());
+    if (!type.ok()) {
+        return type.status();
+    }
+    slot.type = type.value();
+    return slot;
+}
 
-            if (vschema != nullptr) {
-                DCHECK(vdata.__isset.vertex_data);
-                vreader = RowReader::getRowReader(vdata.vertex_data, vschema);
-            }
-            DCHECK(vdata.__isset.edge_data);
-            DCHECK(eschema != nullptr);
-            RowSetReader rsReader(eschema, vdata.edge_data);
-            auto iter = rsReader.begin();
-            while (iter) {
-                auto &getters = expCtx_->getters();
-                getters.getAliasProp = [&](const std::string &,
-                                           const std::string &prop) -> OptVariantType {
-                    auto res = RowReader::getPropByName(&*iter, prop);
-                    if (ok(res)) {
-                        return value(res);
-                    }
-                    return Status::Error("get edge prop failed");
-                };
-                getters.getSrcTagProp = [&](const std::string &tagName,
-                                            const std::string &prop) -> OptVariantType {
-                    auto tagIter = this->srcTagProps_.find(std::make_pair(tagName, prop));
-                    if (tagIter == this->srcTagProps_.end()) {
-                        auto msg = folly::sformat(
-                            "Src tagName : {} , propName : {} is not exist", tagName, prop);
-                        LOG(ERROR) << msg;
-                        return Status::Error(msg);
-                    }
-                    auto index = tagIter->second;
-                    const nebula::cpp2::ValueType &type = vschema->getFieldType(index);
-                    if (type == CommonConstants::kInvalidValueType()) {
-                        auto msg =
-                            folly::sformat("Tag: {} no schema for the index {}", tagName, index);
-                        LOG(ERROR) << msg;
-                        return Status::Error(msg);
-                    }
-                    auto res = RowReader::getPropByIndex(vreader.get(), index);
-                    if (ok(res)) {
-                        return value(std::move(res));
-                    }
-                    return Status::Error(folly::sformat("{}.{} was not exist", tagName, prop));
-                };
-                getters.getDstTagProp = [&](const std::string &tagName,
-                                            const std::string &prop) -> OptVariantType {
-                    auto res = RowReader::getPropByName(&*iter, "_dst");
-                    CHECK(ok(res));
-                    auto dst = value(std::move(res));
-                    auto tagIter = this->dstTagProps_.find(std::make_pair(tagName, prop));
-                    if (tagIter == this->dstTagProps_.end()) {
-                        auto msg = folly::sformat(
-                            "Src tagName : {} , propName : {} is not exist", tagName, prop);
-                        LOG(ERROR) << msg;
-                        return Status::Error(msg);
-                    }
-                    auto index = tagIter->second;
-                    return vertexHolder_->get(boost::get<int64_t>(dst), index);
-                };
-                getters.getVariableProp = [&] (const std::string &prop) {
-                    return getPropFromInterim(vdata.get_vertex_id(), prop);
-                };
-                getters.getInputProp = [&] (const std::string &prop) {
-                    return getPropFromInterim(vdata.get_vertex_id(), prop);
-                };
-                // Evaluate filter
-                if (filter_ != nullptr) {
-                    auto value = filter_->eval();
-                    if (!value.ok()) {
-                        onError_(value.status());
-                        return false;
-                    }
-                    if (!Expression::asBool(value.value())) {
-                        ++iter;
-                        continue;
-                    }
+
+Status GoExecutor::processCompiled(const CompiledExprs &compiled,
+                                   VertexID vid,
+                                   const RowReader *vreader,
+                                   const RowSetReader &rsReader,
+                                   Callback &cb) const {
+    RowSlotReader edgeReader;
+    RowSlotReader srcReader;
+    RowSlotReader dstReader;
+    VariantRowReader inputReader;
+    const CompiledExpression::Reader *readers[kNumSlotSources] = {
+        &edgeReader, &srcReader, &dstReader, &inputReader,
+    };
+    srcReader.reset(vreader);
+    if (index_ != nullptr) {
+        auto rootId = vid;
+        if (backTracker_ != nullptr) {
+            rootId = backTracker_->get(vid);
+        }
+        inputReader.reset(index_->getRowWithVID(rootId));
+    }
+    std::unique_ptr<RowReader> dstRow;
+    auto setupRow = [&] (const RowReader &row) {
+        edgeReader.reset(&row);
+        if (compiled.dstIndex != -1) {
+            auto res = RowReader::getPropByIndex(&row, compiled.dstIndex);
+            CHECK(ok(res));
+            dstRow = vertexHolder_->getReader(boost::get<int64_t>(value(std::move(res))));
+            dstReader.reset(dstRow.get());
+        }
+    };
+
+    // Why the batch being evaluated failed
+    Status status;
+    // Filter the edges batch by batch, and select the matched ones
+    std::vector<uint32_t> selected;
+    if (compiled.filter != nullptr) {
+        CompiledExpression::Batch batch;
+        uint32_t first = 0;
+        auto filter = [&] () {
+            compiled.filter->evalBatch(batch);
+            for (auto i = 0UL; i < batch.size(); i++) {
+                if (batch.failed(i)) {
+                    status = batch.error();
+                    return false;
                 }
-                std::vector<VariantType> record;
-                record.reserve(yields_.size());
-                for (auto *column : yields_) {
-                    auto *expr = column->expr();
-                    auto value = expr->eval();
-                    if (!value.ok()) {
-                        onError_(value.status());
-                        return false;
-                    }
-                    record.emplace_back(std::move(value.value()));
+                if (CompiledExpression::asBool(batch.result(i))) {
+                    selected.emplace_back(first + i);
                 }
-                cb(std::move(record));
-                ++iter;
-            }   // while `iter'
-        }   // for `vdata'
-    }   // for `resp'
-    return true;
+            }
+            first += batch.size();
+            batch.clear();
+            return true;
+        };
+        for (auto iter = rsReader.begin(); iter; ++iter) {
+            setupRow(*iter);
+            compiled.filter->appendRow(readers, batch);
+            if (batch.size() == CompiledExpression::kBatchSize && !filter()) {
+                return status;
+            }
+        }
+        if (batch.size() > 0 && !filter()) {
+            return status;
+        }
+        if (selected.empty()) {
+            return Status::OK();
+        }
+    }
+
+    // Evaluate the yields on the selected edges, batch by batch as well
+    std::vector<CompiledExpression::Batch> batches(compiled.yields.size());
+    size_t numRows = 0;
+    auto yield = [&] () {
+        for (auto i = 0UL; i < batches.size(); i++) {
+            compiled.yields[i]->evalBatch(batches[i]);
+        }
+        for (auto row = 0UL; row < numRows; row++) {
+            std::vector<VariantType> record;
+            record.reserve(batches.size());
+            for (auto &batch : batches) {
+                if (batch.failed(row)) {
+                    status = batch.error();
+                    return false;
+                }
+                record.emplace_back(CompiledExpression::toVariant(batch.result(row)));
+            }
+            cb(std::move(record));
+        }
+        for (auto &batch : batches) {
+            batch.clear();
+        }
+        numRows = 0;
+        return true;
+    };
+    auto next = selected.begin();
+    uint32_t index = 0;
+    for (auto iter = rsReader.begin(); iter; ++iter, ++index) {
+        if (compiled.filter != nullptr) {
+            if (next == selected.end()) {
+                break;
+            }
+            if (*next != index) {
+                continue;
+            }
+            ++next;
+        }
+        setupRow(*iter);
+        for (auto i = 0UL; i < batches.size(); i++) {
+            compiled.yields[i]->appendRow(readers, batches[i]);
+        }
+        if (++numRows == CompiledExpression::kBatchSize && !yield()) {
+            return status;
+        }
+    }
+    if (numRows > 0 && !yield()) {
+        return status;
+    }
+    return Status::OK();
 }
 
 
-OptVariantType GoExecutor::VertexHolder::get(VertexID id, int64_t index) const {
+std::unique_ptr<RowReader> GoExecutor::VertexHolder::getReader(VertexID id) const {
     DCHECK(schema_ != nullptr);
     auto iter = data_.find(id);
-
     if (iter == data_.end()) {
-        return Status::Error("vertex was not found %ld", id);
+        return nullptr;
     }
+    return RowReader::getRowReader(iter->second, schema_);
+}
+
 
-    auto reader = RowReader::getRowReader(iter->second, schema_);
+OptVariantType GoExecutor::VertexHolder::get(VertexID id, int64_t index) const {
+    auto reader = getReader(id);
+    if (reader == nullptr) {
+        return Status::Error("vertex was not found %ld", id);
+    }
 
     auto res = RowReader::getPropByIndex(reader.get(), index);
     if (!ok(res)) {
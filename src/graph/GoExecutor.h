@@ -9,7 +9,10 @@
 
 #include "base/Base.h"
 #include "graph/TraverseExecutor.h"
+#include "graph/VertexSet.h"
 #include "storage/client/StorageClient.h"
+#include "filter/CompiledExpression.h"
+#include "dataman/RowSetReader.h"
 
 namespace nebula {
 
@@ -35,6 +38,11 @@ public:
 
     void feedResult(std::unique_ptr<InterimResult> result) override;
 
+    // The ids to step out from are collected, and indexed, batch by batch
+    bool acceptsBatches() const override {
+        return true;
+    }
+
     void setupResponse(cpp2::ExecutionResponse &resp) override;
 
 private:
@@ -58,10 +66,10 @@ private:
     Status prepareDistinct();
 
     /**
-     * To check if this is the final step.
+     * To check if `step' is the final step.
      */
-    bool isFinalStep() const {
-        return curStep_ == steps_;
+    bool isFinalStep(uint32_t step) const {
+        return step == steps_;
     }
 
     /**
@@ -87,30 +95,60 @@ private:
     Status setupStarts();
 
     /**
-     * To step out for one step.
+     * To prepare the props to return in stepping out, once for all the steps.
+     */
+    Status prepareStepOut();
+
+    /**
+     * To step out from `ids' at step `step'.
+     * The response of each storage host is processed as soon as it arrives,
+     * i.e. the next step is taken from its dst ids, or its results are emitted at the final step,
+     * without waiting for the other hosts.
+     * `ongoing_' should have been increased by the caller.
+     */
+    void stepOut(uint32_t step, std::vector<VertexID> ids);
+
+    /**
+     * Callback invoked upon the response of one host arrives.
      */
-    void stepOut();
+    void onStepOutResponse(uint32_t step, storage::cpp2::QueryResponse &&resp);
 
-    using RpcResponse = storage::StorageRpcResponse<storage::cpp2::QueryResponse>;
     /**
-     * Callback invoked upon the response of stepping out arrives.
+     * Callback invoked upon a response of the final step arrives, with the dst props fetched.
      */
-    void onStepOutResponse(RpcResponse &&rpcResp);
+    void onFinalStepResponse(const storage::cpp2::QueryResponse &resp);
 
     /**
      * Callback invoked when the stepping out action reaches the dead end.
      */
     void onEmptyInputs();
 
+    StatusOr<std::vector<storage::cpp2::PropDef>> getStepOutProps(bool isFinal);
+    StatusOr<std::vector<storage::cpp2::PropDef>> getDstProps();
+
+    void fetchVertexProps(std::vector<VertexID> ids, storage::cpp2::QueryResponse &&resp);
+
     /**
-     * Callback invoked upon the response of retrieving terminal vertex arrives.
+     * To track the requests and responses in flight,
+     * the execution finishes once none is left.
      */
-    void onVertexProps(RpcResponse &&rpcResp);
+    void addOngoing();
+    void finishOngoing();
 
-    StatusOr<std::vector<storage::cpp2::PropDef>> getStepOutProps();
-    StatusOr<std::vector<storage::cpp2::PropDef>> getDstProps();
+    /**
+     * A request, or a response, of step `step' has been processed.
+     */
+    void finishStepWork(uint32_t step);
+
+    /**
+     * To fail if all the requests of any step failed, the steps partially done are logged.
+     */
+    Status checkCompleteness() const;
 
-    void fetchVertexProps(std::vector<VertexID> ids, RpcResponse &&rpcResp);
+    /**
+     * To keep the first error, which is reported once nothing is in flight.
+     */
+    void fail(Status status);
 
     /**
      * To retrieve or generate the column names for the execution result.
@@ -119,36 +157,60 @@ private:
 
     /**
      * To retrieve the dst ids from a stepping out response.
+     * Except at the final step, the ids already reached at the same step are skipped.
      */
-    std::vector<VertexID> getDstIdsFromResp(RpcResponse &rpcResp) const;
+    std::vector<VertexID> getDstIdsFromResp(const storage::cpp2::QueryResponse &resp,
+                                            uint32_t step);
 
     /**
      * All required data have arrived, finish the execution.
      */
-    void finishExecution(RpcResponse &&rpcResp);
+    void finishExecution();
 
     /**
-     * To setup an intermediate representation of the execution result,
+     * To setup an intermediate representation of the results of one response,
      * which is about to be piped to the next executor.
      */
-    bool setupInterimResult(RpcResponse &&rpcResp, std::unique_ptr<InterimResult> &result);
+    Status setupInterimResult(const storage::cpp2::QueryResponse &resp,
+                              std::unique_ptr<InterimResult> &result);
 
     /**
-     * To setup the header of the execution result, i.e. the column names.
+     * To iterate on the data of one final response, and evaluate the filter and yield columns.
+     * For each row that matches the filter, `cb' would be invoked.
      */
-    void setupResponseHeader(cpp2::ExecutionResponse &resp) const;
+    using Callback = std::function<void(std::vector<VariantType>)>;
+    Status processFinalResponse(const storage::cpp2::QueryResponse &resp, Callback &cb) const;
 
     /**
-     * To setup the body of the execution result.
+     * The filter and yield columns compiled against the schemas of one response.
      */
-    bool setupResponseBody(RpcResponse &rpcResp, cpp2::ExecutionResponse &resp) const;
+    struct CompiledExprs {
+        std::unique_ptr<CompiledExpression>                 filter;
+        std::vector<std::unique_ptr<CompiledExpression>>    yields;
+        // Index of `_dst' in the edge schema, to read the dst props, -1 if not needed
+        int64_t                                             dstIndex{-1};
+    };
 
     /**
-     * To iterate on the final data collection, and evaluate the filter and yield columns.
-     * For each row that matches the filter, `cb' would be invoked.
+     * To compile the filter and yield columns, nullptr if any of them could not be compiled,
+     * in which case we fall back to evaluating the expressions directly.
      */
-    using Callback = std::function<void(std::vector<VariantType>)>;
-    bool processFinalResult(RpcResponse &rpcResp, Callback cb) const;
+    std::unique_ptr<CompiledExprs> compileExprs(const meta::SchemaProviderIf *eschema,
+                                                const meta::SchemaProviderIf *vschema) const;
+
+    StatusOr<CompiledExpression::Slot> resolveSlot(const Expression *expr,
+                                                   const meta::SchemaProviderIf *eschema,
+                                                   const meta::SchemaProviderIf *vschema) const;
+
+    /**
+     * To evaluate the compiled expressions on the edges of one vertex, in batches.
+     * The filter is evaluated first, then the yield columns on the matched edges only.
+     */
+    Status processCompiled(const CompiledExprs &compiled,
+                           VertexID vid,
+                           const RowReader *vreader,
+                           const RowSetReader &rsReader,
+                           Callback &cb) const;
 
     /**
      * A container to hold the mapping from vertex id to its properties, used for lookups
@@ -157,6 +219,8 @@ private:
     class VertexHolder final {
     public:
         OptVariantType get(VertexID id, int64_t index) const;
+        // nullptr if `id' was not found
+        std::unique_ptr<RowReader> getReader(VertexID id) const;
         void add(const storage::cpp2::QueryResponse &resp);
         const auto* schema() const {
             return schema_.get();
@@ -171,25 +235,31 @@ private:
         std::unordered_map<VertexID, std::string>   data_;
     };
 
+    // Thread safe, since the responses of all hosts are tracked into it in parallel
     class VertexBackTracker final {
     public:
-        void add(VertexID src, VertexID dst) {
-            VertexID value = src;
-            auto iter = mapping_.find(src);
-            if (iter != mapping_.end()) {
-                value = iter->second;
+        // Map the dst of each edge to the root its src is reached from
+        void add(const std::vector<std::pair<VertexID, VertexID>> &edges) {
+            std::vector<VertexID> roots;
+            roots.reserve(edges.size());
+            for (auto &edge : edges) {
+                roots.emplace_back(edge.first);
+            }
+            mapping_.translate(roots);
+            std::vector<std::pair<VertexID, VertexID>> kvs;
+            kvs.reserve(edges.size());
+            for (auto i = 0UL; i < edges.size(); i++) {
+                kvs.emplace_back(edges[i].second, roots[i]);
             }
-            mapping_[dst] = value;
+            mapping_.set(kvs);
         }
 
-        VertexID get(VertexID id) {
-            auto iter = mapping_.find(id);
-            DCHECK(iter != mapping_.end());
-            return iter->second;
+        VertexID get(VertexID id) const {
+            return mapping_.translate(id);
         }
 
     private:
-         std::unordered_map<VertexID, VertexID>     mapping_;
+        ConcurrentVertexMap                         mapping_;
     };
 
     VariantType getPropFromInterim(VertexID id, const std::string &prop) const;
@@ -204,7 +274,6 @@ private:
     GoSentence                                 *sentence_{nullptr};
     FromType                                    fromType_{kInstantExpr};
     uint32_t                                    steps_{1};
-    uint32_t                                    curStep_{1};
     bool                                        upto_{false};
     bool                                        reversely_{false};
     EdgeType                                    edgeType_;
@@ -214,7 +283,9 @@ private:
     std::vector<YieldColumn*>                   yields_;
     bool                                        distinct_{false};
     bool                                        distinctPushDown_{false};
-    std::unique_ptr<InterimResult>              inputs_;
+    // Whether any inputs have been fed, and the first error with them
+    bool                                        fed_{false};
+    Status                                      inputStatus_;
     using InterimIndex = InterimResult::InterimResultIndex;
     std::unique_ptr<InterimIndex>               index_;
     std::unique_ptr<ExpressionContext>          expCtx_;
@@ -226,6 +297,33 @@ private:
     using SchemaPropIndex = std::unordered_map<std::pair<std::string, std::string>, int64_t>;
     SchemaPropIndex                              srcTagProps_;
     SchemaPropIndex                              dstTagProps_;
+    std::vector<storage::cpp2::PropDef>         stepOutProps_;
+    std::vector<storage::cpp2::PropDef>         finalStepOutProps_;
+    std::vector<storage::cpp2::PropDef>         dstProps_;
+    // To guard the members below, and those shared by the responses while processing,
+    // i.e. `vertexHolder_' and the getters of `expCtx_'
+    std::mutex                                  lock_;
+    uint32_t                                    ongoing_{0};
+    Status                                      status_;
+    bool                                        finalStepped_{false};
+    bool                                        emitted_{false};
+    // The dst ids reached at each step, so that each is stepped out from only once.
+    // The set of a step is created when the step is first sent out, and dropped
+    // once the step is done
+    std::vector<std::unique_ptr<ConcurrentVertexSet>> visited_;
+    struct StepState {
+        // Requests and responses of the step being processed
+        uint32_t                                pending{0};
+        bool                                    done{false};
+        // The storage requests sent, and failed, by the step as a whole
+        size_t                                  reqs{0};
+        size_t                                  failedReqs{0};
+    };
+    std::vector<StepState>                      stepStates_;
+    std::shared_ptr<SchemaWriter>               resultSchema_;
+    std::unordered_set<std::string>             uniqResult_;
+    // The results kept to respond to the client, if not piped
+    std::vector<std::unique_ptr<InterimResult>> outputs_;
 };
 
 }   // namespace graph
@@ -28,3 +28,65 @@ DEFINE_string(stderr_log_file, "graphd-stderr.log", "Destination filename of std
 DEFINE_bool(daemonize, true, "Whether run as a daemon process");
 DEFINE_string(meta_server_addrs, "", "list of meta server addresses,"
                                      "the format looks like ip1:port1, ip2:port2, ip3:port3");
+
+DEFINE_int32(plan_cache_capacity, 1024,
+             "The max number of parsed queries to cache, 0 to disable the cache");
+DEFINE_int32(max_prepared_statements_per_session, 256,
+             "The max number of prepared statements a session could hold");
+
+DEFINE_int32(set_op_concurrency, 4,
+             "The max number of worker tasks a set operation (INTERSECT, MINUS "
+             "or DISTINCT) could be split into");
+
+DEFINE_int64(order_by_memory_limit_bytes, 256 * 1024 * 1024,
+             "The max bytes of rows ORDER BY sorts in memory, "
+             "sorted runs are spilled to disk beyond that");
+DEFINE_int64(group_by_memory_limit_bytes, 256 * 1024 * 1024,
+             "The max bytes of groups GROUP BY keeps in memory, "
+             "partial results are spilled to disk beyond that");
+DEFINE_int32(group_by_concurrency, 4,
+             "The max number of worker tasks GROUP BY could aggregate a batch of rows with");
+DEFINE_string(spill_dir, "/tmp",
+              "The directory to spill the temporary data of ORDER BY and GROUP BY");
+
+DEFINE_string(storage_read_mode, "leader",
+              "The default mode of reading from storage for new sessions, "
+              "could be leader, read_index or bounded_staleness");
+DEFINE_int32(storage_max_staleness_ms, 1000,
+             "The max staleness of the replica in bounded_staleness read mode");
+
+DEFINE_int64(vertex_cache_capacity_bytes, 0,
+             "The max bytes of vertex props to cache across queries, 0 to disable the cache");
+DEFINE_int32(vertex_cache_ttl_ms, 1000,
+             "How long the cached vertex props are valid, "
+             "the writes through other graph daemons could be missed within it");
+
+DEFINE_int64(find_path_max_edges, 1000000,
+             "The max number of edges FIND PATH keeps while searching, "
+             "the query fails beyond that");
+DEFINE_int64(find_path_max_paths, 10000,
+             "The max number of paths FIND PATH returns, the query fails beyond that");
+
+DEFINE_int32(space_stats_ttl_secs, 600,
+             "How long the stats of a space gathered from the storage are used to plan "
+             "MATCH with, before gathered again, 0 to plan without the stats");
+DEFINE_int32(space_stats_timeout_ms, 60000,
+             "The time limit of gathering the stats of a space, regardless of the query "
+             "which starts the gathering");
+DEFINE_int32(space_stats_retry_secs, 10,
+             "How long to wait before gathering the stats of a space again after a failure, "
+             "doubled on each failure in a row, up to space_stats_ttl_secs");
+DEFINE_int64(match_max_rows, 1000000,
+             "The max number of rows MATCH keeps while matching, the query fails beyond that");
+
+DEFINE_int64(query_timeout_ms, 0,
+             "The default timeout of the queries of a session, 0 for no limit");
+DEFINE_int64(query_memory_limit_bytes, 0,
+             "The default max bytes of the results a query of a session keeps, "
+             "the query fails beyond that, 0 for no limit");
+DEFINE_int64(query_memory_soft_limit_bytes, 0,
+             "Beyond this many bytes kept by a query, ORDER BY and GROUP BY spill to disk "
+             "earlier than their own memory limits, 0 for no limit");
+DEFINE_int64(session_memory_limit_bytes, 0,
+             "The max bytes of the results all the running queries of a session keep, "
+             "a query fails beyond that, 0 for no limit");
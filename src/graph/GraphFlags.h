@@ -27,5 +27,34 @@ DECLARE_string(stderr_log_file);
 DECLARE_bool(daemonize);
 DECLARE_string(meta_server_addrs);
 
+DECLARE_int32(plan_cache_capacity);
+DECLARE_int32(max_prepared_statements_per_session);
+
+DECLARE_int32(set_op_concurrency);
+
+DECLARE_int64(order_by_memory_limit_bytes);
+DECLARE_int64(group_by_memory_limit_bytes);
+DECLARE_int32(group_by_concurrency);
+DECLARE_string(spill_dir);
+
+DECLARE_string(storage_read_mode);
+DECLARE_int32(storage_max_staleness_ms);
+
+DECLARE_int64(vertex_cache_capacity_bytes);
+DECLARE_int32(vertex_cache_ttl_ms);
+
+DECLARE_int64(find_path_max_edges);
+DECLARE_int64(find_path_max_paths);
+
+DECLARE_int32(space_stats_ttl_secs);
+DECLARE_int32(space_stats_timeout_ms);
+DECLARE_int32(space_stats_retry_secs);
+DECLARE_int64(match_max_rows);
+
+DECLARE_int64(query_timeout_ms);
+DECLARE_int64(query_memory_limit_bytes);
+DECLARE_int64(query_memory_soft_limit_bytes);
+DECLARE_int64(session_memory_limit_bytes);
+
 
 #endif  // GRAPH_GRAPHFLAGS_H_
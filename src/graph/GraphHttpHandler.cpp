@@ -5,6 +5,9 @@
  */
 
 #include "graph/GraphHttpHandler.h"
+#include "graph/PlanCache.h"
+#include "graph/VertexCache.h"
+#include "graph/MemoryTracker.h"
 #include "webservice/Common.h"
 #include <proxygen/httpserver/RequestHandler.h>
 #include <proxygen/lib/http/ProxygenErrorEnum.h>
@@ -99,6 +102,28 @@ std::string GraphHttpHandler::readValue(std::string& statusName) {
     folly::toLowerAscii(statusName);
     if (statusName == "status") {
         return "running";
+    } else if (statusName == "plan_cache_hits") {
+        // The plan cache statistics are only returned when asked by name
+        return folly::to<std::string>(PlanCache::stats().hits);
+    } else if (statusName == "plan_cache_misses") {
+        return folly::to<std::string>(PlanCache::stats().misses);
+    } else if (statusName == "plan_cache_hit_rate") {
+        auto stats = PlanCache::stats();
+        auto total = stats.hits + stats.misses;
+        return folly::stringPrintf("%.2f", total == 0 ? 0.0 : 100.0 * stats.hits / total);
+    } else if (statusName == "vertex_cache_hit_rate") {
+        auto stats = VertexCache::stats();
+        auto total = stats.hits + stats.misses;
+        return folly::stringPrintf("%.2f", total == 0 ? 0.0 : 100.0 * stats.hits / total);
+    } else if (statusName == "vertex_cache_evictions") {
+        return folly::to<std::string>(VertexCache::stats().evictions);
+    } else if (statusName == "query_memory_bytes") {
+        // Kept by the running queries of all the sessions
+        return folly::to<std::string>(MemoryTracker::stats().used);
+    } else if (statusName == "query_memory_peak_bytes") {
+        return folly::to<std::string>(MemoryTracker::stats().peak);
+    } else if (statusName == "query_memory_exceeded") {
+        return folly::to<std::string>(MemoryTracker::stats().exceeded);
     } else {
         return "unknown";
     }
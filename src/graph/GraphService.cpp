@@ -14,6 +14,45 @@
 namespace nebula {
 namespace graph {
 
+namespace {
+
+StatusOr<std::vector<VariantType>> toParameters(const std::vector<cpp2::ColumnValue>& params) {
+    std::vector<VariantType> values;
+    values.reserve(params.size());
+    for (auto i = 0UL; i < params.size(); i++) {
+        auto &param = params[i];
+        switch (param.getType()) {
+            case cpp2::ColumnValue::Type::bool_val:
+                values.emplace_back(param.get_bool_val());
+                break;
+            case cpp2::ColumnValue::Type::integer:
+                values.emplace_back(param.get_integer());
+                break;
+            case cpp2::ColumnValue::Type::id:
+                values.emplace_back(param.get_id());
+                break;
+            case cpp2::ColumnValue::Type::timestamp:
+                values.emplace_back(param.get_timestamp());
+                break;
+            case cpp2::ColumnValue::Type::single_precision:
+                values.emplace_back(static_cast<double>(param.get_single_precision()));
+                break;
+            case cpp2::ColumnValue::Type::double_precision:
+                values.emplace_back(param.get_double_precision());
+                break;
+            case cpp2::ColumnValue::Type::str:
+                values.emplace_back(param.get_str());
+                break;
+            default:
+                return Status::Error("Unsupported type of parameter `$%lu'", i + 1);
+        }
+    }
+    return values;
+}
+
+}  // Anonymous namespace
+
+
 GraphService::GraphService() {
 }
 
@@ -84,6 +123,77 @@ GraphService::future_execute(int64_t sessionId, const std::string& query) {
 }
 
 
+folly::Future<cpp2::PrepareResponse>
+GraphService::future_prepare(int64_t sessionId, const std::string& stmt) {
+    auto ctx = std::make_unique<RequestContext<cpp2::PrepareResponse>>();
+    ctx->setQuery(stmt);
+    auto future = ctx->future();
+    {
+        auto result = sessionManager_->findSession(sessionId);
+        if (!result.ok()) {
+            FLOG_ERROR("Session not found, id[%ld]", sessionId);
+            ctx->resp().set_error_code(cpp2::ErrorCode::E_SESSION_INVALID);
+            ctx->resp().set_error_msg(result.status().toString());
+            ctx->finish();
+            return future;
+        }
+        ctx->setSession(std::move(result).value());
+    }
+    executionEngine_->prepare(std::move(ctx));
+
+    return future;
+}
+
+
+folly::Future<cpp2::ExecutionResponse>
+GraphService::future_executePrepared(int64_t sessionId,
+                                     int64_t statementId,
+                                     const std::vector<cpp2::ColumnValue>& params) {
+    auto ctx = std::make_unique<RequestContext<cpp2::ExecutionResponse>>();
+    ctx->setRunner(getThreadManager());
+    auto future = ctx->future();
+    do {
+        auto result = sessionManager_->findSession(sessionId);
+        if (!result.ok()) {
+            FLOG_ERROR("Session not found, id[%ld]", sessionId);
+            ctx->resp().set_error_code(cpp2::ErrorCode::E_SESSION_INVALID);
+            ctx->resp().set_error_msg(result.status().toString());
+            break;
+        }
+        auto session = std::move(result).value();
+        auto stmt = session->findStatement(statementId);
+        if (!stmt.ok()) {
+            ctx->resp().set_error_code(cpp2::ErrorCode::E_STATEMENT_NOT_FOUND);
+            ctx->resp().set_error_msg(stmt.status().toString());
+            break;
+        }
+        auto values = toParameters(params);
+        if (!values.ok()) {
+            ctx->resp().set_error_code(cpp2::ErrorCode::E_EXECUTION_ERROR);
+            ctx->resp().set_error_msg(values.status().toString());
+            break;
+        }
+        ctx->setQuery(std::move(stmt).value());
+        ctx->setParameters(std::move(values).value());
+        ctx->setSession(std::move(session));
+        executionEngine_->execute(std::move(ctx));
+        return future;
+    } while (false);
+
+    ctx->finish();
+    return future;
+}
+
+
+void GraphService::unprepare(int64_t sessionId, int64_t statementId) {
+    VLOG(2) << "Remove statement " << statementId << " from session " << sessionId;
+    auto result = sessionManager_->findSession(sessionId);
+    if (result.ok()) {
+        result.value()->removeStatement(statementId);
+    }
+}
+
+
 const char* GraphService::getErrorStr(cpp2::ErrorCode result) {
     switch (result) {
     case cpp2::ErrorCode::SUCCEEDED:
@@ -99,6 +209,8 @@ const char* GraphService::getErrorStr(cpp2::ErrorCode result) {
         return "The session timed out";
     case cpp2::ErrorCode::E_SYNTAX_ERROR:
         return "Syntax error";
+    case cpp2::ErrorCode::E_STATEMENT_NOT_FOUND:
+        return "The prepared statement does not exist";
     /**********************
      * Unknown error
      **********************/
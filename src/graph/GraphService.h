@@ -36,6 +36,16 @@ public:
     folly::Future<cpp2::ExecutionResponse>
     future_execute(int64_t sessionId, const std::string& stmt) override;
 
+    folly::Future<cpp2::PrepareResponse>
+    future_prepare(int64_t sessionId, const std::string& stmt) override;
+
+    folly::Future<cpp2::ExecutionResponse>
+    future_executePrepared(int64_t sessionId,
+                           int64_t statementId,
+                           const std::vector<cpp2::ColumnValue>& params) override;
+
+    void unprepare(int64_t sessionId, int64_t statementId) override;
+
     const char* getErrorStr(cpp2::ErrorCode result);
 
 private:
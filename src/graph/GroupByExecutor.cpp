@@ -0,0 +1,286 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/GroupByExecutor.h"
+#include "graph/GraphFlags.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+cpp2::ColumnValue toColumn(const VariantType &value) {
+    cpp2::ColumnValue col;
+    switch (value.which()) {
+        case VAR_INT64:
+            col.set_integer(boost::get<int64_t>(value));
+            break;
+        case VAR_DOUBLE:
+            col.set_double_precision(boost::get<double>(value));
+            break;
+        case VAR_BOOL:
+            col.set_bool_val(boost::get<bool>(value));
+            break;
+        case VAR_STR:
+            col.set_str(boost::get<std::string>(value));
+            break;
+        default:
+            LOG(FATAL) << "Unknown VariantType: " << value.which();
+    }
+    return col;
+}
+
+}   // Anonymous namespace
+
+
+GroupByExecutor::GroupByExecutor(Sentence *sentence, ExecutionContext *ectx)
+    : TraverseExecutor(ectx)
+    , pending_(folly::makeFuture(Status::OK())) {
+    sentence_ = static_cast<GroupBySentence*>(sentence);
+}
+
+
+Status GroupByExecutor::prepare() {
+    expCtx_ = std::make_unique<ExpressionContext>();
+    for (auto *key : sentence_->keys()) {
+        auto *expr = static_cast<InputPropertyExpression*>(key->expr());
+        keys_.emplace_back(*expr->prop());
+    }
+
+    std::vector<HashAggregator::Column> columns;
+    for (auto *col : sentence_->columns()) {
+        auto *expr = col->expr();
+        HashAggregator::Column column;
+        std::string colName;
+        if (expr->kind() == Expression::kInputProp) {
+            auto &prop = *static_cast<InputPropertyExpression*>(expr)->prop();
+            auto iter = std::find(keys_.begin(), keys_.end(), prop);
+            if (iter == keys_.end()) {
+                return Status::Error("`%s' is neither a group key nor aggregated",
+                                     expr->toString().c_str());
+            }
+            column.fun = HashAggregator::Function::KEY;
+            column.index = iter - keys_.begin();
+            colName = expr->toString();
+        } else if (expr->kind() == Expression::kFunctionCall) {
+            auto *call = static_cast<FunctionCallExpression*>(expr);
+            auto fun = HashAggregator::toFunction(*call->name());
+            if (!fun.ok()) {
+                return fun.status();
+            }
+            column.fun = fun.value();
+            auto &args = call->args();
+            if (call->isStar() && column.fun == HashAggregator::Function::COUNT) {
+                column.fun = HashAggregator::Function::COUNT_ALL;
+                column.index = 0;
+                colName = expr->toString();
+            } else if (call->isStar() || args.size() != 1) {
+                return Status::Error("`%s' takes exactly one argument", call->name()->c_str());
+            } else {
+                auto *arg = args.front().get();
+                arg->setContext(expCtx_.get());
+                auto status = arg->prepare();
+                if (!status.ok()) {
+                    return status;
+                }
+                column.index = keys_.size() + args_.size();
+                args_.emplace_back(arg);
+                colName = expr->toString();
+            }
+        } else {
+            return Status::Error("`%s' is neither a group key nor aggregated",
+                                 expr->toString().c_str());
+        }
+        if (col->alias() != nullptr) {
+            colName = *col->alias();
+        }
+        resultColNames_.emplace_back(std::move(colName));
+        columns.emplace_back(column);
+    }
+
+    if (expCtx_->hasSrcTagProp() || expCtx_->hasDstTagProp() || expCtx_->hasEdgeProp()
+            || expCtx_->hasVariableProp()) {
+        return Status::Error("Only the input properties could be aggregated");
+    }
+
+    aggregator_ = std::make_unique<HashAggregator>(keys_.size(),
+                                                   std::move(columns),
+                                                   FLAGS_group_by_concurrency,
+                                                   runner(),
+                                                   FLAGS_group_by_memory_limit_bytes,
+                                                   FLAGS_spill_dir,
+                                                   ectx()->memory());
+    return Status::OK();
+}
+
+
+void GroupByExecutor::feedResult(std::unique_ptr<InterimResult> result) {
+    if (result == nullptr) {
+        return;
+    }
+    // Aggregate the inputs one by one, in the order they arrive
+    std::shared_ptr<InterimResult> input = std::move(result);
+    pending_ = std::move(pending_).via(runner()).thenValue(
+        [this, input] (Status status) -> folly::Future<Status> {
+            if (!status.ok()) {
+                return folly::makeFuture(std::move(status));
+            }
+            auto rows = toAggregateInput(*input);
+            if (!rows.ok()) {
+                return folly::makeFuture(rows.status());
+            }
+            return aggregator_->add(std::move(rows).value());
+        });
+}
+
+
+StatusOr<std::vector<cpp2::RowValue>>
+GroupByExecutor::toAggregateInput(const InterimResult &result) {
+    auto schema = result.schema();
+    std::vector<int64_t> keyIndexes;
+    for (auto &key : keys_) {
+        auto index = schema->getFieldIndex(key);
+        if (index == -1) {
+            return Status::Error("Field `%s' not exist in input", key.c_str());
+        }
+        keyIndexes.emplace_back(index);
+    }
+
+    auto batch = result.batch();
+    std::vector<cpp2::RowValue> rows;
+    if (batch == nullptr) {
+        return rows;
+    }
+    // Only the columns referred to are read from the batch, rather than whole rows
+    size_t current = 0;
+    auto &getters = expCtx_->getters();
+    getters.getInputProp = [&] (const std::string &prop) -> OptVariantType {
+        auto index = schema->getFieldIndex(prop);
+        if (index == -1) {
+            return Status::Error("Field `%s' not exist in input", prop.c_str());
+        }
+        return batch->column(index).getVariant(current);
+    };
+
+    Status status;
+    rows.reserve(batch->numRows());
+    for (current = 0; current < batch->numRows(); current++) {
+        std::vector<cpp2::ColumnValue> columns;
+        columns.reserve(keyIndexes.size() + args_.size());
+        for (auto index : keyIndexes) {
+            columns.emplace_back(batch->column(index).getColumnValue(current));
+        }
+        for (auto *arg : args_) {
+            auto value = arg->eval();
+            if (!value.ok()) {
+                status = value.status();
+                break;
+            }
+            columns.emplace_back(toColumn(value.value()));
+        }
+        if (!status.ok()) {
+            break;
+        }
+        rows.emplace_back();
+        rows.back().set_columns(std::move(columns));
+    }
+    getters.getInputProp = nullptr;
+    if (!status.ok()) {
+        return status;
+    }
+    return rows;
+}
+
+
+void GroupByExecutor::execute() {
+    FLOG_INFO("Executing Group By: %s", sentence_->toString().c_str());
+    auto cb = [this] (Status status) {
+        if (status.ok()) {
+            status = aggregator_->finish([this] (cpp2::RowValue &row) {
+                addOutput(row);
+            });
+        }
+        if (!status.ok()) {
+            DCHECK(onError_);
+            onError_(std::move(status));
+            return;
+        }
+
+        if (onResult_ && builder_ != nullptr) {
+            onResult_(std::make_unique<InterimResult>(std::move(outputSchema_),
+                                                      builder_->finish()));
+        }
+        DCHECK(onFinish_);
+        onFinish_();
+    };
+
+    auto error = [this] (auto &&e) {
+        LOG(ERROR) << "Exception caught: " << e.what();
+        DCHECK(onError_);
+        onError_(Status::Error("Internal error"));
+    };
+
+    std::move(pending_).via(runner()).thenValue(cb).thenError(error);
+}
+
+
+void GroupByExecutor::addOutput(cpp2::RowValue &row) {
+    if (!onResult_) {
+        rows_.emplace_back(std::move(row));
+        return;
+    }
+    // The groups are put into columns as they come out of the aggregator
+    if (builder_ == nullptr) {
+        outputSchema_ = setupSchema(row.get_columns());
+        if (outputSchema_ == nullptr) {
+            return;
+        }
+        builder_ = std::make_unique<ColumnBatch::Builder>(outputSchema_);
+    }
+    builder_->append(row.get_columns());
+}
+
+
+std::shared_ptr<const meta::SchemaProviderIf>
+GroupByExecutor::setupSchema(const std::vector<cpp2::ColumnValue> &columns) const {
+    auto schema = std::make_shared<SchemaWriter>();
+    for (auto i = 0UL; i < columns.size(); i++) {
+        nebula::cpp2::SupportedType type;
+        switch (columns[i].getType()) {
+            case cpp2::ColumnValue::Type::integer:
+                // all integers in InterimResult are regarded as type of VID
+                type = nebula::cpp2::SupportedType::VID;
+                break;
+            case cpp2::ColumnValue::Type::double_precision:
+                type = nebula::cpp2::SupportedType::DOUBLE;
+                break;
+            case cpp2::ColumnValue::Type::bool_val:
+                type = nebula::cpp2::SupportedType::BOOL;
+                break;
+            case cpp2::ColumnValue::Type::str:
+                type = nebula::cpp2::SupportedType::STRING;
+                break;
+            default:
+                LOG(ERROR) << "Type not supported yet: " << columns[i].getType();
+                return nullptr;
+        }
+        schema->appendCol(resultColNames_[i], type);
+    }
+    return schema;
+}
+
+
+void GroupByExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
+    if (rows_.empty()) {
+        return;
+    }
+    resp.set_column_names(std::move(resultColNames_));
+    resp.set_rows(std::move(rows_));
+}
+
+}  // namespace graph
+}  // namespace nebula
@@ -0,0 +1,77 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_GROUPBYEXECUTOR_H_
+#define GRAPH_GROUPBYEXECUTOR_H_
+
+#include "base/Base.h"
+#include "graph/TraverseExecutor.h"
+#include "graph/HashAggregator.h"
+
+namespace nebula {
+namespace graph {
+
+/**
+ * GROUP BY $-.key [, ...] YIELD $-.key, COUNT(*), SUM($-.prop), ...
+ *
+ * Every input is aggregated as soon as it is fed, so that only the groups,
+ * rather than all the input rows, are held.
+ */
+class GroupByExecutor final : public TraverseExecutor {
+public:
+    GroupByExecutor(Sentence *sentence, ExecutionContext *ectx);
+
+    const char* name() const override {
+        return "GroupByExecutor";
+    }
+
+    Status MUST_USE_RESULT prepare() override;
+
+    void execute() override;
+
+    void feedResult(std::unique_ptr<InterimResult> result) override;
+
+    bool acceptsBatches() const override {
+        return true;
+    }
+
+    void setupResponse(cpp2::ExecutionResponse &resp) override;
+
+private:
+    folly::Executor* runner() const {
+        return ectx()->rctx()->runner();
+    }
+
+    // Turn the input rows into <keys..., arguments...> for the aggregator
+    StatusOr<std::vector<cpp2::RowValue>> toAggregateInput(const InterimResult &result);
+
+    // Put an aggregated row into the output
+    void addOutput(cpp2::RowValue &row);
+
+    // Schema of the output, typed by its first row, nullptr if not supported
+    std::shared_ptr<const meta::SchemaProviderIf>
+    setupSchema(const std::vector<cpp2::ColumnValue> &columns) const;
+
+private:
+    GroupBySentence                                            *sentence_{nullptr};
+    std::unique_ptr<ExpressionContext>                          expCtx_;
+    std::vector<std::string>                                    keys_;
+    // Arguments of the aggregate functions
+    std::vector<Expression*>                                    args_;
+    std::vector<std::string>                                    resultColNames_;
+    std::unique_ptr<HashAggregator>                             aggregator_;
+    // Aggregating of the inputs fed so far
+    folly::Future<Status>                                       pending_;
+    // The output is built into a batch if passed on, or kept as rows for the response
+    std::shared_ptr<const meta::SchemaProviderIf>               outputSchema_;
+    std::unique_ptr<ColumnBatch::Builder>                       builder_;
+    std::vector<cpp2::RowValue>                                 rows_;
+};
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_GROUPBYEXECUTOR_H_
@@ -0,0 +1,492 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/HashAggregator.h"
+#include "graph/HashSetOperator.h"
+#include "graph/ExternalSorter.h"
+#include "graph/ParallelFor.h"
+#include <folly/hash/Hash.h>
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+// Do not bother the other threads for small batches
+constexpr size_t kMinRowsPerTask = 4096;
+
+// The overhead of a group in the hash table, besides its key and accumulators
+constexpr size_t kGroupOverhead = 64;
+
+using Type = cpp2::ColumnValue::Type;
+
+bool isNumeric(const cpp2::ColumnValue &col) {
+    return col.getType() == Type::integer || col.getType() == Type::double_precision;
+}
+
+double toDouble(const cpp2::ColumnValue &col) {
+    if (col.getType() == Type::integer) {
+        return static_cast<double>(col.get_integer());
+    }
+    return col.get_double_precision();
+}
+
+// sum += val, the sum stays an integer until a double is added
+Status addTo(cpp2::ColumnValue &sum, const cpp2::ColumnValue &val) {
+    if (!isNumeric(val)) {
+        return Status::Error("Could not sum up a non-numeric value");
+    }
+    if (sum.getType() == Type::__EMPTY__) {
+        sum = val;
+    } else if (sum.getType() == Type::integer && val.getType() == Type::integer) {
+        sum.set_integer(sum.get_integer() + val.get_integer());
+    } else {
+        sum.set_double_precision(toDouble(sum) + toDouble(val));
+    }
+    return Status::OK();
+}
+
+std::string toString(const cpp2::ColumnValue &col) {
+    switch (col.getType()) {
+        case Type::bool_val:
+            return col.get_bool_val() ? "true" : "false";
+        case Type::integer:
+            return folly::to<std::string>(col.get_integer());
+        case Type::id:
+            return folly::to<std::string>(col.get_id());
+        case Type::double_precision:
+            return folly::to<std::string>(col.get_double_precision());
+        case Type::str:
+            return col.get_str();
+        default:
+            return "";
+    }
+}
+
+}   // Anonymous namespace
+
+
+// The partial result of an output column of a group
+struct HashAggregator::Accumulator {
+    int64_t                                     count{0};
+    // The key of KEY, sum of SUM and AVG, the min or max value of MIN and MAX,
+    // and the comma-separated values of COLLECT
+    cpp2::ColumnValue                           value;
+};
+
+
+struct HashAggregator::Partition {
+    std::unordered_map<std::string, Accumulators>   groups;
+    // The estimated size of the groups
+    size_t                                          bytes{0};
+};
+
+
+// static
+StatusOr<HashAggregator::Function> HashAggregator::toFunction(const std::string &name) {
+    static const std::unordered_map<std::string, Function> functions = {
+        {"count",   Function::COUNT},
+        {"sum",     Function::SUM},
+        {"avg",     Function::AVG},
+        {"min",     Function::MIN},
+        {"max",     Function::MAX},
+        {"collect", Function::COLLECT},
+    };
+    auto iter = functions.find(folly::toLowerAscii(name));
+    if (iter == functions.end()) {
+        return Status::Error("Unknown aggregate function `%s'", name.c_str());
+    }
+    return iter->second;
+}
+
+
+HashAggregator::HashAggregator(size_t numKeys,
+                               std::vector<Column> columns,
+                               size_t concurrency,
+                               folly::Executor *runner,
+                               size_t memLimit,
+                               std::string spillDir,
+                               MemoryTracker *tracker)
+    : numKeys_(numKeys)
+    , columns_(std::move(columns))
+    , runner_(runner)
+    , memLimit_(memLimit)
+    , spillDir_(std::move(spillDir))
+    , tracker_(tracker) {
+    auto numPartitions = std::max<size_t>(concurrency, 1);
+    for (auto i = 0UL; i < numPartitions; i++) {
+        partitions_.emplace_back(std::make_unique<Partition>());
+    }
+}
+
+
+HashAggregator::~HashAggregator() {
+    uncharge();
+}
+
+
+size_t HashAggregator::numGroups() const {
+    size_t num = 0;
+    for (auto &partition : partitions_) {
+        num += partition->groups.size();
+    }
+    return num;
+}
+
+
+folly::Future<Status> HashAggregator::add(std::vector<Row> rows) {
+    struct Batch {
+        std::vector<Row>            rows;
+        std::vector<std::string>    keys;
+        std::vector<size_t>         partitions;
+        std::vector<Status>         statuses;
+    };
+    auto batch = std::make_shared<Batch>();
+    batch->rows = std::move(rows);
+    batch->keys.resize(batch->rows.size());
+    batch->partitions.resize(batch->rows.size());
+
+    auto numPartitions = partitions_.size();
+    auto tasks = std::min(numPartitions, batch->rows.size() / kMinRowsPerTask + 1);
+    batch->statuses.resize(tasks);
+
+    // Every task encodes the keys of a slice of rows
+    auto encode = [this, batch, tasks, numPartitions] (size_t i) {
+        auto range = sliceOf(batch->rows.size(), tasks, i);
+        for (auto j = range.first; j < range.second; j++) {
+            auto &columns = batch->rows[j].get_columns();
+            auto &key = batch->keys[j];
+            for (auto k = 0UL; k < numKeys_; k++) {
+                HashSetOperator::encode(columns[k], key);
+            }
+            auto hash = folly::hash::twang_mix64(std::hash<std::string>()(key));
+            batch->partitions[j] = hash % numPartitions;
+        }
+    };
+    // Then every task aggregates the rows of its own partitions
+    auto aggregate = [this, batch, tasks] (size_t i) {
+        for (auto j = 0UL; j < batch->rows.size(); j++) {
+            auto p = batch->partitions[j];
+            if (p % tasks != i) {
+                continue;
+            }
+            auto &partition = *partitions_[p];
+            auto iter = partition.groups.find(batch->keys[j]);
+            if (iter == partition.groups.end()) {
+                iter = partition.groups.emplace(std::move(batch->keys[j]),
+                                                Accumulators(columns_.size())).first;
+                partition.bytes += estimateSize(iter->first, iter->second);
+            }
+            auto status = accumulate(iter->second, batch->rows[j], partition.bytes);
+            if (!status.ok()) {
+                batch->statuses[i] = std::move(status);
+                return;
+            }
+        }
+    };
+
+    return parallelFor(tasks, runner_, std::move(encode))
+        .thenValue([tasks, runner = runner_, aggregate = std::move(aggregate)] (auto&&) mutable {
+            return parallelFor(tasks, runner, std::move(aggregate));
+        })
+        .thenValue([this, batch] (auto&&) {
+            for (auto &status : batch->statuses) {
+                if (!status.ok()) {
+                    return status;
+                }
+            }
+            size_t bytes = 0;
+            for (auto &partition : partitions_) {
+                bytes += partition->bytes;
+            }
+            if (tracker_ != nullptr && bytes > charged_) {
+                auto status = tracker_->consume(bytes - charged_);
+                if (!status.ok()) {
+                    // Make room by dumping the groups, before giving up
+                    return dump();
+                }
+                charged_ = bytes;
+            }
+            if (bytes > memLimit_ || (tracker_ != nullptr && tracker_->shouldSpill(bytes))) {
+                return dump();
+            }
+            return Status::OK();
+        });
+}
+
+
+Status HashAggregator::accumulate(Accumulators &accs, const Row &row, size_t &bytes) const {
+    auto &columns = row.get_columns();
+    for (auto i = 0UL; i < columns_.size(); i++) {
+        auto &acc = accs[i];
+        auto &column = columns_[i];
+        switch (column.fun) {
+            case Function::KEY:
+                if (acc.count == 0) {
+                    acc.value = columns[column.index];
+                }
+                break;
+            case Function::COUNT_ALL:
+            case Function::COUNT:
+                break;
+            case Function::SUM:
+            case Function::AVG: {
+                auto status = addTo(acc.value, columns[column.index]);
+                if (!status.ok()) {
+                    return status;
+                }
+                break;
+            }
+            case Function::MIN:
+            case Function::MAX: {
+                auto &val = columns[column.index];
+                if (acc.count == 0) {
+                    acc.value = val;
+                    break;
+                }
+                if (val.getType() != acc.value.getType()) {
+                    return Status::Error("Could not compare values of different types");
+                }
+                auto less = column.fun == Function::MIN ? val < acc.value : acc.value < val;
+                if (less) {
+                    acc.value = val;
+                }
+                break;
+            }
+            case Function::COLLECT: {
+                auto str = toString(columns[column.index]);
+                if (acc.count == 0) {
+                    acc.value.set_str(std::move(str));
+                } else {
+                    bytes += str.size() + 2;
+                    acc.value.mutable_str().append(", ").append(str);
+                }
+                break;
+            }
+        }
+        acc.count++;
+    }
+    return Status::OK();
+}
+
+
+Status HashAggregator::merge(Accumulators &to, const Accumulators &from) const {
+    for (auto i = 0UL; i < columns_.size(); i++) {
+        auto &acc = to[i];
+        auto &other = from[i];
+        if (other.count == 0) {
+            continue;
+        }
+        switch (columns_[i].fun) {
+            case Function::KEY:
+                if (acc.count == 0) {
+                    acc.value = other.value;
+                }
+                break;
+            case Function::COUNT_ALL:
+            case Function::COUNT:
+                break;
+            case Function::SUM:
+            case Function::AVG: {
+                auto status = addTo(acc.value, other.value);
+                if (!status.ok()) {
+                    return status;
+                }
+                break;
+            }
+            case Function::MIN:
+            case Function::MAX: {
+                if (acc.count == 0) {
+                    acc.value = other.value;
+                    break;
+                }
+                if (other.value.getType() != acc.value.getType()) {
+                    return Status::Error("Could not compare values of different types");
+                }
+                auto less = columns_[i].fun == Function::MIN
+                          ? other.value < acc.value
+                          : acc.value < other.value;
+                if (less) {
+                    acc.value = other.value;
+                }
+                break;
+            }
+            case Function::COLLECT:
+                if (acc.count == 0) {
+                    acc.value = other.value;
+                } else {
+                    acc.value.mutable_str().append(", ").append(other.value.get_str());
+                }
+                break;
+        }
+        acc.count += other.count;
+    }
+    return Status::OK();
+}
+
+
+HashAggregator::Row HashAggregator::output(const Accumulators &accs) const {
+    std::vector<cpp2::ColumnValue> columns(columns_.size());
+    for (auto i = 0UL; i < columns_.size(); i++) {
+        auto &acc = accs[i];
+        switch (columns_[i].fun) {
+            case Function::KEY:
+            case Function::MIN:
+            case Function::MAX:
+                columns[i] = acc.value;
+                break;
+            case Function::COUNT_ALL:
+            case Function::COUNT:
+                columns[i].set_integer(acc.count);
+                break;
+            case Function::SUM:
+                columns[i] = acc.value;
+                break;
+            case Function::AVG:
+                columns[i].set_double_precision(toDouble(acc.value) / acc.count);
+                break;
+            case Function::COLLECT:
+                columns[i].set_str("[" + acc.value.get_str() + "]");
+                break;
+        }
+    }
+    Row row;
+    row.set_columns(std::move(columns));
+    return row;
+}
+
+
+size_t HashAggregator::estimateSize(const std::string &key, const Accumulators &accs) const {
+    auto size = kGroupOverhead + key.size() + accs.size() * sizeof(Accumulator);
+    for (auto &acc : accs) {
+        if (acc.value.getType() == Type::str) {
+            size += acc.value.get_str().size();
+        }
+    }
+    return size;
+}
+
+
+HashAggregator::Row HashAggregator::toPartial(const std::string &key,
+                                              const Accumulators &accs) const {
+    // <key, count of column 0, value of column 0, count of column 1, ...>
+    std::vector<cpp2::ColumnValue> columns(1 + accs.size() * 2);
+    columns[0].set_str(key);
+    for (auto i = 0UL; i < accs.size(); i++) {
+        columns[1 + i * 2].set_integer(accs[i].count);
+        columns[2 + i * 2] = accs[i].value;
+    }
+    Row row;
+    row.set_columns(std::move(columns));
+    return row;
+}
+
+
+HashAggregator::Accumulators HashAggregator::fromPartial(const Row &row) const {
+    auto &columns = row.get_columns();
+    Accumulators accs(columns_.size());
+    for (auto i = 0UL; i < accs.size(); i++) {
+        accs[i].count = columns[1 + i * 2].get_integer();
+        accs[i].value = columns[2 + i * 2];
+    }
+    return accs;
+}
+
+
+void HashAggregator::uncharge() {
+    if (tracker_ != nullptr) {
+        tracker_->release(charged_);
+    }
+    charged_ = 0;
+}
+
+
+Status HashAggregator::dump() {
+    // The sorter charges the partial results instead
+    uncharge();
+    if (sorter_ == nullptr) {
+        auto less = [] (const Row &lhs, const Row &rhs) {
+            return lhs.get_columns()[0].get_str() < rhs.get_columns()[0].get_str();
+        };
+        sorter_ = std::make_unique<ExternalSorter>(std::move(less),
+                                                   memLimit_,
+                                                   spillDir_,
+                                                   tracker_);
+    }
+    size_t numGroups = 0;
+    for (auto &partition : partitions_) {
+        for (auto &group : partition->groups) {
+            auto status = sorter_->add(toPartial(group.first, group.second));
+            if (!status.ok()) {
+                return status;
+            }
+        }
+        numGroups += partition->groups.size();
+        partition->groups.clear();
+        partition->bytes = 0;
+    }
+    VLOG(2) << "Dumped the partial results of " << numGroups << " groups";
+    return Status::OK();
+}
+
+
+Status HashAggregator::finish(std::function<void(Row&)> cb) {
+    if (sorter_ == nullptr) {
+        for (auto &partition : partitions_) {
+            for (auto &group : partition->groups) {
+                auto row = output(group.second);
+                cb(row);
+            }
+            partition->groups.clear();
+            partition->bytes = 0;
+        }
+        uncharge();
+        return Status::OK();
+    }
+
+    auto status = dump();
+    if (!status.ok()) {
+        return status;
+    }
+    // The partial results come in the order of keys, merge the adjacent ones
+    std::string key;
+    Accumulators accs;
+    bool first = true;
+    Status mergeStatus;
+    status = sorter_->finish([&] (Row &row) {
+        if (!mergeStatus.ok()) {
+            return;
+        }
+        auto &rowKey = row.get_columns()[0].get_str();
+        if (!first && rowKey == key) {
+            mergeStatus = merge(accs, fromPartial(row));
+            return;
+        }
+        if (!first) {
+            auto out = output(accs);
+            cb(out);
+        }
+        first = false;
+        key = rowKey;
+        accs = fromPartial(row);
+    });
+    if (!status.ok()) {
+        return status;
+    }
+    if (!mergeStatus.ok()) {
+        return mergeStatus;
+    }
+    if (!first) {
+        auto out = output(accs);
+        cb(out);
+    }
+    sorter_.reset();
+    return Status::OK();
+}
+
+}   // namespace graph
+}   // namespace nebula
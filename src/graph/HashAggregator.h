@@ -0,0 +1,123 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_HASHAGGREGATOR_H_
+#define GRAPH_HASHAGGREGATOR_H_
+
+#include "base/Base.h"
+#include "base/Status.h"
+#include "base/StatusOr.h"
+#include "gen-cpp2/GraphService.h"
+#include "graph/MemoryTracker.h"
+#include <folly/futures/Future.h>
+
+/**
+ * HashAggregator groups rows by their keys and aggregates the other columns.
+ *
+ * Each input row is laid out as <key columns..., argument columns...>,
+ * and each output column is either a key or an aggregate on an argument.
+ *
+ * The groups are split into partitions by the hash of their keys, so every
+ * batch of rows is aggregated by the partitions in parallel on the given
+ * executor. Batches could be added as soon as they arrive.
+ *
+ * When the estimated size of the groups exceeds the memory limit, the partial
+ * results of all groups are dumped into an ExternalSorter (which spills to
+ * disk in turn) and the hash tables are cleared. In the end, the dumped
+ * partial results are merged in the order of keys.
+ *
+ * The groups are charged to the query's MemoryTracker if given, and are
+ * dumped earlier once the query is beyond its soft limit.
+ */
+
+namespace nebula {
+namespace graph {
+
+class ExternalSorter;
+
+class HashAggregator final {
+public:
+    using Row = cpp2::RowValue;
+
+    enum class Function : uint8_t {
+        KEY,
+        COUNT_ALL,
+        COUNT,
+        SUM,
+        AVG,
+        MIN,
+        MAX,
+        COLLECT,
+    };
+
+    struct Column {
+        Function    fun;
+        // Index of the input column, unused for COUNT_ALL
+        size_t      index;
+    };
+
+    // Returns the aggregate function named `name', case insensitive
+    static StatusOr<Function> toFunction(const std::string &name);
+
+    HashAggregator(size_t numKeys,
+                   std::vector<Column> columns,
+                   size_t concurrency,
+                   folly::Executor *runner,
+                   size_t memLimit,
+                   std::string spillDir,
+                   MemoryTracker *tracker = nullptr);
+    ~HashAggregator();
+
+    // Aggregate a batch of rows, batches must be added one by one
+    folly::Future<Status> add(std::vector<Row> rows);
+
+    // Call `cb' on every output row, in no particular order
+    Status MUST_USE_RESULT finish(std::function<void(Row&)> cb);
+
+    size_t numGroups() const;
+
+private:
+    struct Accumulator;
+    struct Partition;
+    using Accumulators = std::vector<Accumulator>;
+
+    // `bytes' grows with the accumulators
+    Status accumulate(Accumulators &accs, const Row &row, size_t &bytes) const;
+
+    // Merge the partial result `from' into `to'
+    Status merge(Accumulators &to, const Accumulators &from) const;
+
+    Row output(const Accumulators &accs) const;
+
+    size_t estimateSize(const std::string &key, const Accumulators &accs) const;
+
+    // Dump the partial results of all groups to the sorter, and clear the hash tables
+    Status dump();
+
+    // Give back the bytes of the groups charged
+    void uncharge();
+
+    Row toPartial(const std::string &key, const Accumulators &accs) const;
+
+    Accumulators fromPartial(const Row &row) const;
+
+private:
+    size_t                                      numKeys_{0};
+    std::vector<Column>                         columns_;
+    folly::Executor                            *runner_{nullptr};
+    size_t                                      memLimit_{0};
+    std::string                                 spillDir_;
+    std::vector<std::unique_ptr<Partition>>     partitions_;
+    std::unique_ptr<ExternalSorter>             sorter_;
+    MemoryTracker                              *tracker_{nullptr};
+    // The bytes of the groups charged to `tracker_'
+    size_t                                      charged_{0};
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_HASHAGGREGATOR_H_
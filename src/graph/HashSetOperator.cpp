@@ -0,0 +1,373 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/HashSetOperator.h"
+#include "graph/GraphFlags.h"
+#include "graph/ParallelFor.h"
+#include <folly/hash/Hash.h>
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+// Do not bother the other threads for small inputs
+constexpr size_t kMinRowsPerTask = 4096;
+
+// A key in the hash table, referring to the encoded row
+struct KeyRef {
+    folly::StringPiece  key;
+    size_t              hash;
+
+    bool operator==(const KeyRef &rhs) const {
+        return key == rhs.key;
+    }
+};
+
+struct KeyRefHash {
+    size_t operator()(const KeyRef &ref) const {
+        return ref.hash;
+    }
+};
+
+using KeySet = std::unordered_set<KeyRef, KeyRefHash>;
+
+template <typename T>
+void append(std::string &buf, T val) {
+    buf.append(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+}   // Anonymous namespace
+
+
+struct HashSetOperator::State {
+    Op                                  op;
+    size_t                              leftSize{0};
+    Encoder                             encodeLeft;
+    size_t                              rightSize{0};
+    Encoder                             encodeRight;
+    std::vector<std::string>            leftKeys;
+    std::vector<size_t>                 leftHashes;
+    std::vector<std::string>            rightKeys;
+    std::vector<size_t>                 rightHashes;
+    size_t                              numPartitions{1};
+    // Indexes of the left rows in the result, one list for each partition
+    std::vector<Indexes>                kept;
+};
+
+
+// static
+folly::Future<HashSetOperator::Rows>
+HashSetOperator::intersect(Rows left, Rows right, folly::Executor *runner) {
+    return runOnRows(Op::INTERSECT, std::move(left), std::move(right), runner);
+}
+
+
+// static
+folly::Future<HashSetOperator::Indexes>
+HashSetOperator::intersect(Batch left, Batch right, folly::Executor *runner) {
+    return runOnBatches(Op::INTERSECT, std::move(left), std::move(right), runner);
+}
+
+
+// static
+folly::Future<HashSetOperator::Rows>
+HashSetOperator::minus(Rows left, Rows right, folly::Executor *runner) {
+    return runOnRows(Op::MINUS, std::move(left), std::move(right), runner);
+}
+
+
+// static
+folly::Future<HashSetOperator::Indexes>
+HashSetOperator::minus(Batch left, Batch right, folly::Executor *runner) {
+    return runOnBatches(Op::MINUS, std::move(left), std::move(right), runner);
+}
+
+
+// static
+folly::Future<HashSetOperator::Rows>
+HashSetOperator::distinct(Rows rows, folly::Executor *runner) {
+    return runOnRows(Op::DISTINCT, std::move(rows), Rows(), runner);
+}
+
+
+// static
+folly::Future<HashSetOperator::Indexes>
+HashSetOperator::distinct(Batch batch, folly::Executor *runner) {
+    return runOnBatches(Op::DISTINCT, std::move(batch), nullptr, runner);
+}
+
+
+// static
+std::string HashSetOperator::encode(const cpp2::RowValue &row) {
+    std::string buf;
+    buf.reserve(row.get_columns().size() * 9);
+    for (auto &col : row.get_columns()) {
+        encode(col, buf);
+    }
+    return buf;
+}
+
+
+// static
+std::string HashSetOperator::encode(const ColumnBatch &batch, size_t row) {
+    using nebula::cpp2::SupportedType;
+    std::string buf;
+    buf.reserve(batch.numColumns() * 9);
+    for (auto i = 0UL; i < batch.numColumns(); i++) {
+        auto &col = batch.column(i);
+        switch (col.type()) {
+            case SupportedType::BOOL:
+                append(buf, static_cast<uint8_t>(col.getBool(row)));
+                break;
+            case SupportedType::INT:
+            case SupportedType::VID:
+            case SupportedType::TIMESTAMP:
+                append(buf, col.getInt(row));
+                break;
+            case SupportedType::FLOAT:
+            case SupportedType::DOUBLE: {
+                // +0.0 and -0.0 are equal
+                double val = col.getDouble(row);
+                append(buf, val == 0.0 ? 0.0 : val);
+                break;
+            }
+            case SupportedType::STRING: {
+                // The codes are only comparable within one batch
+                auto &str = col.getString(row);
+                append(buf, static_cast<uint32_t>(str.size()));
+                buf.append(str);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return buf;
+}
+
+
+// static
+void HashSetOperator::encode(const cpp2::ColumnValue &col, std::string &buf) {
+    auto type = col.getType();
+    append(buf, static_cast<uint8_t>(type));
+    switch (type) {
+        case cpp2::ColumnValue::Type::bool_val:
+            append(buf, static_cast<uint8_t>(col.get_bool_val()));
+            break;
+        case cpp2::ColumnValue::Type::integer:
+            append(buf, col.get_integer());
+            break;
+        case cpp2::ColumnValue::Type::id:
+            append(buf, col.get_id());
+            break;
+        case cpp2::ColumnValue::Type::timestamp:
+            append(buf, col.get_timestamp());
+            break;
+        case cpp2::ColumnValue::Type::single_precision: {
+            // +0.0 and -0.0 are equal
+            float val = col.get_single_precision();
+            append(buf, val == 0.0f ? 0.0f : val);
+            break;
+        }
+        case cpp2::ColumnValue::Type::double_precision: {
+            double val = col.get_double_precision();
+            append(buf, val == 0.0 ? 0.0 : val);
+            break;
+        }
+        case cpp2::ColumnValue::Type::str: {
+            auto &str = col.get_str();
+            append(buf, static_cast<uint32_t>(str.size()));
+            buf.append(str);
+            break;
+        }
+        case cpp2::ColumnValue::Type::year:
+            append(buf, col.get_year());
+            break;
+        case cpp2::ColumnValue::Type::month: {
+            auto &month = col.get_month();
+            append(buf, month.get_year());
+            append(buf, month.get_month());
+            break;
+        }
+        case cpp2::ColumnValue::Type::date: {
+            auto &date = col.get_date();
+            append(buf, date.get_year());
+            append(buf, date.get_month());
+            append(buf, date.get_day());
+            break;
+        }
+        case cpp2::ColumnValue::Type::datetime: {
+            auto &dt = col.get_datetime();
+            append(buf, dt.get_year());
+            append(buf, dt.get_month());
+            append(buf, dt.get_day());
+            append(buf, dt.get_hour());
+            append(buf, dt.get_minute());
+            append(buf, dt.get_second());
+            append(buf, dt.get_millisec());
+            append(buf, dt.get_microsec());
+            break;
+        }
+        case cpp2::ColumnValue::Type::__EMPTY__:
+            break;
+    }
+}
+
+
+// static
+folly::Future<HashSetOperator::Rows>
+HashSetOperator::runOnRows(Op op, Rows left, Rows right, folly::Executor *runner) {
+    auto leftRows = std::make_shared<Rows>(std::move(left));
+    auto rightRows = std::make_shared<Rows>(std::move(right));
+    auto leftSize = leftRows->size();
+    auto rightSize = rightRows->size();
+    return run(op,
+               leftSize,
+               [leftRows] (size_t i) { return encode((*leftRows)[i]); },
+               rightSize,
+               [rightRows] (size_t i) { return encode((*rightRows)[i]); },
+               runner)
+        .thenValue([leftRows] (Indexes indexes) {
+            Rows rows;
+            rows.reserve(indexes.size());
+            for (auto i : indexes) {
+                rows.emplace_back(std::move((*leftRows)[i]));
+            }
+            return rows;
+        });
+}
+
+
+// static
+folly::Future<HashSetOperator::Indexes>
+HashSetOperator::runOnBatches(Op op, Batch left, Batch right, folly::Executor *runner) {
+    auto leftSize = left == nullptr ? 0 : left->numRows();
+    auto rightSize = right == nullptr ? 0 : right->numRows();
+    return run(op,
+               leftSize,
+               [left] (size_t i) { return encode(*left, i); },
+               rightSize,
+               [right] (size_t i) { return encode(*right, i); },
+               runner);
+}
+
+
+// static
+folly::Future<HashSetOperator::Indexes>
+HashSetOperator::run(Op op,
+                     size_t leftSize,
+                     Encoder encodeLeft,
+                     size_t rightSize,
+                     Encoder encodeRight,
+                     folly::Executor *runner) {
+    auto state = std::make_shared<State>();
+    state->op = op;
+    state->leftSize = leftSize;
+    state->encodeLeft = std::move(encodeLeft);
+    state->rightSize = rightSize;
+    state->encodeRight = std::move(encodeRight);
+    state->leftKeys.resize(leftSize);
+    state->leftHashes.resize(leftSize);
+    state->rightKeys.resize(rightSize);
+    state->rightHashes.resize(rightSize);
+
+    auto total = leftSize + rightSize;
+    auto tasks = std::min<size_t>(std::max(FLAGS_set_op_concurrency, 1),
+                                  total / kMinRowsPerTask + 1);
+    state->numPartitions = tasks;
+    state->kept.resize(tasks);
+
+    // Every task encodes a slice of both sides
+    auto encode = [state, tasks] (size_t i) {
+        auto range = sliceOf(state->leftSize, tasks, i);
+        encodeRange(state->encodeLeft, state->leftKeys, state->leftHashes,
+                    range.first, range.second);
+        range = sliceOf(state->rightSize, tasks, i);
+        encodeRange(state->encodeRight, state->rightKeys, state->rightHashes,
+                    range.first, range.second);
+    };
+    // Then every task builds and probes one partition
+    auto probe = [state] (size_t partition) {
+        probePartition(*state, partition);
+    };
+
+    return parallelFor(tasks, runner, std::move(encode))
+        .thenValue([tasks, runner, probe = std::move(probe)] (auto&&) mutable {
+            return parallelFor(tasks, runner, std::move(probe));
+        })
+        .thenValue([state] (auto&&) {
+            return gather(*state);
+        });
+}
+
+
+// static
+void HashSetOperator::encodeRange(const Encoder &encoder,
+                                  std::vector<std::string> &keys,
+                                  std::vector<size_t> &hashes,
+                                  size_t begin,
+                                  size_t end) {
+    for (auto i = begin; i < end; i++) {
+        keys[i] = encoder(i);
+        hashes[i] = std::hash<std::string>()(keys[i]);
+    }
+}
+
+
+// static
+void HashSetOperator::probePartition(State &state, size_t partition) {
+    auto numPartitions = state.numPartitions;
+    auto inPartition = [numPartitions, partition] (size_t hash) {
+        return folly::hash::twang_mix64(hash) % numPartitions == partition;
+    };
+    auto &kept = state.kept[partition];
+
+    if (state.op == Op::DISTINCT) {
+        KeySet seen;
+        for (auto i = 0UL; i < state.leftSize; i++) {
+            auto hash = state.leftHashes[i];
+            if (inPartition(hash) && seen.emplace(KeyRef{state.leftKeys[i], hash}).second) {
+                kept.emplace_back(i);
+            }
+        }
+        return;
+    }
+
+    KeySet rightKeys;
+    for (auto i = 0UL; i < state.rightSize; i++) {
+        auto hash = state.rightHashes[i];
+        if (inPartition(hash)) {
+            rightKeys.emplace(KeyRef{state.rightKeys[i], hash});
+        }
+    }
+    auto keepFound = state.op == Op::INTERSECT;
+    for (auto i = 0UL; i < state.leftSize; i++) {
+        auto hash = state.leftHashes[i];
+        if (!inPartition(hash)) {
+            continue;
+        }
+        auto found = rightKeys.count(KeyRef{state.leftKeys[i], hash}) > 0;
+        if (found == keepFound) {
+            kept.emplace_back(i);
+        }
+    }
+}
+
+
+// static
+HashSetOperator::Indexes HashSetOperator::gather(State &state) {
+    Indexes indexes;
+    for (auto &kept : state.kept) {
+        indexes.insert(indexes.end(), kept.begin(), kept.end());
+    }
+    std::sort(indexes.begin(), indexes.end());
+    return indexes;
+}
+
+}   // namespace graph
+}   // namespace nebula
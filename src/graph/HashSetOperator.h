@@ -0,0 +1,105 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_HASHSETOPERATOR_H_
+#define GRAPH_HASHSETOPERATOR_H_
+
+#include "base/Base.h"
+#include "gen-cpp2/GraphService.h"
+#include "graph/ColumnBatch.h"
+#include <folly/futures/Future.h>
+
+/**
+ * HashSetOperator implements INTERSECT, MINUS and DISTINCT over rows with
+ * hash tables.
+ *
+ * Each row is first encoded into a compact byte string, which is hashed and
+ * compared instead of the row itself. The rows are then split into
+ * partitions by the hash, and every partition is built and probed
+ * independently, so both steps could run in parallel on the given executor.
+ *
+ * The results keep the order of the left rows. Over column batches only the
+ * indexes of the left rows kept are returned, to select them from the batch
+ * without decoding the rows.
+ */
+
+namespace nebula {
+namespace graph {
+
+class HashSetOperator final {
+public:
+    using Rows = std::vector<cpp2::RowValue>;
+    using Batch = std::shared_ptr<const ColumnBatch>;
+    using Indexes = std::vector<uint32_t>;
+
+    // Rows of `left' which also appear in `right'
+    static folly::Future<Rows> intersect(Rows left, Rows right, folly::Executor *runner);
+    static folly::Future<Indexes> intersect(Batch left, Batch right, folly::Executor *runner);
+
+    // Rows of `left' which do not appear in `right'
+    static folly::Future<Rows> minus(Rows left, Rows right, folly::Executor *runner);
+    static folly::Future<Indexes> minus(Batch left, Batch right, folly::Executor *runner);
+
+    // The first occurrence of each row
+    static folly::Future<Rows> distinct(Rows rows, folly::Executor *runner);
+    static folly::Future<Indexes> distinct(Batch batch, folly::Executor *runner);
+
+    // The compact encoding of a row, two rows are equal iff their encodings are
+    static std::string encode(const cpp2::RowValue &row);
+
+    // The same for row `row' of `batch', comparable with the rows of batches
+    // whose columns are of the same types
+    static std::string encode(const ColumnBatch &batch, size_t row);
+
+    // Append the compact encoding of a column to `buf'
+    static void encode(const cpp2::ColumnValue &col, std::string &buf);
+
+private:
+    HashSetOperator() = delete;
+
+    enum class Op : uint8_t {
+        INTERSECT,
+        MINUS,
+        DISTINCT,
+    };
+
+    // Encodes the row at the index of one side
+    using Encoder = std::function<std::string(size_t)>;
+
+    struct State;
+
+    static folly::Future<Indexes> run(Op op,
+                                      size_t leftSize,
+                                      Encoder encodeLeft,
+                                      size_t rightSize,
+                                      Encoder encodeRight,
+                                      folly::Executor *runner);
+
+    static folly::Future<Rows> runOnRows(Op op,
+                                         Rows left,
+                                         Rows right,
+                                         folly::Executor *runner);
+
+    static folly::Future<Indexes> runOnBatches(Op op,
+                                               Batch left,
+                                               Batch right,
+                                               folly::Executor *runner);
+
+    static void encodeRange(const Encoder &encoder,
+                            std::vector<std::string> &keys,
+                            std::vector<size_t> &hashes,
+                            size_t begin,
+                            size_t end);
+
+    static void probePartition(State &state, size_t partition);
+
+    static Indexes gather(State &state);
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_HASHSETOPERATOR_H_
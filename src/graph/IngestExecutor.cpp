@@ -54,7 +54,11 @@ void IngestExecutor::execute() {
 
     auto *runner = ectx()->rctx()->runner();
 
-    auto cb = [this] (auto &&resp) {
+    auto cb = [this, spaceId] (auto &&resp) {
+        // The vertices cached are stale now, even if the ingestion failed halfway
+        if (ectx()->vertexCache() != nullptr) {
+            ectx()->vertexCache()->invalidate(spaceId);
+        }
         if (!resp) {
             DCHECK(onError_);
             onError_(Status::Error("Ingest Failed"));
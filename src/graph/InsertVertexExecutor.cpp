@@ -175,6 +175,10 @@ void InsertVertexExecutor::execute() {
     auto *runner = ectx()->rctx()->runner();
 
     auto cb = [this] (auto &&resp) {
+        // The vertices cached are stale now, even if only partially written
+        if (ectx()->vertexCache() != nullptr) {
+            ectx()->vertexCache()->invalidate(spaceId_);
+        }
         // For insertion, we regard partial success as failure.
         auto completeness = resp.completeness();
         if (completeness != 100) {
@@ -188,6 +192,9 @@ void InsertVertexExecutor::execute() {
 
     auto error = [this] (auto &&e) {
         LOG(ERROR) << "Exception caught: " << e.what();
+        if (ectx()->vertexCache() != nullptr) {
+            ectx()->vertexCache()->invalidate(spaceId_);
+        }
         DCHECK(onError_);
         onError_(Status::Error("Internal error"));
         return;
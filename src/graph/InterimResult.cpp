@@ -14,8 +14,16 @@ namespace graph {
 constexpr char NotSupported[] = "Type not supported yet";
 
 InterimResult::InterimResult(std::unique_ptr<RowSetWriter> rsWriter) {
-    rsWriter_ = std::move(rsWriter);
-    rsReader_ = std::make_unique<RowSetReader>(rsWriter_->schema(), rsWriter_->data());
+    // Decode the rows once and for all
+    schema_ = rsWriter->schema();
+    ColumnBatch::Builder builder(schema_);
+    RowSetReader rsReader(schema_, rsWriter->data());
+    auto iter = rsReader.begin();
+    while (iter) {
+        builder.append(*iter);
+        ++iter;
+    }
+    batch_ = builder.finish();
 }
 
 
@@ -24,170 +32,157 @@ InterimResult::InterimResult(std::vector<VertexID> vids) {
 }
 
 
+InterimResult::InterimResult(std::shared_ptr<const meta::SchemaProviderIf> schema,
+                             std::shared_ptr<const ColumnBatch> batch) {
+    schema_ = std::move(schema);
+    batch_ = std::move(batch);
+}
+
+
+int64_t InterimResult::vidColumnIndex(const std::string &col) const {
+    using nebula::cpp2::SupportedType;
+    auto index = schema_->getFieldIndex(col);
+    if (index == -1) {
+        return -1;
+    }
+    auto type = schema_->getFieldType(index).type;
+    if (type != SupportedType::VID && type != SupportedType::INT) {
+        return -1;
+    }
+    return index;
+}
+
 StatusOr<std::vector<VertexID>> InterimResult::getVIDs(const std::string &col) const {
     if (!vids_.empty()) {
-        DCHECK(rsReader_ == nullptr);
+        DCHECK(batch_ == nullptr);
         return vids_;
     }
-    DCHECK(rsReader_ != nullptr);
-    std::vector<VertexID> result;
-    auto iter = rsReader_->begin();
-    while (iter) {
-        VertexID vid;
-        auto rc = iter->getVid(col, vid);
-        if (rc != ResultType::SUCCEEDED) {
-            return Status::Error("Column `%s' not found", col.c_str());
-        }
-        result.emplace_back(vid);
-        ++iter;
+    DCHECK(batch_ != nullptr);
+    auto index = vidColumnIndex(col);
+    if (index == -1) {
+        return Status::Error("Column `%s' not found", col.c_str());
     }
-    return result;
+    return batch_->column(index).ints();
 }
 
 StatusOr<std::vector<VertexID>> InterimResult::getDistinctVIDs(const std::string &col) const {
     if (!vids_.empty()) {
-        DCHECK(rsReader_ == nullptr);
+        DCHECK(batch_ == nullptr);
         return vids_;
     }
-    DCHECK(rsReader_ != nullptr);
-    std::unordered_set<VertexID> uniq;
-    auto iter = rsReader_->begin();
-    while (iter) {
-        VertexID vid;
-        auto rc = iter->getVid(col, vid);
-        if (rc != ResultType::SUCCEEDED) {
-            return Status::Error("Column `%s' not found", col.c_str());
-        }
-        uniq.emplace(vid);
-        ++iter;
+    DCHECK(batch_ != nullptr);
+    auto index = vidColumnIndex(col);
+    if (index == -1) {
+        return Status::Error("Column `%s' not found", col.c_str());
     }
+    auto &vids = batch_->column(index).ints();
+    std::unordered_set<VertexID> uniq(vids.begin(), vids.end());
     std::vector<VertexID> result(uniq.begin(), uniq.end());
     return result;
 }
 
 std::vector<cpp2::RowValue> InterimResult::getRows() const {
-    DCHECK(rsReader_ != nullptr);
-    auto schema = rsReader_->schema();
-    auto columnCnt = schema->getNumFields();
+    DCHECK(batch_ != nullptr);
     std::vector<cpp2::RowValue> rows;
-    folly::StringPiece piece;
-    using nebula::cpp2::SupportedType;
-    auto rowIter = rsReader_->begin();
-    while (rowIter) {
-        std::vector<cpp2::ColumnValue> row;
-        row.reserve(columnCnt);
-        auto fieldIter = schema->begin();
-        while (fieldIter) {
-            auto type = fieldIter->getType().type;
-            auto field = fieldIter->getName();
-            row.emplace_back();
-            switch (type) {
-                case SupportedType::VID: {
-                    int64_t v;
-                    auto rc = rowIter->getVid(field, v);
-                    CHECK(rc == ResultType::SUCCEEDED);
-                    row.back().set_integer(v);
-                    break;
-                }
-                case SupportedType::DOUBLE: {
-                    double v;
-                    auto rc = rowIter->getDouble(field, v);
-                    CHECK(rc == ResultType::SUCCEEDED);
-                    row.back().set_double_precision(v);
-                    break;
-                }
-                case SupportedType::BOOL: {
-                    bool v;
-                    auto rc = rowIter->getBool(field, v);
-                    CHECK(rc == ResultType::SUCCEEDED);
-                    row.back().set_bool_val(v);
-                    break;
-                }
-                case SupportedType::STRING: {
-                    auto rc = rowIter->getString(field, piece);
-                    CHECK(rc == ResultType::SUCCEEDED);
-                    row.back().set_str(piece.toString());
-                    break;
-                }
-                default:
-                    LOG(FATAL) << "Unknown Type: " << static_cast<int32_t>(type);
-            }
-            ++fieldIter;
-        }
-        rows.emplace_back();
-        rows.back().set_columns(std::move(row));
-        ++rowIter;
+    rows.reserve(batch_->numRows());
+    for (auto i = 0UL; i < batch_->numRows(); i++) {
+        rows.emplace_back(batch_->getRow(i));
     }
     return rows;
 }
 
+void InterimResult::forEachRow(std::function<bool(cpp2::RowValue&)> cb) const {
+    DCHECK(batch_ != nullptr);
+    for (auto i = 0UL; i < batch_->numRows(); i++) {
+        auto row = batch_->getRow(i);
+        if (!cb(row)) {
+            break;
+        }
+    }
+}
+
+std::unique_ptr<InterimResult> InterimResult::select(const std::vector<uint32_t> &rows) const {
+    DCHECK(batch_ != nullptr);
+    auto result = std::make_unique<InterimResult>(schema_, batch_->select(rows));
+    result->charges_ = charges_;
+    return result;
+}
+
+std::unique_ptr<InterimResult> InterimResult::slice(size_t offset, size_t count) const {
+    DCHECK(batch_ != nullptr);
+    auto result = std::make_unique<InterimResult>(schema_, batch_->slice(offset, count));
+    result->charges_ = charges_;
+    return result;
+}
+
+std::unique_ptr<InterimResult> InterimResult::merge(
+            std::vector<std::unique_ptr<InterimResult>> results) {
+    results.erase(std::remove_if(results.begin(), results.end(), [] (const auto &result) {
+        return result == nullptr || result->numRows() == 0;
+    }), results.end());
+    if (results.empty()) {
+        return nullptr;
+    }
+    if (results.size() == 1) {
+        return std::move(results.front());
+    }
+    // The rows are copied column by column, in the types of the first batch
+    auto schema = results.front()->schema();
+    ColumnBatch::Builder builder(schema);
+    std::vector<std::shared_ptr<const MemoryCharge>> charges;
+    for (auto &result : results) {
+        DCHECK(result->batch_ != nullptr);
+        auto &batch = *result->batch_;
+        for (auto i = 0UL; i < batch.numRows(); i++) {
+            builder.append(batch, i);
+        }
+        for (auto &charge : result->charges_) {
+            charges.emplace_back(std::move(charge));
+        }
+    }
+    auto merged = std::make_unique<InterimResult>(std::move(schema), builder.finish());
+    merged->charges_ = std::move(charges);
+    return merged;
+}
+
 std::unique_ptr<InterimResult::InterimResultIndex>
-InterimResult::buildIndex(const std::string &vidColumn) const {
+InterimResult::buildIndex(const std::string &vidColumn,
+                          std::unique_ptr<InterimResultIndex> index) const {
     using nebula::cpp2::SupportedType;
-    std::unique_ptr<InterimResultIndex> index;
-
-    DCHECK(rsReader_ != nullptr);
-    auto schema = rsReader_->schema();
-    auto columnCnt = schema->getNumFields();
+    DCHECK(batch_ != nullptr);
+    auto columnCnt = schema_->getNumFields();
     uint32_t vidIndex = 0u;
 
-    index = std::make_unique<InterimResultIndex>();
+    bool appending = index != nullptr;
+    if (!appending) {
+        index = std::make_unique<InterimResultIndex>();
+    }
     for (auto i = 0u; i < columnCnt; i++) {
-        auto name = schema->getFieldName(i);
+        auto name = schema_->getFieldName(i);
         if (vidColumn == name) {
-            if (schema->getFieldType(i).type != SupportedType::VID) {
+            if (schema_->getFieldType(i).type != SupportedType::VID) {
                 return nullptr;
             }
             vidIndex = i;
         }
-        index->columnToIndex_[name] = i;
+        if (!appending) {
+            index->columnToIndex_[name] = i;
+            index->columnTypes_.emplace_back(schema_->getFieldType(i).type);
+        }
     }
+    DCHECK_EQ(columnCnt, index->columnTypes_.size());
 
-    auto rowIter = rsReader_->begin();
-    auto rowIndex = 0u;
-    while (rowIter) {
-        Row row;
+    auto &vids = batch_->column(vidIndex).ints();
+    auto offset = index->rows_.size();
+    index->rows_.reserve(offset + batch_->numRows());
+    for (auto rowIndex = 0u; rowIndex < batch_->numRows(); rowIndex++) {
+        InterimResultIndex::Row row;
         row.reserve(columnCnt);
         for (auto i = 0u; i < columnCnt; i++) {
-            auto type = schema->getFieldType(i).type;
-            switch (type) {
-                case SupportedType::VID: {
-                    int64_t v;
-                    auto rc = rowIter->getVid(i, v);
-                    CHECK(rc == ResultType::SUCCEEDED);
-                    if (i == vidIndex) {
-                        index->vidToRowIndex_[v] = rowIndex++;
-                    }
-                    row.emplace_back(v);
-                    break;
-                }
-                case SupportedType::DOUBLE: {
-                    double v;
-                    auto rc = rowIter->getDouble(i, v);
-                    CHECK(rc == ResultType::SUCCEEDED);
-                    row.emplace_back(v);
-                    break;
-                }
-                case SupportedType::BOOL: {
-                    bool v;
-                    auto rc = rowIter->getBool(i, v);
-                    CHECK(rc == ResultType::SUCCEEDED);
-                    row.emplace_back(v);
-                    break;
-                }
-                case SupportedType::STRING: {
-                    folly::StringPiece piece;
-                    auto rc = rowIter->getString(i, piece);
-                    CHECK(rc == ResultType::SUCCEEDED);
-                    row.emplace_back(piece.toString());
-                    break;
-                }
-                default:
-                    LOG(FATAL) << "Unknown Type: " << static_cast<int32_t>(type);
-            }
+            row.emplace_back(batch_->column(i).getVariant(rowIndex));
         }
+        index->vidToRowIndex_[vids[rowIndex]] = offset + rowIndex;
         index->rows_.emplace_back(std::move(row));
-        ++rowIter;
     }
 
     return index;
@@ -212,6 +207,23 @@ VariantType InterimResult::InterimResultIndex::getColumnWithVID(VertexID id,
     return rows_[rowIndex][columnIndex];
 }
 
+const InterimResult::InterimResultIndex::Row*
+InterimResult::InterimResultIndex::getRowWithVID(VertexID id) const {
+    auto iter = vidToRowIndex_.find(id);
+    if (iter == vidToRowIndex_.end()) {
+        return nullptr;
+    }
+    return &rows_[iter->second];
+}
+
+int64_t InterimResult::InterimResultIndex::getColumnIndex(const std::string &col) const {
+    auto iter = columnToIndex_.find(col);
+    if (iter == columnToIndex_.end()) {
+        return -1;
+    }
+    return iter->second;
+}
+
 Status InterimResult::castTo(cpp2::ColumnValue *col,
                              const nebula::cpp2::SupportedType &type) {
     using nebula::cpp2::SupportedType;
@@ -349,33 +361,18 @@ Status InterimResult::castToStr(cpp2::ColumnValue *col) {
 std::unique_ptr<InterimResult> InterimResult::getInterim(
             std::shared_ptr<const meta::SchemaProviderIf> resultSchema,
             std::vector<cpp2::RowValue> &rows) {
-    auto rsWriter = std::make_unique<RowSetWriter>(resultSchema);
+    // Build the columns directly, rather than encoding the rows
+    ColumnBatch::Builder builder(resultSchema);
+    if (!builder.status().ok()) {
+        return nullptr;
+    }
     for (auto &r : rows) {
-        RowWriter writer(resultSchema);
-        auto &cols = r.get_columns();
-        for (auto &col : cols) {
-            switch (col.getType()) {
-                case cpp2::ColumnValue::Type::integer:
-                    writer << col.get_integer();
-                    break;
-                case cpp2::ColumnValue::Type::double_precision:
-                    writer << col.get_double_precision();
-                    break;
-                case cpp2::ColumnValue::Type::bool_val:
-                    writer << col.get_bool_val();
-                    break;
-                case cpp2::ColumnValue::Type::str:
-                    writer << col.get_str();
-                    break;
-                default:
-                    LOG(ERROR) << NotSupported << static_cast<int32_t>(col.getType());
-                    return nullptr;
-            }
-        }
-        rsWriter->addRow(writer);
+        builder.append(r.get_columns());
     }
-
-    return std::make_unique<InterimResult>(std::move(rsWriter));
+    if (!builder.status().ok()) {
+        return nullptr;
+    }
+    return std::make_unique<InterimResult>(std::move(resultSchema), builder.finish());
 }
 }   // namespace graph
 }   // namespace nebula
@@ -13,11 +13,19 @@
 #include "dataman/RowSetReader.h"
 #include "dataman/RowSetWriter.h"
 #include "dataman/SchemaWriter.h"
+#include "graph/ColumnBatch.h"
 
 namespace nebula {
 namespace graph {
+
+class MemoryCharge;
+
 /**
  * The intermediate form of execution result, used in pipeline and variable.
+ *
+ * The rows are kept in a ColumnBatch, which is shared rather than copied,
+ * so that executors could pass on the rows without encoding them again.
+ * They are converted to thrift rows only for the final response.
  */
 class InterimResult final {
 public:
@@ -30,10 +38,15 @@ public:
 
     explicit InterimResult(std::unique_ptr<RowSetWriter> rsWriter);
     explicit InterimResult(std::vector<VertexID> vids);
+    InterimResult(std::shared_ptr<const meta::SchemaProviderIf> schema,
+                  std::shared_ptr<const ColumnBatch> batch);
 
     static std::unique_ptr<InterimResult> getInterim(
             std::shared_ptr<const meta::SchemaProviderIf> resultSchema,
             std::vector<cpp2::RowValue> &rows);
+    // Concatenate the batches of one result, in order, nullptr if all are empty
+    static std::unique_ptr<InterimResult> merge(
+            std::vector<std::unique_ptr<InterimResult>> results);
     static Status castTo(cpp2::ColumnValue *col,
                          const nebula::cpp2::SupportedType &type);
     static Status castToInt(cpp2::ColumnValue *col);
@@ -42,11 +55,32 @@ public:
     static Status castToStr(cpp2::ColumnValue *col);
 
     std::shared_ptr<const meta::SchemaProviderIf> schema() const {
-        return rsReader_->schema();
+        return schema_;
+    }
+
+    std::shared_ptr<const ColumnBatch> batch() const {
+        return batch_;
+    }
+
+    size_t numRows() const {
+        return batch_ == nullptr ? vids_.size() : batch_->numRows();
+    }
+
+    // A rough estimation of the memory taken
+    size_t memoryBytes() const {
+        auto bytes = sizeof(InterimResult) + vids_.capacity() * sizeof(VertexID);
+        return batch_ == nullptr ? bytes : bytes + batch_->memoryBytes();
+    }
+
+    // The same without the dictionaries of the batch, which might be shared
+    size_t columnBytes() const {
+        auto bytes = sizeof(InterimResult) + vids_.capacity() * sizeof(VertexID);
+        return batch_ == nullptr ? bytes : bytes + batch_->columnBytes();
     }
 
-    std::string& data() const {
-        return rsWriter_->data();
+    // Held till this result is dropped, or passed on to the results derived from it
+    void addCharge(std::shared_ptr<const MemoryCharge> charge) {
+        charges_.emplace_back(std::move(charge));
     }
 
     StatusOr<std::vector<VertexID>> getVIDs(const std::string &col) const;
@@ -55,26 +89,54 @@ public:
 
     std::vector<cpp2::RowValue> getRows() const;
 
+    // Convert the rows one by one, stop once `cb' returns false
+    void forEachRow(std::function<bool(cpp2::RowValue&)> cb) const;
+
+    // The rows at `rows', in that order, sharing the strings and the charges with this one
+    std::unique_ptr<InterimResult> select(const std::vector<uint32_t> &rows) const;
+
+    // At most `count' rows from `offset', the same way
+    std::unique_ptr<InterimResult> slice(size_t offset, size_t count) const;
+
     class InterimResultIndex;
-    std::unique_ptr<InterimResultIndex> buildIndex(const std::string &vidColumn) const;
+    // The rows are appended to `index' if given, e.g. to index the batches of a result
+    // one by one, in which case the batches must share the schema
+    std::unique_ptr<InterimResultIndex> buildIndex(
+            const std::string &vidColumn,
+            std::unique_ptr<InterimResultIndex> index = nullptr) const;
 
     class InterimResultIndex final {
     public:
         VariantType getColumnWithVID(VertexID id, const std::string &col) const;
 
+        using Row = std::vector<VariantType>;
+        // The row of `id', nullptr if not exist
+        const Row* getRowWithVID(VertexID id) const;
+
+        // Index of the column named `col', -1 if not exist
+        int64_t getColumnIndex(const std::string &col) const;
+
+        nebula::cpp2::SupportedType getColumnType(int64_t index) const {
+            return columnTypes_[index];
+        }
+
     private:
         friend class InterimResult;
-        using Row = std::vector<VariantType>;
         std::vector<Row>                            rows_;
         std::unordered_map<std::string, uint32_t>   columnToIndex_;
+        std::vector<nebula::cpp2::SupportedType>    columnTypes_;
         std::unordered_map<VertexID, uint32_t>      vidToRowIndex_;
     };
 
 private:
-    using Row = std::vector<VariantType>;
-    std::unique_ptr<RowSetReader>               rsReader_;
-    std::unique_ptr<RowSetWriter>               rsWriter_;
-    std::vector<VertexID>                       vids_;
+    // Index of the integer column `col', -1 if not exist
+    int64_t vidColumnIndex(const std::string &col) const;
+
+private:
+    std::shared_ptr<const meta::SchemaProviderIf>   schema_;
+    std::shared_ptr<const ColumnBatch>              batch_;
+    std::vector<VertexID>                           vids_;
+    std::vector<std::shared_ptr<const MemoryCharge>> charges_;
 };
 
 }   // namespace graph
@@ -0,0 +1,68 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/KillQueryExecutor.h"
+#include "graph/QueryManager.h"
+
+namespace nebula {
+namespace graph {
+
+KillQueryExecutor::KillQueryExecutor(Sentence *sentence,
+                                     ExecutionContext *ectx) : Executor(ectx) {
+    sentence_ = static_cast<KillQuerySentence*>(sentence);
+}
+
+
+Status KillQueryExecutor::prepare() {
+    return Status::OK();
+}
+
+
+void KillQueryExecutor::execute() {
+    auto id = sentence_->id();
+    auto query = ectx()->queries() == nullptr ? nullptr : ectx()->queries()->find(id);
+    if (query == nullptr) {
+        DCHECK(onError_);
+        onError_(Status::Error("Query %ld is not running", id));
+        return;
+    }
+    if (!query->killableBy(ectx()->rctx()->session())) {
+        DCHECK(onError_);
+        onError_(Status::Error("Query %ld is not allowed to be killed by user `%s'",
+                               id, ectx()->rctx()->session()->user().c_str()));
+        return;
+    }
+    query->kill();
+    if (query->space() < 0) {
+        // No reads sent to the storage without a space
+        DCHECK(onFinish_);
+        onFinish_();
+        return;
+    }
+
+    auto future = ectx()->storage()->killQuery(query->space(), query->token());
+    auto *runner = ectx()->rctx()->runner();
+    // The query is killed anyway, the storage hosts failed to reach just
+    // keep scanning for it until its reads time out or finish
+    auto cb = [this, id] (auto &&resp) {
+        if (resp.completeness() != 100) {
+            LOG(INFO) << "Kill query " << id << " on the storage partially failed: "
+                      << resp.completeness() << "%";
+        }
+        DCHECK(onFinish_);
+        onFinish_();
+    };
+    auto error = [this] (auto &&e) {
+        LOG(ERROR) << "Exception caught: " << e.what();
+        DCHECK(onFinish_);
+        onFinish_();
+    };
+    std::move(future).via(runner).thenValue(cb).thenError(error);
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -0,0 +1,43 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_KILLQUERYEXECUTOR_H_
+#define GRAPH_KILLQUERYEXECUTOR_H_
+
+#include "base/Base.h"
+#include "graph/Executor.h"
+
+namespace nebula {
+namespace graph {
+
+/**
+ * Stop a query running on this graphd, with the id listed by SHOW QUERIES, e.g.
+ *   KILL QUERY 12
+ *
+ * The query fails at its next step, and the storage hosts are told to stop
+ * the reads of the query meanwhile.
+ */
+class KillQueryExecutor final : public Executor {
+public:
+    KillQueryExecutor(Sentence *sentence, ExecutionContext *ectx);
+
+    const char* name() const override {
+        return "KillQueryExecutor";
+    }
+
+    Status MUST_USE_RESULT prepare() override;
+
+    void execute() override;
+
+private:
+    KillQuerySentence                          *sentence_{nullptr};
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+
+#endif  // GRAPH_KILLQUERYEXECUTOR_H_
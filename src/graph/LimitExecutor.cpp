@@ -0,0 +1,81 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/LimitExecutor.h"
+
+namespace nebula {
+namespace graph {
+
+LimitExecutor::LimitExecutor(Sentence *sentence, ExecutionContext *ectx)
+    : TraverseExecutor(ectx) {
+    sentence_ = static_cast<LimitSentence*>(sentence);
+}
+
+Status LimitExecutor::prepare() {
+    if (sentence_->offset() < 0 || sentence_->count() < 0) {
+        return Status::SyntaxError("Offset and count of LIMIT could not be negative");
+    }
+    return Status::OK();
+}
+
+void LimitExecutor::feedResult(std::unique_ptr<InterimResult> result) {
+    if (result == nullptr) {
+        return;
+    }
+    auto begin = sentence_->offset();
+    auto end = begin + sentence_->count();
+    auto numRows = static_cast<int64_t>(result->numRows());
+    // Pick the rows within [begin, end) of this batch, without decoding them
+    if (numInputs_ < end && numInputs_ + numRows > begin) {
+        auto offset = std::max(begin - numInputs_, 0L);
+        auto count = std::min(end - numInputs_, numRows) - offset;
+        outputs_.emplace_back(result->slice(offset, count));
+    }
+    numInputs_ += numRows;
+}
+
+void LimitExecutor::execute() {
+    FLOG_INFO("Executing Limit: %s", sentence_->toString().c_str());
+    if (onResult_) {
+        if (outputs_.empty()) {
+            onResult_(nullptr);
+        }
+        for (auto &output : outputs_) {
+            onResult_(std::move(output));
+        }
+        outputs_.clear();
+    }
+    DCHECK(onFinish_);
+    onFinish_();
+}
+
+void LimitExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
+    if (outputs_.empty()) {
+        return;
+    }
+
+    auto schema = outputs_.front()->schema();
+    std::vector<std::string> columnNames;
+    columnNames.reserve(schema->getNumFields());
+    auto field = schema->begin();
+    while (field) {
+        columnNames.emplace_back(field->getName());
+        ++field;
+    }
+    resp.set_column_names(std::move(columnNames));
+    std::vector<cpp2::RowValue> rows;
+    for (auto &output : outputs_) {
+        output->forEachRow([&rows] (cpp2::RowValue &row) {
+            rows.emplace_back(std::move(row));
+            return true;
+        });
+    }
+    resp.set_rows(std::move(rows));
+}
+
+}  // namespace graph
+}  // namespace nebula
@@ -0,0 +1,46 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_LIMITEXECUTOR_H_
+#define GRAPH_LIMITEXECUTOR_H_
+
+#include "base/Base.h"
+#include "graph/TraverseExecutor.h"
+
+namespace nebula {
+namespace graph {
+
+class LimitExecutor final : public TraverseExecutor {
+public:
+    LimitExecutor(Sentence *sentence, ExecutionContext *ectx);
+
+    const char* name() const override {
+        return "LimitExecutor";
+    }
+
+    Status MUST_USE_RESULT prepare() override;
+
+    void execute() override;
+
+    void feedResult(std::unique_ptr<InterimResult> result) override;
+
+    // Only the rows within the range are kept, as the batches arrive
+    bool acceptsBatches() const override {
+        return true;
+    }
+
+    void setupResponse(cpp2::ExecutionResponse &resp) override;
+
+private:
+    LimitSentence                                              *sentence_{nullptr};
+    // Number of the input rows so far
+    int64_t                                                     numInputs_{0};
+    // Slices of the input batches, sharing the columns with them
+    std::vector<std::unique_ptr<InterimResult>>                 outputs_;
+};
+}  // namespace graph
+}  // namespace nebula
+#endif  // GRAPH_LIMITEXECUTOR_H_
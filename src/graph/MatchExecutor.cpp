@@ -6,6 +6,9 @@
 
 #include "base/Base.h"
 #include "graph/MatchExecutor.h"
+#include "graph/GraphFlags.h"
+#include "dataman/RowSetWriter.h"
+#include "dataman/SchemaWriter.h"
 
 namespace nebula {
 namespace graph {
@@ -17,7 +20,339 @@ MatchExecutor::MatchExecutor(Sentence *sentence, ExecutionContext *ectx)
 
 
 Status MatchExecutor::prepare() {
-    return Status::Error("Does not support");
+    return Status::OK();
+}
+
+
+Status MatchExecutor::prepareClauses() {
+    DCHECK(sentence_ != nullptr);
+    Status status;
+    do {
+        status = checkIfGraphSpaceChosen();
+        if (!status.ok()) {
+            break;
+        }
+        for (auto *path : sentence_->patterns()->paths()) {
+            status = preparePath(path);
+            if (!status.ok()) {
+                break;
+            }
+        }
+        if (!status.ok()) {
+            break;
+        }
+        // Nodes are only bound from the ones bound before, starting from the first
+        std::vector<bool> reached(nodes_.size(), false);
+        reached[0] = true;
+        for (auto changed = true; changed;) {
+            changed = false;
+            for (auto &edge : edges_) {
+                if (reached[edge.src] != reached[edge.dst]) {
+                    reached[edge.src] = reached[edge.dst] = true;
+                    changed = true;
+                }
+            }
+        }
+        for (auto i = 1UL; i < nodes_.size(); i++) {
+            if (!reached[i]) {
+                status = Status::Error("Node `%s' is not connected to `%s'",
+                                       nodes_[i].c_str(), nodes_[0].c_str());
+                break;
+            }
+        }
+        if (!status.ok()) {
+            break;
+        }
+        status = prepareVids(sentence_->from(), from_);
+        if (!status.ok()) {
+            break;
+        }
+    } while (false);
+    return status;
+}
+
+
+Status MatchExecutor::preparePath(const MatchPath *path) {
+    auto nodes = path->nodes();
+    auto edges = path->edges();
+    DCHECK_EQ(nodes.size(), edges.size() + 1);
+    auto left = nodeIndex(*nodes[0]);
+    for (auto i = 0UL; i < edges.size(); i++) {
+        auto right = nodeIndex(*nodes[i + 1]);
+        auto status = prepareEdge(edges[i], left, right);
+        if (!status.ok()) {
+            return status;
+        }
+        left = right;
+    }
+    return Status::OK();
+}
+
+
+Status MatchExecutor::prepareEdge(const MatchEdge *edge, size_t left, size_t right) {
+    auto spaceId = ectx()->rctx()->session()->space();
+    auto edgeStatus = ectx()->schemaManager()->toEdgeType(spaceId, *edge->edge());
+    if (!edgeStatus.ok()) {
+        return edgeStatus.status();
+    }
+    Edge e;
+    e.type = edgeStatus.value();
+    e.src = edge->isReversely() ? right : left;
+    e.dst = edge->isReversely() ? left : right;
+    auto *clause = edge->whereClause();
+    if (clause != nullptr) {
+        auto *filter = clause->filter();
+        ExpressionContext ctx;
+        filter->setContext(&ctx);
+        auto status = filter->prepare();
+        if (!status.ok()) {
+            return status;
+        }
+        // The filter is evaluated by the storage, along with the edges of the src
+        if (ctx.hasDstTagProp() || ctx.hasInputProp() || ctx.hasVariableProp()) {
+            return Status::Error("Only the props of `%s' and of its source could be filtered on",
+                                 edge->edge()->c_str());
+        }
+        for (auto &prop : ctx.aliasProps()) {
+            if (prop.first != *edge->edge()) {
+                return Status::Error("Unknown edge `%s'", prop.first.c_str());
+            }
+        }
+        e.filter = Expression::encode(filter);
+    }
+    edges_.emplace_back(std::move(e));
+    return Status::OK();
+}
+
+
+size_t MatchExecutor::nodeIndex(const std::string &name) {
+    auto it = std::find(nodes_.begin(), nodes_.end(), name);
+    if (it != nodes_.end()) {
+        return it - nodes_.begin();
+    }
+    nodes_.emplace_back(name);
+    return nodes_.size() - 1;
+}
+
+
+void MatchExecutor::execute() {
+    FLOG_INFO("Executing Match: %s", sentence_->toString().c_str());
+    auto status = prepareClauses();
+    if (!status.ok()) {
+        DCHECK(onError_);
+        onError_(std::move(status));
+        return;
+    }
+
+    bound_.resize(nodes_.size(), false);
+    bound_[0] = true;
+    rows_.reserve(from_.size());
+    for (auto vid : from_) {
+        rows_.emplace_back(nodes_.size(), 0);
+        rows_.back()[0] = vid;
+    }
+
+    // Without the stats, e.g. while they are gathered the first time,
+    // all the degrees are taken as the same
+    auto *cache = ectx()->spaceStats();
+    if (cache != nullptr) {
+        stats_ = cache->get(ectx()->storage(),
+                            ectx()->rctx()->runner(),
+                            ectx()->rctx()->session()->space());
+    }
+    matchNext();
+}
+
+
+void MatchExecutor::matchNext() {
+    auto step = nextStep();
+    if (rows_.empty() || !step.hasValue()) {
+        finishExecution();
+        return;
+    }
+
+    auto &edge = edges_[step->edge];
+    auto ids = distinctVids(step->outBound ? edge.src : edge.dst);
+    auto future = getNeighborIds(std::move(ids),
+                                 edge.type,
+                                 step->outBound,
+                                 step->outBound ? edge.filter : "");
+    auto *runner = ectx()->rctx()->runner();
+    auto cb = [this, step = step.value()] (NeighborsResponse &&result) {
+        auto status = onStep(step, std::move(result));
+        if (!status.ok()) {
+            DCHECK(onError_);
+            onError_(std::move(status));
+            return;
+        }
+        matchNext();
+    };
+    auto error = [this] (auto &&e) {
+        LOG(ERROR) << "Exception caught: " << e.what();
+        onError_(Status::Error("Internal error"));
+    };
+    std::move(future).via(runner).thenValue(cb).thenError(error);
+}
+
+
+folly::Optional<MatchExecutor::Step> MatchExecutor::nextStep() const {
+    std::unordered_map<size_t, size_t> frontiers;
+    auto frontier = [&] (size_t node) {
+        auto it = frontiers.find(node);
+        if (it == frontiers.end()) {
+            it = frontiers.emplace(node, distinctVids(node).size()).first;
+        }
+        return static_cast<double>(it->second);
+    };
+    folly::Optional<Step> best;
+    double bestCost = 0;
+    // The edges with a filter are only taken into their dst if no other step is left.
+    // Such a step does not match the edge, which is then taken out of its src
+    // with the filter, to join the rows.
+    for (auto unfiltered : {false, true}) {
+        for (auto i = 0UL; i < edges_.size(); i++) {
+            auto &edge = edges_[i];
+            if (edge.matched) {
+                continue;
+            }
+            for (auto outBound : {true, false}) {
+                auto from = outBound ? edge.src : edge.dst;
+                auto to = outBound ? edge.dst : edge.src;
+                if (!bound_[from] || (!outBound && !edge.filter.empty() && !unfiltered)) {
+                    continue;
+                }
+                auto degree = stats_ == nullptr ? 1.0 : stats_->degree(edge.type, outBound);
+                auto cost = frontier(from) * degree;
+                if (!bound_[to]) {
+                    cost += rows_.size() * degree;
+                }
+                if (!best.hasValue() || cost < bestCost) {
+                    best = Step{i, outBound};
+                    bestCost = cost;
+                }
+            }
+        }
+        if (best.hasValue()) {
+            break;
+        }
+    }
+    return best;
+}
+
+
+std::vector<VertexID> MatchExecutor::distinctVids(size_t node) const {
+    std::vector<VertexID> vids;
+    vids.reserve(rows_.size());
+    for (auto &row : rows_) {
+        vids.emplace_back(row[node]);
+    }
+    std::sort(vids.begin(), vids.end());
+    vids.erase(std::unique(vids.begin(), vids.end()), vids.end());
+    return vids;
+}
+
+
+Status MatchExecutor::onStep(const Step &step, NeighborsResponse &&result) {
+    auto &edge = edges_[step.edge];
+    auto from = step.outBound ? edge.src : edge.dst;
+    auto to = step.outBound ? edge.dst : edge.src;
+    // The neighbors of each vertex of the frontier, along the step
+    std::unordered_map<VertexID, std::vector<VertexID>> neighbors;
+    auto status = forEachNeighbor(std::move(result), [&] (VertexID vid, VertexID dst) {
+        neighbors[vid].emplace_back(dst);
+        return Status::OK();
+    });
+    if (!status.ok()) {
+        return status;
+    }
+    // The edges of different ranks between the same vertices match the same
+    for (auto &pair : neighbors) {
+        auto &dsts = pair.second;
+        std::sort(dsts.begin(), dsts.end());
+        dsts.erase(std::unique(dsts.begin(), dsts.end()), dsts.end());
+    }
+
+    std::vector<std::vector<VertexID>> rows;
+    if (bound_[to]) {
+        // Join the rows with the edges on the pair of the ends
+        for (auto &row : rows_) {
+            auto it = neighbors.find(row[from]);
+            if (it == neighbors.end()) {
+                continue;
+            }
+            if (std::binary_search(it->second.begin(), it->second.end(), row[to])) {
+                rows.emplace_back(std::move(row));
+            }
+        }
+    } else {
+        for (auto &row : rows_) {
+            auto it = neighbors.find(row[from]);
+            if (it == neighbors.end()) {
+                continue;
+            }
+            for (auto vid : it->second) {
+                if (rows.size() >= static_cast<size_t>(FLAGS_match_max_rows)) {
+                    return Status::Error("Too many rows matched, more than %ld",
+                                         FLAGS_match_max_rows);
+                }
+                rows.emplace_back(row);
+                rows.back()[to] = vid;
+            }
+        }
+        bound_[to] = true;
+    }
+    rows_ = std::move(rows);
+    edge.matched = step.outBound || edge.filter.empty();
+    return Status::OK();
+}
+
+
+void MatchExecutor::finishExecution() {
+    if (onResult_) {
+        std::unique_ptr<InterimResult> outputs;
+        if (!rows_.empty()) {
+            auto schema = std::make_shared<SchemaWriter>();
+            for (auto &node : nodes_) {
+                schema->appendCol(node, nebula::cpp2::SupportedType::VID);
+            }
+            auto rsWriter = std::make_unique<RowSetWriter>(schema);
+            for (auto &row : rows_) {
+                RowWriter writer(schema);
+                for (auto vid : row) {
+                    writer << vid;
+                }
+                rsWriter->addRow(writer.encode());
+            }
+            outputs = std::make_unique<InterimResult>(std::move(rsWriter));
+        }
+        onResult_(std::move(outputs));
+    } else {
+        resp_ = std::make_unique<cpp2::ExecutionResponse>();
+        resp_->set_column_names(nodes_);
+        std::vector<cpp2::RowValue> rows;
+        rows.reserve(rows_.size());
+        for (auto &row : rows_) {
+            std::vector<cpp2::ColumnValue> columns(row.size());
+            for (auto i = 0UL; i < row.size(); i++) {
+                columns[i].set_id(row[i]);
+            }
+            rows.emplace_back();
+            rows.back().set_columns(std::move(columns));
+        }
+        if (!rows.empty()) {
+            resp_->set_rows(std::move(rows));
+        }
+    }
+    DCHECK(onFinish_);
+    onFinish_();
+}
+
+
+void MatchExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
+    if (resp_ == nullptr) {
+        resp_ = std::make_unique<cpp2::ExecutionResponse>();
+    }
+    resp = std::move(*resp_);
 }
 
 }   // namespace graph
@@ -9,6 +9,20 @@
 
 #include "base/Base.h"
 #include "graph/TraverseExecutor.h"
+#include "graph/SpaceStatsCache.h"
+#include "storage/client/StorageClient.h"
+
+/**
+ * MatchExecutor binds the nodes of the patterns to vertices, starting from the
+ * vertices given for the first node, one edge of the patterns at a time.
+ *
+ * The edge taken next is the cheapest one with any end bound, estimated with the
+ * average degrees from the space stats: the edges to fetch from the frontier, plus
+ * the rows it would expand to. So the edges with the fewer neighbors are taken first,
+ * and an edge with both ends bound, which only filters the rows, as soon as possible,
+ * by joining the rows with the edges fetched on the pair of its ends.
+ * Until the stats of the space have been gathered, all the degrees are taken as 1.
+ */
 
 namespace nebula {
 namespace graph {
@@ -18,19 +32,71 @@ public:
     MatchExecutor(Sentence *sentence, ExecutionContext *ectx);
 
     const char* name() const override {
-        return "UseExecutor";
+        return "MatchExecutor";
     }
 
     Status MUST_USE_RESULT prepare() override;
 
+    void execute() override;
+
     void feedResult(std::unique_ptr<InterimResult> result) override {
         UNUSED(result);
     }
 
-    void execute() override {}
+    void setupResponse(cpp2::ExecutionResponse &resp) override;
+
+private:
+    // An edge of the patterns, with the indexes of its nodes, in the direction of the edge
+    struct Edge {
+        size_t                                  src;
+        size_t                                  dst;
+        EdgeType                                type;
+        // The encoded filter, which is pushed down along the out-edges only
+        std::string                             filter;
+        bool                                    matched{false};
+    };
+
+    // To take `edge' out of its src, or into its dst if not `outBound'
+    struct Step {
+        size_t                                  edge;
+        bool                                    outBound;
+    };
+
+    Status prepareClauses();
+
+    Status preparePath(const MatchPath *path);
+
+    Status prepareEdge(const MatchEdge *edge, size_t left, size_t right);
+
+    size_t nodeIndex(const std::string &name);
+
+    /**
+     * To take the cheapest step, or to finish the matching.
+     */
+    void matchNext();
+
+    folly::Optional<Step> nextStep() const;
+
+    std::vector<VertexID> distinctVids(size_t node) const;
+
+    /**
+     * To expand the rows with the edges of one step, or to filter them
+     * if the other end of the edge has been bound too.
+     */
+    Status onStep(const Step &step, NeighborsResponse &&result);
+
+    void finishExecution();
 
 private:
-    MatchSentence                                *sentence_{nullptr};
+    MatchSentence                              *sentence_{nullptr};
+    std::vector<std::string>                    nodes_;
+    std::vector<Edge>                           edges_;
+    std::vector<VertexID>                       from_;
+    std::shared_ptr<const SpaceStats>           stats_;
+    std::vector<bool>                           bound_;
+    // The vertices bound to the nodes, with 0 for the nodes not bound yet
+    std::vector<std::vector<VertexID>>          rows_;
+    std::unique_ptr<cpp2::ExecutionResponse>    resp_;
 };
 
 }   // namespace graph
@@ -0,0 +1,101 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/MemoryTracker.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+// Charged by the trackers without a parent, i.e. the sessions'
+std::atomic<int64_t> totalUsed{0};
+std::atomic<int64_t> totalPeak{0};
+std::atomic<int64_t> totalExceeded{0};
+
+// A buffer smaller than this is not spilled for the soft limit
+constexpr int64_t kMinSpillBytes = 1L << 20;
+
+void updatePeak(std::atomic<int64_t> &peak, int64_t now) {
+    auto old = peak.load();
+    while (now > old && !peak.compare_exchange_weak(old, now)) {
+    }
+}
+
+}   // Anonymous namespace
+
+
+MemoryTracker::MemoryTracker(std::string name,
+                             int64_t limit,
+                             int64_t softLimit,
+                             std::shared_ptr<MemoryTracker> parent)
+    : name_(std::move(name))
+    , limit_(limit)
+    , softLimit_(softLimit)
+    , parent_(std::move(parent)) {
+}
+
+
+MemoryTracker::~MemoryTracker() {
+    release(used_);
+}
+
+
+Status MemoryTracker::consume(int64_t bytes) {
+    if (bytes <= 0) {
+        return Status::OK();
+    }
+    auto now = used_.fetch_add(bytes) + bytes;
+    if (limit_ > 0 && now > limit_) {
+        used_ -= bytes;
+        totalExceeded++;
+        return Status::Error("Memory limit of the %s exceeded: %ld bytes",
+                             name_.c_str(), limit_);
+    }
+    if (parent_ != nullptr) {
+        auto status = parent_->consume(bytes);
+        if (!status.ok()) {
+            used_ -= bytes;
+            return status;
+        }
+    } else {
+        updatePeak(totalPeak, totalUsed.fetch_add(bytes) + bytes);
+    }
+    updatePeak(peak_, now);
+    return Status::OK();
+}
+
+
+void MemoryTracker::release(int64_t bytes) {
+    if (bytes <= 0) {
+        return;
+    }
+    used_ -= bytes;
+    if (parent_ != nullptr) {
+        parent_->release(bytes);
+    } else {
+        totalUsed -= bytes;
+    }
+}
+
+
+bool MemoryTracker::shouldSpill(int64_t bytes) const {
+    return bytes >= kMinSpillBytes && overSoftLimit();
+}
+
+
+// static
+MemoryTracker::Stats MemoryTracker::stats() {
+    Stats s;
+    s.used = totalUsed.load();
+    s.peak = totalPeak.load();
+    s.exceeded = totalExceeded.load();
+    return s;
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -0,0 +1,113 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_MEMORYTRACKER_H_
+#define GRAPH_MEMORYTRACKER_H_
+
+#include "base/Base.h"
+#include "base/Status.h"
+#include "cpp/helpers.h"
+
+/**
+ * MemoryTracker counts the bytes held by a query, or by all the running queries
+ * of a session. A query's tracker charges its session's as well, so either limit
+ * could stop a query from taking more.
+ *
+ * The bytes are estimated by the executors on the results they keep, so they are
+ * the bulk of a query's memory rather than the exact amount. Whatever is still
+ * charged is given back when the tracker is destroyed, i.e. with the query.
+ *
+ * Beyond the soft limit, the executors able to spill to disk do so earlier than
+ * their own memory limits; beyond the hard limit, nothing more could be charged.
+ *
+ * MemoryCharge gives back the bytes of a result once the result is dropped,
+ * rather than with the query.
+ */
+
+namespace nebula {
+namespace graph {
+
+class MemoryTracker final : public cpp::NonCopyable, public cpp::NonMovable {
+public:
+    struct Stats {
+        // The bytes charged by all the sessions now, and at most
+        int64_t used{0};
+        int64_t peak{0};
+        // Times of a hard limit reached
+        int64_t exceeded{0};
+    };
+
+    /**
+     * @name        to tell the tracker in the errors, e.g. "query 12"
+     * @limit       the hard limit, 0 for no limit
+     * @softLimit   0 for no limit
+     * @parent      charged along with this tracker
+     */
+    MemoryTracker(std::string name,
+                  int64_t limit,
+                  int64_t softLimit,
+                  std::shared_ptr<MemoryTracker> parent = nullptr);
+    ~MemoryTracker();
+
+    // Nothing is charged if any limit on the way up would be exceeded
+    Status MUST_USE_RESULT consume(int64_t bytes);
+
+    void release(int64_t bytes);
+
+    int64_t used() const {
+        return used_;
+    }
+
+    int64_t peak() const {
+        return peak_;
+    }
+
+    int64_t limit() const {
+        return limit_;
+    }
+
+    bool overSoftLimit() const {
+        return softLimit_ > 0 && used_ > softLimit_;
+    }
+
+    // Whether a buffer of `bytes' ought to be spilled to ease the memory,
+    // which is not worth it for a small one
+    bool shouldSpill(int64_t bytes) const;
+
+    // The process-wide statistics
+    static Stats stats();
+
+private:
+    const std::string                           name_;
+    const int64_t                               limit_{0};
+    const int64_t                               softLimit_{0};
+    std::shared_ptr<MemoryTracker>              parent_;
+    std::atomic<int64_t>                        used_{0};
+    std::atomic<int64_t>                        peak_{0};
+};
+
+
+class MemoryCharge final : public cpp::NonCopyable, public cpp::NonMovable {
+public:
+    // `bytes' have been consumed from `tracker', to be released by the charge
+    MemoryCharge(std::shared_ptr<MemoryTracker> tracker, int64_t bytes)
+        : tracker_(std::move(tracker))
+        , bytes_(bytes) {
+    }
+
+    ~MemoryCharge() {
+        tracker_->release(bytes_);
+    }
+
+private:
+    std::shared_ptr<MemoryTracker>              tracker_;
+    const int64_t                               bytes_{0};
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_MEMORYTRACKER_H_
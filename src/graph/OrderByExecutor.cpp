@@ -6,9 +6,49 @@
 
 #include "base/Base.h"
 #include "graph/OrderByExecutor.h"
+#include "graph/ExternalSorter.h"
+#include "graph/GraphFlags.h"
+#include <numeric>
 
 namespace nebula {
 namespace graph {
+
+namespace {
+
+// The sorted rows are passed on in batches of this many rows
+constexpr size_t kOutputBatchRows = 4096;
+
+// Compares row `a' with row `b' of one column, negative if `a' is smaller
+int compareAt(const ColumnBatch::Column &col, size_t a, size_t b) {
+    using nebula::cpp2::SupportedType;
+    switch (col.type()) {
+        case SupportedType::BOOL:
+            return static_cast<int>(col.getBool(a)) - static_cast<int>(col.getBool(b));
+        case SupportedType::INT:
+        case SupportedType::VID:
+        case SupportedType::TIMESTAMP: {
+            auto lhs = col.getInt(a);
+            auto rhs = col.getInt(b);
+            return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+        }
+        case SupportedType::FLOAT:
+        case SupportedType::DOUBLE: {
+            auto lhs = col.getDouble(a);
+            auto rhs = col.getDouble(b);
+            return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+        }
+        case SupportedType::STRING:
+            if (col.getCode(a) == col.getCode(b)) {
+                return 0;
+            }
+            return col.getString(a).compare(col.getString(b));
+        default:
+            return 0;
+    }
+}
+
+}   // Anonymous namespace
+
 namespace cpp2 {
 
 bool ColumnValue::operator < (const ColumnValue& rhs) const {
@@ -78,104 +118,246 @@ Status OrderByExecutor::prepare() {
 }
 
 void OrderByExecutor::feedResult(std::unique_ptr<InterimResult> result) {
-    if (result == nullptr) {
+    if (result == nullptr || result->numRows() == 0) {
         return;
     }
     DCHECK(sentence_ != nullptr);
-    inputs_ = std::move(result);
-    rows_ = inputs_->getRows();
+    if (schema_ == nullptr) {
+        schema_ = result->schema();
+        setupSortFactors();
+    }
+    if (status_.ok()) {
+        status_ = addRows(std::move(result));
+    }
+}
 
-    auto schema = inputs_->schema();
+void OrderByExecutor::setupSortFactors() {
     auto factors = sentence_->factors();
     sortFactors_.reserve(factors.size());
     for (auto &factor : factors) {
         auto expr = static_cast<InputPropertyExpression*>(factor->expr());
         folly::StringPiece field = *(expr->prop());
-        auto fieldIndex = schema->getFieldIndex(field);
+        auto fieldIndex = schema_->getFieldIndex(field);
         if (fieldIndex == -1) {
             LOG(INFO) << "Field(" << field << ") not exist in input schema.";
             continue;
         }
-        auto pair = std::make_pair(schema->getFieldIndex(field), factor->orderType());
+        auto pair = std::make_pair(fieldIndex, factor->orderType());
         sortFactors_.emplace_back(std::move(pair));
     }
 }
 
-void OrderByExecutor::execute() {
-    FLOG_INFO("Executing Order By: %s", sentence_->toString().c_str());
-    auto comparator = [this] (cpp2::RowValue& lhs, cpp2::RowValue& rhs) {
-        const auto &lhsColumns = lhs.get_columns();
-        const auto &rhsColumns = rhs.get_columns();
-        for (auto &factor : this->sortFactors_) {
-            auto fieldIndex = factor.first;
-            auto orderType = factor.second;
-            if (lhsColumns[fieldIndex] == rhsColumns[fieldIndex]) {
+bool OrderByExecutor::lessThan(const cpp2::RowValue &lhs, const cpp2::RowValue &rhs) const {
+    const auto &lhsColumns = lhs.get_columns();
+    const auto &rhsColumns = rhs.get_columns();
+    for (auto &factor : sortFactors_) {
+        auto fieldIndex = factor.first;
+        auto orderType = factor.second;
+        if (lhsColumns[fieldIndex] == rhsColumns[fieldIndex]) {
+            continue;
+        }
+
+        if (orderType == OrderFactor::OrderType::ASCEND) {
+            return lhsColumns[fieldIndex] < rhsColumns[fieldIndex];
+        } else if (orderType == OrderFactor::OrderType::DESCEND) {
+            return lhsColumns[fieldIndex] > rhsColumns[fieldIndex];
+        } else {
+            LOG(FATAL) << "Unkown Order Type: " << orderType;
+        }
+    }
+    return false;
+}
+
+std::vector<uint32_t> OrderByExecutor::sortedIndexes(const ColumnBatch &batch,
+                                                     size_t limit) const {
+    std::vector<uint32_t> indexes(batch.numRows());
+    std::iota(indexes.begin(), indexes.end(), 0);
+    auto less = [&] (uint32_t lhs, uint32_t rhs) {
+        for (auto &factor : sortFactors_) {
+            auto cmp = compareAt(batch.column(factor.first), lhs, rhs);
+            if (cmp == 0) {
                 continue;
             }
-
-            if (orderType == OrderFactor::OrderType::ASCEND) {
-                return lhsColumns[fieldIndex] < rhsColumns[fieldIndex];
-            } else if (orderType == OrderFactor::OrderType::DESCEND) {
-                return lhsColumns[fieldIndex] > rhsColumns[fieldIndex];
+            if (factor.second == OrderFactor::OrderType::ASCEND) {
+                return cmp < 0;
+            } else if (factor.second == OrderFactor::OrderType::DESCEND) {
+                return cmp > 0;
             } else {
-                LOG(FATAL) << "Unkown Order Type: " << orderType;
+                LOG(FATAL) << "Unkown Order Type: " << factor.second;
             }
         }
-        return false;
+        // Ties are broken by the arrival order, to keep the sort stable
+        return lhs < rhs;
     };
+    if (limit < indexes.size()) {
+        std::partial_sort(indexes.begin(), indexes.begin() + limit, indexes.end(), less);
+        indexes.resize(limit);
+    } else {
+        std::sort(indexes.begin(), indexes.end(), less);
+    }
+    return indexes;
+}
 
-    if (!sortFactors_.empty()) {
-        std::sort(rows_.begin(), rows_.end(), comparator);
+Status OrderByExecutor::addRows(std::unique_ptr<InterimResult> result) {
+    if (limit_ >= 0) {
+        return addTopN(std::move(result));
+    }
+    if (sorter_ != nullptr) {
+        return addToSorter(*result);
+    }
+    // The batches are kept as they are, and sorted by their row indexes at last,
+    // till there are too many of them to sort in memory
+    auto bytes = static_cast<int64_t>(result->memoryBytes());
+    auto *tracker = ectx()->memory();
+    if (sortFactors_.empty() || (bufferedBytes_ + bytes <= FLAGS_order_by_memory_limit_bytes &&
+            (tracker == nullptr || !tracker->shouldSpill(bufferedBytes_ + bytes)))) {
+        auto status = ectx()->trackResult(*result);
+        if (!status.ok()) {
+            return status;
+        }
+        bufferedBytes_ += bytes;
+        batches_.emplace_back(std::move(result));
+        return Status::OK();
+    }
+    // Not charged, the rows are charged one by one by the sorter instead
+    batches_.emplace_back(std::move(result));
+    auto less = [this] (const cpp2::RowValue &lhs, const cpp2::RowValue &rhs) {
+        return lessThan(lhs, rhs);
+    };
+    sorter_ = std::make_unique<ExternalSorter>(std::move(less),
+                                               FLAGS_order_by_memory_limit_bytes,
+                                               FLAGS_spill_dir,
+                                               tracker);
+    auto batches = std::move(batches_);
+    batches_.clear();
+    bufferedBytes_ = 0;
+    for (auto &batch : batches) {
+        auto status = addToSorter(*batch);
+        if (!status.ok()) {
+            return status;
+        }
+        batch.reset();
+    }
+    return Status::OK();
+}
+
+Status OrderByExecutor::addToSorter(const InterimResult &result) {
+    Status status;
+    result.forEachRow([&] (cpp2::RowValue &row) {
+        status = sorter_->add(std::move(row));
+        return status.ok();
+    });
+    return status;
+}
+
+void OrderByExecutor::execute() {
+    FLOG_INFO("Executing Order By: %s", sentence_->toString().c_str());
+    auto status = status_;
+    if (status.ok()) {
+        if (limit_ >= 0) {
+            status = compactTopN();
+            result_ = InterimResult::merge(std::move(batches_));
+        } else if (sorter_ != nullptr) {
+            status = finishSort();
+        } else {
+            finishInMemory();
+        }
+    }
+    if (!status.ok()) {
+        DCHECK(onError_);
+        onError_(std::move(status));
+        return;
     }
 
     if (onResult_) {
-        onResult_(setupInterimResult());
+        if (!rows_.empty()) {
+            onResult_(setupInterimResult());
+        } else if (result_ != nullptr) {
+            onResult_(std::move(result_));
+        }
     }
     DCHECK(onFinish_);
     onFinish_();
 }
 
-std::unique_ptr<InterimResult> OrderByExecutor::setupInterimResult() {
-    if (rows_.empty()) {
-        return nullptr;
+Status OrderByExecutor::addTopN(std::unique_ptr<InterimResult> result) {
+    auto limit = static_cast<size_t>(limit_);
+    if (limit == 0 || (sortFactors_.empty() && bufferedRows_ >= limit)) {
+        // Nothing to sort, the first rows are just enough
+        return Status::OK();
+    }
+    auto status = ectx()->trackResult(*result);
+    if (!status.ok()) {
+        return status;
     }
+    bufferedRows_ += result->numRows();
+    batches_.emplace_back(std::move(result));
+    // Cut the rows down to the top ones once there are a few times as many
+    if (bufferedRows_ >= std::max(2 * limit, kOutputBatchRows)) {
+        return compactTopN();
+    }
+    return Status::OK();
+}
 
-    auto schema = inputs_->schema();
-    auto rsWriter = std::make_unique<RowSetWriter>(schema);
-    using Type = cpp2::ColumnValue::Type;
-    for (auto &row : rows_) {
-        RowWriter writer(schema);
-        auto columns = row.get_columns();
-        for (auto &column : columns) {
-            switch (column.getType()) {
-                case Type::integer:
-                    writer << column.get_integer();
-                    break;
-                case Type::double_precision:
-                    writer << column.get_double_precision();
-                    break;
-                case Type::bool_val:
-                    writer << column.get_bool_val();
-                    break;
-                case Type::str:
-                    writer << column.get_str();
-                    break;
-                default:
-                    LOG(FATAL) << "Not Support: " << column.getType();
-            }
+Status OrderByExecutor::compactTopN() {
+    auto merged = InterimResult::merge(std::move(batches_));
+    batches_.clear();
+    bufferedRows_ = 0;
+    if (merged == nullptr) {
+        return Status::OK();
+    }
+    auto indexes = sortedIndexes(*merged->batch(), static_cast<size_t>(limit_));
+    bufferedRows_ = indexes.size();
+    // Built from the batch rather than selected from `merged', so that the rows cut
+    // are given back along with the charges of `merged'
+    auto top = std::make_unique<InterimResult>(merged->schema(), merged->batch()->select(indexes));
+    auto status = ectx()->trackResult(*top);
+    batches_.emplace_back(std::move(top));
+    return status;
+}
+
+void OrderByExecutor::finishInMemory() {
+    auto merged = InterimResult::merge(std::move(batches_));
+    batches_.clear();
+    bufferedBytes_ = 0;
+    if (merged == nullptr || sortFactors_.empty()) {
+        result_ = std::move(merged);
+        return;
+    }
+    result_ = merged->select(sortedIndexes(*merged->batch(), merged->numRows()));
+}
+
+Status OrderByExecutor::finishSort() {
+    if (sorter_->numRuns() > 0) {
+        LOG(INFO) << "Order By spilled " << sorter_->numRuns() << " sorted runs to disk";
+    }
+    // Passed on in batches as the runs are merged, unless kept for the response
+    auto status = sorter_->finish([this] (cpp2::RowValue &row) {
+        rows_.emplace_back(std::move(row));
+        if (onResult_ && rows_.size() >= kOutputBatchRows) {
+            onResult_(setupInterimResult());
         }
-        rsWriter->addRow(writer);
+    });
+    sorter_.reset();
+    return status;
+}
+
+std::unique_ptr<InterimResult> OrderByExecutor::setupInterimResult() {
+    if (rows_.empty()) {
+        return nullptr;
     }
 
-    return std::make_unique<InterimResult>(std::move(rsWriter));
+    auto result = InterimResult::getInterim(schema_, rows_);
+    rows_.clear();
+    return result;
 }
 
 void OrderByExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
-    if (rows_.empty()) {
+    if (rows_.empty() && result_ == nullptr) {
         return;
     }
 
-    auto schema = inputs_->schema();
+    auto schema = schema_;
     std::vector<std::string> columnNames;
     columnNames.reserve(schema->getNumFields());
     auto field = schema->begin();
@@ -184,7 +366,7 @@ void OrderByExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
         ++field;
     }
     resp.set_column_names(std::move(columnNames));
-    resp.set_rows(std::move(rows_));
+    resp.set_rows(rows_.empty() ? result_->getRows() : std::move(rows_));
 }
 
 }  // namespace graph
@@ -9,6 +9,7 @@
 
 #include "base/Base.h"
 #include "graph/TraverseExecutor.h"
+#include "graph/ExternalSorter.h"
 
 namespace nebula {
 namespace graph {
@@ -27,15 +28,65 @@ public:
 
     void feedResult(std::unique_ptr<InterimResult> result) override;
 
+    // The batches are kept, or spilled to disk, as they arrive
+    bool acceptsBatches() const override {
+        return true;
+    }
+
+    // The batches kept are charged here, the rows to spill by the sorter
+    bool tracksInputMemory() const override {
+        return true;
+    }
+
     void setupResponse(cpp2::ExecutionResponse &resp) override;
 
+    // Only the first `limit' rows are needed by the downstream, i.e. a LIMIT follows
+    void setLimit(int64_t limit) {
+        limit_ = limit;
+    }
+
 private:
+    void setupSortFactors();
+
+    bool lessThan(const cpp2::RowValue &lhs, const cpp2::RowValue &rhs) const;
+
+    // Indexes of the first `limit' rows of `batch' in the sorted order.
+    // Rows are compared column by column in place, without being decoded
+    std::vector<uint32_t> sortedIndexes(const ColumnBatch &batch, size_t limit) const;
+
+    Status addRows(std::unique_ptr<InterimResult> result);
+
+    Status addToSorter(const InterimResult &result);
+
+    // Keep the first `limit_' rows, cutting the batches down to them from time to time
+    Status addTopN(std::unique_ptr<InterimResult> result);
+
+    Status compactTopN();
+
+    // Sort the row indexes of the batches kept, and select the rows in that order
+    void finishInMemory();
+
+    // Merge the runs spilled to disk. The sorted rows are passed on to `onResult_'
+    // in batches while the runs are merged, if it is set
+    Status finishSort();
+
+    // Takes the rows of `rows_'
     std::unique_ptr<InterimResult> setupInterimResult();
 
 private:
     OrderBySentence                                            *sentence_{nullptr};
-    std::unique_ptr<InterimResult>                              inputs_;
+    int64_t                                                     limit_{-1};
+    std::shared_ptr<const meta::SchemaProviderIf>               schema_;
+    Status                                                      status_;
+    // Batches fed, till they are too many to be sorted in memory
+    std::vector<std::unique_ptr<InterimResult>>                 batches_;
+    int64_t                                                     bufferedBytes_{0};
+    size_t                                                      bufferedRows_{0};
+    std::unique_ptr<ExternalSorter>                             sorter_;
+    // Rows merged from the runs spilled
     std::vector<cpp2::RowValue>                                 rows_;
+    // Rows sorted in memory
+    std::unique_ptr<InterimResult>                              result_;
     std::vector<std::pair<int64_t, OrderFactor::OrderType>>     sortFactors_;
 };
 }  // namespace graph
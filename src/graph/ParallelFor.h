@@ -0,0 +1,43 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_PARALLELFOR_H_
+#define GRAPH_PARALLELFOR_H_
+
+#include "base/Base.h"
+#include <folly/futures/Future.h>
+
+namespace nebula {
+namespace graph {
+
+// Run fn(0), fn(1), ..., fn(tasks - 1) on the runner,
+// or in the current thread if there is only one task
+inline folly::Future<folly::Unit> parallelFor(size_t tasks,
+                                              folly::Executor *runner,
+                                              std::function<void(size_t)> fn) {
+    if (tasks <= 1 || runner == nullptr) {
+        for (auto i = 0UL; i < tasks; i++) {
+            fn(i);
+        }
+        return folly::makeFuture();
+    }
+    std::vector<folly::Future<folly::Unit>> futures;
+    futures.reserve(tasks);
+    for (auto i = 0UL; i < tasks; i++) {
+        futures.emplace_back(folly::via(runner, [fn, i] () { fn(i); }));
+    }
+    return folly::collect(futures).thenValue([] (auto&&) {});
+}
+
+// The i-th of n even slices of [0, size)
+inline std::pair<size_t, size_t> sliceOf(size_t size, size_t n, size_t i) {
+    return std::make_pair(size * i / n, size * (i + 1) / n);
+}
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_PARALLELFOR_H_
@@ -6,6 +6,7 @@
 
 #include "base/Base.h"
 #include "graph/PipeExecutor.h"
+#include "graph/OrderByExecutor.h"
 
 namespace nebula {
 namespace graph {
@@ -28,33 +29,65 @@ Status PipeExecutor::prepare() {
     DCHECK(right_ != nullptr);
 
     auto onError = [this] (Status s) {
-        /**
-         * TODO(dutor)
-         * If we allow concurrent execution of both sides, we must wait for all their
-         * internal on-fly async-requests' to arrive before call `onError_'.
-         * For the sake of simplicity, we don't allow the pipeline way for now.
-         */
         onError_(std::move(s));
     };
 
     // Setup dependencies
     {
         auto onFinish = [this] () {
+            auto status = ectx()->checkCancelled();
+            if (!status.ok()) {
+                if (!fed_) {
+                    onError_(std::move(status));
+                    return;
+                }
+                // Same as `left_' failed, `right_' is to finish on the batches fed.
+                leftStatus_ = std::move(status);
+                right_->execute();
+                return;
+            }
+            if (!batches_.empty()) {
+                right_->feedResult(InterimResult::merge(std::move(batches_)));
+            }
             // Start executing `right_' when `left_' is finished.
             right_->execute();
         };
         left_->setOnFinish(onFinish);
 
         auto onResult = [this] (std::unique_ptr<InterimResult> result) {
-            // Feed results from `left_' to `right_'
-            right_->feedResult(std::move(result));
+            // Charged till `right_' drops it, the query fails at its next check
+            // if that exceeds the memory limits
+            if (result != nullptr && !right_->tracksInputMemory()) {
+                ectx()->trackResult(*result);
+            }
+            // Feed results from `left_' to `right_', as soon as they are produced if possible
+            if (right_->acceptsBatches()) {
+                fed_ = true;
+                right_->feedResult(std::move(result));
+            } else {
+                batches_.emplace_back(std::move(result));
+            }
         };
         left_->setOnResult(onResult);
 
-        left_->setOnError(onError);
+        auto onLeftError = [this] (Status s) {
+            if (!fed_) {
+                onError_(std::move(s));
+                return;
+            }
+            // `right_' might be still working on the batches fed,
+            // so let it finish before the error is reported.
+            leftStatus_ = std::move(s);
+            right_->execute();
+        };
+        left_->setOnError(onLeftError);
     }
     {
         auto onFinish = [this] () {
+            if (!leftStatus_.ok()) {
+                onError_(std::move(leftStatus_));
+                return;
+            }
             // This executor is done when `right_' finishes.
             DCHECK(onFinish_);
             onFinish_();
@@ -63,6 +96,9 @@ Status PipeExecutor::prepare() {
 
         if (onResult_) {
             auto onResult = [this] (std::unique_ptr<InterimResult> result) {
+                if (!leftStatus_.ok()) {
+                    return;
+                }
                 // This executor takes results of `right_' as results.
                 onResult_(std::move(result));
             };
@@ -88,10 +124,38 @@ Status PipeExecutor::prepare() {
         return status;
     }
 
+    pushDownLimit();
 
     return Status::OK();
 }
 
+
+void PipeExecutor::pushDownLimit() {
+    if (sentence_->right()->kind() != Sentence::Kind::kLimit) {
+        return;
+    }
+    // The right most executor of the left side, e.g. ORDER BY of `GO | ORDER BY | LIMIT'
+    auto *executor = left_.get();
+    while (auto *pipe = dynamic_cast<PipeExecutor*>(executor)) {
+        executor = pipe->right();
+    }
+    auto *orderBy = dynamic_cast<OrderByExecutor*>(executor);
+    if (orderBy == nullptr) {
+        return;
+    }
+    auto *limit = static_cast<LimitSentence*>(sentence_->right());
+    auto offset = limit->offset();
+    auto count = limit->count();
+    if (offset < 0 || count < 0) {
+        return;
+    }
+    // The sum overflows, i.e. the top-N would not cut anything
+    if (count > std::numeric_limits<int64_t>::max() - offset) {
+        return;
+    }
+    orderBy->setLimit(offset + count);
+}
+
 Status PipeExecutor::syntaxPreCheck() {
     // Set op not support input,
     // because '$-' would be ambiguous in such a situation:
@@ -108,6 +172,16 @@ void PipeExecutor::execute() {
 }
 
 
+bool PipeExecutor::acceptsBatches() const {
+    return left_->acceptsBatches();
+}
+
+
+bool PipeExecutor::tracksInputMemory() const {
+    return left_->tracksInputMemory();
+}
+
+
 void PipeExecutor::feedResult(std::unique_ptr<InterimResult> result) {
     left_->feedResult(std::move(result));
 }
@@ -27,15 +27,31 @@ public:
 
     void feedResult(std::unique_ptr<InterimResult> result) override;
 
+    bool acceptsBatches() const override;
+
+    bool tracksInputMemory() const override;
+
     void setupResponse(cpp2::ExecutionResponse &resp) override;
 
+    TraverseExecutor* right() const {
+        return right_.get();
+    }
+
 private:
     Status syntaxPreCheck();
 
+    // Tell the ORDER BY right before a LIMIT how many rows are needed
+    void pushDownLimit();
+
 private:
     PipedSentence                              *sentence_{nullptr};
     std::unique_ptr<TraverseExecutor>           left_;
     std::unique_ptr<TraverseExecutor>           right_;
+    // Results of `left_' to be merged, for a `right_' which doesn't accept batches
+    std::vector<std::unique_ptr<InterimResult>> batches_;
+    // Whether any batch has been fed to `right_' before `left_' finishes
+    bool                                        fed_{false};
+    Status                                      leftStatus_;
 };
 
 }   // namespace graph
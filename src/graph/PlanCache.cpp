@@ -0,0 +1,155 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/PlanCache.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+std::atomic<int64_t> hits{0};
+std::atomic<int64_t> misses{0};
+std::atomic<int64_t> evictions{0};
+std::atomic<int64_t> invalidations{0};
+
+}   // Anonymous namespace
+
+
+std::unique_ptr<SequentialSentences> PlanCache::get(GraphSpaceID space,
+                                                    const std::string &query,
+                                                    int64_t schemaVersion) {
+    auto key = makeKey(space, query);
+    std::lock_guard<std::mutex> g(lock_);
+    checkSchemaVersion(schemaVersion);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        misses++;
+        return nullptr;
+    }
+    hits++;
+    auto sentences = std::move(it->second->second);
+    entries_.erase(it->second);
+    index_.erase(it);
+    return sentences;
+}
+
+
+void PlanCache::put(GraphSpaceID space,
+                    const std::string &query,
+                    int64_t schemaVersion,
+                    std::unique_ptr<SequentialSentences> sentences) {
+    if (capacity_ == 0 || sentences == nullptr) {
+        return;
+    }
+    auto key = makeKey(space, query);
+    std::lock_guard<std::mutex> g(lock_);
+    checkSchemaVersion(schemaVersion);
+    if (schemaVersion != schemaVersion_) {
+        // Parsed before the schema changed
+        return;
+    }
+    while (entries_.size() >= capacity_) {
+        auto &last = entries_.back();
+        auto range = index_.equal_range(last.first);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == std::prev(entries_.end())) {
+                index_.erase(it);
+                break;
+            }
+        }
+        entries_.pop_back();
+        evictions++;
+    }
+    entries_.emplace_front(key, std::move(sentences));
+    index_.emplace(std::move(key), entries_.begin());
+}
+
+
+size_t PlanCache::size() const {
+    std::lock_guard<std::mutex> g(lock_);
+    return entries_.size();
+}
+
+
+void PlanCache::checkSchemaVersion(int64_t schemaVersion) {
+    if (schemaVersion <= schemaVersion_) {
+        return;
+    }
+    if (!entries_.empty()) {
+        VLOG(1) << "Schema version changed from " << schemaVersion_
+                << " to " << schemaVersion << ", drop " << entries_.size()
+                << " cached plans";
+        invalidations++;
+    }
+    index_.clear();
+    entries_.clear();
+    schemaVersion_ = schemaVersion;
+}
+
+
+// static
+std::string PlanCache::normalize(const std::string &query) {
+    std::string result;
+    result.reserve(query.size());
+    char quote = '\0';
+    bool escaped = false;
+    // The pending white space, a newline is kept as is since it ends
+    // a line comment
+    char pendingSpace = '\0';
+    for (auto c : query) {
+        if (quote != '\0') {
+            // Inside a string literal, keep everything as it is
+            result.push_back(c);
+            if (escaped) {
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+            } else if (c == quote) {
+                quote = '\0';
+            }
+            continue;
+        }
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            if (!result.empty() && pendingSpace != '\n') {
+                pendingSpace = c == '\n' ? '\n' : ' ';
+            }
+            continue;
+        }
+        if (pendingSpace != '\0') {
+            result.push_back(pendingSpace);
+            pendingSpace = '\0';
+        }
+        if (c == '"' || c == '\'') {
+            quote = c;
+        }
+        result.push_back(c);
+    }
+    return result;
+}
+
+
+// static
+std::string PlanCache::makeKey(GraphSpaceID space, const std::string &query) {
+    auto key = folly::stringPrintf("%d:", space);
+    key.append(normalize(query));
+    return key;
+}
+
+
+// static
+PlanCache::Stats PlanCache::stats() {
+    Stats s;
+    s.hits = hits.load();
+    s.misses = misses.load();
+    s.evictions = evictions.load();
+    s.invalidations = invalidations.load();
+    return s;
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -0,0 +1,91 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_PLANCACHE_H_
+#define GRAPH_PLANCACHE_H_
+
+#include "base/Base.h"
+#include "cpp/helpers.h"
+#include "parser/SequentialSentences.h"
+
+/**
+ * PlanCache keeps the parsed sentences of recent queries, so the same query
+ * does not need to be parsed again.
+ *
+ * The executors keep per-execution state in the sentences (e.g. the
+ * expression contexts), so a cached entry is taken out of the cache while a
+ * query is running, and put back when the query is done. Several entries
+ * might exist for the same query if it runs concurrently.
+ *
+ * The entries are keyed by the normalized query text and the space, and the
+ * whole cache is dropped when the schema version from MetaClient changes.
+ */
+
+namespace nebula {
+namespace graph {
+
+class PlanCache final : public cpp::NonCopyable, public cpp::NonMovable {
+public:
+    struct Stats {
+        int64_t hits{0};
+        int64_t misses{0};
+        int64_t evictions{0};
+        int64_t invalidations{0};
+    };
+
+    explicit PlanCache(size_t capacity) : capacity_(capacity) {}
+
+    /**
+     * Take the parsed sentences of the query out of the cache.
+     * Returns nullptr if missed.
+     */
+    std::unique_ptr<SequentialSentences> get(GraphSpaceID space,
+                                             const std::string &query,
+                                             int64_t schemaVersion);
+
+    /**
+     * Put the parsed sentences back, the least recently used entry will
+     * be evicted if the cache is full.
+     */
+    void put(GraphSpaceID space,
+             const std::string &query,
+             int64_t schemaVersion,
+             std::unique_ptr<SequentialSentences> sentences);
+
+    size_t size() const;
+
+    /**
+     * Trim the query and collapse the white spaces outside the string
+     * literals, so trivially different queries share the same entry.
+     * Newlines are kept since they end the line comments
+     */
+    static std::string normalize(const std::string &query);
+
+    // The process-wide statistics
+    static Stats stats();
+
+private:
+    static std::string makeKey(GraphSpaceID space, const std::string &query);
+
+    // Drop all entries if the schema has changed.
+    // Pre-condition: The caller needs to hold lock_
+    void checkSchemaVersion(int64_t schemaVersion);
+
+private:
+    using Entry = std::pair<std::string, std::unique_ptr<SequentialSentences>>;
+
+    const size_t                                                    capacity_;
+    mutable std::mutex                                              lock_;
+    int64_t                                                         schemaVersion_{-1};
+    // The most recently used entry is at the front
+    std::list<Entry>                                                entries_;
+    std::unordered_multimap<std::string, std::list<Entry>::iterator> index_;
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_PLANCACHE_H_
@@ -0,0 +1,112 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/QueryManager.h"
+#include "graph/GraphFlags.h"
+#include <folly/Random.h>
+
+namespace nebula {
+namespace graph {
+
+RunningQuery::RunningQuery(int64_t id,
+                           int64_t token,
+                           const ClientSession *session,
+                           std::string query,
+                           int64_t timeoutMs)
+        : id_(id)
+        , token_(token)
+        , sessionId_(session->id())
+        , user_(session->user())
+        , space_(session->space())
+        , query_(std::move(query))
+        , timeoutMs_(timeoutMs) {
+    memory_ = std::make_shared<MemoryTracker>(folly::stringPrintf("query %ld", id),
+                                              session->queryMemoryLimitBytes(),
+                                              std::max(FLAGS_query_memory_soft_limit_bytes, 0L),
+                                              session->memory());
+}
+
+
+void RunningQuery::abort(Status status) {
+    std::lock_guard<std::mutex> g(lock_);
+    if (!aborted_) {
+        abortStatus_ = std::move(status);
+        aborted_ = true;
+    }
+}
+
+
+Status RunningQuery::check() const {
+    if (killed_) {
+        return Status::Error("Query %ld was killed", id_);
+    }
+    if (aborted_) {
+        std::lock_guard<std::mutex> g(lock_);
+        return abortStatus_;
+    }
+    if (timeoutMs_ > 0 && elapsedMs() >= static_cast<uint64_t>(timeoutMs_)) {
+        return Status::Error("Query %ld timed out after %ld ms", id_, timeoutMs_);
+    }
+    return Status::OK();
+}
+
+
+int32_t RunningQuery::timeLeftMs() const {
+    if (timeoutMs_ <= 0) {
+        return 0;
+    }
+    auto elapsed = static_cast<int64_t>(elapsedMs());
+    auto left = std::max(timeoutMs_ - elapsed, 1L);
+    return std::min(left, static_cast<int64_t>(std::numeric_limits<int32_t>::max()));
+}
+
+
+std::shared_ptr<RunningQuery> QueryManager::add(const ClientSession *session,
+                                                std::string query,
+                                                int64_t timeoutMs) {
+    auto id = nextId_++;
+    int64_t token = 0;
+    while (token == 0) {
+        token = static_cast<int64_t>(folly::Random::rand64());
+    }
+    auto running = std::make_shared<RunningQuery>(id, token, session, std::move(query), timeoutMs);
+    std::lock_guard<std::mutex> g(lock_);
+    queries_.emplace(id, running);
+    return running;
+}
+
+
+void QueryManager::remove(int64_t id) {
+    std::lock_guard<std::mutex> g(lock_);
+    queries_.erase(id);
+}
+
+
+std::shared_ptr<RunningQuery> QueryManager::find(int64_t id) const {
+    std::lock_guard<std::mutex> g(lock_);
+    auto it = queries_.find(id);
+    return it == queries_.end() ? nullptr : it->second;
+}
+
+
+std::vector<std::shared_ptr<RunningQuery>> QueryManager::queries() const {
+    std::vector<std::shared_ptr<RunningQuery>> result;
+    {
+        std::lock_guard<std::mutex> g(lock_);
+        result.reserve(queries_.size());
+        for (auto &entry : queries_) {
+            result.emplace_back(entry.second);
+        }
+    }
+    std::sort(result.begin(), result.end(), [] (const auto &a, const auto &b) {
+        return a->id() < b->id();
+    });
+    return result;
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -0,0 +1,136 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_QUERYMANAGER_H_
+#define GRAPH_QUERYMANAGER_H_
+
+#include "base/Base.h"
+#include "base/Status.h"
+#include "cpp/helpers.h"
+#include "time/Duration.h"
+#include "graph/ClientSession.h"
+#include "graph/MemoryTracker.h"
+
+/**
+ * QueryManager keeps the queries running on this graphd, to be listed by SHOW QUERIES
+ * and stopped by KILL QUERY.
+ *
+ * A query stops cooperatively: the executors check it between their steps, and the
+ * reads sent to the storage carry its time left and its token, so the storage hosts
+ * stop scanning for it as well once it times out or is killed.
+ *
+ * The results a query keeps are charged to its MemoryTracker, under the one of its
+ * session. The query is aborted once either hard limit is reached.
+ */
+
+namespace nebula {
+namespace graph {
+
+class RunningQuery final : public cpp::NonCopyable, public cpp::NonMovable {
+public:
+    RunningQuery(int64_t id,
+                 int64_t token,
+                 const ClientSession *session,
+                 std::string query,
+                 int64_t timeoutMs);
+
+    int64_t id() const {
+        return id_;
+    }
+
+    // Unique across the graph daemons, to identify the query to the storage
+    int64_t token() const {
+        return token_;
+    }
+
+    int64_t sessionId() const {
+        return sessionId_;
+    }
+
+    const std::string& user() const {
+        return user_;
+    }
+
+    GraphSpaceID space() const {
+        return space_;
+    }
+
+    const std::string& query() const {
+        return query_;
+    }
+
+    int64_t timeoutMs() const {
+        return timeoutMs_;
+    }
+
+    uint64_t elapsedMs() const {
+        return duration_.elapsedInMSec();
+    }
+
+    // Only the user running the query could kill it, from any of its sessions
+    bool killableBy(const ClientSession *session) const {
+        return session->id() == sessionId_ || session->user() == user_;
+    }
+
+    void kill() {
+        killed_ = true;
+    }
+
+    // Fail the query at its next check with `status', e.g. for the memory limit exceeded
+    void abort(Status status);
+
+    // Charged with the results the query keeps, which might hold it a little longer
+    const std::shared_ptr<MemoryTracker>& memory() const {
+        return memory_;
+    }
+
+    // OK unless the query has been killed or has timed out
+    Status check() const;
+
+    // The time left, 0 for no limit, so at least 1 before the query times out
+    int32_t timeLeftMs() const;
+
+private:
+    const int64_t                               id_;
+    const int64_t                               token_;
+    const int64_t                               sessionId_;
+    const std::string                           user_;
+    const GraphSpaceID                          space_;
+    const std::string                           query_;
+    const int64_t                               timeoutMs_;
+    time::Duration                              duration_;
+    std::atomic<bool>                           killed_{false};
+    std::atomic<bool>                           aborted_{false};
+    mutable std::mutex                          lock_;
+    Status                                      abortStatus_;
+    std::shared_ptr<MemoryTracker>              memory_;
+};
+
+
+class QueryManager final : public cpp::NonCopyable, public cpp::NonMovable {
+public:
+    std::shared_ptr<RunningQuery> add(const ClientSession *session,
+                                      std::string query,
+                                      int64_t timeoutMs);
+
+    void remove(int64_t id);
+
+    // nullptr if the query is not running
+    std::shared_ptr<RunningQuery> find(int64_t id) const;
+
+    // Ordered by the ids, i.e. the older ones first
+    std::vector<std::shared_ptr<RunningQuery>> queries() const;
+
+private:
+    std::atomic<int64_t>                                        nextId_{1};
+    mutable std::mutex                                          lock_;
+    std::unordered_map<int64_t, std::shared_ptr<RunningQuery>>  queries_;
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_QUERYMANAGER_H_
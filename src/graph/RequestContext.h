@@ -44,6 +44,15 @@ public:
         return query_;
     }
 
+    // The values bound to the placeholders of a prepared statement
+    void setParameters(std::vector<VariantType> parameters) {
+        parameters_ = std::move(parameters);
+    }
+
+    const std::vector<VariantType>& parameters() const {
+        return parameters_;
+    }
+
     Response& resp() {
         return resp_;
     }
@@ -83,6 +92,7 @@ public:
 private:
     time::Duration                              duration_;
     std::string                                 query_;
+    std::vector<VariantType>                    parameters_;
     Response                                    resp_;
     folly::Promise<Response>                    promise_;
     std::shared_ptr<ClientSession>              session_;
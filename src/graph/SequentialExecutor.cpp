@@ -44,6 +44,12 @@ Status SequentialExecutor::prepare() {
     };
     for (auto i = 0U; i < executors_.size() - 1; i++) {
         auto onFinish = [this, next = i + 1] () {
+            auto status = ectx()->checkCancelled();
+            if (!status.ok()) {
+                DCHECK(onError_);
+                onError_(std::move(status));
+                return;
+            }
             executors_[next]->execute();
         };
         executors_[i]->setOnFinish(onFinish);
@@ -6,6 +6,7 @@
 
 #include "base/Base.h"
 #include "graph/SetExecutor.h"
+#include "graph/HashSetOperator.h"
 
 namespace nebula {
 namespace graph {
@@ -48,15 +49,18 @@ Status SetExecutor::prepare() {
 }
 
 void SetExecutor::setLeft() {
-    auto onFinish = [] () {
-        return;
+    auto onFinish = [this] () {
+        this->leftResult_ = InterimResult::merge(std::move(leftBatches_));
+        VLOG(3) << "Left result set.";
+        leftP_.setValue();
     };
 
     futures_.emplace_back(leftP_.getFuture());
     auto onResult = [this] (std::unique_ptr<InterimResult> result) {
-        this->leftResult_ = std::move(result);
-        VLOG(3) << "Left result set.";
-        leftP_.setValue();
+        if (result != nullptr) {
+            ectx()->trackResult(*result);
+        }
+        leftBatches_.emplace_back(std::move(result));
     };
 
     auto onError = [this] (Status s) {
@@ -71,15 +75,18 @@ void SetExecutor::setLeft() {
 }
 
 void SetExecutor::setRight() {
-    auto onFinish = [] () {
-        return;
+    auto onFinish = [this] () {
+        this->rightResult_ = InterimResult::merge(std::move(rightBatches_));
+        VLOG(3) << "Right result set.";
+        rightP_.setValue();
     };
 
     futures_.emplace_back(rightP_.getFuture());
     auto onResult = [this] (std::unique_ptr<InterimResult> result) {
-        this->rightResult_ = std::move(result);
-        VLOG(3) << "Right result set.";
-        rightP_.setValue();
+        if (result != nullptr) {
+            ectx()->trackResult(*result);
+        }
+        rightBatches_.emplace_back(std::move(result));
     };
 
     auto onError = [this] (Status s) {
@@ -163,25 +170,24 @@ void SetExecutor::doUnion() {
         return;
     }
 
-    auto leftRows = leftResult_->getRows();
-    auto rightRows = rightResult_->getRows();
-    if (!castingMap_.empty()) {
-        auto stat = doCasting(rightRows);
-        if (!stat.ok()) {
-            DCHECK(onError_);
-            onError_(status);
-            return;
-        }
+    auto right = castRight();
+    if (!right.ok()) {
+        DCHECK(onError_);
+        onError_(right.status());
+        return;
     }
 
-    leftRows.insert(leftRows.end(),
-                    std::make_move_iterator(rightRows.begin()),
-                    std::make_move_iterator(rightRows.end()));
-    if (sentence_->distinct()) {
-        doDistinct(leftRows);
+    std::vector<std::unique_ptr<InterimResult>> results;
+    results.emplace_back(std::move(leftResult_));
+    results.emplace_back(std::move(right).value());
+    auto merged = InterimResult::merge(std::move(results));
+    if (merged != nullptr && sentence_->distinct()) {
+        auto batch = merged->batch();
+        finishExecution(std::move(merged), HashSetOperator::distinct(std::move(batch), runner()));
+        return;
     }
 
-    finishExecution(std::move(leftRows));
+    finishExecution(std::move(merged));
     return;
 }
 
@@ -217,29 +223,35 @@ Status SetExecutor::checkSchema() {
     return Status::OK();
 }
 
-Status SetExecutor::doCasting(std::vector<cpp2::RowValue> &rows) const {
-    for (auto &row : rows) {
-        auto cols = row.get_columns();
+StatusOr<std::unique_ptr<InterimResult>> SetExecutor::castRight() {
+    if (castingMap_.empty()) {
+        return std::move(rightResult_);
+    }
+    // Only the rows to be cast are decoded, and built again in the types of the left
+    ColumnBatch::Builder builder(resultSchema_);
+    if (!builder.status().ok()) {
+        return builder.status();
+    }
+    Status status;
+    rightResult_->forEachRow([&] (cpp2::RowValue &row) {
+        auto &cols = row.columns;
         for (auto &pair : castingMap_) {
-            auto stat =
-                InterimResult::castTo(&cols[pair.first], pair.second.get_type());
-            if (!stat.ok()) {
-                return stat;
+            status = InterimResult::castTo(&cols[pair.first], pair.second.get_type());
+            if (!status.ok()) {
+                return false;
             }
         }
-        row.set_columns(std::move(cols));
+        builder.append(cols);
+        return true;
+    });
+    if (!status.ok()) {
+        return status;
     }
-
-    return Status::OK();
+    rightResult_.reset();
+    return std::make_unique<InterimResult>(resultSchema_, builder.finish());
 }
 
 
-void SetExecutor::doDistinct(std::vector<cpp2::RowValue> &rows) const {
-    std::sort(rows.begin(), rows.end());
-    auto it = std::unique(rows.begin(), rows.end());
-    rows.erase(it, rows.end());
-}
-
 void SetExecutor::doIntersect() {
     VLOG(3) << "Do InterSect.";
     if (leftResult_ == nullptr || rightResult_ == nullptr) {
@@ -255,29 +267,17 @@ void SetExecutor::doIntersect() {
         return;
     }
 
-    auto leftRows = leftResult_->getRows();
-    auto rightRows = rightResult_->getRows();
-    if (!castingMap_.empty()) {
-        Status stat = doCasting(rightRows);
-        if (!stat.ok()) {
-            DCHECK(onError_);
-            onError_(status);
-            return;
-        }
-    }
-
-    std::vector<cpp2::RowValue> rows;
-    for (auto &lr : leftRows) {
-        for (auto &rr : rightRows) {
-            if (rr == lr) {
-                rows.emplace_back(std::move(rr));
-                break;
-            }
-        }
+    auto right = castRight();
+    if (!right.ok()) {
+        DCHECK(onError_);
+        onError_(right.status());
+        return;
     }
 
-    finishExecution(std::move(rows));
-    return;
+    auto future = HashSetOperator::intersect(leftResult_->batch(),
+                                             right.value()->batch(),
+                                             runner());
+    finishExecution(std::move(leftResult_), std::move(future));
 }
 
 void SetExecutor::doMinus() {
@@ -302,29 +302,17 @@ void SetExecutor::doMinus() {
         return;
     }
 
-    auto leftRows = leftResult_->getRows();
-    auto rightRows = rightResult_->getRows();
-    if (!castingMap_.empty()) {
-        Status stat = doCasting(rightRows);
-        if (!stat.ok()) {
-            DCHECK(onError_);
-            onError_(status);
-            return;
-        }
-    }
-
-    for (auto &rr : rightRows) {
-        for (auto iter = leftRows.begin(); iter < leftRows.end();) {
-            if (rr == *iter) {
-                iter = leftRows.erase(iter);
-            } else {
-                ++iter;
-            }
-        }
+    auto right = castRight();
+    if (!right.ok()) {
+        DCHECK(onError_);
+        onError_(right.status());
+        return;
     }
 
-    finishExecution(std::move(leftRows));
-    return;
+    auto future = HashSetOperator::minus(leftResult_->batch(),
+                                         right.value()->batch(),
+                                         runner());
+    finishExecution(std::move(leftResult_), std::move(future));
 }
 
 void SetExecutor::getResultCols(std::unique_ptr<InterimResult> &result) {
@@ -363,17 +351,20 @@ void SetExecutor::finishExecution(std::unique_ptr<InterimResult> result) {
     onFinish_();
 }
 
-void SetExecutor::finishExecution(std::vector<cpp2::RowValue> rows) {
-    if (onResult_) {
-        auto outputs = InterimResult::getInterim(resultSchema_, rows);
-        onResult_(std::move(outputs));
-    } else {
-        resp_ = std::make_unique<cpp2::ExecutionResponse>();
-        resp_->set_column_names(std::move(colNames_));
-        resp_->set_rows(std::move(rows));
-    }
-    DCHECK(onFinish_);
-    onFinish_();
+void SetExecutor::finishExecution(std::unique_ptr<InterimResult> source,
+                                  folly::Future<std::vector<uint32_t>> future) {
+    auto cb = [this, source = std::move(source)] (std::vector<uint32_t> indexes) {
+        finishExecution(indexes.empty() ? nullptr : source->select(indexes));
+    };
+
+    auto error = [this] (auto &&e) {
+        LOG(ERROR) << "Exception caught: " << e.what();
+        DCHECK(onError_);
+        onError_(Status::Error("Internal error"));
+        return;
+    };
+
+    std::move(future).thenValue(std::move(cb)).thenError(error);
 }
 
 void SetExecutor::feedResult(std::unique_ptr<InterimResult> result) {
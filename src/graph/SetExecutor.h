@@ -38,7 +38,9 @@ private:
 
     void finishExecution(std::unique_ptr<InterimResult> result);
 
-    void finishExecution(std::vector<cpp2::RowValue> leftRows);
+    // Finish with the rows of `source' selected by the hash set operation
+    void finishExecution(std::unique_ptr<InterimResult> source,
+                         folly::Future<std::vector<uint32_t>> future);
 
     void doUnion();
 
@@ -50,16 +52,22 @@ private:
 
     void getResultCols(std::unique_ptr<InterimResult> &result);
 
-    Status doCasting(std::vector<cpp2::RowValue> &rows) const;
-
-    void doDistinct(std::vector<cpp2::RowValue> &rows) const;
+    // The right result in the column types of the left
+    StatusOr<std::unique_ptr<InterimResult>> castRight();
 
     void onEmptyInputs();
 
+    folly::Executor* runner() const {
+        return ectx()->rctx()->runner();
+    }
+
 private:
     SetSentence                                                *sentence_{nullptr};
     std::unique_ptr<TraverseExecutor>                           left_;
     std::unique_ptr<TraverseExecutor>                           right_;
+    // Batches of the results, merged once the executor finishes
+    std::vector<std::unique_ptr<InterimResult>>                 leftBatches_;
+    std::vector<std::unique_ptr<InterimResult>>                 rightBatches_;
     std::unique_ptr<InterimResult>                              leftResult_;
     std::unique_ptr<InterimResult>                              rightResult_;
     folly::Promise<folly::Unit>                                 leftP_;
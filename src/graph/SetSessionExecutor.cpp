@@ -0,0 +1,78 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/SetSessionExecutor.h"
+
+namespace nebula {
+namespace graph {
+
+SetSessionExecutor::SetSessionExecutor(Sentence *sentence,
+                                       ExecutionContext *ectx) : Executor(ectx) {
+    sentence_ = static_cast<SetSessionSentence*>(sentence);
+}
+
+
+Status SetSessionExecutor::prepare() {
+    auto v = sentence_->value()->eval();
+    if (!v.ok()) {
+        return v.status();
+    }
+    value_ = v.value();
+    return Status::OK();
+}
+
+
+void SetSessionExecutor::execute() {
+    auto *session = ectx()->rctx()->session();
+    auto &name = *sentence_->name();
+    Status status;
+    if (name == "read_mode") {
+        if (value_.which() != VAR_STR) {
+            status = Status::Error("`read_mode' should be a string");
+        } else {
+            status = session->setReadMode(boost::get<std::string>(value_));
+        }
+    } else if (name == "max_staleness_ms") {
+        if (value_.which() != VAR_INT64) {
+            status = Status::Error("`max_staleness_ms' should be an integer");
+        } else {
+            status = session->setMaxStalenessMs(boost::get<int64_t>(value_));
+        }
+    } else if (name == "vertex_cache") {
+        if (value_.which() != VAR_BOOL) {
+            status = Status::Error("`vertex_cache' should be a bool");
+        } else {
+            session->setVertexCacheEnabled(boost::get<bool>(value_));
+        }
+    } else if (name == "query_timeout_ms") {
+        if (value_.which() != VAR_INT64) {
+            status = Status::Error("`query_timeout_ms' should be an integer");
+        } else {
+            status = session->setQueryTimeoutMs(boost::get<int64_t>(value_));
+        }
+    } else if (name == "query_memory_limit_bytes") {
+        if (value_.which() != VAR_INT64) {
+            status = Status::Error("`query_memory_limit_bytes' should be an integer");
+        } else {
+            status = session->setQueryMemoryLimitBytes(boost::get<int64_t>(value_));
+        }
+    } else {
+        status = Status::Error("Unknown session variable `%s'", name.c_str());
+    }
+
+    if (!status.ok()) {
+        DCHECK(onError_);
+        onError_(std::move(status));
+        return;
+    }
+
+    DCHECK(onFinish_);
+    onFinish_();
+}
+
+}   // namespace graph
+}   // namespace nebula
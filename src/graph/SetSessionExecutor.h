@@ -0,0 +1,44 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_SETSESSIONEXECUTOR_H_
+#define GRAPH_SETSESSIONEXECUTOR_H_
+
+#include "base/Base.h"
+#include "graph/Executor.h"
+
+namespace nebula {
+namespace graph {
+
+/**
+ * Change the settings of the current session, e.g.
+ *   SET SESSION read_mode = "read_index"
+ *   SET SESSION max_staleness_ms = 500
+ *   SET SESSION query_timeout_ms = 10000
+ *   SET SESSION query_memory_limit_bytes = 1073741824
+ */
+class SetSessionExecutor final : public Executor {
+public:
+    SetSessionExecutor(Sentence *sentence, ExecutionContext *ectx);
+
+    const char* name() const override {
+        return "SetSessionExecutor";
+    }
+
+    Status MUST_USE_RESULT prepare() override;
+
+    void execute() override;
+
+private:
+    SetSessionSentence                         *sentence_{nullptr};
+    VariantType                                 value_;
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+
+#endif  // GRAPH_SETSESSIONEXECUTOR_H_
@@ -5,6 +5,7 @@
  */
 
 #include "graph/ShowExecutor.h"
+#include "graph/QueryManager.h"
 #include "network/NetworkUtils.h"
 
 namespace nebula {
@@ -63,6 +64,9 @@ void ShowExecutor::execute() {
         case ShowSentence::ShowType::kShowCreateEdge:
             showCreateEdge();
             break;
+        case ShowSentence::ShowType::kShowQueries:
+            showQueries();
+            break;
         case ShowSentence::ShowType::kUnknown:
             onError_(Status::Error("Type unknown"));
             break;
@@ -457,6 +461,37 @@ void ShowExecutor::showCreateEdge() {
 }
 
 
+void ShowExecutor::showQueries() {
+    std::vector<std::shared_ptr<RunningQuery>> queries;
+    if (ectx()->queries() != nullptr) {
+        queries = ectx()->queries()->queries();
+    }
+    std::vector<cpp2::RowValue> rows;
+    std::vector<std::string> header{"Id", "Session", "User", "Query",
+                                    "Duration(ms)", "Timeout(ms)", "Memory(bytes)"};
+    resp_ = std::make_unique<cpp2::ExecutionResponse>();
+    resp_->set_column_names(std::move(header));
+
+    for (auto &query : queries) {
+        std::vector<cpp2::ColumnValue> row;
+        row.resize(7);
+        row[0].set_integer(query->id());
+        row[1].set_integer(query->sessionId());
+        row[2].set_str(query->user());
+        row[3].set_str(query->query());
+        row[4].set_integer(query->elapsedMs());
+        row[5].set_integer(query->timeoutMs());
+        row[6].set_integer(query->memory()->used());
+        rows.emplace_back();
+        rows.back().set_columns(std::move(row));
+    }
+    resp_->set_rows(std::move(rows));
+
+    DCHECK(onFinish_);
+    onFinish_();
+}
+
+
 void ShowExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
     resp = std::move(*resp_);
 }
@@ -31,6 +31,7 @@ public:
     void showCreateSpace();
     void showCreateTag();
     void showCreateEdge();
+    void showQueries();
 
     void setupResponse(cpp2::ExecutionResponse &resp) override;
 
@@ -0,0 +1,113 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/SpaceStatsCache.h"
+#include "time/WallClock.h"
+
+namespace nebula {
+namespace graph {
+
+SpaceStats::SpaceStats(std::vector<storage::cpp2::SpaceStatsResponse> &responses) {
+    for (auto &resp : responses) {
+        for (auto &tag : resp.get_tag_vertices()) {
+            tagVertices_[tag.first] += tag.second;
+        }
+        for (auto &edge : resp.get_edges()) {
+            auto &stats = edges_[edge.first];
+            stats.edges += edge.second.get_edges();
+            stats.vertices += edge.second.get_vertices();
+        }
+    }
+}
+
+
+int64_t SpaceStats::vertices(TagID tag) const {
+    auto it = tagVertices_.find(tag);
+    return it == tagVertices_.end() ? 0 : it->second;
+}
+
+
+double SpaceStats::degree(EdgeType type, bool outBound) const {
+    // The in-edges are kept with the negative type
+    auto it = edges_.find(outBound ? type : -type);
+    if (it == edges_.end() || it->second.get_vertices() == 0) {
+        return 1.0;
+    }
+    return static_cast<double>(it->second.get_edges()) / it->second.get_vertices();
+}
+
+
+SpaceStatsCache::StatsPtr SpaceStatsCache::get(storage::StorageClient *storage,
+                                               folly::Executor *runner,
+                                               GraphSpaceID space) {
+    std::lock_guard<std::mutex> g(lock_);
+    auto &entry = entries_[space];
+    auto now = time::WallClock::fastNowInSec();
+    if (!entry.gathering
+            && now >= entry.retryAt
+            && (entry.stats == nullptr || now - entry.gatheredAt >= ttlSecs_)) {
+        // The stale stats are still used meanwhile
+        gather(storage, runner, space, entry);
+    }
+    return entry.stats;
+}
+
+
+void SpaceStatsCache::gather(storage::StorageClient *storage,
+                             folly::Executor *runner,
+                             GraphSpaceID space,
+                             Entry &entry) {
+    entry.gathering = true;
+    // Not on behalf of any query, so neither killed nor timed out along with one
+    storage::cpp2::ReadOptions options;
+    options.set_timeout_ms(timeoutMs_);
+    auto future = storage->getSpaceStats(space, std::move(options));
+    auto cb = [this, space] (auto &&result) {
+        StatsPtr stats;
+        // The degrees are the ratios, which hold with some of the parts missing
+        if (result.completeness() == 0) {
+            LOG(ERROR) << "Gather the stats of space " << space << " failed";
+        } else {
+            if (result.completeness() != 100) {
+                LOG(INFO) << "Gather the stats of space " << space << " partially failed: "
+                          << result.completeness() << "%";
+            }
+            stats = std::make_shared<const SpaceStats>(result.responses());
+        }
+        onGathered(space, std::move(stats));
+    };
+    auto error = [this, space] (auto &&e) {
+        LOG(ERROR) << "Exception caught: " << e.what();
+        onGathered(space, nullptr);
+    };
+    std::move(future).via(runner).thenValue(cb).thenError(error);
+}
+
+
+void SpaceStatsCache::onGathered(GraphSpaceID space, StatsPtr stats) {
+    std::lock_guard<std::mutex> g(lock_);
+    auto &entry = entries_[space];
+    auto now = time::WallClock::fastNowInSec();
+    if (stats != nullptr) {
+        entry.stats = std::move(stats);
+        entry.gatheredAt = now;
+        entry.failures = 0;
+        entry.retryAt = 0;
+    } else {
+        // The stale stats are used if any, till gathered again after the backoff,
+        // rather than scanning the whole space for every query
+        auto backoff = std::min(retrySecs_ << std::min(entry.failures, 16), ttlSecs_);
+        entry.failures++;
+        entry.retryAt = now + backoff;
+        LOG(WARNING) << "Gather the stats of space " << space << " again in "
+                     << backoff << " seconds";
+    }
+    entry.gathering = false;
+}
+
+}   // namespace graph
+}   // namespace nebula
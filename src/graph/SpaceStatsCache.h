@@ -0,0 +1,93 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_SPACESTATSCACHE_H_
+#define GRAPH_SPACESTATSCACHE_H_
+
+#include "base/Base.h"
+#include "cpp/helpers.h"
+#include "storage/client/StorageClient.h"
+
+/**
+ * The numbers of the vertices per tag and of the edges per edge type of a space,
+ * gathered from all the storage hosts, to estimate the costs of the traversals.
+ *
+ * SpaceStatsCache keeps the stats of each space, gathering them in the background
+ * the first time, and again once they are older than the TTL, since that scans
+ * the whole space. No query waits for the gathering, nor bounds it: the gathering
+ * has a timeout of its own, and is retried with a backoff after a failure.
+ */
+
+namespace nebula {
+namespace graph {
+
+class SpaceStats final {
+public:
+    explicit SpaceStats(std::vector<storage::cpp2::SpaceStatsResponse> &responses);
+
+    // The number of the vertices with `tag'
+    int64_t vertices(TagID tag) const;
+
+    /**
+     * The average number of the edges of `type' going out of a vertex, or coming into
+     * one if not `outBound', among the vertices which have any of such edges.
+     * It is 1 if there is no such edges, i.e. neutral to the costs of the other types.
+     */
+    double degree(EdgeType type, bool outBound) const;
+
+private:
+    std::unordered_map<TagID, int64_t>                          tagVertices_;
+    std::unordered_map<EdgeType, storage::cpp2::EdgeStats>      edges_;
+};
+
+
+class SpaceStatsCache final : public cpp::NonCopyable, public cpp::NonMovable {
+public:
+    SpaceStatsCache(int64_t ttlSecs, int32_t timeoutMs, int64_t retrySecs)
+        : ttlSecs_(ttlSecs)
+        , timeoutMs_(timeoutMs)
+        , retrySecs_(retrySecs) {}
+
+    using StatsPtr = std::shared_ptr<const SpaceStats>;
+
+    /**
+     * The stats of `space' gathered last time, which might be stale, or nullptr if none
+     * has been gathered yet. The gathering is started meanwhile if needed.
+     */
+    StatsPtr get(storage::StorageClient *storage,
+                 folly::Executor *runner,
+                 GraphSpaceID space);
+
+private:
+    struct Entry {
+        StatsPtr                                        stats;
+        int64_t                                         gatheredAt{0};
+        bool                                            gathering{false};
+        // The failures in a row, and when to gather again after the last one
+        int32_t                                         failures{0};
+        int64_t                                         retryAt{0};
+    };
+
+    // Pre-condition: The caller needs to hold lock_
+    void gather(storage::StorageClient *storage,
+                folly::Executor *runner,
+                GraphSpaceID space,
+                Entry &entry);
+
+    void onGathered(GraphSpaceID space, StatsPtr stats);
+
+private:
+    const int64_t                                       ttlSecs_;
+    const int32_t                                       timeoutMs_;
+    const int64_t                                       retrySecs_;
+    std::mutex                                          lock_;
+    std::unordered_map<GraphSpaceID, Entry>             entries_;
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_SPACESTATSCACHE_H_
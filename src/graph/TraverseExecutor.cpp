@@ -10,6 +10,8 @@
 #include "graph/GoExecutor.h"
 #include "graph/PipeExecutor.h"
 #include "graph/OrderByExecutor.h"
+#include "graph/LimitExecutor.h"
+#include "graph/GroupByExecutor.h"
 #include "graph/FetchVerticesExecutor.h"
 #include "graph/FetchEdgesExecutor.h"
 #include "dataman/RowReader.h"
@@ -17,6 +19,9 @@
 #include "graph/SetExecutor.h"
 #include "graph/FindExecutor.h"
 #include "graph/MatchExecutor.h"
+#include "dataman/RowSetReader.h"
+#include "dataman/ResultSchemaProvider.h"
+#include <folly/ScopeGuard.h>
 
 namespace nebula {
 namespace graph {
@@ -41,6 +46,12 @@ TraverseExecutor::makeTraverseExecutor(Sentence *sentence, ExecutionContext *ect
         case Sentence::Kind::kOrderBy:
             executor = std::make_unique<OrderByExecutor>(sentence, ectx);
             break;
+        case Sentence::Kind::kLimit:
+            executor = std::make_unique<LimitExecutor>(sentence, ectx);
+            break;
+        case Sentence::Kind::kGroupBy:
+            executor = std::make_unique<GroupByExecutor>(sentence, ectx);
+            break;
         case Sentence::Kind::kFetchVertices:
             executor = std::make_unique<FetchVerticesExecutor>(sentence, ectx);
             break;
@@ -66,6 +77,109 @@ TraverseExecutor::makeTraverseExecutor(Sentence *sentence, ExecutionContext *ect
     return executor;
 }
 
+
+Status TraverseExecutor::prepareVids(const VertexIDList *list, std::vector<VertexID> &vids) {
+    std::unordered_set<VertexID> uniq(vids.begin(), vids.end());
+    for (auto *expr : list->vidList()) {
+        auto status = expr->prepare();
+        if (!status.ok()) {
+            return status;
+        }
+        auto value = expr->eval();
+        if (!value.ok()) {
+            return value.status();
+        }
+        auto v = value.value();
+        if (!Expression::isInt(v)) {
+            return Status::Error("Vertex ID should be of type integer");
+        }
+        auto vid = Expression::asInt(v);
+        if (uniq.emplace(vid).second) {
+            vids.emplace_back(vid);
+        }
+    }
+    return Status::OK();
+}
+
+
+folly::SemiFuture<TraverseExecutor::NeighborsResponse>
+TraverseExecutor::getNeighborIds(std::vector<VertexID> ids,
+                                 EdgeType type,
+                                 bool outBound,
+                                 std::string filter) {
+    std::vector<storage::cpp2::PropDef> props;
+    {
+        storage::cpp2::PropDef pd;
+        pd.owner = storage::cpp2::PropOwner::EDGE;
+        pd.name = "_dst";
+        props.emplace_back(std::move(pd));
+    }
+    auto *session = ectx()->rctx()->session();
+    return ectx()->storage()->getNeighbors(session->space(),
+                                           std::move(ids),
+                                           type,
+                                           outBound,
+                                           std::move(filter),
+                                           std::move(props),
+                                           ectx()->readOptions());
+}
+
+
+Status TraverseExecutor::forEachNeighbor(NeighborsResponse &&result,
+                                         std::function<Status(VertexID, VertexID)> cb) {
+    // The storage might have cut the responses short for a cancelled query
+    auto status = ectx()->checkCancelled();
+    if (!status.ok()) {
+        return status;
+    }
+    // The responses are charged while they are processed
+    int64_t bytes = 0;
+    for (auto &resp : result.responses()) {
+        bytes += estimateSize(resp);
+    }
+    status = ectx()->trackMemory(bytes);
+    if (!status.ok()) {
+        return status;
+    }
+    SCOPE_EXIT {
+        ectx()->untrackMemory(bytes);
+    };
+    auto completeness = result.completeness();
+    if (completeness == 0) {
+        return Status::Error("Get neighbors failed");
+    } else if (completeness != 100) {
+        LOG(INFO) << "Get neighbors partially failed: "  << completeness << "%";
+        for (auto &error : result.failedParts()) {
+            LOG(ERROR) << "part: " << error.first
+                       << "error code: " << static_cast<int>(error.second);
+        }
+    }
+
+    for (auto &resp : result.responses()) {
+        auto *vertices = resp.get_vertices();
+        if (vertices == nullptr) {
+            continue;
+        }
+        auto schema = std::make_shared<ResultSchemaProvider>(resp.edge_schema);
+        for (auto &vdata : *vertices) {
+            RowSetReader rsReader(schema, vdata.edge_data);
+            auto iter = rsReader.begin();
+            while (iter) {
+                VertexID dst;
+                auto rc = iter->getVid("_dst", dst);
+                CHECK(rc == ResultType::SUCCEEDED);
+                ++iter;
+                status = cb(vdata.get_vertex_id(), dst);
+                if (!status.ok()) {
+                    return status;
+                }
+            }
+        }
+    }
+    return Status::OK();
+}
+
+
 void Collector::collect(VariantType &var, RowWriter *writer) const {
     switch (var.which()) {
         case VAR_INT64:
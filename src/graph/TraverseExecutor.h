@@ -13,6 +13,7 @@
 #include "meta/SchemaProviderIf.h"
 #include "dataman/RowReader.h"
 #include "dataman/RowWriter.h"
+#include "storage/client/StorageClient.h"
 
 namespace nebula {
 namespace graph {
@@ -73,6 +74,27 @@ public:
 
     virtual void feedResult(std::unique_ptr<InterimResult> result) = 0;
 
+    /**
+     * Whether `feedResult()' could be invoked once for each batch of the inputs,
+     * as soon as the batch is produced, i.e. before the upstream finishes.
+     * `execute()' is invoked after the last batch, i.e. upon the end of the inputs.
+     * Such an executor must not report any error before `execute()'.
+     *
+     * Otherwise, all the batches are merged and fed at once.
+     */
+    virtual bool acceptsBatches() const {
+        return false;
+    }
+
+    /**
+     * Whether the results fed are charged to the query by this executor itself,
+     * e.g. as the rows it buffers to spill. Otherwise, the executor feeding them
+     * charges each result till it is dropped.
+     */
+    virtual bool tracksInputMemory() const {
+        return false;
+    }
+
     /**
      * `onResult_' must be set except for the right most executor
      * inside the chain of pipeline.
@@ -82,6 +104,9 @@ public:
      * it means that this executor is the right most one, whose results must
      * be cached during its execution and are to be used to fill `ExecutionResponse'
      * upon `setupResponse()'s invoke.
+     *
+     * `onResult_' could be invoked more than once, with one batch of the results
+     * each time, but never concurrently, and `onFinish_' marks the end of the results.
      */
     void setOnResult(OnResult onResult) {
         onResult_ = std::move(onResult);
@@ -93,6 +118,28 @@ public:
 protected:
     std::unique_ptr<TraverseExecutor> makeTraverseExecutor(Sentence *sentence);
 
+    // Evaluate the vertex ids of `list', appended to `vids' without the duplicates
+    Status prepareVids(const VertexIDList *list, std::vector<VertexID> &vids);
+
+    using NeighborsResponse = storage::StorageRpcResponse<storage::cpp2::QueryResponse>;
+
+    /**
+     * Get the edges of `type' going out of `ids' if `outBound', or coming into them
+     * otherwise, with only the other ends, i.e. `_dst', and the encoded `filter'.
+     */
+    folly::SemiFuture<NeighborsResponse> getNeighborIds(std::vector<VertexID> ids,
+                                                        EdgeType type,
+                                                        bool outBound,
+                                                        std::string filter);
+
+    /**
+     * Invoke `cb' with each edge of `result', as the vertex asked for and the other end,
+     * stopping at the first error of it. The responses are charged to the query meanwhile.
+     * It fails if the query has been cancelled, or if all the parts failed.
+     */
+    Status forEachNeighbor(NeighborsResponse &&result,
+                           std::function<Status(VertexID, VertexID)> cb);
+
 protected:
     OnResult                                    onResult_;
 };
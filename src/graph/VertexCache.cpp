@@ -0,0 +1,224 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/VertexCache.h"
+#include "time/WallClock.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+std::atomic<int64_t> hits{0};
+std::atomic<int64_t> misses{0};
+std::atomic<int64_t> evictions{0};
+std::atomic<int64_t> invalidations{0};
+
+}   // Anonymous namespace
+
+
+folly::Future<VertexCache::RpcResponse> VertexCache::getVertexProps(
+        storage::StorageClient *storage,
+        folly::Executor *runner,
+        GraphSpaceID space,
+        std::vector<VertexID> vertices,
+        std::vector<storage::cpp2::PropDef> returnCols,
+        storage::cpp2::ReadOptions readOptions,
+        int64_t schemaVersion) {
+    auto props = propsKey(returnCols);
+    // Taken before reading, so the writes meanwhile are not missed
+    auto epoch = this->epoch(space);
+    std::vector<VertexID> missed;
+    auto cached = get(space, props, vertices, schemaVersion, missed);
+    if (missed.empty()) {
+        RpcResponse resp(1);
+        resp.responses().emplace_back(std::move(cached));
+        return folly::makeFuture(std::move(resp));
+    }
+
+    auto future = storage->getVertexProps(space,
+                                          std::move(missed),
+                                          std::move(returnCols),
+                                          std::move(readOptions));
+    auto cb = [this, space, props = std::move(props), epoch, schemaVersion,
+               cached = std::move(cached)] (RpcResponse &&resp) mutable {
+        for (auto &r : resp.responses()) {
+            put(space, props, epoch, schemaVersion, r);
+        }
+        if (!cached.get_vertices()->empty()) {
+            resp.responses().emplace_back(std::move(cached));
+        }
+        return std::move(resp);
+    };
+    return std::move(future).via(runner).thenValue(std::move(cb));
+}
+
+
+storage::cpp2::QueryResponse VertexCache::get(GraphSpaceID space,
+                                              const std::string &props,
+                                              const std::vector<VertexID> &vertices,
+                                              int64_t schemaVersion,
+                                              std::vector<VertexID> &missed) {
+    storage::cpp2::QueryResponse resp;
+    resp.set_result(storage::cpp2::ResponseCommon());
+    std::vector<storage::cpp2::VertexData> found;
+    auto now = time::WallClock::fastNowInMilliSec();
+    {
+        std::lock_guard<std::mutex> g(lock_);
+        checkSchemaVersion(schemaVersion);
+        auto epochIt = epochs_.find(space);
+        auto epoch = epochIt == epochs_.end() ? 0 : epochIt->second;
+        for (auto vid : vertices) {
+            auto it = index_.find(makeKey(space, props, vid));
+            if (it == index_.end()) {
+                misses++;
+                missed.emplace_back(vid);
+                continue;
+            }
+            auto entry = it->second;
+            if (entry->epoch != epoch || entry->expiration <= now) {
+                erase(entry);
+                misses++;
+                missed.emplace_back(vid);
+                continue;
+            }
+            hits++;
+            if (!resp.__isset.vertex_schema) {
+                // The same schema for the same props
+                resp.set_vertex_schema(*entry->schema);
+            }
+            found.emplace_back(entry->vdata);
+            entries_.splice(entries_.begin(), entries_, entry);
+        }
+    }
+    resp.set_vertices(std::move(found));
+    return resp;
+}
+
+
+void VertexCache::put(GraphSpaceID space,
+                      const std::string &props,
+                      int64_t epoch,
+                      int64_t schemaVersion,
+                      const storage::cpp2::QueryResponse &resp) {
+    if (capacity_ == 0
+            || resp.get_vertices() == nullptr
+            || resp.get_vertex_schema() == nullptr) {
+        return;
+    }
+    auto schema = std::make_shared<const nebula::cpp2::Schema>(*resp.get_vertex_schema());
+    auto expiration = time::WallClock::fastNowInMilliSec() + ttlMs_;
+
+    std::lock_guard<std::mutex> g(lock_);
+    checkSchemaVersion(schemaVersion);
+    auto epochIt = epochs_.find(space);
+    if (schemaVersion != schemaVersion_
+            || epoch != (epochIt == epochs_.end() ? 0 : epochIt->second)) {
+        // Read before the schema changed, or the space was written
+        return;
+    }
+    for (auto &vdata : *resp.get_vertices()) {
+        auto key = makeKey(space, props, vdata.get_vertex_id());
+        // Counting the key twice, for the entry and for the index
+        auto size = sizeof(Entry) + 2 * key.size() + vdata.get_vertex_data().size();
+        if (size > capacity_) {
+            continue;
+        }
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            erase(it->second);
+        }
+        while (size_ + size > capacity_) {
+            erase(std::prev(entries_.end()));
+            evictions++;
+        }
+        entries_.emplace_front(Entry{key, epoch, expiration, schema, vdata, size});
+        index_.emplace(std::move(key), entries_.begin());
+        size_ += size;
+    }
+}
+
+
+int64_t VertexCache::epoch(GraphSpaceID space) const {
+    std::lock_guard<std::mutex> g(lock_);
+    auto it = epochs_.find(space);
+    return it == epochs_.end() ? 0 : it->second;
+}
+
+
+void VertexCache::invalidate(GraphSpaceID space) {
+    std::lock_guard<std::mutex> g(lock_);
+    // The entries of the previous epochs are dropped when looked up, or evicted
+    epochs_[space]++;
+    invalidations++;
+}
+
+
+size_t VertexCache::size() const {
+    std::lock_guard<std::mutex> g(lock_);
+    return size_;
+}
+
+
+void VertexCache::checkSchemaVersion(int64_t schemaVersion) {
+    if (schemaVersion <= schemaVersion_) {
+        return;
+    }
+    if (!entries_.empty()) {
+        VLOG(1) << "Schema version changed from " << schemaVersion_
+                << " to " << schemaVersion << ", drop " << entries_.size()
+                << " cached vertices";
+        invalidations++;
+    }
+    index_.clear();
+    entries_.clear();
+    size_ = 0;
+    schemaVersion_ = schemaVersion;
+}
+
+
+void VertexCache::erase(std::list<Entry>::iterator it) {
+    index_.erase(it->key);
+    size_ -= it->size;
+    entries_.erase(it);
+}
+
+
+// static
+std::string VertexCache::propsKey(const std::vector<storage::cpp2::PropDef> &returnCols) {
+    std::string key;
+    for (auto &prop : returnCols) {
+        key.append(folly::stringPrintf("%d.%d.",
+                                       static_cast<int32_t>(prop.get_owner()),
+                                       prop.get_tag_id()));
+        key.append(prop.get_name());
+        key.push_back(',');
+    }
+    return key;
+}
+
+
+// static
+std::string VertexCache::makeKey(GraphSpaceID space, const std::string &props, VertexID vid) {
+    auto key = folly::stringPrintf("%d:%ld:", space, vid);
+    key.append(props);
+    return key;
+}
+
+
+// static
+VertexCache::Stats VertexCache::stats() {
+    Stats s;
+    s.hits = hits.load();
+    s.misses = misses.load();
+    s.evictions = evictions.load();
+    s.invalidations = invalidations.load();
+    return s;
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -0,0 +1,127 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_VERTEXCACHE_H_
+#define GRAPH_VERTEXCACHE_H_
+
+#include "base/Base.h"
+#include "cpp/helpers.h"
+#include "storage/client/StorageClient.h"
+
+/**
+ * VertexCache keeps the vertex props recently read from the storage, shared by
+ * all the queries, so the props of the hot vertices are not read again and again.
+ *
+ * The entries are keyed by the space, the vertex and the props read, and the
+ * memory taken is bounded by the capacity in bytes, the least recently used
+ * entries being evicted first.
+ *
+ * An entry is valid for a short TTL only, since the vertices might be written
+ * through other graph daemons. The writes through this one bump the epoch of the
+ * space, which invalidates all the entries read before, and the whole cache is
+ * dropped when the schema version from MetaClient changes.
+ */
+
+namespace nebula {
+namespace graph {
+
+class VertexCache final : public cpp::NonCopyable, public cpp::NonMovable {
+public:
+    using RpcResponse = storage::StorageRpcResponse<storage::cpp2::QueryResponse>;
+
+    struct Stats {
+        int64_t hits{0};
+        int64_t misses{0};
+        int64_t evictions{0};
+        int64_t invalidations{0};
+    };
+
+    VertexCache(size_t capacity, int64_t ttlMs) : capacity_(capacity), ttlMs_(ttlMs) {}
+
+    /**
+     * The same as StorageClient::getVertexProps(), but only the vertices missed
+     * are read from the storage, and put into the cache on `runner' when the
+     * responses arrive. The vertices hit come in one more response.
+     */
+    folly::Future<RpcResponse> getVertexProps(
+        storage::StorageClient *storage,
+        folly::Executor *runner,
+        GraphSpaceID space,
+        std::vector<VertexID> vertices,
+        std::vector<storage::cpp2::PropDef> returnCols,
+        storage::cpp2::ReadOptions readOptions,
+        int64_t schemaVersion);
+
+    /**
+     * Take the props of `vertices' from the cache, in a response of their own.
+     * The vertices missed are appended to `missed'.
+     */
+    storage::cpp2::QueryResponse get(GraphSpaceID space,
+                                     const std::string &props,
+                                     const std::vector<VertexID> &vertices,
+                                     int64_t schemaVersion,
+                                     std::vector<VertexID> &missed);
+
+    /**
+     * Put the vertices of `resp' into the cache, unless the space has been
+     * written since `epoch', i.e. when they were read.
+     */
+    void put(GraphSpaceID space,
+             const std::string &props,
+             int64_t epoch,
+             int64_t schemaVersion,
+             const storage::cpp2::QueryResponse &resp);
+
+    // The epoch of the space, to be passed to put() for the vertices about to be read
+    int64_t epoch(GraphSpaceID space) const;
+
+    // The vertices of the space have been written
+    void invalidate(GraphSpaceID space);
+
+    // Bytes taken by the entries
+    size_t size() const;
+
+    // The process-wide statistics
+    static Stats stats();
+
+    // The key of the props read, in the order of `returnCols'
+    static std::string propsKey(const std::vector<storage::cpp2::PropDef> &returnCols);
+
+private:
+    struct Entry {
+        std::string                                     key;
+        int64_t                                         epoch;
+        int64_t                                         expiration;
+        std::shared_ptr<const nebula::cpp2::Schema>     schema;
+        storage::cpp2::VertexData                       vdata;
+        size_t                                          size;
+    };
+
+    static std::string makeKey(GraphSpaceID space, const std::string &props, VertexID vid);
+
+    // Drop all entries if the schema has changed.
+    // Pre-condition: The caller needs to hold lock_
+    void checkSchemaVersion(int64_t schemaVersion);
+
+    // Pre-condition: The caller needs to hold lock_
+    void erase(std::list<Entry>::iterator it);
+
+private:
+    const size_t                                                    capacity_;
+    const int64_t                                                   ttlMs_;
+    mutable std::mutex                                              lock_;
+    int64_t                                                         schemaVersion_{-1};
+    size_t                                                          size_{0};
+    std::unordered_map<GraphSpaceID, int64_t>                       epochs_;
+    // The most recently used entry is at the front
+    std::list<Entry>                                                entries_;
+    std::unordered_map<std::string, std::list<Entry>::iterator>     index_;
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_VERTEXCACHE_H_
@@ -0,0 +1,251 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/VertexSet.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+constexpr size_t kInitialSlots = 16;
+
+// The shard of an id, taking the bits above those picking the slots
+size_t shardOf(VertexID vid, size_t numShards) {
+    return (VertexSet::hash(vid) >> 40) % numShards;
+}
+
+// Indexes into `ids' for each shard
+std::vector<std::vector<uint32_t>> groupByShard(const std::vector<VertexID> &ids,
+                                                size_t numShards) {
+    std::vector<std::vector<uint32_t>> groups(numShards);
+    for (auto i = 0UL; i < ids.size(); i++) {
+        groups[shardOf(ids[i], numShards)].emplace_back(i);
+    }
+    return groups;
+}
+
+}   // Anonymous namespace
+
+constexpr VertexID VertexSet::kEmpty;
+constexpr size_t ConcurrentVertexSet::kDefaultShards;
+
+
+bool VertexSet::insert(VertexID vid) {
+    if (vid == kEmpty) {
+        if (hasEmpty_) {
+            return false;
+        }
+        hasEmpty_ = true;
+        size_++;
+        return true;
+    }
+    // Keep the load factor under 1/2
+    if ((size_ + 1) * 2 > slots_.size()) {
+        grow();
+    }
+    auto mask = slots_.size() - 1;
+    for (auto i = hash(vid) & mask; ; i = (i + 1) & mask) {
+        if (slots_[i] == vid) {
+            return false;
+        }
+        if (slots_[i] == kEmpty) {
+            slots_[i] = vid;
+            size_++;
+            return true;
+        }
+    }
+}
+
+
+bool VertexSet::contains(VertexID vid) const {
+    if (vid == kEmpty) {
+        return hasEmpty_;
+    }
+    if (slots_.empty()) {
+        return false;
+    }
+    auto mask = slots_.size() - 1;
+    for (auto i = hash(vid) & mask; ; i = (i + 1) & mask) {
+        if (slots_[i] == vid) {
+            return true;
+        }
+        if (slots_[i] == kEmpty) {
+            return false;
+        }
+    }
+}
+
+
+void VertexSet::grow() {
+    std::vector<VertexID> slots(std::max(kInitialSlots, slots_.size() * 2), kEmpty);
+    auto mask = slots.size() - 1;
+    for (auto vid : slots_) {
+        if (vid == kEmpty) {
+            continue;
+        }
+        auto i = hash(vid) & mask;
+        while (slots[i] != kEmpty) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = vid;
+    }
+    slots_ = std::move(slots);
+}
+
+
+void VertexMap::set(VertexID key, VertexID value) {
+    if (key == VertexSet::kEmpty) {
+        if (!hasEmpty_) {
+            hasEmpty_ = true;
+            size_++;
+        }
+        emptyValue_ = value;
+        return;
+    }
+    if ((size_ + 1) * 2 > slots_.size()) {
+        grow();
+    }
+    auto mask = slots_.size() - 1;
+    for (auto i = VertexSet::hash(key) & mask; ; i = (i + 1) & mask) {
+        auto &slot = slots_[i];
+        if (slot.first == key) {
+            slot.second = value;
+            return;
+        }
+        if (slot.first == VertexSet::kEmpty) {
+            slot.first = key;
+            slot.second = value;
+            size_++;
+            return;
+        }
+    }
+}
+
+
+const VertexID* VertexMap::find(VertexID key) const {
+    if (key == VertexSet::kEmpty) {
+        return hasEmpty_ ? &emptyValue_ : nullptr;
+    }
+    if (slots_.empty()) {
+        return nullptr;
+    }
+    auto mask = slots_.size() - 1;
+    for (auto i = VertexSet::hash(key) & mask; ; i = (i + 1) & mask) {
+        auto &slot = slots_[i];
+        if (slot.first == key) {
+            return &slot.second;
+        }
+        if (slot.first == VertexSet::kEmpty) {
+            return nullptr;
+        }
+    }
+}
+
+
+void VertexMap::grow() {
+    std::vector<Slot> slots(std::max(kInitialSlots, slots_.size() * 2),
+                            Slot(VertexSet::kEmpty, 0));
+    auto mask = slots.size() - 1;
+    for (auto &slot : slots_) {
+        if (slot.first == VertexSet::kEmpty) {
+            continue;
+        }
+        auto i = VertexSet::hash(slot.first) & mask;
+        while (slots[i].first != VertexSet::kEmpty) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = slot;
+    }
+    slots_ = std::move(slots);
+}
+
+
+ConcurrentVertexSet::ConcurrentVertexSet(size_t numShards)
+        : shards_(std::max(numShards, 1UL)) {
+}
+
+
+std::vector<VertexID> ConcurrentVertexSet::insert(const std::vector<VertexID> &vids) {
+    std::vector<VertexID> inserted;
+    auto groups = groupByShard(vids, shards_.size());
+    for (auto i = 0UL; i < groups.size(); i++) {
+        if (groups[i].empty()) {
+            continue;
+        }
+        auto &shard = shards_[i];
+        std::lock_guard<std::mutex> g(shard.lock);
+        for (auto index : groups[i]) {
+            if (shard.set.insert(vids[index])) {
+                inserted.emplace_back(vids[index]);
+            }
+        }
+    }
+    return inserted;
+}
+
+
+size_t ConcurrentVertexSet::size() const {
+    size_t size = 0;
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> g(shard.lock);
+        size += shard.set.size();
+    }
+    return size;
+}
+
+
+ConcurrentVertexMap::ConcurrentVertexMap(size_t numShards)
+        : shards_(std::max(numShards, 1UL)) {
+}
+
+
+void ConcurrentVertexMap::set(const std::vector<std::pair<VertexID, VertexID>> &kvs) {
+    std::vector<std::vector<uint32_t>> groups(shards_.size());
+    for (auto i = 0UL; i < kvs.size(); i++) {
+        groups[shardOf(kvs[i].first, shards_.size())].emplace_back(i);
+    }
+    for (auto i = 0UL; i < groups.size(); i++) {
+        if (groups[i].empty()) {
+            continue;
+        }
+        auto &shard = shards_[i];
+        std::lock_guard<std::mutex> g(shard.lock);
+        for (auto index : groups[i]) {
+            shard.map.set(kvs[index].first, kvs[index].second);
+        }
+    }
+}
+
+
+void ConcurrentVertexMap::translate(std::vector<VertexID> &ids) const {
+    auto groups = groupByShard(ids, shards_.size());
+    for (auto i = 0UL; i < groups.size(); i++) {
+        if (groups[i].empty()) {
+            continue;
+        }
+        auto &shard = shards_[i];
+        std::lock_guard<std::mutex> g(shard.lock);
+        for (auto index : groups[i]) {
+            auto *value = shard.map.find(ids[index]);
+            if (value != nullptr) {
+                ids[index] = *value;
+            }
+        }
+    }
+}
+
+
+VertexID ConcurrentVertexMap::translate(VertexID id) const {
+    auto &shard = shards_[shardOf(id, shards_.size())];
+    std::lock_guard<std::mutex> g(shard.lock);
+    auto *value = shard.map.find(id);
+    return value == nullptr ? id : *value;
+}
+
+}   // namespace graph
+}   // namespace nebula
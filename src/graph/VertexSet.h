@@ -0,0 +1,145 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_VERTEXSET_H_
+#define GRAPH_VERTEXSET_H_
+
+#include "base/Base.h"
+#include "cpp/helpers.h"
+
+/**
+ * Hash tables of vertex ids for the traversals, i.e. the visited vertices and
+ * the roots the vertices are reached from.
+ *
+ * The tables are open addressed with linear probing, keeping the ids in one
+ * flat array, so an id takes 16 to 32 bytes, instead of the 40 or more of a node
+ * in std::unordered_set/map, and a lookup touches a cache line or two.
+ * Nothing is ever erased, which the traversals do not need.
+ */
+
+namespace nebula {
+namespace graph {
+
+class VertexSet final {
+public:
+    // Returns false if `vid' is in the set already
+    bool insert(VertexID vid);
+
+    bool contains(VertexID vid) const;
+
+    size_t size() const {
+        return size_;
+    }
+
+    // Bytes taken by the table
+    size_t memory() const {
+        return slots_.capacity() * sizeof(VertexID);
+    }
+
+    // Ids are hashed with the finalizer of MurmurHash3, the ids being sequential usually
+    static uint64_t hash(VertexID vid) {
+        auto h = static_cast<uint64_t>(vid);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // Marks an empty slot, so it is kept aside if inserted
+    static constexpr VertexID kEmpty = std::numeric_limits<VertexID>::min();
+
+private:
+    void grow();
+
+private:
+    std::vector<VertexID>                       slots_;
+    size_t                                      size_{0};
+    bool                                        hasEmpty_{false};
+};
+
+
+// Maps a vertex id to another, e.g. to the root it is reached from
+class VertexMap final {
+public:
+    // Set the value of `key', overwriting the one before
+    void set(VertexID key, VertexID value);
+
+    // nullptr if `key' is not found
+    const VertexID* find(VertexID key) const;
+
+    size_t size() const {
+        return size_;
+    }
+
+    size_t memory() const {
+        return slots_.capacity() * sizeof(Slot);
+    }
+
+private:
+    using Slot = std::pair<VertexID, VertexID>;
+
+    void grow();
+
+private:
+    std::vector<Slot>                           slots_;
+    size_t                                      size_{0};
+    bool                                        hasEmpty_{false};
+    VertexID                                    emptyValue_{0};
+};
+
+
+/**
+ * The tables above sharded by the vertex ids, each shard with its own lock,
+ * so the responses from the storage hosts could be merged in parallel.
+ * The ids are taken in batches, locking each shard once for a batch.
+ */
+class ConcurrentVertexSet final : public cpp::NonCopyable, public cpp::NonMovable {
+public:
+    explicit ConcurrentVertexSet(size_t numShards = kDefaultShards);
+
+    // Insert `vids', and returns those not in the set before
+    std::vector<VertexID> insert(const std::vector<VertexID> &vids);
+
+    size_t size() const;
+
+    static constexpr size_t kDefaultShards = 16;
+
+private:
+    struct Shard {
+        mutable std::mutex                      lock;
+        VertexSet                               set;
+    };
+
+    std::vector<Shard>                          shards_;
+};
+
+
+class ConcurrentVertexMap final : public cpp::NonCopyable, public cpp::NonMovable {
+public:
+    explicit ConcurrentVertexMap(size_t numShards = ConcurrentVertexSet::kDefaultShards);
+
+    void set(const std::vector<std::pair<VertexID, VertexID>> &kvs);
+
+    // Replace the ids with their values, those not found are left as they are
+    void translate(std::vector<VertexID> &ids) const;
+
+    VertexID translate(VertexID id) const;
+
+private:
+    struct Shard {
+        mutable std::mutex                      lock;
+        VertexMap                               map;
+    };
+
+    std::vector<Shard>                          shards_;
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_VERTEXSET_H_
@@ -373,7 +373,7 @@ TEST_F(DataTest, MatchTest) {
         cpp2::ExecutionResponse resp;
         std::string cmd = "MATCH";
         auto code = client_->execute(cmd, resp);
-        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+        ASSERT_EQ(cpp2::ErrorCode::E_SYNTAX_ERROR, code);
     }
 }
 
@@ -0,0 +1,124 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "graph/ExternalSorter.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+cpp2::RowValue makeRow(int64_t key, int64_t seq) {
+    std::vector<cpp2::ColumnValue> cols(3);
+    cols[0].set_integer(key);
+    cols[1].set_integer(seq);
+    cols[2].set_str(folly::stringPrintf("row_%ld", seq));
+    cpp2::RowValue row;
+    row.set_columns(std::move(cols));
+    return row;
+}
+
+// Order by the first column only
+bool lessByKey(const cpp2::RowValue &lhs, const cpp2::RowValue &rhs) {
+    return lhs.get_columns()[0].get_integer() < rhs.get_columns()[0].get_integer();
+}
+
+void checkSorted(const std::vector<cpp2::RowValue> &rows, size_t expected) {
+    ASSERT_EQ(expected, rows.size());
+    for (auto i = 1UL; i < rows.size(); i++) {
+        auto &prev = rows[i - 1].get_columns();
+        auto &cur = rows[i].get_columns();
+        ASSERT_LE(prev[0].get_integer(), cur[0].get_integer());
+        if (prev[0].get_integer() == cur[0].get_integer()) {
+            // Stable
+            ASSERT_LT(prev[1].get_integer(), cur[1].get_integer());
+        }
+        ASSERT_EQ(folly::stringPrintf("row_%ld", cur[1].get_integer()), cur[2].get_str());
+    }
+}
+
+}   // Anonymous namespace
+
+TEST(ExternalSorter, InMemory) {
+    ExternalSorter sorter(lessByKey, 1024 * 1024, "/tmp");
+    for (auto i = 0; i < 1000; i++) {
+        ASSERT_TRUE(sorter.add(makeRow(folly::Random::rand32(100), i)).ok());
+    }
+    ASSERT_EQ(0UL, sorter.numRuns());
+
+    std::vector<cpp2::RowValue> rows;
+    auto status = sorter.finish([&rows] (cpp2::RowValue &row) {
+        rows.emplace_back(std::move(row));
+    });
+    ASSERT_TRUE(status.ok()) << status;
+    checkSorted(rows, 1000UL);
+}
+
+TEST(ExternalSorter, Spill) {
+    // Only a few rows fit in memory
+    ExternalSorter sorter(lessByKey, 1024, "/tmp");
+    for (auto i = 0; i < 10000; i++) {
+        ASSERT_TRUE(sorter.add(makeRow(folly::Random::rand32(100), i)).ok());
+    }
+    ASSERT_LT(1UL, sorter.numRuns());
+
+    std::vector<cpp2::RowValue> rows;
+    auto status = sorter.finish([&rows] (cpp2::RowValue &row) {
+        rows.emplace_back(std::move(row));
+    });
+    ASSERT_TRUE(status.ok()) << status;
+    checkSorted(rows, 10000UL);
+    ASSERT_EQ(0UL, sorter.numRuns());
+}
+
+TEST(ExternalSorter, MemoryTracker) {
+    {
+        // Beyond the soft limit, the rows are spilled long before the memory limit
+        MemoryTracker tracker("query", 0, 1);
+        ExternalSorter sorter(lessByKey, 1024 * 1024 * 1024, "/tmp", &tracker);
+        for (auto i = 0; i < 30000; i++) {
+            ASSERT_TRUE(sorter.add(makeRow(folly::Random::rand32(100), i)).ok());
+        }
+        ASSERT_LT(0UL, sorter.numRuns());
+
+        std::vector<cpp2::RowValue> rows;
+        auto status = sorter.finish([&rows] (cpp2::RowValue &row) {
+            rows.emplace_back(std::move(row));
+        });
+        ASSERT_TRUE(status.ok()) << status;
+        checkSorted(rows, 30000UL);
+        ASSERT_EQ(0, tracker.used());
+    }
+    {
+        // At the hard limit, the rows are spilled to make room
+        MemoryTracker tracker("query", 512 * 1024, 0);
+        ExternalSorter sorter(lessByKey, 1024 * 1024 * 1024, "/tmp", &tracker);
+        for (auto i = 0; i < 30000; i++) {
+            ASSERT_TRUE(sorter.add(makeRow(folly::Random::rand32(100), i)).ok());
+        }
+        ASSERT_LT(0UL, sorter.numRuns());
+        ASSERT_GE(512 * 1024, tracker.peak());
+
+        std::vector<cpp2::RowValue> rows;
+        auto status = sorter.finish([&rows] (cpp2::RowValue &row) {
+            rows.emplace_back(std::move(row));
+        });
+        ASSERT_TRUE(status.ok()) << status;
+        checkSorted(rows, 30000UL);
+        ASSERT_EQ(0, tracker.used());
+    }
+}
+
+TEST(ExternalSorter, BadSpillDir) {
+    ExternalSorter sorter(lessByKey, 0, "/path/not/exist");
+    auto status = sorter.add(makeRow(1, 0));
+    ASSERT_FALSE(status.ok());
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -0,0 +1,128 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/test/TestEnv.h"
+#include "graph/test/TestBase.h"
+#include "graph/test/TraverseTestBase.h"
+#include "graph/GraphFlags.h"
+#include "meta/test/TestUtils.h"
+
+namespace nebula {
+namespace graph {
+
+class FindPathTest : public TraverseTestBase {
+protected:
+    void SetUp() override {
+        TraverseTestBase::SetUp();
+        // ...
+    }
+
+    void TearDown() override {
+        // ...
+        TraverseTestBase::TearDown();
+    }
+};
+
+TEST_F(FindPathTest, FindPath) {
+    // The path over `like' through the players, e.g. "1 -like-> 2"
+    auto path = [this] (std::vector<std::string> names, const char *edge = " -like-> ") {
+        std::string buf;
+        for (auto &name : names) {
+            if (!buf.empty()) {
+                buf += edge;
+            }
+            buf += std::to_string(players_[name].vid());
+        }
+        return std::make_tuple(std::move(buf));
+    };
+    {
+        // From several sources to several targets, all the paths of the shortest length
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "FIND SHORTEST PATH FROM %ld, %ld TO %ld, %ld OVER like";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["Tim Duncan"].vid(),
+                                         players_["Tracy McGrady"].vid(),
+                                         players_["LaMarcus Aldridge"].vid(),
+                                         players_["LeBron James"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::string> expectedColNames{"_path_"};
+        ASSERT_EQ(expectedColNames, *resp.get_column_names());
+        std::vector<std::tuple<std::string>> expected = {
+            path({"Tim Duncan", "Tony Parker", "LaMarcus Aldridge"}),
+            path({"Tracy McGrady", "Rudy Gay", "LaMarcus Aldridge"}),
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        // The cycles between Tim Duncan, Tony Parker and Manu Ginobili are not taken
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "FIND ALL PATH FROM %ld TO %ld OVER like UPTO 3 STEPS";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["Tim Duncan"].vid(),
+                                         players_["Manu Ginobili"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<std::string>> expected = {
+            path({"Tim Duncan", "Manu Ginobili"}),
+            path({"Tim Duncan", "Tony Parker", "Manu Ginobili"}),
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "FIND SHORTEST PATH FROM %ld TO %ld OVER like REVERSELY";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["LaMarcus Aldridge"].vid(),
+                                         players_["Tracy McGrady"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<std::string>> expected = {
+            path({"LaMarcus Aldridge", "Rudy Gay", "Tracy McGrady"}, " <-like- "),
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        // Kobe Bryant could not be reached from Tim Duncan
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "FIND ALL PATH FROM %ld TO %ld OVER like";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["Tim Duncan"].vid(),
+                                         players_["Kobe Bryant"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        ASSERT_EQ(nullptr, resp.get_rows());
+    }
+    {
+        gflags::FlagSaver flagSaver;
+        FLAGS_find_path_max_edges = 5;
+        // Dejounte Murray likes more than 5 players
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "FIND SHORTEST PATH FROM %ld TO %ld OVER like";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["Dejounte Murray"].vid(),
+                                         players_["Ray Allen"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+        ASSERT_NE(std::string::npos, resp.get_error_msg()->find("Too many edges"));
+    }
+    {
+        gflags::FlagSaver flagSaver;
+        FLAGS_find_path_max_paths = 1;
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "FIND ALL PATH FROM %ld TO %ld OVER like UPTO 3 STEPS";
+        auto query = folly::stringPrintf(fmt,
+                                         players_["Tim Duncan"].vid(),
+                                         players_["Manu Ginobili"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+        ASSERT_NE(std::string::npos, resp.get_error_msg()->find("Too many paths"));
+    }
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -407,5 +407,71 @@ TEST_F(GoTest, ReferenceVariableInYieldAndWhere) {
     }
 }
 
+
+TEST_F(GoTest, PreparedStatement) {
+    int64_t statementId = 0;
+    {
+        cpp2::PrepareResponse resp;
+        std::string stmt = "GO FROM $1 OVER serve WHERE serve.start_year >= $2 "
+                           "YIELD $^.player.name, serve.start_year, $$.team.name";
+        auto code = client_->prepare(stmt, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        ASSERT_EQ(2, *resp.get_num_parameters());
+        statementId = *resp.get_statement_id();
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Boris Diaw"];
+        std::vector<cpp2::ColumnValue> params(2);
+        params[0].set_id(player.vid());
+        params[1].set_integer(2012);
+        auto code = client_->executePrepared(statementId, params, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<std::string, int64_t, std::string>> expected = {
+            {player.name(), 2012, "Spurs"},
+            {player.name(), 2016, "Jazz"},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        // Run again with other values
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Rajon Rondo"];
+        std::vector<cpp2::ColumnValue> params(2);
+        params[0].set_id(player.vid());
+        params[1].set_integer(2017);
+        auto code = client_->executePrepared(statementId, params, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<std::string, int64_t, std::string>> expected = {
+            {player.name(), 2017, "Pelicans"},
+            {player.name(), 2018, "Lakers"},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        // Number of parameters mismatched
+        cpp2::ExecutionResponse resp;
+        std::vector<cpp2::ColumnValue> params(1);
+        params[0].set_id(players_["Tim Duncan"].vid());
+        auto code = client_->executePrepared(statementId, params, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+    }
+    {
+        // Placeholders are not allowed in plain queries
+        cpp2::ExecutionResponse resp;
+        auto code = client_->execute("GO FROM $1 OVER serve", resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+    }
+    {
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, client_->unprepare(statementId));
+        cpp2::ExecutionResponse resp;
+        std::vector<cpp2::ColumnValue> params(2);
+        params[0].set_id(players_["Tim Duncan"].vid());
+        params[1].set_integer(2012);
+        auto code = client_->executePrepared(statementId, params, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_STATEMENT_NOT_FOUND, code);
+    }
+}
+
 }   // namespace graph
 }   // namespace nebula
@@ -91,6 +91,14 @@ TEST_F(GraphHttpHandlerTest, GraphStatusTest) {
         ASSERT_TRUE(it->second.isString());
         ASSERT_EQ("running", it->second.getString());
     }
+    {
+        auto url = "/status?daemon=plan_cache_hit_rate";
+        auto request = folly::stringPrintf("http://%s:%d%s", FLAGS_ws_ip.c_str(),
+                                           FLAGS_ws_http_port, url);
+        auto resp = http::HttpClient::get(request);
+        ASSERT_TRUE(resp.ok());
+        ASSERT_EQ("plan_cache_hit_rate=0.00\n", resp.value());
+    }
     {
         auto url = "/status123?daemon=status";
         auto request = folly::stringPrintf("http://%s:%d%s", FLAGS_ws_ip.c_str(),
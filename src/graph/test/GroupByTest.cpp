@@ -0,0 +1,150 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/test/TestEnv.h"
+#include "graph/test/TestBase.h"
+#include "graph/test/TraverseTestBase.h"
+#include "meta/test/TestUtils.h"
+
+namespace nebula {
+namespace graph {
+
+class GroupByTest : public TraverseTestBase {
+protected:
+    void SetUp() override {
+        TraverseTestBase::SetUp();
+        // ...
+    }
+
+    void TearDown() override {
+        // ...
+        TraverseTestBase::TearDown();
+    }
+};
+
+TEST_F(GroupByTest, SyntaxError) {
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GROUP BY $-.name";
+        auto code = client_->execute(fmt, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_SYNTAX_ERROR, code);
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GROUP BY YIELD COUNT(*)";
+        auto code = client_->execute(fmt, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_SYNTAX_ERROR, code);
+    }
+}
+
+TEST_F(GroupByTest, WrongColumn) {
+    std::string go = "GO FROM %ld OVER serve YIELD "
+                     "$^.player.name as name, serve.start_year as start";
+    auto &player = players_["Boris Diaw"];
+    {
+        cpp2::ExecutionResponse resp;
+        // Neither a key nor aggregated
+        auto fmt = go + "| GROUP BY $-.name YIELD $-.start";
+        auto query = folly::stringPrintf(fmt.c_str(), player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto fmt = go + "| GROUP BY $-.name YIELD $-.name, MEDIAN($-.start)";
+        auto query = folly::stringPrintf(fmt.c_str(), player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        // Not taken as COUNT(*)
+        auto fmt = go + "| GROUP BY $-.name YIELD $-.name, COUNT()";
+        auto query = folly::stringPrintf(fmt.c_str(), player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto fmt = go + "| GROUP BY $-.name YIELD $-.name, SUM(*)";
+        auto query = folly::stringPrintf(fmt.c_str(), player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto fmt = go + "| GROUP BY $-.team YIELD $-.team, COUNT(*)";
+        auto query = folly::stringPrintf(fmt.c_str(), player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+    }
+}
+
+TEST_F(GroupByTest, Aggregate) {
+    std::string go = "GO FROM %ld,%ld OVER serve YIELD "
+                     "$^.player.name as name, serve.start_year as start";
+    auto &boris = players_["Boris Diaw"];
+    auto &aldridge = players_["LaMarcus Aldridge"];
+    {
+        cpp2::ExecutionResponse resp;
+        auto fmt = go + "| GROUP BY $-.name YIELD $-.name AS name, COUNT(*) AS cnt, "
+                        "MIN($-.start) AS first, MAX($-.start) AS last";
+        auto query = folly::stringPrintf(fmt.c_str(), boris.vid(), aldridge.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::string> expectedColNames{"name", "cnt", "first", "last"};
+        ASSERT_EQ(expectedColNames, *resp.get_column_names());
+        std::vector<std::tuple<std::string, int64_t, int64_t, int64_t>> expected = {
+            {boris.name(), 5, 2003, 2016},
+            {aldridge.name(), 2, 2006, 2015},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto fmt = go + "| GROUP BY name YIELD $-.name, SUM($-.start), AVG($-.start)";
+        auto query = folly::stringPrintf(fmt.c_str(), boris.vid(), aldridge.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<std::string, int64_t, double>> expected = {
+            {boris.name(), 10044, 2008.8},
+            {aldridge.name(), 4021, 2010.5},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO FROM %ld OVER serve YIELD $^.player.name as name, "
+                    "serve.start_year as start "
+                    "| GROUP BY $-.name YIELD COLLECT($-.start + 1) AS years";
+        auto query = folly::stringPrintf(fmt, aldridge.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        ASSERT_EQ(1UL, resp.get_rows()->size());
+        auto &years = resp.get_rows()->front().get_columns()[0].get_str();
+        ASSERT_TRUE(years == "[2007, 2016]" || years == "[2016, 2007]") << years;
+    }
+}
+
+TEST_F(GroupByTest, OrderByCount) {
+    cpp2::ExecutionResponse resp;
+    auto &boris = players_["Boris Diaw"];
+    auto &aldridge = players_["LaMarcus Aldridge"];
+    auto *fmt = "GO FROM %ld,%ld OVER serve YIELD $$.team.name as team "
+                "| GROUP BY $-.team YIELD $-.team AS team, COUNT(*) AS cnt "
+                "| ORDER BY $-.cnt DESC, $-.team | LIMIT 1";
+    auto query = folly::stringPrintf(fmt, boris.vid(), aldridge.vid());
+    auto code = client_->execute(query, resp);
+    ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+    std::vector<std::tuple<std::string, int64_t>> expected = {
+        {"Spurs", 2},
+    };
+    ASSERT_TRUE(verifyResult(resp, expected, false));
+}
+
+}   // namespace graph
+}   // namespace nebula
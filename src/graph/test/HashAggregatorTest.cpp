@@ -0,0 +1,177 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include "graph/HashAggregator.h"
+
+namespace nebula {
+namespace graph {
+
+using Function = HashAggregator::Function;
+using Rows = std::vector<cpp2::RowValue>;
+
+// <key, value>
+static cpp2::RowValue makeRow(int64_t key, int64_t value) {
+    std::vector<cpp2::ColumnValue> cols(2);
+    cols[0].set_integer(key);
+    cols[1].set_integer(value);
+    cpp2::RowValue row;
+    row.set_columns(std::move(cols));
+    return row;
+}
+
+// Rows of keys [0, numKeys), and values [0, numValues) for every key
+static Rows makeRows(int64_t numKeys, int64_t numValues) {
+    Rows rows;
+    for (auto v = 0; v < numValues; v++) {
+        for (auto k = 0; k < numKeys; k++) {
+            rows.emplace_back(makeRow(k, v));
+        }
+    }
+    return rows;
+}
+
+static std::vector<HashAggregator::Column> allColumns() {
+    return {
+        {Function::KEY, 0},
+        {Function::COUNT_ALL, 0},
+        {Function::SUM, 1},
+        {Function::AVG, 1},
+        {Function::MIN, 1},
+        {Function::MAX, 1},
+    };
+}
+
+// Check the output of allColumns() on makeRows(numKeys, numValues)
+static void checkResult(Rows rows, int64_t numKeys, int64_t numValues) {
+    ASSERT_EQ(static_cast<size_t>(numKeys), rows.size());
+    std::sort(rows.begin(), rows.end(), [] (const auto &lhs, const auto &rhs) {
+        return lhs.get_columns()[0].get_integer() < rhs.get_columns()[0].get_integer();
+    });
+    for (auto k = 0; k < numKeys; k++) {
+        auto &cols = rows[k].get_columns();
+        ASSERT_EQ(6UL, cols.size());
+        ASSERT_EQ(k, cols[0].get_integer());
+        ASSERT_EQ(numValues, cols[1].get_integer());
+        ASSERT_EQ(numValues * (numValues - 1) / 2, cols[2].get_integer());
+        ASSERT_DOUBLE_EQ((numValues - 1) / 2.0, cols[3].get_double_precision());
+        ASSERT_EQ(0, cols[4].get_integer());
+        ASSERT_EQ(numValues - 1, cols[5].get_integer());
+    }
+}
+
+
+TEST(HashAggregator, Function) {
+    ASSERT_EQ(Function::COUNT, HashAggregator::toFunction("count").value());
+    ASSERT_EQ(Function::SUM, HashAggregator::toFunction("SUM").value());
+    ASSERT_EQ(Function::COLLECT, HashAggregator::toFunction("Collect").value());
+    ASSERT_FALSE(HashAggregator::toFunction("median").ok());
+}
+
+
+TEST(HashAggregator, Aggregate) {
+    HashAggregator aggregator(1, allColumns(), 1, nullptr, 1024 * 1024, "/tmp");
+    // Batches are aggregated as they come
+    for (auto i = 0; i < 3; i++) {
+        auto status = aggregator.add(makeRows(10, 10)).get();
+        ASSERT_TRUE(status.ok()) << status;
+    }
+    ASSERT_EQ(10UL, aggregator.numGroups());
+
+    Rows rows;
+    auto status = aggregator.finish([&rows] (cpp2::RowValue &row) {
+        rows.emplace_back(std::move(row));
+    });
+    ASSERT_TRUE(status.ok()) << status;
+    ASSERT_EQ(10UL, rows.size());
+    for (auto &row : rows) {
+        auto &cols = row.get_columns();
+        ASSERT_EQ(30, cols[1].get_integer());
+        ASSERT_EQ(135, cols[2].get_integer());
+        ASSERT_DOUBLE_EQ(4.5, cols[3].get_double_precision());
+    }
+}
+
+
+TEST(HashAggregator, Collect) {
+    std::vector<HashAggregator::Column> columns = {
+        {Function::KEY, 0},
+        {Function::COLLECT, 1},
+    };
+    HashAggregator aggregator(1, std::move(columns), 1, nullptr, 1024 * 1024, "/tmp");
+    auto status = aggregator.add({makeRow(1, 1), makeRow(1, 2), makeRow(2, 3)}).get();
+    ASSERT_TRUE(status.ok()) << status;
+
+    std::unordered_map<int64_t, std::string> collected;
+    status = aggregator.finish([&collected] (cpp2::RowValue &row) {
+        auto &cols = row.get_columns();
+        collected[cols[0].get_integer()] = cols[1].get_str();
+    });
+    ASSERT_TRUE(status.ok()) << status;
+    ASSERT_EQ("[1, 2]", collected[1]);
+    ASSERT_EQ("[3]", collected[2]);
+}
+
+
+TEST(HashAggregator, Parallel) {
+    folly::CPUThreadPoolExecutor pool(4);
+    HashAggregator aggregator(1, allColumns(), 4, &pool, 64 * 1024 * 1024, "/tmp");
+    auto status = aggregator.add(makeRows(1000, 100)).get();
+    ASSERT_TRUE(status.ok()) << status;
+
+    Rows rows;
+    status = aggregator.finish([&rows] (cpp2::RowValue &row) {
+        rows.emplace_back(std::move(row));
+    });
+    ASSERT_TRUE(status.ok()) << status;
+    checkResult(std::move(rows), 1000, 100);
+}
+
+
+TEST(HashAggregator, Spill) {
+    folly::CPUThreadPoolExecutor pool(4);
+    // Only a few groups fit in memory
+    HashAggregator aggregator(1, allColumns(), 4, &pool, 4096, "/tmp");
+    for (auto i = 0; i < 10; i++) {
+        // Values [10 * i, 10 * i + 10) for each key
+        Rows rows;
+        for (auto v = 10 * i; v < 10 * i + 10; v++) {
+            for (auto k = 0; k < 1000; k++) {
+                rows.emplace_back(makeRow(k, v));
+            }
+        }
+        auto status = aggregator.add(std::move(rows)).get();
+        ASSERT_TRUE(status.ok()) << status;
+    }
+
+    Rows rows;
+    auto status = aggregator.finish([&rows] (cpp2::RowValue &row) {
+        rows.emplace_back(std::move(row));
+    });
+    ASSERT_TRUE(status.ok()) << status;
+    checkResult(std::move(rows), 1000, 100);
+}
+
+
+TEST(HashAggregator, NonNumeric) {
+    std::vector<HashAggregator::Column> columns = {
+        {Function::KEY, 0},
+        {Function::SUM, 1},
+    };
+    HashAggregator aggregator(1, std::move(columns), 1, nullptr, 1024 * 1024, "/tmp");
+    std::vector<cpp2::ColumnValue> cols(2);
+    cols[0].set_integer(1);
+    cols[1].set_str("one");
+    cpp2::RowValue row;
+    row.set_columns(std::move(cols));
+    auto status = aggregator.add({row}).get();
+    ASSERT_FALSE(status.ok());
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -0,0 +1,160 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include "graph/HashSetOperator.h"
+#include "dataman/SchemaWriter.h"
+
+DECLARE_int32(set_op_concurrency);
+
+namespace nebula {
+namespace graph {
+
+using Rows = HashSetOperator::Rows;
+
+static cpp2::RowValue makeRow(int64_t id, std::string name) {
+    std::vector<cpp2::ColumnValue> cols(2);
+    cols[0].set_integer(id);
+    cols[1].set_str(std::move(name));
+    cpp2::RowValue row;
+    row.set_columns(std::move(cols));
+    return row;
+}
+
+static Rows makeRows(int64_t from, int64_t to) {
+    Rows rows;
+    for (auto i = from; i < to; i++) {
+        rows.emplace_back(makeRow(i, folly::to<std::string>("row", i)));
+    }
+    return rows;
+}
+
+static HashSetOperator::Batch makeBatch(const Rows &rows) {
+    auto schema = std::make_shared<SchemaWriter>();
+    schema->appendCol("id", nebula::cpp2::SupportedType::INT);
+    schema->appendCol("name", nebula::cpp2::SupportedType::STRING);
+    ColumnBatch::Builder builder(schema);
+    for (auto &row : rows) {
+        builder.append(row.get_columns());
+    }
+    return builder.finish();
+}
+
+
+TEST(HashSetOperator, Encode) {
+    ASSERT_EQ(HashSetOperator::encode(makeRow(1, "a")),
+              HashSetOperator::encode(makeRow(1, "a")));
+    ASSERT_NE(HashSetOperator::encode(makeRow(1, "a")),
+              HashSetOperator::encode(makeRow(1, "b")));
+    ASSERT_NE(HashSetOperator::encode(makeRow(1, "a")),
+              HashSetOperator::encode(makeRow(2, "a")));
+
+    // Same value in different types
+    std::vector<cpp2::ColumnValue> cols(1);
+    cols[0].set_integer(1);
+    cpp2::RowValue intRow;
+    intRow.set_columns(cols);
+    cols[0].set_id(1);
+    cpp2::RowValue idRow;
+    idRow.set_columns(cols);
+    ASSERT_NE(HashSetOperator::encode(intRow), HashSetOperator::encode(idRow));
+
+    // The boundaries of strings are kept
+    std::vector<cpp2::ColumnValue> strs(2);
+    strs[0].set_str("ab");
+    strs[1].set_str("c");
+    cpp2::RowValue row1;
+    row1.set_columns(strs);
+    strs[0].set_str("a");
+    strs[1].set_str("bc");
+    cpp2::RowValue row2;
+    row2.set_columns(strs);
+    ASSERT_NE(HashSetOperator::encode(row1), HashSetOperator::encode(row2));
+}
+
+
+TEST(HashSetOperator, Small) {
+    auto left = makeRows(0, 10);
+    left.emplace_back(makeRow(5, "row5"));
+    auto right = makeRows(5, 20);
+    {
+        auto rows = HashSetOperator::intersect(left, right, nullptr).get();
+        Rows expected = makeRows(5, 10);
+        expected.emplace_back(makeRow(5, "row5"));
+        ASSERT_EQ(expected, rows);
+    }
+    {
+        auto rows = HashSetOperator::minus(left, right, nullptr).get();
+        ASSERT_EQ(makeRows(0, 5), rows);
+    }
+    {
+        auto rows = HashSetOperator::distinct(left, nullptr).get();
+        ASSERT_EQ(makeRows(0, 10), rows);
+    }
+    {
+        auto rows = HashSetOperator::minus(left, Rows(), nullptr).get();
+        ASSERT_EQ(left, rows);
+        rows = HashSetOperator::intersect(Rows(), right, nullptr).get();
+        ASSERT_TRUE(rows.empty());
+    }
+}
+
+
+TEST(HashSetOperator, Batches) {
+    auto left = makeRows(0, 10);
+    left.emplace_back(makeRow(5, "row5"));
+    // The strings are coded differently in the two batches
+    auto right = makeRows(5, 20);
+    std::reverse(right.begin(), right.end());
+    auto leftBatch = makeBatch(left);
+    auto rightBatch = makeBatch(right);
+    using Indexes = HashSetOperator::Indexes;
+    {
+        auto indexes = HashSetOperator::intersect(leftBatch, rightBatch, nullptr).get();
+        ASSERT_EQ(Indexes({5, 6, 7, 8, 9, 10}), indexes);
+    }
+    {
+        auto indexes = HashSetOperator::minus(leftBatch, rightBatch, nullptr).get();
+        ASSERT_EQ(Indexes({0, 1, 2, 3, 4}), indexes);
+    }
+    {
+        auto indexes = HashSetOperator::distinct(leftBatch, nullptr).get();
+        ASSERT_EQ(Indexes({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), indexes);
+    }
+    {
+        auto indexes = HashSetOperator::minus(leftBatch, nullptr, nullptr).get();
+        ASSERT_EQ(left.size(), indexes.size());
+        indexes = HashSetOperator::intersect(nullptr, rightBatch, nullptr).get();
+        ASSERT_TRUE(indexes.empty());
+    }
+}
+
+
+TEST(HashSetOperator, Parallel) {
+    FLAGS_set_op_concurrency = 8;
+    folly::CPUThreadPoolExecutor pool(4);
+    auto left = makeRows(0, 100000);
+    auto right = makeRows(50000, 150000);
+    {
+        auto rows = HashSetOperator::intersect(left, right, &pool).get();
+        ASSERT_EQ(makeRows(50000, 100000), rows);
+    }
+    {
+        auto rows = HashSetOperator::minus(left, right, &pool).get();
+        ASSERT_EQ(makeRows(0, 50000), rows);
+    }
+    {
+        auto all = left;
+        all.insert(all.end(), right.begin(), right.end());
+        auto rows = HashSetOperator::distinct(std::move(all), &pool).get();
+        ASSERT_EQ(makeRows(0, 150000), rows);
+    }
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -0,0 +1,202 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "graph/InterimResult.h"
+#include "graph/MemoryTracker.h"
+#include "dataman/RowWriter.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+std::shared_ptr<SchemaWriter> makeSchema() {
+    auto schema = std::make_shared<SchemaWriter>();
+    schema->appendCol("id", nebula::cpp2::SupportedType::VID);
+    schema->appendCol("score", nebula::cpp2::SupportedType::DOUBLE);
+    schema->appendCol("flag", nebula::cpp2::SupportedType::BOOL);
+    schema->appendCol("name", nebula::cpp2::SupportedType::STRING);
+    return schema;
+}
+
+// Only two distinct names
+cpp2::RowValue makeRow(int64_t id) {
+    std::vector<cpp2::ColumnValue> cols(4);
+    cols[0].set_integer(id);
+    cols[1].set_double_precision(id * 0.5);
+    cols[2].set_bool_val(id % 2 == 0);
+    cols[3].set_str(folly::stringPrintf("name_%ld", id % 2));
+    cpp2::RowValue row;
+    row.set_columns(std::move(cols));
+    return row;
+}
+
+void checkRow(int64_t id, const cpp2::RowValue &row) {
+    auto &cols = row.get_columns();
+    ASSERT_EQ(4UL, cols.size());
+    ASSERT_EQ(id, cols[0].get_integer());
+    ASSERT_EQ(id * 0.5, cols[1].get_double_precision());
+    ASSERT_EQ(id % 2 == 0, cols[2].get_bool_val());
+    ASSERT_EQ(folly::stringPrintf("name_%ld", id % 2), cols[3].get_str());
+}
+
+}   // Anonymous namespace
+
+
+TEST(InterimResultTest, FromRows) {
+    std::vector<cpp2::RowValue> rows;
+    for (auto i = 0; i < 10; i++) {
+        rows.emplace_back(makeRow(i));
+    }
+    auto result = InterimResult::getInterim(makeSchema(), rows);
+    ASSERT_NE(nullptr, result);
+    ASSERT_EQ(10UL, result->numRows());
+
+    auto got = result->getRows();
+    ASSERT_EQ(10UL, got.size());
+    for (auto i = 0; i < 10; i++) {
+        checkRow(i, got[i]);
+    }
+
+    // Equal strings are encoded once
+    auto &names = result->batch()->column(3);
+    ASSERT_EQ(names.getCode(0), names.getCode(2));
+    ASSERT_NE(names.getCode(0), names.getCode(1));
+
+    auto vids = result->getVIDs("id");
+    ASSERT_TRUE(vids.ok());
+    ASSERT_EQ(10UL, vids.value().size());
+    ASSERT_EQ(9, vids.value().back());
+    ASSERT_FALSE(result->getVIDs("name").ok());
+    ASSERT_FALSE(result->getVIDs("nonexist").ok());
+}
+
+
+TEST(InterimResultTest, FromRowSetWriter) {
+    auto schema = makeSchema();
+    auto rsWriter = std::make_unique<RowSetWriter>(schema);
+    for (auto i = 0; i < 10; i++) {
+        RowWriter writer(schema);
+        writer << i << i * 0.5 << (i % 2 == 0) << folly::stringPrintf("name_%d", i % 2);
+        rsWriter->addRow(writer);
+    }
+    InterimResult result(std::move(rsWriter));
+    auto i = 0;
+    result.forEachRow([&] (cpp2::RowValue &row) {
+        checkRow(i++, row);
+        return true;
+    });
+    ASSERT_EQ(10, i);
+
+    auto index = result.buildIndex("id");
+    ASSERT_NE(nullptr, index);
+    auto *row = index->getRowWithVID(3);
+    ASSERT_NE(nullptr, row);
+    ASSERT_EQ("name_1", boost::get<std::string>((*row)[3]));
+    ASSERT_EQ(nullptr, index->getRowWithVID(10));
+    ASSERT_EQ(nullptr, result.buildIndex("name"));
+}
+
+
+TEST(InterimResultTest, IndexBatches) {
+    std::unique_ptr<InterimResult::InterimResultIndex> index;
+    for (auto i = 0; i < 10; i += 5) {
+        std::vector<cpp2::RowValue> rows;
+        for (auto j = i; j < i + 5; j++) {
+            rows.emplace_back(makeRow(j));
+        }
+        auto result = InterimResult::getInterim(makeSchema(), rows);
+        ASSERT_NE(nullptr, result);
+        index = result->buildIndex("id", std::move(index));
+        ASSERT_NE(nullptr, index);
+    }
+    for (auto i = 0; i < 10; i++) {
+        auto *row = index->getRowWithVID(i);
+        ASSERT_NE(nullptr, row);
+        ASSERT_EQ(i * 0.5, boost::get<double>((*row)[1]));
+    }
+    ASSERT_EQ(nullptr, index->getRowWithVID(10));
+    ASSERT_EQ(3, index->getColumnIndex("name"));
+}
+
+
+TEST(InterimResultTest, SliceAndSelect) {
+    std::vector<cpp2::RowValue> rows;
+    for (auto i = 0; i < 10; i++) {
+        rows.emplace_back(makeRow(i));
+    }
+    auto result = InterimResult::getInterim(makeSchema(), rows);
+    ASSERT_NE(nullptr, result);
+
+    auto sliced = result->slice(8, 5);
+    auto got = sliced->getRows();
+    ASSERT_EQ(2UL, got.size());
+    checkRow(8, got[0]);
+    checkRow(9, got[1]);
+    ASSERT_EQ(0UL, result->slice(10, 1)->numRows());
+    ASSERT_EQ(10UL, result->slice(0, std::numeric_limits<int64_t>::max())->numRows());
+
+    auto selected = result->select({7, 0, 7});
+    got = selected->getRows();
+    ASSERT_EQ(3UL, got.size());
+    checkRow(7, got[0]);
+    checkRow(0, got[1]);
+    checkRow(7, got[2]);
+    // The strings are shared, not copied
+    ASSERT_EQ(&result->batch()->column(3).getString(7),
+              &selected->batch()->column(3).getString(0));
+}
+
+
+TEST(InterimResultTest, Merge) {
+    std::vector<std::unique_ptr<InterimResult>> results;
+    results.emplace_back(nullptr);
+    ASSERT_EQ(nullptr, InterimResult::merge(std::move(results)));
+
+    results.clear();
+    for (auto i = 0; i < 10; i += 5) {
+        std::vector<cpp2::RowValue> rows;
+        for (auto j = i; j < i + 5; j++) {
+            rows.emplace_back(makeRow(j));
+        }
+        results.emplace_back(InterimResult::getInterim(makeSchema(), rows));
+        results.emplace_back(nullptr);
+    }
+    auto merged = InterimResult::merge(std::move(results));
+    ASSERT_NE(nullptr, merged);
+    auto got = merged->getRows();
+    ASSERT_EQ(10UL, got.size());
+    for (auto i = 0; i < 10; i++) {
+        checkRow(i, got[i]);
+    }
+    // The strings are encoded again into one dictionary
+    auto &names = merged->batch()->column(3);
+    ASSERT_EQ(names.getCode(1), names.getCode(9));
+}
+
+
+TEST(InterimResultTest, Charges) {
+    auto tracker = std::make_shared<MemoryTracker>("query 1", 0, 0);
+    std::vector<std::unique_ptr<InterimResult>> results;
+    for (auto i = 0; i < 2; i++) {
+        std::vector<cpp2::RowValue> rows{makeRow(i)};
+        results.emplace_back(InterimResult::getInterim(makeSchema(), rows));
+        ASSERT_TRUE(tracker->consume(10).ok());
+        results.back()->addCharge(std::make_shared<MemoryCharge>(tracker, 10));
+    }
+    // Held by the result merged
+    auto merged = InterimResult::merge(std::move(results));
+    results.clear();
+    ASSERT_EQ(20, tracker->used());
+    merged.reset();
+    ASSERT_EQ(0, tracker->used());
+    ASSERT_EQ(20, tracker->peak());
+}
+
+}   // namespace graph
+}   // namespace nebula
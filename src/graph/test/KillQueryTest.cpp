@@ -0,0 +1,134 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/test/TestEnv.h"
+#include "graph/test/TestBase.h"
+#include "graph/test/TraverseTestBase.h"
+#include "meta/test/TestUtils.h"
+
+namespace nebula {
+namespace graph {
+
+class KillQueryTest : public TraverseTestBase {
+protected:
+    void SetUp() override {
+        TraverseTestBase::SetUp();
+        // ...
+    }
+
+    void TearDown() override {
+        // ...
+        TraverseTestBase::TearDown();
+    }
+};
+
+TEST_F(KillQueryTest, KillQuery) {
+    {
+        cpp2::ExecutionResponse resp;
+        std::string query = "SHOW QUERIES";
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::string> expectedColNames{
+            "Id", "Session", "User", "Query", "Duration(ms)", "Timeout(ms)", "Memory(bytes)"
+        };
+        ASSERT_EQ(expectedColNames, *resp.get_column_names());
+        // Only the query itself is running
+        ASSERT_EQ(1, resp.get_rows()->size());
+        auto &columns = resp.get_rows()->front().get_columns();
+        ASSERT_EQ(query, columns[3].get_str());
+        ASSERT_EQ(0, columns[5].get_integer());
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        std::string query = "KILL QUERY 999999999";
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        std::string query = "SET SESSION query_timeout_ms = -1";
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Tim Duncan"];
+        auto *fmt = "TIMEOUT 60000 GO FROM %ld OVER serve";
+        auto query = folly::stringPrintf(fmt, player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t>> expected = {
+            {teams_["Spurs"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        std::string query = "TIMEOUT 60000 SHOW QUERIES";
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        ASSERT_EQ(1, resp.get_rows()->size());
+        ASSERT_EQ(60000, resp.get_rows()->front().get_columns()[5].get_integer());
+    }
+}
+
+
+TEST_F(KillQueryTest, CancelRunning) {
+    // Round the cycle of Tim Duncan and Tony Parker, with a read for each step
+    auto *fmt = "GO 100000 STEPS FROM %ld OVER like";
+    auto query = folly::stringPrintf(fmt, players_["Tim Duncan"].vid());
+    {
+        cpp2::ExecutionResponse resp;
+        auto code = client_->execute("TIMEOUT 1 " + query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+        ASSERT_NE(std::string::npos, resp.get_error_msg()->find("timed out"));
+    }
+    {
+        auto client = gEnv->getClient();
+        ASSERT_NE(nullptr, client);
+        cpp2::ExecutionResponse resp;
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, client->execute("USE nba", resp));
+
+        // Bounded by a timeout, in case it is never killed
+        auto bounded = "TIMEOUT 60000 " + query;
+        auto code = cpp2::ErrorCode::SUCCEEDED;
+        std::thread running([&] () {
+            code = client->execute(bounded, resp);
+        });
+        // Killed from another session
+        int64_t id = 0;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (id == 0 && std::chrono::steady_clock::now() < deadline) {
+            cpp2::ExecutionResponse shown;
+            if (client_->execute("SHOW QUERIES", shown) != cpp2::ErrorCode::SUCCEEDED) {
+                break;
+            }
+            for (auto &row : *shown.get_rows()) {
+                auto &columns = row.get_columns();
+                if (columns[3].get_str() == bounded) {
+                    id = columns[0].get_integer();
+                }
+            }
+            if (id == 0) {
+                usleep(1000);
+            }
+        }
+        if (id == 0) {
+            running.join();
+        }
+        ASSERT_NE(0, id) << "The query is not seen running";
+        cpp2::ExecutionResponse killed;
+        auto killCode = client_->execute(folly::stringPrintf("KILL QUERY %ld", id), killed);
+        running.join();
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, killCode);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+        ASSERT_NE(std::string::npos, resp.get_error_msg()->find("was killed"));
+    }
+}
+
+}   // namespace graph
+}   // namespace nebula
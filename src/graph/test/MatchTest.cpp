@@ -0,0 +1,83 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/test/TestEnv.h"
+#include "graph/test/TestBase.h"
+#include "graph/test/TraverseTestBase.h"
+#include "meta/test/TestUtils.h"
+
+namespace nebula {
+namespace graph {
+
+class MatchTest : public TraverseTestBase {
+protected:
+    void SetUp() override {
+        TraverseTestBase::SetUp();
+        // ...
+    }
+
+    void TearDown() override {
+        // ...
+        TraverseTestBase::TearDown();
+    }
+};
+
+TEST_F(MatchTest, Match) {
+    {
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Tim Duncan"];
+        auto *fmt = "MATCH (a)-[:like]->(b)-[:like]->(c)-[:like]->(a) FROM %ld";
+        auto query = folly::stringPrintf(fmt, player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::string> expectedColNames{"a", "b", "c"};
+        ASSERT_EQ(expectedColNames, *resp.get_column_names());
+        std::vector<std::tuple<int64_t, int64_t, int64_t>> expected = {
+            {player.vid(), players_["Tony Parker"].vid(), players_["Manu Ginobili"].vid()},
+            {player.vid(), players_["Tony Parker"].vid(), players_["LaMarcus Aldridge"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Tony Parker"];
+        auto *fmt = "MATCH (a)-[:like WHERE like.likeness > 90]->(b) FROM %ld";
+        auto query = folly::stringPrintf(fmt, player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t, int64_t>> expected = {
+            {player.vid(), players_["Tim Duncan"].vid()},
+            {player.vid(), players_["Manu Ginobili"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        // The filtered edge is taken into `b' first, then out of it with the filter
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Tim Duncan"];
+        auto *fmt = "MATCH (a)<-[:like WHERE like.likeness < 80]-(b) FROM %ld";
+        auto query = folly::stringPrintf(fmt, player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<int64_t, int64_t>> expected = {
+            {player.vid(), players_["LaMarcus Aldridge"].vid()},
+            {player.vid(), players_["Marco Belinelli"].vid()},
+            {player.vid(), players_["Danny Green"].vid()},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "MATCH (a)-[:like]->(b), (c)-[:like]->(d) FROM %ld";
+        auto query = folly::stringPrintf(fmt, players_["Tim Duncan"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+    }
+}
+
+}   // namespace graph
+}   // namespace nebula
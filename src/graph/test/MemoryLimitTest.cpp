@@ -0,0 +1,105 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/test/TestEnv.h"
+#include "graph/test/TestBase.h"
+#include "graph/test/TraverseTestBase.h"
+#include "graph/GraphFlags.h"
+#include "meta/test/TestUtils.h"
+
+namespace nebula {
+namespace graph {
+
+class MemoryLimitTest : public TraverseTestBase {
+protected:
+    void SetUp() override {
+        TraverseTestBase::SetUp();
+        // ...
+    }
+
+    void TearDown() override {
+        // ...
+        TraverseTestBase::TearDown();
+    }
+};
+
+TEST_F(MemoryLimitTest, MemoryLimit) {
+    auto &player = players_["Tim Duncan"];
+    auto query = folly::stringPrintf("GO FROM %ld OVER like", player.vid());
+    {
+        cpp2::ExecutionResponse resp;
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        ASSERT_NE(nullptr, resp.get_peak_memory_bytes());
+        ASSERT_LT(0, *resp.get_peak_memory_bytes());
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto code = client_->execute("SET SESSION query_memory_limit_bytes = 1", resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+        ASSERT_NE(std::string::npos, resp.get_error_msg()->find("Memory limit"));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto code = client_->execute("SET SESSION query_memory_limit_bytes = 0", resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+    }
+}
+
+
+TEST_F(MemoryLimitTest, SpilledMemoryLimit) {
+    gflags::FlagSaver flagSaver;
+    // Every row is spilled as it comes
+    FLAGS_order_by_memory_limit_bytes = 1;
+    auto *fmt = "GO FROM %ld, %ld, %ld, %ld OVER like "
+                "YIELD like._dst AS id, like.likeness AS likeness";
+    auto go = folly::stringPrintf(fmt,
+                                  players_["Tim Duncan"].vid(),
+                                  players_["Tony Parker"].vid(),
+                                  players_["Dejounte Murray"].vid(),
+                                  players_["Chris Paul"].vid());
+    int64_t peak = 0;
+    {
+        // The outputs are kept for the response
+        cpp2::ExecutionResponse resp;
+        auto code = client_->execute(go, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        ASSERT_NE(nullptr, resp.get_peak_memory_bytes());
+        peak = *resp.get_peak_memory_bytes();
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto query = folly::stringPrintf("SET SESSION query_memory_limit_bytes = %ld", peak);
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+    }
+    {
+        // Charged once, by the sorter, rather than by the pipe as well
+        cpp2::ExecutionResponse resp;
+        auto code = client_->execute(go + " | ORDER BY $-.likeness", resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        ASSERT_LE(*resp.get_peak_memory_bytes(), peak);
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto code = client_->execute("SET SESSION query_memory_limit_bytes = 0", resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+    }
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -0,0 +1,66 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "graph/MemoryTracker.h"
+
+namespace nebula {
+namespace graph {
+
+TEST(MemoryTracker, Limits) {
+    auto stats = MemoryTracker::stats();
+    auto session = std::make_shared<MemoryTracker>("session 1", 100, 0);
+    {
+        MemoryTracker query1("query 1", 60, 0, session);
+        ASSERT_TRUE(query1.consume(50).ok());
+        // Beyond the limit of the query, nothing is charged
+        ASSERT_FALSE(query1.consume(20).ok());
+        ASSERT_EQ(50, query1.used());
+        ASSERT_EQ(50, session->used());
+
+        MemoryTracker query2("query 2", 0, 0, session);
+        ASSERT_TRUE(query2.consume(40).ok());
+        // Beyond the limit of the session
+        auto status = query2.consume(20);
+        ASSERT_FALSE(status.ok());
+        ASSERT_NE(std::string::npos, status.toString().find("session 1"));
+        ASSERT_EQ(40, query2.used());
+        ASSERT_EQ(90, session->used());
+
+        query1.release(30);
+        ASSERT_TRUE(query2.consume(20).ok());
+        ASSERT_EQ(20, query1.used());
+        ASSERT_EQ(50, query1.peak());
+        ASSERT_EQ(60, query2.used());
+        ASSERT_EQ(90, session->peak());
+
+        auto now = MemoryTracker::stats();
+        ASSERT_EQ(stats.used + 80, now.used);
+        ASSERT_EQ(stats.exceeded + 2, now.exceeded);
+    }
+    // Given back once the queries are done
+    ASSERT_EQ(0, session->used());
+    ASSERT_EQ(90, session->peak());
+    ASSERT_EQ(stats.used, MemoryTracker::stats().used);
+}
+
+
+TEST(MemoryTracker, SoftLimit) {
+    MemoryTracker query("query 1", 0, 1024, nullptr);
+    ASSERT_TRUE(query.consume(1024).ok());
+    ASSERT_FALSE(query.overSoftLimit());
+    ASSERT_TRUE(query.consume(1).ok());
+    ASSERT_TRUE(query.overSoftLimit());
+    // Not worth spilling a small buffer
+    ASSERT_FALSE(query.shouldSpill(1024));
+    ASSERT_TRUE(query.shouldSpill(16 * 1024 * 1024));
+    query.release(1);
+    ASSERT_FALSE(query.shouldSpill(16 * 1024 * 1024));
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -256,5 +256,46 @@ TEST_F(OrderByTest, InterimResult) {
         ASSERT_TRUE(verifyResult(resp, expected));
     }
 }
+
+TEST_F(OrderByTest, Limit) {
+    std::string go = "GO FROM %ld OVER serve YIELD "
+                     "$^.player.name as name, serve.start_year as start, $$.team.name as team";
+    {
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Boris Diaw"];
+        auto fmt = go + "| ORDER BY $-.team | LIMIT 2";
+        auto query = folly::stringPrintf(fmt.c_str(), player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<std::string, int64_t, std::string>> expected = {
+            {player.name(), 2003, "Hawks"},
+            {player.name(), 2008, "Hornets"},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected, false));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Boris Diaw"];
+        auto fmt = go + "| ORDER BY $-.start DESC | LIMIT 1, 3";
+        auto query = folly::stringPrintf(fmt.c_str(), player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<std::string, int64_t, std::string>> expected = {
+            {player.name(), 2012, "Spurs"},
+            {player.name(), 2008, "Hornets"},
+            {player.name(), 2005, "Suns"},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected, false));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Boris Diaw"];
+        auto fmt = go + "| ORDER BY $-.team | LIMIT 10, 2";
+        auto query = folly::stringPrintf(fmt.c_str(), player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        ASSERT_EQ(nullptr, resp.get_rows());
+    }
+}
 }   // namespace graph
 }   // namespace nebula
@@ -0,0 +1,94 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "graph/PlanCache.h"
+#include "parser/GQLParser.h"
+
+namespace nebula {
+namespace graph {
+
+static std::unique_ptr<SequentialSentences> parse(const std::string &query) {
+    auto result = GQLParser().parse(query);
+    CHECK(result.ok()) << result.status();
+    return std::move(result).value();
+}
+
+
+TEST(PlanCache, Normalize) {
+    ASSERT_EQ("GO FROM 1 OVER like", PlanCache::normalize("  GO  FROM 1\tOVER like  "));
+    ASSERT_EQ("GO FROM 1 OVER like", PlanCache::normalize("GO FROM 1 OVER like"));
+    // White spaces in string literals are kept
+    ASSERT_EQ("YIELD \"a  b\" , 'c  d'", PlanCache::normalize("YIELD  \"a  b\" ,  'c  d'"));
+    ASSERT_EQ("YIELD \"a\\\"  b\"", PlanCache::normalize("YIELD \"a\\\"  b\""));
+    // Newlines end the line comments
+    ASSERT_EQ("# comment\nYIELD 1", PlanCache::normalize("# comment  \n  YIELD 1"));
+}
+
+
+TEST(PlanCache, GetAndPut) {
+    PlanCache cache(2);
+    auto query = "GO FROM 1 OVER like";
+    ASSERT_EQ(nullptr, cache.get(1, query, 0));
+
+    cache.put(1, query, 0, parse(query));
+    ASSERT_EQ(1UL, cache.size());
+    // Different space
+    ASSERT_EQ(nullptr, cache.get(2, query, 0));
+
+    auto sentences = cache.get(1, "GO  FROM 1   OVER like", 0);
+    ASSERT_NE(nullptr, sentences);
+    ASSERT_EQ(parse(query)->toString(), sentences->toString());
+    // Taken out of the cache while in use
+    ASSERT_EQ(0UL, cache.size());
+    ASSERT_EQ(nullptr, cache.get(1, query, 0));
+
+    // Two copies of the same query
+    cache.put(1, query, 0, std::move(sentences));
+    cache.put(1, query, 0, parse(query));
+    ASSERT_EQ(2UL, cache.size());
+
+    // Evict the least recently used one
+    cache.put(1, "YIELD 1", 0, parse("YIELD 1"));
+    ASSERT_EQ(2UL, cache.size());
+    ASSERT_NE(nullptr, cache.get(1, query, 0));
+    ASSERT_EQ(nullptr, cache.get(1, query, 0));
+    ASSERT_NE(nullptr, cache.get(1, "YIELD 1", 0));
+}
+
+
+TEST(PlanCache, SchemaChanged) {
+    PlanCache cache(10);
+    auto query = "GO FROM 1 OVER like";
+    cache.put(1, query, 1, parse(query));
+    cache.put(1, "YIELD 1", 1, parse("YIELD 1"));
+    ASSERT_EQ(2UL, cache.size());
+
+    auto invalidations = PlanCache::stats().invalidations;
+    ASSERT_EQ(nullptr, cache.get(1, query, 2));
+    ASSERT_EQ(0UL, cache.size());
+    ASSERT_EQ(invalidations + 1, PlanCache::stats().invalidations);
+
+    // Parsed under the old schema
+    cache.put(1, query, 1, parse(query));
+    ASSERT_EQ(0UL, cache.size());
+}
+
+
+TEST(PlanCache, Stats) {
+    PlanCache cache(10);
+    auto before = PlanCache::stats();
+    cache.get(1, "YIELD 1", 0);
+    cache.put(1, "YIELD 1", 0, parse("YIELD 1"));
+    cache.get(1, "YIELD 1", 0);
+    auto after = PlanCache::stats();
+    ASSERT_EQ(before.hits + 1, after.hits);
+    ASSERT_EQ(before.misses + 1, after.misses);
+}
+
+}   // namespace graph
+}   // namespace nebula
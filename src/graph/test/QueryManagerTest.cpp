@@ -0,0 +1,52 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "graph/QueryManager.h"
+#include "graph/SessionManager.h"
+
+namespace nebula {
+namespace graph {
+
+TEST(QueryManager, Basic) {
+    auto sm = std::make_shared<SessionManager>();
+    auto session = sm->createSession();
+    session->setUser("user");
+    QueryManager queries;
+
+    auto query = queries.add(session.get(), "GO FROM 1 OVER like", 0);
+    ASSERT_NE(nullptr, query);
+    ASSERT_EQ(query.get(), queries.find(query->id()).get());
+    ASSERT_EQ(1, queries.queries().size());
+    ASSERT_TRUE(query->check().ok());
+
+    query->kill();
+    ASSERT_FALSE(query->check().ok());
+    queries.remove(query->id());
+    ASSERT_EQ(nullptr, queries.find(query->id()));
+}
+
+
+TEST(QueryManager, KillableBy) {
+    auto sm = std::make_shared<SessionManager>();
+    auto session = sm->createSession();
+    session->setUser("user");
+    auto sameUser = sm->createSession();
+    sameUser->setUser("user");
+    auto otherUser = sm->createSession();
+    otherUser->setUser("other");
+    QueryManager queries;
+
+    auto query = queries.add(session.get(), "GO FROM 1 OVER like", 0);
+    ASSERT_TRUE(query->killableBy(session.get()));
+    ASSERT_TRUE(query->killableBy(sameUser.get()));
+    ASSERT_FALSE(query->killableBy(otherUser.get()));
+    queries.remove(query->id());
+}
+
+}   // namespace graph
+}   // namespace nebula
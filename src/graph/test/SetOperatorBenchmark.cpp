@@ -0,0 +1,137 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include "graph/HashSetOperator.h"
+
+DECLARE_int32(set_op_concurrency);
+
+using nebula::graph::HashSetOperator;
+using Rows = HashSetOperator::Rows;
+
+// Rows look like the output of `GO ... YIELD $^.name, edge.prop, $$.name'
+Rows makeRows(int64_t from, int64_t to) {
+    Rows rows;
+    rows.reserve(to - from);
+    for (auto i = from; i < to; i++) {
+        std::vector<nebula::graph::cpp2::ColumnValue> cols(3);
+        cols[0].set_str(folly::stringPrintf("player-%ld", i / 10));
+        cols[1].set_integer(i);
+        cols[2].set_str(folly::stringPrintf("team-%ld", i % 100));
+        rows.emplace_back();
+        rows.back().set_columns(std::move(cols));
+    }
+    return rows;
+}
+
+// The nested loops used before, for comparison
+Rows nestedLoopMinus(Rows left, const Rows &right) {
+    for (auto &rr : right) {
+        for (auto iter = left.begin(); iter < left.end();) {
+            if (rr == *iter) {
+                iter = left.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+    return left;
+}
+
+void runMinus(size_t iters, int64_t size, int32_t concurrency, bool nestedLoop) {
+    Rows left, right;
+    std::unique_ptr<folly::CPUThreadPoolExecutor> pool;
+    BENCHMARK_SUSPEND {
+        left = makeRows(0, size);
+        right = makeRows(size / 2, size / 2 * 3);
+        FLAGS_set_op_concurrency = concurrency;
+        pool = std::make_unique<folly::CPUThreadPoolExecutor>(concurrency);
+    }
+    for (size_t i = 0; i < iters; i++) {
+        Rows rows;
+        if (nestedLoop) {
+            rows = nestedLoopMinus(left, right);
+        } else {
+            rows = HashSetOperator::minus(left, right, pool.get()).get();
+        }
+        folly::doNotOptimizeAway(rows);
+    }
+}
+
+void runIntersect(size_t iters, int64_t size, int32_t concurrency) {
+    Rows left, right;
+    std::unique_ptr<folly::CPUThreadPoolExecutor> pool;
+    BENCHMARK_SUSPEND {
+        left = makeRows(0, size);
+        right = makeRows(size / 2, size / 2 * 3);
+        FLAGS_set_op_concurrency = concurrency;
+        pool = std::make_unique<folly::CPUThreadPoolExecutor>(concurrency);
+    }
+    for (size_t i = 0; i < iters; i++) {
+        auto rows = HashSetOperator::intersect(left, right, pool.get()).get();
+        folly::doNotOptimizeAway(rows);
+    }
+}
+
+void runDistinct(size_t iters, int64_t size, int32_t concurrency) {
+    Rows rows;
+    std::unique_ptr<folly::CPUThreadPoolExecutor> pool;
+    BENCHMARK_SUSPEND {
+        rows = makeRows(0, size);
+        auto dup = makeRows(0, size / 2);
+        rows.insert(rows.end(), dup.begin(), dup.end());
+        FLAGS_set_op_concurrency = concurrency;
+        pool = std::make_unique<folly::CPUThreadPoolExecutor>(concurrency);
+    }
+    for (size_t i = 0; i < iters; i++) {
+        auto result = HashSetOperator::distinct(rows, pool.get()).get();
+        folly::doNotOptimizeAway(result);
+    }
+}
+
+BENCHMARK(minus_nested_loop_2k, n) {
+    runMinus(n, 2000, 1, true);
+}
+BENCHMARK_RELATIVE(minus_hash_2k, n) {
+    runMinus(n, 2000, 1, false);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(minus_hash_100k_1_thread, n) {
+    runMinus(n, 100000, 1, false);
+}
+BENCHMARK_RELATIVE(minus_hash_100k_4_threads, n) {
+    runMinus(n, 100000, 4, false);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(intersect_hash_100k_1_thread, n) {
+    runIntersect(n, 100000, 1);
+}
+BENCHMARK_RELATIVE(intersect_hash_100k_4_threads, n) {
+    runIntersect(n, 100000, 4);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(distinct_hash_100k_1_thread, n) {
+    runDistinct(n, 100000, 1);
+}
+BENCHMARK_RELATIVE(distinct_hash_100k_4_threads, n) {
+    runDistinct(n, 100000, 4);
+}
+
+
+int main(int argc, char** argv) {
+    folly::init(&argc, &argv, true);
+
+    folly::runBenchmarks();
+    return 0;
+}
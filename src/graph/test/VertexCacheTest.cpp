@@ -0,0 +1,123 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "graph/VertexCache.h"
+
+namespace nebula {
+namespace graph {
+
+static storage::cpp2::QueryResponse makeResponse(const std::vector<VertexID> &vids) {
+    nebula::cpp2::Schema schema;
+    schema.columns.emplace_back();
+    schema.columns.back().set_name("name");
+    std::vector<storage::cpp2::VertexData> vertices;
+    for (auto vid : vids) {
+        storage::cpp2::VertexData vdata;
+        vdata.set_vertex_id(vid);
+        vdata.set_vertex_data(folly::stringPrintf("data_%ld", vid));
+        vertices.emplace_back(std::move(vdata));
+    }
+    storage::cpp2::QueryResponse resp;
+    resp.set_result(storage::cpp2::ResponseCommon());
+    resp.set_vertex_schema(std::move(schema));
+    resp.set_vertices(std::move(vertices));
+    return resp;
+}
+
+
+static std::vector<VertexID> getVIds(const storage::cpp2::QueryResponse &resp) {
+    std::vector<VertexID> vids;
+    for (auto &vdata : *resp.get_vertices()) {
+        EXPECT_EQ(folly::stringPrintf("data_%ld", vdata.get_vertex_id()),
+                  vdata.get_vertex_data());
+        vids.emplace_back(vdata.get_vertex_id());
+    }
+    return vids;
+}
+
+
+TEST(VertexCache, GetAndPut) {
+    VertexCache cache(1024 * 1024, 60 * 1000);
+    auto before = VertexCache::stats();
+    std::vector<VertexID> missed;
+    auto resp = cache.get(1, "props", {1, 2, 3}, 0, missed);
+    ASSERT_TRUE(getVIds(resp).empty());
+    ASSERT_EQ(std::vector<VertexID>({1, 2, 3}), missed);
+
+    cache.put(1, "props", cache.epoch(1), 0, makeResponse({1, 2}));
+    missed.clear();
+    resp = cache.get(1, "props", {1, 2, 3}, 0, missed);
+    ASSERT_EQ(std::vector<VertexID>({1, 2}), getVIds(resp));
+    ASSERT_NE(nullptr, resp.get_vertex_schema());
+    ASSERT_EQ(std::vector<VertexID>({3}), missed);
+    auto after = VertexCache::stats();
+    ASSERT_EQ(before.hits + 2, after.hits);
+    ASSERT_EQ(before.misses + 4, after.misses);
+
+    // Other props, or another space
+    missed.clear();
+    cache.get(1, "others", {1}, 0, missed);
+    cache.get(2, "props", {1}, 0, missed);
+    ASSERT_EQ(std::vector<VertexID>({1, 1}), missed);
+}
+
+
+TEST(VertexCache, Invalidate) {
+    VertexCache cache(1024 * 1024, 60 * 1000);
+    auto epoch = cache.epoch(1);
+    cache.put(1, "props", epoch, 0, makeResponse({1}));
+    cache.put(2, "props", cache.epoch(2), 0, makeResponse({1}));
+    cache.invalidate(1);
+
+    // Read before the space was written
+    cache.put(1, "props", epoch, 0, makeResponse({2}));
+    std::vector<VertexID> missed;
+    cache.get(1, "props", {1, 2}, 0, missed);
+    ASSERT_EQ(std::vector<VertexID>({1, 2}), missed);
+    // Other spaces are not affected
+    missed.clear();
+    cache.get(2, "props", {1}, 0, missed);
+    ASSERT_TRUE(missed.empty());
+
+    // The schema changed
+    cache.get(2, "props", {1}, 1, missed);
+    ASSERT_EQ(std::vector<VertexID>({1}), missed);
+    ASSERT_EQ(0UL, cache.size());
+}
+
+
+TEST(VertexCache, Expire) {
+    VertexCache cache(1024 * 1024, 1);
+    cache.put(1, "props", cache.epoch(1), 0, makeResponse({1}));
+    ::usleep(10 * 1000);
+    std::vector<VertexID> missed;
+    cache.get(1, "props", {1}, 0, missed);
+    ASSERT_EQ(std::vector<VertexID>({1}), missed);
+}
+
+
+TEST(VertexCache, Evict) {
+    VertexCache cache(1024, 60 * 1000);
+    std::vector<VertexID> vids;
+    for (auto i = 0; i < 100; i++) {
+        vids.emplace_back(i);
+    }
+    auto before = VertexCache::stats();
+    cache.put(1, "props", cache.epoch(1), 0, makeResponse(vids));
+    ASSERT_LE(cache.size(), 1024UL);
+    ASSERT_LT(before.evictions, VertexCache::stats().evictions);
+
+    // The most recently put ones are kept
+    std::vector<VertexID> missed;
+    auto resp = cache.get(1, "props", {0, 99}, 0, missed);
+    ASSERT_EQ(std::vector<VertexID>({99}), getVIds(resp));
+    ASSERT_EQ(std::vector<VertexID>({0}), missed);
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -0,0 +1,96 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "graph/VertexSet.h"
+
+namespace nebula {
+namespace graph {
+
+TEST(VertexSet, InsertAndContains) {
+    VertexSet set;
+    ASSERT_FALSE(set.contains(1));
+    for (auto i = 0; i < 10000; i++) {
+        ASSERT_TRUE(set.insert(i * 7));
+    }
+    ASSERT_EQ(10000UL, set.size());
+    for (auto i = 0; i < 10000; i++) {
+        ASSERT_FALSE(set.insert(i * 7));
+        ASSERT_TRUE(set.contains(i * 7));
+        ASSERT_FALSE(set.contains(i * 7 + 1));
+    }
+    // Far less than std::unordered_set
+    ASSERT_LE(set.memory(), 32768UL * sizeof(VertexID));
+
+    // The id marking the empty slots
+    ASSERT_FALSE(set.contains(VertexSet::kEmpty));
+    ASSERT_TRUE(set.insert(VertexSet::kEmpty));
+    ASSERT_FALSE(set.insert(VertexSet::kEmpty));
+    ASSERT_TRUE(set.contains(VertexSet::kEmpty));
+    ASSERT_EQ(10001UL, set.size());
+}
+
+
+TEST(VertexSet, Map) {
+    VertexMap map;
+    ASSERT_EQ(nullptr, map.find(1));
+    for (auto i = -5000; i < 5000; i++) {
+        map.set(i, i * 2);
+    }
+    map.set(0, 1);
+    map.set(VertexSet::kEmpty, 3);
+    ASSERT_EQ(10001UL, map.size());
+    for (auto i = -5000; i < 5000; i++) {
+        auto *value = map.find(i);
+        ASSERT_NE(nullptr, value);
+        ASSERT_EQ(i == 0 ? 1 : i * 2, *value);
+    }
+    ASSERT_EQ(3, *map.find(VertexSet::kEmpty));
+    ASSERT_EQ(nullptr, map.find(5000));
+}
+
+
+TEST(VertexSet, Concurrent) {
+    ConcurrentVertexSet set;
+    auto inserted = set.insert({1, 2, 3, 2, 1});
+    std::sort(inserted.begin(), inserted.end());
+    ASSERT_EQ(std::vector<VertexID>({1, 2, 3}), inserted);
+
+    // Each id is inserted by exactly one of the threads
+    std::vector<std::vector<VertexID>> results(4);
+    std::vector<std::thread> threads;
+    for (auto t = 0UL; t < results.size(); t++) {
+        threads.emplace_back([&, t] {
+            std::vector<VertexID> vids;
+            for (auto i = 0; i < 10000; i++) {
+                vids.emplace_back(i);
+            }
+            results[t] = set.insert(vids);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    size_t total = 0;
+    for (auto &result : results) {
+        total += result.size();
+    }
+    ASSERT_EQ(9997UL, total);
+    ASSERT_EQ(10000UL, set.size());
+
+    ConcurrentVertexMap map;
+    map.set({{2, 1}, {3, 1}});
+    map.set({{4, 2}});
+    std::vector<VertexID> ids = {2, 3, 4, 5};
+    map.translate(ids);
+    ASSERT_EQ(std::vector<VertexID>({1, 1, 2, 5}), ids);
+    ASSERT_EQ(2, map.translate(4));
+    ASSERT_EQ(5, map.translate(5));
+}
+
+}   // namespace graph
+}   // namespace nebula
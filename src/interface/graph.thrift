@@ -27,6 +27,8 @@ enum ErrorCode {
     E_EXECUTION_ERROR = -8,
     // Nothing is executed When command is comment
     E_STATEMENT_EMTPY = -9,
+    // The prepared statement does not exist in the session
+    E_STATEMENT_NOT_FOUND = -10,
 } (cpp.enum_strict)
 
 
@@ -93,6 +95,17 @@ struct ExecutionResponse {
     4: optional list<binary> column_names;  // Column names
     5: optional list<RowValue> rows;
     6: optional string space_name;
+    7: optional i64 peak_memory_bytes;      // Peak memory of the results kept
+}
+
+
+struct PrepareResponse {
+    1: required ErrorCode error_code;
+    2: required i32 latency_in_us;          // Execution time on server
+    3: optional string error_msg;
+    4: optional i64 statement_id;
+    // Number of parameters, i.e. the largest N of the placeholders $N
+    5: optional i32 num_parameters;
 }
 
 
@@ -109,4 +122,12 @@ service GraphService {
     oneway void signout(1: i64 sessionId)
 
     ExecutionResponse execute(1: i64 sessionId, 2: string stmt)
+
+    // Prepared statements take the placeholders $1, $2, ..., which are bound
+    // to params[0], params[1], ... on each execution
+    PrepareResponse prepare(1: i64 sessionId, 2: string stmt)
+    ExecutionResponse executePrepared(1: i64 sessionId,
+                                      2: i64 statementId,
+                                      3: list<ColumnValue> params)
+    oneway void unprepare(1: i64 sessionId, 2: i64 statementId)
 }
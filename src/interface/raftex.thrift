@@ -9,6 +9,7 @@ namespace java com.vesoft.nebula.raftex
 namespace go nebula.raftex
 
 cpp_include "base/ThriftTypes.h"
+cpp_include "<folly/io/IOBuf.h>"
 
 enum ErrorCode {
     SUCCEEDED = 0;
@@ -31,6 +32,7 @@ enum ErrorCode {
     E_NOT_A_LEADER = -13;
     E_HOST_DISCONNECTED = -14;
     E_TOO_MANY_REQUESTS = -15;
+    E_BAD_LOG_BATCH = -16;      // The compressed logs could not be decoded
 
     E_EXCEPTION = -20;          // An thrift internal exception was thrown
 }
@@ -43,6 +45,10 @@ typedef i64 (cpp.type = "nebula::LogID") LogID
 typedef i32 (cpp.type = "nebula::IPv4") IPv4
 typedef i32 (cpp.type = "nebula::Port") Port
 
+// Log payloads are kept in IOBufs, so one batch can be shared among
+// all followers without copying the bytes
+typedef binary (cpp.type = "folly::IOBuf") IOBuf
+
 
 // A request to ask for vote
 struct AskForVoteRequest {
@@ -62,9 +68,14 @@ struct AskForVoteResponse {
 }
 
 
+enum CompressionType {
+    NONE = 0;
+    ZSTD = 1;
+}
+
 struct LogEntry {
     1: ClusterID cluster;
-    2: binary log_str;
+    2: IOBuf log_str;
 }
 
 
@@ -107,6 +118,13 @@ struct AppendLogRequest {
     11: list<LogEntry> log_str_list;
 
     12: optional binary snapshot_uri;   // Snapshot URL
+
+    //
+    // When compression is not NONE, log_str_list is empty, and all logs
+    // are encoded and compressed into compressed_logs
+    //
+    13: CompressionType compression = CompressionType.NONE;
+    14: optional IOBuf compressed_logs;
 }
 
 
@@ -119,12 +137,37 @@ struct AppendLogResponse {
     6: LogID        last_log_id;
     7: TermID       last_log_term;
     8: bool         pulling_snapshot;
+    // The compression the host is able to decode. Old hosts leave it NONE
+    9: CompressionType accepted_compression = CompressionType.NONE;
+}
+
+
+// The read index of a part is the leader's committed log id. A follower
+// or a learner waits until it has committed up to it before serving a
+// consistent read
+struct ReadIndex {
+    1: ErrorCode    error_code;
+    2: LogID        committed_log_id;
+    3: TermID       current_term;
+}
+
+
+// Asks the leader for the read indexes of all the parts it leads at once
+struct GetReadIndexRequest {
+    1: GraphSpaceID         space;
+    2: list<PartitionID>    parts;
+}
+
+
+struct GetReadIndexResponse {
+    1: map<PartitionID, ReadIndex>(cpp.template = "std::unordered_map") indexes;
 }
 
 
 service RaftexService {
     AskForVoteResponse askForVote(1: AskForVoteRequest req);
     AppendLogResponse appendLog(1: AppendLogRequest req);
+    GetReadIndexResponse getReadIndex(1: GetReadIndexRequest req);
 }
 
 
@@ -23,6 +23,10 @@ enum ErrorCode {
     E_KEY_HAS_EXISTS = -12,
     E_SPACE_NOT_FOUND = -13,
     E_PART_NOT_FOUND = -14,
+    // The replica is not able to serve the read in the requested mode
+    E_STALE_REPLICA = -15,
+    // The query the request belongs to was killed, or ran out of its time
+    E_QUERY_CANCELLED = -16,
 
     // meta failures
     E_EDGE_PROP_NOT_FOUND = -21,
@@ -98,6 +102,21 @@ struct QueryStatsResponse {
     3: optional binary data,
 }
 
+struct EdgeStats {
+    // The number of the edges
+    1: i64 edges,
+    // The number of the vertices the edges go out of
+    2: i64 vertices,
+}
+
+struct SpaceStatsResponse {
+    1: required ResponseCommon result,
+    // tagId => the number of the vertices with the tag
+    2: map<common.TagID, i64>(cpp.template = "std::unordered_map") tag_vertices,
+    // edgeType => the stats of the edges, a negative type for the in-edges
+    3: map<common.EdgeType, EdgeStats>(cpp.template = "std::unordered_map") edges,
+}
+
 struct Tag {
     1: common.TagID tag_id,
     2: binary props,
@@ -122,6 +141,26 @@ struct Edge {
     2: binary props,
 }
 
+enum ReadMode {
+    // Only read from the leader
+    LEADER = 0,
+    // Read from any replica, after it has caught up with the commit index
+    // of the leader, which is linearizable
+    READ_INDEX = 1,
+    // Read from any replica which heard from the leader recently enough
+    BOUNDED_STALENESS = 2,
+} (cpp.enum_strict)
+
+struct ReadOptions {
+    1: ReadMode mode,
+    // Only valid when mode is BOUNDED_STALENESS
+    2: i32 max_staleness_ms,
+    // The time left of the query when the request is sent, 0 for no limit
+    3: i32 timeout_ms,
+    // Identifies the query to KILL, 0 if it could not be killed
+    4: i64 query_token,
+}
+
 struct GetNeighborsRequest {
     1: common.GraphSpaceID space_id,
     // partId => ids
@@ -130,12 +169,14 @@ struct GetNeighborsRequest {
     3: common.EdgeType edge_type,
     4: binary filter,
     5: list<PropDef> return_columns,
+    6: optional ReadOptions read_options,
 }
 
 struct VertexPropRequest {
     1: common.GraphSpaceID space_id,
     2: map<common.PartitionID, list<common.VertexID>>(cpp.template = "std::unordered_map") parts,
     3: list<PropDef> return_columns,
+    4: optional ReadOptions read_options,
 }
 
 struct EdgePropRequest {
@@ -145,6 +186,23 @@ struct EdgePropRequest {
     3: common.EdgeType edge_type,
     4: binary filter,
     5: list<PropDef> return_columns,
+    6: optional ReadOptions read_options,
+}
+
+struct SpaceStatsRequest {
+    1: common.GraphSpaceID space_id,
+    // partId => unused, each part is scanned as a whole.
+    // It is a map to be resent by the client the same way as the other requests.
+    2: map<common.PartitionID, i32>(cpp.template = "std::unordered_map") parts,
+    // Only the timeout and the query token are taken, the parts are always scanned on the leaders
+    3: optional ReadOptions read_options,
+}
+
+struct KillQueryRequest {
+    1: common.GraphSpaceID space_id,
+    // partId => unused, the same as SpaceStatsRequest
+    2: map<common.PartitionID, i32>(cpp.template = "std::unordered_map") parts,
+    3: i64 query_token,
 }
 
 struct AddVerticesRequest {
@@ -215,6 +273,13 @@ service StorageService {
     QueryResponse getProps(1: VertexPropRequest req);
     EdgePropResponse getEdgeProps(1: EdgePropRequest req)
 
+    // The number of the vertices per tag and of the edges per edge type,
+    // which are counted by scanning the parts, to plan the queries with
+    SpaceStatsResponse getSpaceStats(1: SpaceStatsRequest req)
+
+    // The reads of the query in progress stop, and so do the ones arriving later
+    ExecResponse killQuery(1: KillQueryRequest req)
+
     ExecResponse addVertices(1: AddVerticesRequest req);
     ExecResponse addEdges(1: AddEdgesRequest req);
 
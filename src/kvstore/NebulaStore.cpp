@@ -16,6 +16,8 @@
 DEFINE_string(engine_type, "rocksdb", "rocksdb, memory...");
 DEFINE_int32(custom_filter_interval_secs, 24 * 3600, "interval to trigger custom compaction");
 DEFINE_int32(num_workers, 4, "Number of worker threads");
+DEFINE_int32(wal_flush_threads_per_path, 1,
+             "Number of threads flushing wal buffers for each data path");
 
 namespace nebula {
 namespace kvstore {
@@ -45,7 +47,8 @@ bool NebulaStore::init() {
         return false;
     }
 
-    flusher_ = std::make_unique<wal::BufferFlusher>();
+    flusher_ = std::make_unique<wal::BufferFlusher>(options_.dataPaths_,
+                                                    FLAGS_wal_flush_threads_per_path);
     CHECK(!!options_.partMan_);
     LOG(INFO) << "Scan the local path, and init the spaces_";
     {
@@ -158,6 +158,11 @@ public:
 
     bool isLeader(GraphSpaceID spaceId, PartitionID partId);
 
+    // Queue depth and latency of the wal buffer flusher
+    wal::BufferFlusher::Stats walFlusherStats() const {
+        return flusher_->stats();
+    }
+
 private:
     /**
      * Implement four interfaces in Handler.
@@ -17,6 +17,8 @@ DEFINE_uint32(max_appendlog_batch_size, 128,
 DEFINE_uint32(max_outstanding_requests, 1024,
               "The max number of outstanding appendLog requests");
 DEFINE_int32(raft_rpc_timeout_ms, 500, "rpc timeout for raft client");
+DEFINE_bool(enable_raft_log_compression, false,
+            "Whether to compress the logs sent to the hosts supporting it");
 
 
 namespace nebula {
@@ -205,6 +207,19 @@ void Host::appendLogsInternal(folly::EventBase* eb,
         }
 
         cpp2::AppendLogResponse resp = std::move(t).value();
+        {
+            std::lock_guard<std::mutex> g(self->lock_);
+            if (resp.get_error_code() == cpp2::ErrorCode::E_BAD_LOG_BATCH
+                    && !self->compressionDisabled_) {
+                LOG(WARNING) << self->idStr_
+                             << "The host could not decode the compressed logs,"
+                                " stop compressing the logs sent to it";
+                self->compressionDisabled_ = true;
+            }
+            self->peerCompression_ = self->compressionDisabled_
+                ? cpp2::CompressionType::NONE
+                : resp.get_accepted_compression();
+        }
         VLOG(3) << self->idStr_ << "AppendLogResponse "
                 << "code " << static_cast<int32_t>(resp.get_error_code())
                 << ", currTerm " << resp.get_current_term()
@@ -334,25 +349,22 @@ Host::prepareAppendLogRequest() const {
 
     VLOG(2) << idStr_ << "Prepare AppendLogs request from Log "
                       << lastLogIdSent_ + 1 << " to " << logIdToSend_;
-    auto it = part_->wal()->iterator(lastLogIdSent_ + 1, logIdToSend_);
-    if (it->valid()) {
+    auto batch = part_->getLogBatch(lastLogIdSent_ + 1, logIdToSend_, logTermToSend_);
+    if (batch != nullptr) {
         VLOG(2) << idStr_ << "Prepare the list of log entries to send";
-
-        auto term = it->logTerm();
-        req->set_log_term(term);
-
-        std::vector<cpp2::LogEntry> logs;
-        for (size_t cnt = 0;
-             it->valid()
-                && it->logTerm() == term
-                && cnt < FLAGS_max_appendlog_batch_size;
-             ++(*it), ++cnt) {
-            cpp2::LogEntry le;
-            le.set_cluster(it->logSource());
-            le.set_log_str(it->logMsg().toString());
-            logs.emplace_back(std::move(le));
+        req->set_log_term(batch->logTerm);
+        const folly::IOBuf* compressed = nullptr;
+        if (FLAGS_enable_raft_log_compression
+                && peerCompression_ == cpp2::CompressionType::ZSTD) {
+            compressed = part_->compressedLogs(*batch);
+        }
+        if (compressed != nullptr) {
+            req->set_compression(cpp2::CompressionType::ZSTD);
+            req->set_compressed_logs(*compressed);
+        } else {
+            // Copying the entries only bumps the reference counts of the buffers
+            req->set_log_str_list(batch->logs);
         }
-        req->set_log_str_list(std::move(logs));
     } else {
         LOG(FATAL) << idStr_ << "We have not support snapshot yet";
     }
@@ -126,6 +126,11 @@ private:
     TermID lastLogTermSent_{0};
 
     LogID committedLogId_{0};
+
+    // The compression the host told us it is able to decode
+    cpp2::CompressionType peerCompression_{cpp2::CompressionType::NONE};
+    // Once the host failed to decode a batch, it is only sent plain logs
+    bool compressionDisabled_{false};
 };
 
 }  // namespace raftex
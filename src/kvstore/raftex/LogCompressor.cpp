@@ -0,0 +1,169 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "kvstore/raftex/LogCompressor.h"
+#include <zstd.h>
+#include <folly/lang/Bits.h>
+#include "time/Duration.h"
+
+DEFINE_int32(raft_compression_level, 1, "The zstd level used to compress log batches");
+DEFINE_uint32(raft_compression_min_batch_bytes, 4096,
+              "Log batches smaller than this are sent uncompressed");
+DEFINE_double(raft_compression_max_ratio, 0.8,
+              "Log batches are sent uncompressed unless compressed size / raw size "
+              "is no more than this ratio");
+DEFINE_uint64(raft_max_decompressed_batch_bytes, 256 * 1024 * 1024,
+              "The max size of a decompressed log batch");
+
+namespace nebula {
+namespace raftex {
+
+namespace {
+
+std::atomic<int64_t> rawBytes{0};
+std::atomic<int64_t> compressedBytes{0};
+std::atomic<int64_t> skippedBatches{0};
+std::atomic<int64_t> compressUs{0};
+std::atomic<int64_t> decompressUs{0};
+
+constexpr size_t kEntryHeaderSize = sizeof(ClusterID) + sizeof(int32_t);
+
+}  // Anonymous namespace
+
+
+// static
+std::unique_ptr<folly::IOBuf> LogCompressor::compress(
+        cpp2::CompressionType type,
+        const std::vector<cpp2::LogEntry>& logs) {
+    if (type != cpp2::CompressionType::ZSTD) {
+        return nullptr;
+    }
+
+    size_t rawSize = 0;
+    for (auto& le : logs) {
+        rawSize += kEntryHeaderSize + le.get_log_str().computeChainDataLength();
+    }
+    if (rawSize < FLAGS_raft_compression_min_batch_bytes) {
+        return nullptr;
+    }
+
+    time::Duration duration;
+    std::string raw;
+    raw.reserve(rawSize);
+    for (auto& le : logs) {
+        // The header is little endian whatever the host is
+        ClusterID cluster = folly::Endian::little(le.get_cluster());
+        int32_t len = folly::Endian::little(
+            static_cast<int32_t>(le.get_log_str().computeChainDataLength()));
+        raw.append(reinterpret_cast<const char*>(&cluster), sizeof(ClusterID));
+        raw.append(reinterpret_cast<const char*>(&len), sizeof(int32_t));
+        for (auto range : le.get_log_str()) {
+            raw.append(reinterpret_cast<const char*>(range.data()), range.size());
+        }
+    }
+
+    auto buf = folly::IOBuf::create(ZSTD_compressBound(raw.size()));
+    auto ret = ZSTD_compress(buf->writableData(),
+                             buf->capacity(),
+                             raw.data(),
+                             raw.size(),
+                             FLAGS_raft_compression_level);
+    compressUs += duration.elapsedInUSec();
+    if (ZSTD_isError(ret)) {
+        LOG(ERROR) << "Failed to compress the log batch: " << ZSTD_getErrorName(ret);
+        return nullptr;
+    }
+    if (ret > raw.size() * FLAGS_raft_compression_max_ratio) {
+        VLOG(3) << "Not worth compressing the log batch, " << raw.size()
+                << " bytes to " << ret << " bytes";
+        skippedBatches++;
+        return nullptr;
+    }
+
+    buf->append(ret);
+    rawBytes += raw.size();
+    compressedBytes += ret;
+    return buf;
+}
+
+
+// static
+bool LogCompressor::decompress(cpp2::CompressionType type,
+                               const folly::IOBuf& data,
+                               std::vector<cpp2::LogEntry>& logs) {
+    if (type != cpp2::CompressionType::ZSTD) {
+        LOG(ERROR) << "Unknown compression type " << static_cast<int32_t>(type);
+        return false;
+    }
+
+    time::Duration duration;
+    auto input = data.cloneCoalescedAsValue();
+    auto rawSize = ZSTD_getFrameContentSize(input.data(), input.length());
+    if (rawSize == ZSTD_CONTENTSIZE_UNKNOWN
+            || rawSize == ZSTD_CONTENTSIZE_ERROR
+            || rawSize > FLAGS_raft_max_decompressed_batch_bytes) {
+        LOG(ERROR) << "Bad size of the compressed log batch";
+        return false;
+    }
+
+    auto buf = folly::IOBuf::create(rawSize);
+    auto ret = ZSTD_decompress(buf->writableData(), rawSize, input.data(), input.length());
+    if (ZSTD_isError(ret) || ret != rawSize) {
+        LOG(ERROR) << "Failed to decompress the log batch";
+        return false;
+    }
+    buf->append(rawSize);
+
+    // Every log entry refers to its own range of the decompressed buffer
+    const char* start = reinterpret_cast<const char*>(buf->data());
+    size_t offset = 0;
+    while (offset < rawSize) {
+        if (offset + kEntryHeaderSize > rawSize) {
+            LOG(ERROR) << "The log batch is truncated";
+            return false;
+        }
+        ClusterID cluster;
+        int32_t len;
+        memcpy(&cluster, start + offset, sizeof(ClusterID));
+        memcpy(&len, start + offset + sizeof(ClusterID), sizeof(int32_t));
+        cluster = folly::Endian::little(cluster);
+        len = folly::Endian::little(len);
+        offset += kEntryHeaderSize;
+        if (len < 0 || offset + len > rawSize) {
+            LOG(ERROR) << "The log batch is truncated";
+            return false;
+        }
+
+        cpp2::LogEntry le;
+        le.set_cluster(cluster);
+        auto logBuf = buf->cloneOneAsValue();
+        logBuf.trimStart(offset);
+        logBuf.trimEnd(rawSize - offset - len);
+        le.set_log_str(std::move(logBuf));
+        logs.emplace_back(std::move(le));
+        offset += len;
+    }
+
+    decompressUs += duration.elapsedInUSec();
+    return true;
+}
+
+
+// static
+LogCompressor::Stats LogCompressor::stats() {
+    Stats s;
+    s.rawBytes = rawBytes.load();
+    s.compressedBytes = compressedBytes.load();
+    s.skippedBatches = skippedBatches.load();
+    s.compressUs = compressUs.load();
+    s.decompressUs = decompressUs.load();
+    return s;
+}
+
+}  // namespace raftex
+}  // namespace nebula
+
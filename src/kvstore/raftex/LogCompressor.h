@@ -0,0 +1,58 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef RAFTEX_LOGCOMPRESSOR_H_
+#define RAFTEX_LOGCOMPRESSOR_H_
+
+#include "base/Base.h"
+#include <folly/io/IOBuf.h>
+#include "gen-cpp2/raftex_types.h"
+
+namespace nebula {
+namespace raftex {
+
+/**
+ * Compresses a batch of log entries into one buffer, and restores the
+ * entries on the receiving side.
+ *
+ * Each entry is encoded as <cluster (int64), length (int32), log>, with the
+ * integers in little endian, and the encoded batch is compressed as a whole.
+ */
+class LogCompressor final {
+public:
+    struct Stats {
+        // Bytes of the batches before and after being compressed
+        int64_t rawBytes{0};
+        int64_t compressedBytes{0};
+        // Number of batches not worth compressing
+        int64_t skippedBatches{0};
+        // Time spent on compressing and decompressing, in microseconds
+        int64_t compressUs{0};
+        int64_t decompressUs{0};
+    };
+
+    // Returns nullptr when the batch is too small or the compression
+    // does not save enough bytes
+    static std::unique_ptr<folly::IOBuf> compress(
+        cpp2::CompressionType type,
+        const std::vector<cpp2::LogEntry>& logs);
+
+    static bool decompress(cpp2::CompressionType type,
+                           const folly::IOBuf& data,
+                           std::vector<cpp2::LogEntry>& logs);
+
+    // The process-wide statistics
+    static Stats stats();
+
+private:
+    LogCompressor() = delete;
+};
+
+}  // namespace raftex
+}  // namespace nebula
+
+#endif  // RAFTEX_LOGCOMPRESSOR_H_
+
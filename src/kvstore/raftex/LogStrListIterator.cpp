@@ -18,6 +18,12 @@ LogStrListIterator::LogStrListIterator(
         , term_(term)
         , logEntries_(std::move(logEntries)) {
     idx_ = 0;
+    // The log received from the wire could span several buffers
+    for (auto& entry : logEntries_) {
+        if (entry.log_str.isChained()) {
+            entry.log_str.coalesce();
+        }
+    }
 }
 
 
@@ -52,7 +58,8 @@ ClusterID LogStrListIterator::logSource() const {
 
 folly::StringPiece LogStrListIterator::logMsg() const {
     DCHECK(valid());
-    return logEntries_.at(idx_).get_log_str();
+    const auto& buf = logEntries_.at(idx_).get_log_str();
+    return folly::StringPiece(reinterpret_cast<const char*>(buf.data()), buf.length());
 }
 
 }  // namespace raftex
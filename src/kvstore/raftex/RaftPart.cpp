@@ -17,6 +17,7 @@
 #include "kvstore/wal/FileBasedWal.h"
 #include "kvstore/wal/BufferFlusher.h"
 #include "kvstore/raftex/LogStrListIterator.h"
+#include "kvstore/raftex/LogCompressor.h"
 #include "kvstore/raftex/Host.h"
 
 
@@ -30,6 +31,12 @@ DEFINE_int32(wal_ttl, 86400, "Default wal ttl");
 DEFINE_int64(wal_file_size, 128 * 1024 * 1024, "Default wal file size");
 DEFINE_int32(wal_buffer_size, 8 * 1024 * 1024, "Default wal buffer size");
 DEFINE_int32(wal_buffer_num, 4, "Default wal buffer number");
+DEFINE_int32(raft_read_index_rpc_timeout_ms, 500,
+             "Timeout of the read index request sent to the leader");
+DEFINE_uint32(raft_log_batch_cache_size, 4,
+              "The number of recently built appendLog batches kept for reuse");
+
+DECLARE_uint32(max_appendlog_batch_size);
 
 
 namespace nebula {
@@ -314,6 +321,8 @@ void RaftPart::stop() {
         status_ = Status::STOPPED;
         leader_ = {0, 0};
         role_ = Role::FOLLOWER;
+        // Nobody waiting for the read index would be served any more
+        wakeUpCommitWaiters();
 
         hosts = std::move(hosts_);
     }
@@ -702,6 +711,7 @@ void RaftPart::processAppendLogResponses(
             // Step 3: Commit the batch
             if (commitLogs(std::move(walIt))) {
                 committedLogId_ = lastLogId;
+                wakeUpCommitWaiters();
                 firstLogId = lastLogId_ + 1;
             } else {
                 LOG(FATAL) << idStr_ << "Failed to commit logs";
@@ -1089,6 +1099,22 @@ void RaftPart::processAppendLogRequest(
         cpp2::AppendLogResponse& resp) {
     bool hasSnapshot = req.get_snapshot_uri() != nullptr;
 
+    // Decompress the logs before taking the lock
+    std::vector<cpp2::LogEntry> decompressedLogs;
+    bool compressed = req.get_compression() != cpp2::CompressionType::NONE;
+    if (compressed) {
+        if (req.get_compressed_logs() == nullptr
+                || !LogCompressor::decompress(req.get_compression(),
+                                              *req.get_compressed_logs(),
+                                              decompressedLogs)) {
+            LOG(ERROR) << idStr_ << "Failed to decode the compressed logs";
+            resp.set_error_code(cpp2::ErrorCode::E_BAD_LOG_BATCH);
+            resp.set_accepted_compression(cpp2::CompressionType::NONE);
+            return;
+        }
+    }
+    const auto& logStrList = compressed ? decompressedLogs : req.get_log_str_list();
+
     VLOG(2) << idStr_
             << "Received logAppend "
             << ": GraphSpaceId = " << req.get_space()
@@ -1102,7 +1128,7 @@ void RaftPart::processAppendLogRequest(
             << ", lastLogTermSent = " << req.get_last_log_term_sent()
             << folly::stringPrintf(
                     ", num_logs = %ld, logTerm = %ld",
-                    req.get_log_str_list().size(),
+                    logStrList.size(),
                     req.get_log_term())
             << (hasSnapshot
                 ? ", SnapshotURI = " + *(req.get_snapshot_uri())
@@ -1117,6 +1143,7 @@ void RaftPart::processAppendLogRequest(
     resp.set_last_log_id(lastLogId_);
     resp.set_last_log_term(lastLogTerm_);
     resp.set_pulling_snapshot(false);
+    resp.set_accepted_compression(cpp2::CompressionType::ZSTD);
 
     // Check status
     if (UNLIKELY(status_ == Status::STOPPED)) {
@@ -1199,13 +1226,13 @@ void RaftPart::processAppendLogRequest(
     }
 
     // Append new logs
-    size_t numLogs = req.get_log_str_list().size();
+    size_t numLogs = logStrList.size();
     LogID firstId = req.get_last_log_id_sent() + 1;
     VLOG(2) << idStr_ << "Writing log [" << firstId
             << ", " << firstId + numLogs - 1 << "] to WAL";
     LogStrListIterator iter(firstId,
                             req.get_log_term(),
-                            req.get_log_str_list());
+                            logStrList);
     if (wal_->appendLogs(iter)) {
         CHECK_EQ(firstId + numLogs - 1, wal_->lastLogId());
         lastLogId_ = wal_->lastLogId();
@@ -1229,6 +1256,7 @@ void RaftPart::processAppendLogRequest(
                               << committedLogId_ + 1 << " to "
                               << lastLogIdCanCommit;
             committedLogId_ = lastLogIdCanCommit;
+            wakeUpCommitWaiters();
             resp.set_committed_log_id(lastLogIdCanCommit);
         } else {
             LOG(ERROR) << idStr_ << "Failed to commit log "
@@ -1251,6 +1279,196 @@ void RaftPart::processAppendLogRequest(
 }
 
 
+void RaftPart::processGetReadIndexRequest(cpp2::ReadIndex& resp) {
+    VLOG(3) << idStr_ << "Received getReadIndex";
+    std::lock_guard<std::mutex> g(raftLock_);
+    resp.set_current_term(term_);
+    if (status_ != Status::RUNNING) {
+        resp.set_error_code(cpp2::ErrorCode::E_BAD_STATE);
+        return;
+    }
+    if (role_ != Role::LEADER) {
+        resp.set_error_code(cpp2::ErrorCode::E_NOT_A_LEADER);
+        return;
+    }
+    if (!hasLeaderLease()) {
+        VLOG(2) << idStr_ << "The leader lease has expired";
+        resp.set_error_code(cpp2::ErrorCode::E_NOT_READY);
+        return;
+    }
+    resp.set_committed_log_id(committedLogId_);
+    resp.set_error_code(cpp2::ErrorCode::SUCCEEDED);
+}
+
+
+bool RaftPart::hasLeaderLease() const {
+    CHECK(!raftLock_.try_lock());
+    // The followers will not start an election within the heartbeat interval
+    // since they received the last message, keep half of it as the margin
+    return role_ == Role::LEADER
+        && lastMsgSentDur_.elapsedInMSec() < FLAGS_raft_heartbeat_interval_secs * 1000 / 2;
+}
+
+
+bool RaftPart::leaderLeaseValid() const {
+    std::lock_guard<std::mutex> g(raftLock_);
+    return status_ == Status::RUNNING && hasLeaderLease();
+}
+
+
+folly::Future<bool> RaftPart::waitForCommitted(LogID readIndex, int32_t timeoutMs) {
+    folly::Future<bool> future = folly::makeFuture(false);
+    std::pair<LogID, uint64_t> key;
+    {
+        std::lock_guard<std::mutex> g(raftLock_);
+        if (status_ != Status::RUNNING) {
+            return false;
+        }
+        if (committedLogId_ >= readIndex) {
+            return true;
+        }
+        if (timeoutMs <= 0) {
+            return false;
+        }
+        key = std::make_pair(readIndex, nextCommitWaiterId_++);
+        future = commitWaiters_[key].getFuture();
+    }
+    return std::move(future)
+        .within(std::chrono::milliseconds(timeoutMs))
+        .thenTry([self = shared_from_this(), key] (folly::Try<bool>&& t) {
+            if (t.hasException()) {
+                // Timed out, the waiter is dropped unless it has just been woken up
+                std::lock_guard<std::mutex> g(self->raftLock_);
+                self->commitWaiters_.erase(key);
+                return false;
+            }
+            return t.value();
+        });
+}
+
+
+void RaftPart::wakeUpCommitWaiters() {
+    CHECK(!raftLock_.try_lock());
+    while (!commitWaiters_.empty()) {
+        auto it = commitWaiters_.begin();
+        if (status_ == Status::RUNNING && it->first.first > committedLogId_) {
+            break;
+        }
+        it->second.setValue(status_ == Status::RUNNING);
+        commitWaiters_.erase(it);
+    }
+}
+
+
+// static
+folly::Future<std::unordered_set<PartitionID>> RaftPart::readIndexes(
+        std::vector<std::shared_ptr<RaftPart>> parts,
+        int32_t timeoutMs) {
+    std::unordered_set<PartitionID> unreadable;
+    std::unordered_map<HostAddr, std::vector<std::shared_ptr<RaftPart>>> partsByLeader;
+    for (auto& part : parts) {
+        std::lock_guard<std::mutex> g(part->raftLock_);
+        if (part->status_ != Status::RUNNING) {
+            unreadable.emplace(part->partId_);
+        } else if (part->role_ == Role::LEADER) {
+            if (!part->hasLeaderLease()) {
+                unreadable.emplace(part->partId_);
+            }
+        } else if (part->leader_ == HostAddr(0, 0)) {
+            VLOG(2) << part->idStr_ << "No leader for now, could not get the read index";
+            unreadable.emplace(part->partId_);
+        } else {
+            partsByLeader[part->leader_].emplace_back(part);
+        }
+    }
+    if (partsByLeader.empty()) {
+        return unreadable;
+    }
+
+    auto* ioPool = parts.front()->ioThreadPool_.get();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    std::vector<folly::Future<std::vector<PartitionID>>> results;
+    for (auto& lp : partsByLeader) {
+        auto& leader = lp.first;
+        cpp2::GetReadIndexRequest req;
+        req.set_space(lp.second.front()->spaceId_);
+        for (auto& part : lp.second) {
+            req.parts.emplace_back(part->partId_);
+        }
+
+        auto* evb = ioPool->getEventBase();
+        auto future = folly::via(evb, [evb, leader, req = std::move(req)] {
+            static ThriftClientManager<cpp2::RaftexServiceAsyncClient> clientsMan;
+            auto client = clientsMan.client(leader,
+                                            evb,
+                                            false,
+                                            FLAGS_raft_read_index_rpc_timeout_ms);
+            return client->future_getReadIndex(req);
+        });
+        results.emplace_back(std::move(future)
+            .within(std::chrono::milliseconds(timeoutMs))
+            .thenTry([evb, leader, deadline, leaderParts = std::move(lp.second)]
+                     (folly::Try<cpp2::GetReadIndexResponse>&& t) {
+                std::vector<folly::Future<bool>> waits;
+                if (t.hasException()) {
+                    LOG(ERROR) << "Failed to get the read indexes from " << leader
+                               << ": " << t.exception().what();
+                } else {
+                    auto& indexes = t.value().get_indexes();
+                    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        deadline - std::chrono::steady_clock::now()).count();
+                    for (auto& part : leaderParts) {
+                        auto it = indexes.find(part->partId_);
+                        if (it == indexes.end()
+                                || it->second.get_error_code() != cpp2::ErrorCode::SUCCEEDED) {
+                            VLOG(2) << part->idStr_ << "Failed to get the read index";
+                            waits.emplace_back(folly::makeFuture(false));
+                            continue;
+                        }
+                        waits.emplace_back(part->waitForCommitted(
+                            it->second.get_committed_log_id(),
+                            static_cast<int32_t>(remaining)));
+                    }
+                }
+                return folly::collectAll(waits).via(evb).thenValue(
+                        [leaderParts] (std::vector<folly::Try<bool>>&& tries) {
+                    std::vector<PartitionID> failed;
+                    for (size_t i = 0; i < leaderParts.size(); i++) {
+                        // No waits at all if the rpc failed
+                        if (i >= tries.size() || !tries[i].hasValue() || !tries[i].value()) {
+                            failed.emplace_back(leaderParts[i]->partId_);
+                        }
+                    }
+                    return failed;
+                });
+            }));
+    }
+
+    return folly::collectAll(results).via(ioPool).thenValue(
+            [unreadable = std::move(unreadable)]
+            (std::vector<folly::Try<std::vector<PartitionID>>>&& tries) mutable {
+        for (auto& t : tries) {
+            CHECK(!t.hasException());
+            unreadable.insert(t.value().begin(), t.value().end());
+        }
+        return std::move(unreadable);
+    });
+}
+
+
+bool RaftPart::isFresh(int32_t maxStalenessMs) const {
+    std::lock_guard<std::mutex> g(raftLock_);
+    if (status_ != Status::RUNNING) {
+        return false;
+    }
+    if (role_ == Role::LEADER) {
+        return lastMsgSentDur_.elapsedInMSec() <= static_cast<uint64_t>(maxStalenessMs);
+    }
+    return leader_ != HostAddr(0, 0)
+        && lastMsgRecvDur_.elapsedInMSec() <= static_cast<uint64_t>(maxStalenessMs);
+}
+
+
 cpp2::ErrorCode RaftPart::verifyLeader(
         const cpp2::AppendLogRequest& req,
         std::lock_guard<std::mutex>& lck) {
@@ -1331,6 +1549,83 @@ std::vector<std::shared_ptr<Host>> RaftPart::followers() const {
     return hosts;
 }
 
+RaftPart::LogBatchPtr RaftPart::getLogBatch(LogID firstId,
+                                            LogID lastId,
+                                            TermID leaderTerm) {
+    std::lock_guard<std::mutex> g(logBatchesLock_);
+    // Within one leader term, the logs in the wal never change, so a batch
+    // built for the same range in the same term can be sent again
+    for (auto it = logBatches_.rbegin(); it != logBatches_.rend(); ++it) {
+        auto& batch = *it;
+        if (batch->firstLogId == firstId
+                && batch->lastLogId == lastId
+                && batch->leaderTerm == leaderTerm) {
+            VLOG(3) << idStr_ << "Reuse the log batch from " << firstId
+                    << " to " << lastId;
+            return batch;
+        }
+    }
+
+    auto iter = wal_->iterator(firstId, lastId);
+    if (!iter->valid()) {
+        return nullptr;
+    }
+
+    auto batch = std::make_shared<LogBatch>();
+    batch->firstLogId = firstId;
+    batch->lastLogId = lastId;
+    batch->leaderTerm = leaderTerm;
+    batch->logTerm = iter->logTerm();
+
+    // Copy all logs into one buffer, every log entry refers to its own range
+    auto arena = std::make_unique<std::string>();
+    std::vector<std::pair<ClusterID, std::pair<size_t, size_t>>> ranges;
+    for (size_t cnt = 0;
+         iter->valid()
+            && iter->logTerm() == batch->logTerm
+            && cnt < FLAGS_max_appendlog_batch_size;
+         ++(*iter), ++cnt) {
+        auto msg = iter->logMsg();
+        ranges.emplace_back(iter->logSource(), std::make_pair(arena->size(), msg.size()));
+        arena->append(msg.data(), msg.size());
+    }
+
+    auto arenaSize = arena->size();
+    auto* arenaData = &(*arena)[0];
+    auto buf = folly::IOBuf::takeOwnership(
+        arenaData,
+        arenaSize,
+        [] (void*, void* userData) {
+            delete static_cast<std::string*>(userData);
+        },
+        arena.release());
+
+    batch->logs.reserve(ranges.size());
+    for (auto& range : ranges) {
+        cpp2::LogEntry le;
+        le.set_cluster(range.first);
+        auto logBuf = buf->cloneOneAsValue();
+        logBuf.trimStart(range.second.first);
+        logBuf.trimEnd(arenaSize - range.second.first - range.second.second);
+        le.set_log_str(std::move(logBuf));
+        batch->logs.emplace_back(std::move(le));
+    }
+
+    logBatches_.emplace_back(batch);
+    while (logBatches_.size() > FLAGS_raft_log_batch_cache_size) {
+        logBatches_.pop_front();
+    }
+    return batch;
+}
+
+const folly::IOBuf* RaftPart::compressedLogs(const LogBatch& batch) const {
+    std::call_once(batch.compressOnce, [&batch] {
+        batch.compressedLogs = LogCompressor::compress(cpp2::CompressionType::ZSTD,
+                                                       batch.logs);
+    });
+    return batch.compressedLogs.get();
+}
+
 bool RaftPart::checkAppendLogResult(AppendLogResult res) {
     if (res != AppendLogResult::SUCCEEDED) {
         {
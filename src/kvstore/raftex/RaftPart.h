@@ -165,6 +165,35 @@ public:
         const cpp2::AppendLogRequest& req,
         cpp2::AppendLogResponse& resp);
 
+    // Process the read index request from a follower or a learner
+    void processGetReadIndexRequest(cpp2::ReadIndex& resp);
+
+    /*****************************************************
+     *
+     * Methods used by reads served by any replica
+     *
+     ****************************************************/
+    // Get the read indexes of the parts, with one request to the leader of
+    // each group of parts, then wait for every part to commit up to its read
+    // index. On a leader part only the lease is checked. The future holds the
+    // parts that could not catch up within timeoutMs, or do not know their
+    // leader. Nothing is blocked while waiting
+    static folly::Future<std::unordered_set<PartitionID>> readIndexes(
+        std::vector<std::shared_ptr<RaftPart>> parts,
+        int32_t timeoutMs);
+
+    // Resolves to true once the local replica has committed up to readIndex,
+    // or to false if it could not within timeoutMs. A timeoutMs of zero or less
+    // does not wait at all
+    folly::Future<bool> waitForCommitted(LogID readIndex, int32_t timeoutMs);
+
+    // Whether the part is the leader and holds the leader lease
+    bool leaderLeaseValid() const;
+
+    // Whether the local replica heard from the leader (or, on the leader,
+    // reached the quorum) within maxStalenessMs
+    bool isFresh(int32_t maxStalenessMs) const;
+
 
 protected:
     // Protected constructor to prevent from instantiating directly
@@ -248,6 +277,26 @@ private:
                    LogType,
                    std::string>>;
 
+    // A batch of logs read from the wal. The batch is shared by all hosts
+    // which need to send the same range of logs, and the log payloads are
+    // IOBufs backed by one buffer, so no host copies the bytes again
+    struct LogBatch {
+        LogID firstLogId;
+        // The upper bound being asked for
+        LogID lastLogId;
+        // The leader's term when the batch was built
+        TermID leaderTerm;
+        // All logs in a batch belong to the same term
+        TermID logTerm;
+        std::vector<cpp2::LogEntry> logs;
+
+        // The compressed logs are built on first use, and nullptr means
+        // the batch is not worth compressing
+        mutable std::once_flag compressOnce;
+        mutable std::unique_ptr<folly::IOBuf> compressedLogs;
+    };
+    using LogBatchPtr = std::shared_ptr<const LogBatch>;
+
 
     /****************************************************
      *
@@ -294,6 +343,16 @@ private:
     // Pre-condition: The caller needs to hold the raftLock_
     AppendLogResult canAppendLogs();
 
+    // Whether the leader reached the quorum recently enough that no other
+    // leader could have been elected
+    // Pre-condition: The caller needs to hold the raftLock_
+    bool hasLeaderLease() const;
+
+    // Fulfill the commitWaiters_ whose read indexes have been committed, or
+    // all of them once the part is stopped
+    // Pre-condition: The caller needs to hold the raftLock_
+    void wakeUpCommitWaiters();
+
     folly::Future<AppendLogResult> appendLogAsync(ClusterID source,
                                                   LogType logType,
                                                   std::string log);
@@ -322,6 +381,16 @@ private:
 
     std::vector<std::shared_ptr<Host>> followers() const;
 
+    // Returns at most max_appendlog_batch_size logs starting from firstId
+    // and ending no later than lastId. Recently built batches are cached,
+    // so followers asking for the same range reuse the same batch.
+    // Returns nullptr if the logs are not in the wal
+    LogBatchPtr getLogBatch(LogID firstId, LogID lastId, TermID leaderTerm);
+
+    // Returns the compressed logs of the batch, or nullptr if the batch is
+    // not worth compressing
+    const folly::IOBuf* compressedLogs(const LogBatch& batch) const;
+
     bool checkAppendLogResult(AppendLogResult res);
 
 protected:
@@ -421,6 +490,11 @@ protected:
     // Partition level lock to synchronize the access of the partition
     mutable std::mutex raftLock_;
 
+    // The lock is used to protect logBatches_
+    std::mutex logBatchesLock_;
+    // The most recently built batches, the latest is at the back
+    std::deque<LogBatchPtr> logBatches_;
+
     PromiseSet<AppendLogResult> sendingPromise_;
 
     Status status_;
@@ -445,6 +519,10 @@ protected:
     TermID lastLogTerm_{0};
     // The id for the last globally committed log (from the leader)
     LogID committedLogId_{0};
+    // The reads waiting for committedLogId_ to reach their read indexes, keyed
+    // by the read index and an id of the waiter, so a timed out one could be erased
+    std::map<std::pair<LogID, uint64_t>, folly::Promise<bool>> commitWaiters_;
+    uint64_t nextCommitWaiterId_{0};
 
     // To record how long ago when the last leader message received
     time::Duration lastMsgRecvDur_;
@@ -213,6 +213,23 @@ void RaftexService::appendLog(
     part->processAppendLogRequest(req, resp);
 }
 
+
+void RaftexService::getReadIndex(
+        cpp2::GetReadIndexResponse& resp,
+        const cpp2::GetReadIndexRequest& req) {
+    for (auto partId : req.get_parts()) {
+        cpp2::ReadIndex index;
+        auto part = findPart(req.get_space(), partId);
+        if (!part) {
+            // Not found
+            index.set_error_code(cpp2::ErrorCode::E_UNKNOWN_PART);
+        } else {
+            part->processGetReadIndexRequest(index);
+        }
+        resp.indexes.emplace(partId, std::move(index));
+    }
+}
+
 }  // namespace raftex
 }  // namespace nebula
 
@@ -0,0 +1,122 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include <folly/Random.h>
+#include <zstd.h>
+#include "kvstore/raftex/LogCompressor.h"
+#include "kvstore/raftex/LogStrListIterator.h"
+
+DECLARE_double(raft_compression_max_ratio);
+
+namespace nebula {
+namespace raftex {
+
+std::vector<cpp2::LogEntry> genLogs(int32_t num, bool random) {
+    std::vector<cpp2::LogEntry> logs;
+    for (int32_t i = 0; i < num; i++) {
+        std::string msg;
+        if (random) {
+            for (int32_t j = 0; j < 64; j++) {
+                msg.append(folly::to<std::string>(folly::Random::rand64()));
+            }
+        } else {
+            msg = folly::stringPrintf("vertex_%d_tag_1_prop_name_value_%d_", i, i % 10);
+            msg.append(256, 'a' + i % 26);
+        }
+        cpp2::LogEntry le;
+        le.set_cluster(i % 3);
+        le.set_log_str(*folly::IOBuf::copyBuffer(msg));
+        logs.emplace_back(std::move(le));
+    }
+    return logs;
+}
+
+
+TEST(LogCompressor, CompressAndDecompress) {
+    auto logs = genLogs(100, false);
+    auto compressed = LogCompressor::compress(cpp2::CompressionType::ZSTD, logs);
+    ASSERT_NE(nullptr, compressed);
+
+    std::vector<cpp2::LogEntry> decompressed;
+    ASSERT_TRUE(LogCompressor::decompress(cpp2::CompressionType::ZSTD,
+                                          *compressed,
+                                          decompressed));
+    ASSERT_EQ(logs.size(), decompressed.size());
+
+    LogStrListIterator expected(1, 1, logs);
+    LogStrListIterator actual(1, 1, std::move(decompressed));
+    for (; expected.valid(); ++expected, ++actual) {
+        ASSERT_TRUE(actual.valid());
+        EXPECT_EQ(expected.logSource(), actual.logSource());
+        EXPECT_EQ(expected.logMsg(), actual.logMsg());
+    }
+    EXPECT_FALSE(actual.valid());
+
+    auto stats = LogCompressor::stats();
+    EXPECT_LT(stats.compressedBytes, stats.rawBytes);
+}
+
+
+TEST(LogCompressor, SkipSmallOrIncompressibleBatch) {
+    // Too small to be compressed
+    auto logs = genLogs(1, false);
+    EXPECT_EQ(nullptr, LogCompressor::compress(cpp2::CompressionType::ZSTD, logs));
+
+    // Nothing to compress
+    EXPECT_EQ(nullptr, LogCompressor::compress(cpp2::CompressionType::NONE,
+                                               genLogs(100, false)));
+
+    // Random digits could only be compressed to less than a half,
+    // so raise the bar to make sure it is skipped
+    FLAGS_raft_compression_max_ratio = 0.1;
+    EXPECT_EQ(nullptr, LogCompressor::compress(cpp2::CompressionType::ZSTD,
+                                               genLogs(100, true)));
+    FLAGS_raft_compression_max_ratio = 0.8;
+}
+
+
+TEST(LogCompressor, CorruptedBatch) {
+    auto logs = genLogs(100, false);
+    auto compressed = LogCompressor::compress(cpp2::CompressionType::ZSTD, logs);
+    ASSERT_NE(nullptr, compressed);
+    compressed->trimEnd(compressed->length() / 2);
+
+    std::vector<cpp2::LogEntry> decompressed;
+    EXPECT_FALSE(LogCompressor::decompress(cpp2::CompressionType::ZSTD,
+                                           *compressed,
+                                           decompressed));
+}
+
+
+TEST(LogCompressor, LittleEndianHeader) {
+    // One entry of cluster 0x0102 with a log "abc", encoded byte by byte
+    std::string raw("\x02\x01\x00\x00\x00\x00\x00\x00" "\x03\x00\x00\x00" "abc", 15);
+    std::string buf(ZSTD_compressBound(raw.size()), '\0');
+    auto size = ZSTD_compress(&buf[0], buf.size(), raw.data(), raw.size(), 1);
+    ASSERT_FALSE(ZSTD_isError(size));
+
+    std::vector<cpp2::LogEntry> logs;
+    ASSERT_TRUE(LogCompressor::decompress(cpp2::CompressionType::ZSTD,
+                                          *folly::IOBuf::copyBuffer(buf.data(), size),
+                                          logs));
+    ASSERT_EQ(1, logs.size());
+    EXPECT_EQ(0x0102, logs[0].get_cluster());
+    EXPECT_EQ("abc", logs[0].get_log_str().cloneCoalescedAsValue().moveToFbString().toStdString());
+}
+
+}  // namespace raftex
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,117 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include <folly/String.h>
+#include "fs/TempDir.h"
+#include "fs/FileUtils.h"
+#include "thread/GenericThreadPool.h"
+#include "network/NetworkUtils.h"
+#include "kvstore/wal/BufferFlusher.h"
+#include "kvstore/raftex/RaftexService.h"
+#include "kvstore/raftex/test/RaftexTestBase.h"
+#include "kvstore/raftex/test/TestShard.h"
+
+namespace nebula {
+namespace raftex {
+
+class ReadIndexTest : public RaftexTestFixture {
+public:
+    ReadIndexTest() : RaftexTestFixture("read_index_test") {}
+
+protected:
+    std::vector<std::shared_ptr<RaftPart>> followers() const {
+        std::vector<std::shared_ptr<RaftPart>> parts;
+        for (auto& c : copies_) {
+            if (c != leader_) {
+                parts.emplace_back(c);
+            }
+        }
+        return parts;
+    }
+};
+
+
+TEST_F(ReadIndexTest, LeaderLease) {
+    std::vector<std::string> msgs;
+    appendLogs(0, 9, leader_, msgs);
+    checkConsensus(copies_, 0, 9, msgs);
+
+    EXPECT_TRUE(leader_->leaderLeaseValid());
+    for (auto& part : followers()) {
+        EXPECT_FALSE(part->leaderLeaseValid());
+    }
+}
+
+
+TEST_F(ReadIndexTest, IsFresh) {
+    std::vector<std::string> msgs;
+    appendLogs(0, 9, leader_, msgs);
+    checkConsensus(copies_, 0, 9, msgs);
+
+    for (auto& c : copies_) {
+        EXPECT_TRUE(c->isFresh(60 * 1000));
+    }
+    // Nothing could be heard from the leader within 1ms after a quiet while
+    usleep(50 * 1000);
+    for (auto& c : copies_) {
+        EXPECT_FALSE(c->isFresh(1));
+    }
+}
+
+
+TEST_F(ReadIndexTest, ReadIndexes) {
+    std::vector<std::string> msgs;
+    appendLogs(0, 99, leader_, msgs);
+
+    // All the followers ask the leader in one request
+    auto unreadable = RaftPart::readIndexes(followers(), 1000).get();
+    EXPECT_TRUE(unreadable.empty());
+    // Having waited for the read index, the logs are readable on the followers
+    checkConsensus(copies_, 0, 99, msgs);
+
+    // The leader only checks its lease
+    unreadable = RaftPart::readIndexes({leader_}, 1000).get();
+    EXPECT_TRUE(unreadable.empty());
+
+    // Wait for a log never to be committed
+    EXPECT_FALSE(copies_[0]->waitForCommitted(1000000, 100).get());
+    // No time left to wait
+    EXPECT_FALSE(copies_[0]->waitForCommitted(1000000, 0).get());
+    EXPECT_TRUE(copies_[0]->waitForCommitted(1, 0).get());
+    // Already committed
+    EXPECT_TRUE(copies_[0]->waitForCommitted(1, 100).get());
+
+    // The followers still take the old leader as theirs,
+    // which is not able to answer any more
+    auto parts = followers();
+    size_t idx = leader_->index();
+    killOneCopy(services_, copies_, leader_, idx);
+    unreadable = RaftPart::readIndexes(parts, 1000).get();
+    EXPECT_EQ(parts.size(), unreadable.size());
+
+    waitUntilLeaderElected(copies_, leader_);
+    rebootOneCopy(services_, copies_, allHosts_, idx);
+    waitUntilAllHasLeader(copies_);
+    checkLeadership(copies_, leader_);
+}
+
+}  // namespace raftex
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    // `flusher' is extern-declared in RaftexTestBase.h, defined in RaftexTestBase.cpp
+    using nebula::raftex::flusher;
+    flusher = std::make_unique<nebula::wal::BufferFlusher>();
+
+    return RUN_ALL_TESTS();
+}
@@ -7,73 +7,163 @@
 #include "base/Base.h"
 #include "kvstore/wal/BufferFlusher.h"
 #include "kvstore/wal/FileBasedWal.h"
+#include "time/Duration.h"
+
+DEFINE_int32(wal_flush_queue_warn_depth, 64,
+             "Log a warning when the number of buffers waiting to be flushed "
+             "by one flush thread exceeds this depth");
 
 namespace nebula {
 namespace wal {
 
 BufferFlusher::BufferFlusher()
-    : flushThread_("Buffer flusher",
-                   std::bind(&BufferFlusher::flushLoop, this)) {
+        : threadsPerPath_(1) {
+    start();
+}
+
+
+BufferFlusher::BufferFlusher(std::vector<std::string> dataPaths,
+                             size_t threadsPerPath)
+        : dataPaths_(std::move(dataPaths))
+        , threadsPerPath_(std::max<size_t>(threadsPerPath, 1)) {
+    start();
 }
 
 
 BufferFlusher::~BufferFlusher() {
-    {
-        std::lock_guard<std::mutex> g(buffersLock_);
-        stopped_ = true;
+    stopped_ = true;
+    for (auto& shard : shards_) {
+        {
+            // Make sure the loop is either waiting or will see the flag
+            std::lock_guard<std::mutex> g(shard->buffersLock);
+        }
+        shard->bufferReadyCV.notify_one();
     }
 
-    bufferReadyCV_.notify_one();
+    for (auto& shard : shards_) {
+        shard->flushThread.join();
+        CHECK(shard->buffers.empty());
+    }
+}
+
 
-    flushThread_.join();
-    CHECK(buffers_.empty());
+void BufferFlusher::start() {
+    size_t numGroups = std::max<size_t>(dataPaths_.size(), 1);
+    for (size_t i = 0; i < numGroups * threadsPerPath_; i++) {
+        shards_.emplace_back(std::make_unique<Shard>());
+        auto* shard = shards_.back().get();
+        shard->flushThread = thread::NamedThread(
+            folly::stringPrintf("flusher-%lu", i),
+            std::bind(&BufferFlusher::flushLoop, this, shard));
+    }
+    LOG(INFO) << "Buffer flusher started with " << shards_.size() << " threads";
+}
+
+
+BufferFlusher::Shard* BufferFlusher::pickShard(const FileBasedWal* wal) const {
+    const auto& dir = wal->path();
+    size_t group = 0;
+    for (size_t i = 0; i < dataPaths_.size(); i++) {
+        if (underPath(dir, dataPaths_[i])) {
+            group = i;
+            break;
+        }
+    }
+    auto idx = group * threadsPerPath_ + std::hash<std::string>()(dir) % threadsPerPath_;
+    return shards_[idx].get();
+}
+
+
+// static
+bool BufferFlusher::underPath(folly::StringPiece dir, folly::StringPiece path) {
+    while (path.size() > 1 && path.endsWith('/')) {
+        path.pop_back();
+    }
+    if (!dir.startsWith(path)) {
+        return false;
+    }
+    return dir.size() == path.size()
+        || path.endsWith('/')
+        || dir[path.size()] == '/';
 }
 
 
 bool BufferFlusher::flushBuffer(std::shared_ptr<FileBasedWal> wal,
                                 BufferPtr buffer) {
+    auto* shard = pickShard(wal.get());
+    size_t depth = 0;
     {
-        std::lock_guard<std::mutex> g(buffersLock_);
+        std::lock_guard<std::mutex> g(shard->buffersLock);
 
         if (stopped_) {
             LOG(ERROR) << "Buffer flusher has stopped";
             return false;
         }
 
-        buffers_.emplace(std::move(wal), std::move(buffer));
+        shard->buffers.emplace(std::move(wal), std::move(buffer));
+        depth = shard->buffers.size();
+        queueDepth_++;
+    }
+
+    // The queue grows by one at a time, so only warn when it crosses the depth,
+    // instead of for every buffer while it stays above
+    if (depth == static_cast<size_t>(FLAGS_wal_flush_queue_warn_depth) + 1) {
+        LOG(WARNING) << "Too many buffers waiting to be flushed, depth " << depth;
     }
 
     // Notify the loop thread
-    bufferReadyCV_.notify_one();
+    shard->bufferReadyCV.notify_one();
 
     return true;
 }
 
 
-void BufferFlusher::flushLoop() {
+BufferFlusher::Stats BufferFlusher::stats() const {
+    Stats s;
+    s.queueDepth = queueDepth_.load();
+    s.flushedBuffers = flushedBuffers_.load();
+    s.totalFlushLatencyUs = totalFlushLatencyUs_.load();
+    s.maxFlushLatencyUs = maxFlushLatencyUs_.load();
+    s.bufferExhausted = bufferExhausted_.load();
+    return s;
+}
+
+
+void BufferFlusher::flushLoop(Shard* shard) {
     LOG(INFO) << "Buffer flusher loop started";
 
     while (true) {
-        decltype(buffers_)::value_type bufferPair;
+        decltype(shard->buffers)::value_type bufferPair;
         {
-            std::unique_lock<std::mutex> g(buffersLock_);
-            if (buffers_.empty()) {
+            std::unique_lock<std::mutex> g(shard->buffersLock);
+            if (shard->buffers.empty()) {
                 if (stopped_) {
                     VLOG(1) << "The buffer flusher has stopped,"
                                " so exiting the flush loop";
                     break;
                 }
                 // Otherwise need to wait
-                bufferReadyCV_.wait(g, [this] {
-                    return !buffers_.empty() || stopped_;
+                shard->bufferReadyCV.wait(g, [this, shard] {
+                    return !shard->buffers.empty() || stopped_;
                 });
                 continue;
             } else {
-                bufferPair = std::move(buffers_.front());
-                buffers_.pop();
+                bufferPair = std::move(shard->buffers.front());
+                shard->buffers.pop();
             }
         }
+        queueDepth_--;
+
+        time::Duration duration;
         bufferPair.first->flushBuffer(bufferPair.second);
+        int64_t latency = duration.elapsedInUSec();
+
+        flushedBuffers_++;
+        totalFlushLatencyUs_ += latency;
+        auto maxLatency = maxFlushLatencyUs_.load();
+        while (latency > maxLatency
+                && !maxFlushLatencyUs_.compare_exchange_weak(maxLatency, latency)) {
+        }
     }
 
     LOG(INFO) << "Buffer flusher loop finished";
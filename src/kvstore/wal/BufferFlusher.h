@@ -16,26 +16,80 @@ namespace wal {
 
 class FileBasedWal;
 
+/**
+ * BufferFlusher persists the frozen buffers of all FileBasedWal instances.
+ *
+ * The flusher runs a group of flush threads for each data path, so WALs
+ * living on different disks do not serialize on one thread. A WAL is always
+ * dispatched to the same thread (by hashing its directory), so the buffers
+ * of one WAL are still flushed in the order they were frozen.
+ */
 class BufferFlusher final {
 public:
+    struct Stats {
+        // Number of buffers queued but not flushed yet
+        int64_t queueDepth{0};
+        // Number of buffers flushed since the flusher started
+        int64_t flushedBuffers{0};
+        // Total and max time (in microseconds) spent on flushing buffers
+        int64_t totalFlushLatencyUs{0};
+        int64_t maxFlushLatencyUs{0};
+        // Number of times appendLogs() had to wait for a vacant buffer
+        int64_t bufferExhausted{0};
+    };
+
+    // Start one flush thread serving all WALs
     BufferFlusher();
+    // Start threadsPerPath flush threads for each data path. WALs which
+    // do not live under any of the given paths share the first group
+    BufferFlusher(std::vector<std::string> dataPaths, size_t threadsPerPath);
     ~BufferFlusher();
 
     bool flushBuffer(std::shared_ptr<FileBasedWal> wal, BufferPtr buffer);
 
+    // Called by the WAL when all its buffers are in use
+    void onBufferExhausted() {
+        bufferExhausted_++;
+    }
+
+    size_t numThreads() const {
+        return shards_.size();
+    }
+
+    Stats stats() const;
+
+    // Whether dir is the given data path or lives under it, comparing whole
+    // path components, so "/data10/wal" is not under "/data1"
+    static bool underPath(folly::StringPiece dir, folly::StringPiece path);
+
 private:
-    void flushLoop();
+    struct Shard {
+        std::queue<
+            std::pair<std::shared_ptr<FileBasedWal>, BufferPtr>
+        > buffers;
+        std::mutex buffersLock;
+        std::condition_variable bufferReadyCV;
+        thread::NamedThread flushThread;
+    };
+
+    void start();
+
+    Shard* pickShard(const FileBasedWal* wal) const;
+
+    void flushLoop(Shard* shard);
 
 private:
-    bool stopped_{false};
+    std::atomic<bool> stopped_{false};
 
-    std::queue<
-        std::pair<std::shared_ptr<FileBasedWal>, BufferPtr>
-    > buffers_;
-    std::mutex buffersLock_;
-    std::condition_variable bufferReadyCV_;
+    const std::vector<std::string> dataPaths_;
+    const size_t threadsPerPath_;
+    std::vector<std::unique_ptr<Shard>> shards_;
 
-    thread::NamedThread flushThread_;
+    std::atomic<int64_t> queueDepth_{0};
+    std::atomic<int64_t> flushedBuffers_{0};
+    std::atomic<int64_t> totalFlushLatencyUs_{0};
+    std::atomic<int64_t> maxFlushLatencyUs_{0};
+    std::atomic<int64_t> bufferExhausted_{0};
 };
 
 }  // namespace wal
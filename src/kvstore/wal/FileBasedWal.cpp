@@ -11,6 +11,10 @@
 #include "fs/FileUtils.h"
 #include "time/WallClock.h"
 
+DEFINE_int32(wal_index_interval, 64,
+             "Keep the offset of every N-th log of the wal files in memory, "
+             "so the readers could seek to a log quickly");
+
 namespace nebula {
 namespace wal {
 
@@ -321,7 +325,8 @@ void FileBasedWal::prepareNewFile(LogID startLogId) {
 void FileBasedWal::dumpCord(Cord& cord,
                             LogID firstId,
                             LogID lastId,
-                            TermID lastTerm) {
+                            TermID lastTerm,
+                            const std::vector<std::pair<LogID, size_t>>& index) {
     if (cord.size() <= 0) {
         return;
     }
@@ -330,6 +335,7 @@ void FileBasedWal::dumpCord(Cord& cord,
         // Need to prepare a new file
         prepareNewFile(firstId);
     }
+    size_t startPos = currInfo_->size();
 
     auto cb = [this](const char* p, int32_t s) -> bool {
         const char* start = p;
@@ -353,6 +359,9 @@ void FileBasedWal::dumpCord(Cord& cord,
         currInfo_->setSize(currInfo_->size() + cord.size());
         currInfo_->setLastId(lastId);
         currInfo_->setLastTerm(lastTerm);
+        for (auto& entry : index) {
+            currInfo_->addIndex(entry.first, startPos + entry.second);
+        }
     }
 }
 
@@ -370,21 +379,28 @@ void FileBasedWal::flushBuffer(BufferPtr buffer) {
     }
 
     Cord cord;
+    std::vector<std::pair<LogID, size_t>> cordIndex;
     LogID firstIdInCord = buffer->firstLogId();
-    auto accessFn = [&cord, &firstIdInCord, this] (
+    auto accessFn = [&cord, &cordIndex, &firstIdInCord, this] (
             LogID id,
             TermID term,
             ClusterID cluster,
             const std::string& log) {
+        // Only the logs on the index interval of the file will be kept
+        LogID firstIdInFile = currFd_ >= 0 ? currInfo_->firstId() : firstIdInCord;
+        if ((id - firstIdInFile) % std::max(FLAGS_wal_index_interval, 1) == 0) {
+            cordIndex.emplace_back(id, cord.size());
+        }
         cord << id << term << int32_t(log.size()) << cluster;
         cord.write(log.data(), log.size());
         cord << int32_t(log.size());
 
         size_t currSize = currFd_ >= 0 ? currInfo_->size() : 0;
         if (currSize + cord.size() > maxFileSize_) {
-            dumpCord(cord, firstIdInCord, id, term);
+            dumpCord(cord, firstIdInCord, id, term, cordIndex);
             // Reset the cord
             cord.clear();
+            cordIndex.clear();
             firstIdInCord = id + 1;
 
             // Need to close the current file and create a new file
@@ -397,7 +413,7 @@ void FileBasedWal::flushBuffer(BufferPtr buffer) {
 
     // Dump the rest if any
     if (!cord.empty()) {
-        dumpCord(cord, firstIdInCord, lastLog.first, lastLog.second);
+        dumpCord(cord, firstIdInCord, lastLog.first, lastLog.second, cordIndex);
     }
 
     // Flush the wal file
@@ -424,7 +440,7 @@ BufferPtr FileBasedWal::createNewBuffer(
         // Log appending is way too fast
         LOG(WARNING) << "Write buffer is exhausted,"
                         " need to wait for vacancy";
-        // TODO: Output a counter here
+        flusher_->onBufferExhausted();
         // Need to wait for a vacant slot
         slotReadyCV_.wait(guard, [self = shared_from_this()] {
             return self->buffers_.size() < self->policy_.numBuffers;
@@ -595,6 +611,7 @@ bool FileBasedWal::rollbackToLog(LogID id) {
     }
 
     int fd{-1};
+    WalFileInfoPtr lastInfo;
     while (!foundTarget) {
         LOG(WARNING) << "Need to rollback from files."
                         " This is an expensive operation."
@@ -629,9 +646,10 @@ bool FileBasedWal::rollbackToLog(LogID id) {
             break;
         }
 
-        fd = open(walFiles_.rbegin()->second->path(), O_RDONLY);
+        lastInfo = walFiles_.rbegin()->second;
+        fd = open(lastInfo->path(), O_RDONLY);
         CHECK_GE(fd, 0) << "Failed to open file \""
-                        << walFiles_.rbegin()->second->path()
+                        << lastInfo->path()
                         << "\" (" << errno << "): "
                         << strerror(errno);
         lastLogId_ = id;
@@ -640,7 +658,21 @@ bool FileBasedWal::rollbackToLog(LogID id) {
 
     // Find the current log entry
     if (fd >= 0) {
-        size_t pos = 0;
+        // Start from the closest indexed log
+        auto start = lastInfo->seek(lastLogId_);
+        size_t pos = start.second;
+        if (pos > 0) {
+            LogID logId;
+            if (pread(fd, reinterpret_cast<char*>(&logId), sizeof(LogID), pos)
+                    != static_cast<ssize_t>(sizeof(LogID))
+                || logId != start.first) {
+                // The index only saves some walking, so do without it
+                LOG(ERROR) << "The wal index of " << lastInfo->path()
+                           << " is broken, expect log " << start.first
+                           << " at offset " << pos;
+                pos = 0;
+            }
+        }
         while (true) {
             LogID logId;
             // Read the logID
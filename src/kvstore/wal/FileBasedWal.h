@@ -62,6 +62,11 @@ public:
         return stopped_.load();
     }
 
+    // Return the directory holding the WAL files
+    const std::string& path() const {
+        return dir_;
+    }
+
     // Return the ID of the first log message in the WAL
     LogID firstLogId() const override {
         return firstLogId_;
@@ -140,11 +145,13 @@ private:
     // Scan all WAL files
     void scanAllWalFiles();
 
-    // Dump a Cord to the current file
+    // Dump a Cord to the current file. The index holds the offsets of the
+    // logs relative to the beginning of the cord
     void dumpCord(Cord& cord,
                   LogID firstId,
                   LogID lastId,
-                  TermID lastTerm);
+                  TermID lastTerm,
+                  const std::vector<std::pair<LogID, size_t>>& index);
 
     // Close down the current wal file
     void closeCurrFile();
@@ -6,6 +6,7 @@
 
 #include "base/Base.h"
 #include "kvstore/wal/FileBasedWalIterator.h"
+#include <sys/mman.h>
 #include "kvstore/wal/FileBasedWal.h"
 #include "kvstore/wal/WalFileInfo.h"
 
@@ -60,18 +61,14 @@ FileBasedWalIterator::FileBasedWalIterator(
         // We need to read from the WAL files
         wal_->accessAllWalInfo([this] (WalFileInfoPtr info) {
             if (lastId_ >= info->firstId()) {
-                int fd = open(info->path(), O_RDONLY);
-                if (fd < 0) {
-                    LOG(ERROR) << "Failed to open wal file \""
-                               << info->path()
-                               << "\" (" << errno << "): "
-                               << strerror(errno);
+                // Get the last id before mapping, so all logs in the range
+                // are covered by the mapped size
+                auto lastIdInFile = info->lastId();
+                if (!mapFile(info)) {
                     currId_ = lastId_ + 1;
                     return false;
                 }
-                fds_.push_front(fd);
-                idRanges_.push_front(
-                    std::make_pair(info->firstId(), info->lastId()));
+                idRanges_.push_front(std::make_pair(info->firstId(), lastIdInFile));
             }
             if (info->firstId() <= currId_) {
                 // Go no further
@@ -81,6 +78,9 @@ FileBasedWalIterator::FileBasedWalIterator(
             }
         });
 
+        if (currId_ > lastId_) {
+            return;
+        }
         if (idRanges_.empty() || idRanges_.front().first > currId_) {
             LOG(ERROR) << "LogID " << currId_
                        << " is out of the wal files range";
@@ -93,45 +93,52 @@ FileBasedWalIterator::FileBasedWalIterator(
     }
 
     if (!idRanges_.empty()) {
-        // Find the correct position in the first WAL file
-        currPos_ = 0;
-        while (true) {
-            LogID logId;
-            // Read the logID
-            int fd = fds_.front();
-            CHECK_EQ(pread(fd,
-                           reinterpret_cast<char*>(&logId),
-                           sizeof(LogID),
-                           currPos_),
-                     static_cast<ssize_t>(sizeof(LogID)));
-            // Read the termID
-            CHECK_EQ(pread(fd,
-                           reinterpret_cast<char*>(&currTerm_),
-                           sizeof(TermID),
-                           currPos_ + sizeof(LogID)),
-                     static_cast<ssize_t>(sizeof(TermID)));
-            // Read the log length
-            CHECK_EQ(pread(fd,
-                           reinterpret_cast<char*>(&currMsgLen_),
-                           sizeof(int32_t),
-                           currPos_ + sizeof(LogID) + sizeof(TermID)),
-                     static_cast<ssize_t>(sizeof(int32_t)));
-            if (logId == currId_) {
-                break;
+        // Jump to the closest indexed log in the first WAL file,
+        // then walk to the wanted one
+        auto& info = files_.front().info;
+        auto start = info->seek(currId_);
+        currPos_ = start.second;
+        LogID logId = 0;
+        if (!readHeader(logId) || logId != start.first) {
+            // The index only saves some walking, so do without it
+            LOG(ERROR) << "The wal index of " << info->path() << " is broken, expect log "
+                       << start.first << " at offset " << start.second;
+            currPos_ = 0;
+            if (!readHeader(logId)) {
+                currId_ = lastId_ + 1;
+                return;
             }
+        }
+        if (logId > currId_) {
+            LOG(ERROR) << "LogID " << currId_ << " is not found in " << info->path();
+            currId_ = lastId_ + 1;
+            return;
+        }
+        while (logId < currId_) {
             currPos_ += sizeof(LogID)
                         + sizeof(TermID)
                         + sizeof(int32_t) * 2
                         + currMsgLen_
                         + sizeof(ClusterID);
+            if (!readHeader(logId)) {
+                currId_ = lastId_ + 1;
+                return;
+            }
+            info->addIndex(logId, currPos_);
         }
+        if (logId != currId_) {
+            LOG(ERROR) << "LogID " << currId_ << " is not found in " << info->path();
+            currId_ = lastId_ + 1;
+            return;
+        }
+        readAhead();
     }
 }
 
 
 FileBasedWalIterator::~FileBasedWalIterator() {
-    for (auto& fd : fds_) {
-        close(fd);
+    for (auto& file : files_) {
+        unmapFile(file);
     }
 }
 
@@ -146,9 +153,9 @@ LogIterator& FileBasedWalIterator::operator++() {
                     << ", and the first ID in the next file is "
                     << nextFirstId_
                     << ", so need to move to the next file";
-            // Close the current file
-            CHECK_EQ(close(fds_.front()), 0);
-            fds_.pop_front();
+            // Unmap the current file
+            unmapFile(files_.front());
+            files_.pop_front();
             idRanges_.pop_front();
 
             if (idRanges_.empty()) {
@@ -163,6 +170,7 @@ LogIterator& FileBasedWalIterator::operator++() {
             nextFirstId_ = getFirstIdInNextFile();
             CHECK_EQ(currId_, idRanges_.front().first);
             currPos_ = 0;
+            readAhead();
         } else {
             // Move to the next log
             currPos_ += sizeof(LogID)
@@ -172,27 +180,9 @@ LogIterator& FileBasedWalIterator::operator++() {
                         + sizeof(ClusterID);
         }
 
-        LogID logId;
-        int fd = fds_.front();
-        // Read the logID
-        CHECK_EQ(pread(fd,
-                       reinterpret_cast<char*>(&logId),
-                       sizeof(LogID),
-                       currPos_),
-                 static_cast<ssize_t>(sizeof(LogID)));
+        LogID logId = 0;
+        CHECK(readHeader(logId));
         CHECK_EQ(currId_, logId);
-        // Read the termID
-        CHECK_EQ(pread(fd,
-                       reinterpret_cast<char*>(&currTerm_),
-                       sizeof(TermID),
-                       currPos_ + sizeof(LogID)),
-                 static_cast<ssize_t>(sizeof(TermID)));
-        // Read the log length
-        CHECK_EQ(pread(fd,
-                       reinterpret_cast<char*>(&currMsgLen_),
-                       sizeof(int32_t),
-                       currPos_ + sizeof(TermID) + sizeof(LogID)),
-                 static_cast<ssize_t>(sizeof(int32_t)));
     } else if (currId_ <= lastId_) {
         // Need to adjust nextFirstId_, in case we just start
         // reading buffers
@@ -243,20 +233,16 @@ ClusterID FileBasedWalIterator::logSource() const {
         return buffers_.front()->getCluster(currIdx_);
     } else {
         // Retrieve from the file
-        DCHECK(!fds_.empty());
+        DCHECK(!files_.empty());
 
         ClusterID cluster = 0;
-        CHECK_EQ(pread(fds_.front(),
-                       &(cluster),
-                       sizeof(ClusterID),
-                       currPos_
-                        + sizeof(LogID)
-                        + sizeof(TermID)
-                        + sizeof(int32_t)),
-                 static_cast<ssize_t>(sizeof(ClusterID)))
-            << "Failed to read. Curr position is " << currPos_
-            << ", expected read length is " << sizeof(ClusterID)
-            << " (errno: " << errno << "): " << strerror(errno);
+        memcpy(&cluster,
+               files_.front().data
+                + currPos_
+                + sizeof(LogID)
+                + sizeof(TermID)
+                + sizeof(int32_t),
+               sizeof(ClusterID));
 
         return cluster;
     }
@@ -270,23 +256,15 @@ folly::StringPiece FileBasedWalIterator::logMsg() const {
         return buffers_.front()->getLog(currIdx_);
     } else {
         // Retrieve from the file
-        DCHECK(!fds_.empty());
-
-        currLog_.resize(currMsgLen_);
-        CHECK_EQ(pread(fds_.front(),
-                       &(currLog_[0]),
-                       currMsgLen_,
-                       currPos_
-                        + sizeof(LogID)
-                        + sizeof(TermID)
-                        + sizeof(int32_t)
-                        + sizeof(ClusterID)),
-                 static_cast<ssize_t>(currMsgLen_))
-            << "Failed to read. Curr position is " << currPos_
-            << ", expected read length is " << currMsgLen_
-            << " (errno: " << errno << "): " << strerror(errno);
-
-        return currLog_;
+        DCHECK(!files_.empty());
+
+        return folly::StringPiece(files_.front().data
+                                    + currPos_
+                                    + sizeof(LogID)
+                                    + sizeof(TermID)
+                                    + sizeof(int32_t)
+                                    + sizeof(ClusterID),
+                                  currMsgLen_);
     }
 }
 
@@ -312,6 +290,97 @@ LogID FileBasedWalIterator::getFirstIdInNextFile() const {
     }
 }
 
+
+bool FileBasedWalIterator::mapFile(WalFileInfoPtr info) {
+    int fd = open(info->path(), O_RDONLY);
+    if (fd < 0) {
+        LOG(ERROR) << "Failed to open wal file \""
+                   << info->path()
+                   << "\" (" << errno << "): "
+                   << strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        LOG(ERROR) << "Failed to get the size of wal file \""
+                   << info->path()
+                   << "\" (" << errno << "): "
+                   << strerror(errno);
+        close(fd);
+        return false;
+    }
+
+    MappedFile file;
+    file.info = std::move(info);
+    file.size = st.st_size;
+    if (file.size > 0) {
+        void* addr = mmap(nullptr, file.size, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            LOG(ERROR) << "Failed to map wal file \""
+                       << file.info->path()
+                       << "\" (" << errno << "): "
+                       << strerror(errno);
+            close(fd);
+            return false;
+        }
+        madvise(addr, file.size, MADV_SEQUENTIAL);
+        file.data = static_cast<const char*>(addr);
+    }
+    // The mapping stays valid after the file is closed
+    close(fd);
+
+    files_.push_front(std::move(file));
+    return true;
+}
+
+
+void FileBasedWalIterator::unmapFile(MappedFile& file) {
+    if (file.data != nullptr) {
+        CHECK_EQ(munmap(const_cast<char*>(file.data), file.size), 0);
+        file.data = nullptr;
+    }
+}
+
+
+void FileBasedWalIterator::readAhead() {
+    auto& file = files_.front();
+    if (file.data == nullptr) {
+        return;
+    }
+    static const size_t kPageSize = sysconf(_SC_PAGESIZE);
+    size_t start = currPos_ / kPageSize * kPageSize;
+    if (start < file.size) {
+        madvise(const_cast<char*>(file.data) + start, file.size - start, MADV_WILLNEED);
+    }
+}
+
+
+bool FileBasedWalIterator::readHeader(LogID& logId) {
+    auto& file = files_.front();
+    if (currPos_ + sizeof(LogID) + sizeof(TermID) + sizeof(int32_t) > file.size) {
+        LOG(ERROR) << "Failed to read the log header from " << file.info->path()
+                   << ", curr position is " << currPos_;
+        return false;
+    }
+    const char* p = file.data + currPos_;
+    memcpy(&logId, p, sizeof(LogID));
+    memcpy(&currTerm_, p + sizeof(LogID), sizeof(TermID));
+    memcpy(&currMsgLen_, p + sizeof(LogID) + sizeof(TermID), sizeof(int32_t));
+    if (currMsgLen_ < 0
+            || currPos_
+                + sizeof(LogID)
+                + sizeof(TermID)
+                + sizeof(int32_t) * 2
+                + currMsgLen_
+                + sizeof(ClusterID) > file.size) {
+        LOG(ERROR) << "The log " << logId << " in " << file.info->path()
+                   << " is truncated, curr position is " << currPos_;
+        return false;
+    }
+    return true;
+}
+
 }  // namespace wal
 }  // namespace nebula
 
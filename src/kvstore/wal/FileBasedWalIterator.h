@@ -10,6 +10,7 @@
 #include "base/Base.h"
 #include "base/LogIterator.h"
 #include "kvstore/wal/InMemoryLogBuffer.h"
+#include "kvstore/wal/WalFileInfo.h"
 
 namespace nebula {
 namespace wal {
@@ -24,6 +25,9 @@ class FileBasedWal;
  * or from the in-memory buffers. If the given log id is out of range,
  * an invalid (valid() method will return false) iterator will be
  * constructed
+ *
+ * The WAL files are mapped into memory and read sequentially, and the
+ * sparse index of each file is used to seek to the first log
  */
 class FileBasedWalIterator final : public LogIterator {
 public:
@@ -47,9 +51,24 @@ public:
     folly::StringPiece logMsg() const override;
 
 private:
+    struct MappedFile {
+        WalFileInfoPtr info;
+        const char* data{nullptr};
+        size_t size{0};
+    };
+
     LogID getFirstIdInNextBuffer() const;
     LogID getFirstIdInNextFile() const;
 
+    // Map the whole wal file and put it at the front of files_
+    bool mapFile(WalFileInfoPtr info);
+    void unmapFile(MappedFile& file);
+    // Hint the kernel to read the rest of the front file from currPos_
+    void readAhead();
+    // Read the log header at currPos_ of the front file into logId. Returns
+    // false if the log at currPos_ is not entirely in the file
+    bool readHeader(LogID& logId);
+
 private:
     // Holds the Wal object, so that it will not be destroyed before the iterator
     std::shared_ptr<FileBasedWal> wal_;
@@ -67,10 +86,9 @@ private:
 
     // [firstId, lastId]
     std::list<std::pair<LogID, LogID>> idRanges_;
-    std::list<int> fds_;
+    std::list<MappedFile> files_;
     int64_t currPos_{0};
     int32_t currMsgLen_{0};
-    mutable std::string currLog_;
 };
 
 }  // namespace wal
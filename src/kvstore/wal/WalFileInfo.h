@@ -12,6 +12,8 @@
 #include "kvstore/wal/Wal.h"
 #include "kvstore/wal/InMemoryLogBuffer.h"
 
+DECLARE_int32(wal_index_interval);
+
 namespace nebula {
 namespace wal {
 
@@ -23,7 +25,8 @@ public:
         , lastLogId_(-1)
         , lastLogTerm_(-1)
         , mtime_(0)
-        , size_(0) {}
+        , size_(0)
+        , indexInterval_(std::max(FLAGS_wal_index_interval, 1)) {}
 
     const char* path() const {
         return fullpath_.c_str();
@@ -61,6 +64,39 @@ public:
         size_ = size;
     }
 
+    // The sparse index keeps the offset of every indexInterval_-th log in
+    // the file, so the readers could jump close to any log without parsing
+    // all logs before it. Logs not on the interval are ignored
+    void addIndex(LogID id, size_t offset) {
+        auto delta = id - firstLogId_;
+        if (delta <= 0 || delta % indexInterval_ != 0) {
+            return;
+        }
+        size_t slot = delta / indexInterval_;
+        std::lock_guard<std::mutex> g(indexLock_);
+        if (slot >= index_.size()) {
+            index_.resize(slot + 1, -1);
+        }
+        index_[slot] = offset;
+    }
+
+    // Returns the closest indexed log no later than the given id, and its
+    // offset in the file. The first log in the file is always at offset 0
+    std::pair<LogID, size_t> seek(LogID id) const {
+        if (id > firstLogId_) {
+            std::lock_guard<std::mutex> g(indexLock_);
+            int64_t slot = std::min<int64_t>((id - firstLogId_) / indexInterval_,
+                                             static_cast<int64_t>(index_.size()) - 1);
+            for (; slot > 0; slot--) {
+                if (index_[slot] >= 0) {
+                    return std::make_pair(firstLogId_ + slot * indexInterval_,
+                                          index_[slot]);
+                }
+            }
+        }
+        return std::make_pair(firstLogId_, 0);
+    }
+
 private:
     const std::string fullpath_;
     const LogID firstLogId_;
@@ -68,6 +104,12 @@ private:
     TermID lastLogTerm_;
     time_t mtime_;
     size_t size_;
+
+    const int32_t indexInterval_;
+    mutable std::mutex indexLock_;
+    // Slot i holds the offset of log (firstLogId_ + i * indexInterval_),
+    // -1 if unknown yet
+    std::vector<int64_t> index_;
 };
 
 
@@ -138,6 +138,138 @@ TEST(FileBasedWal, CacheOverflow) {
 }
 
 
+TEST(FileBasedWal, SeekInFiles) {
+    FileBasedWalPolicy policy;
+    policy.fileSize = 1024L * 1024L;
+    policy.bufferSize = 1024L * 1024L;
+    policy.numBuffers = 2;
+
+    TempDir walDir("/tmp/testWal.XXXXXX");
+    auto wal = FileBasedWal::getWal(walDir.path(),
+                                    policy,
+                                    flusher.get(),
+                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                        return true;
+                                    });
+    for (int i = 1; i <= 10000; i++) {
+        ASSERT_TRUE(wal->appendLog(i /*id*/, i / 100 /*term*/, i /*cluster*/,
+                                   folly::stringPrintf(kLongMsg, i)));
+    }
+    // Wait one second to make sure all buffers have been flushed
+    sleep(1);
+
+    auto checkFrom = [&wal] (LogID start) {
+        auto it = wal->iterator(start, 10000);
+        LogID id = start;
+        while (it->valid() && id < start + 200) {
+            ASSERT_EQ(id, it->logId());
+            ASSERT_EQ(id / 100, it->logTerm());
+            ASSERT_EQ(id, it->logSource());
+            ASSERT_EQ(folly::stringPrintf(kLongMsg, id), it->logMsg());
+            ++(*it);
+            ++id;
+        }
+        ASSERT_EQ(std::min<LogID>(start + 200, 10001), id);
+    };
+
+    std::vector<LogID> starts = {1, 2, 64, 65, 955, 956, 4321, 9999, 10000};
+    // The index is built when writing the files
+    for (auto start : starts) {
+        checkFrom(start);
+    }
+
+    // Reopen the wal, the index is built when seeking
+    wal.reset();
+    wal = FileBasedWal::getWal(walDir.path(),
+                               policy,
+                               flusher.get(),
+                               [](LogID, TermID, ClusterID, const std::string&) {
+                                   return true;
+                               });
+    ASSERT_EQ(10000, wal->lastLogId());
+    for (int round = 0; round < 2; round++) {
+        for (auto it = starts.rbegin(); it != starts.rend(); ++it) {
+            checkFrom(*it);
+        }
+    }
+}
+
+
+TEST(FileBasedWal, ParallelFlush) {
+    FileBasedWalPolicy policy;
+    policy.fileSize = 1024L * 1024L;
+    policy.bufferSize = 1024L * 1024L;
+    policy.numBuffers = 2;
+
+    TempDir path1("/tmp/testWal.XXXXXX");
+    TempDir path2("/tmp/testWal.XXXXXX");
+    BufferFlusher parallelFlusher({path1.path(), path2.path()}, 2);
+    ASSERT_EQ(4, parallelFlusher.numThreads());
+
+    std::vector<std::string> walDirs;
+    for (auto* root : {path1.path(), path2.path()}) {
+        for (int part = 1; part <= 3; part++) {
+            walDirs.emplace_back(folly::stringPrintf("%s/wal/%d", root, part));
+        }
+    }
+
+    std::vector<std::thread> writers;
+    for (auto& dir : walDirs) {
+        writers.emplace_back([&parallelFlusher, &policy, dir] {
+            auto wal = FileBasedWal::getWal(dir,
+                                            policy,
+                                            &parallelFlusher,
+                                            [](LogID, TermID, ClusterID, const std::string&) {
+                                                return true;
+                                            });
+            for (int i = 1; i <= 5000; i++) {
+                ASSERT_TRUE(wal->appendLog(i /*id*/, 1 /*term*/, 0 /*cluster*/,
+                                           folly::stringPrintf(kLongMsg, i)));
+            }
+        });
+    }
+    for (auto& t : writers) {
+        t.join();
+    }
+
+    auto stats = parallelFlusher.stats();
+    EXPECT_EQ(0, stats.queueDepth);
+    EXPECT_LT(0, stats.flushedBuffers);
+    EXPECT_LE(stats.maxFlushLatencyUs, stats.totalFlushLatencyUs);
+
+    // Every wal should have all its logs in order
+    for (auto& dir : walDirs) {
+        auto wal = FileBasedWal::getWal(dir,
+                                        policy,
+                                        &parallelFlusher,
+                                        [](LogID, TermID, ClusterID, const std::string&) {
+                                            return true;
+                                        });
+        EXPECT_EQ(5000, wal->lastLogId());
+        auto it = wal->iterator(1, 5000);
+        LogID id = 1;
+        while (it->valid()) {
+            ASSERT_EQ(id, it->logId());
+            ASSERT_EQ(folly::stringPrintf(kLongMsg, id), it->logMsg());
+            ++(*it);
+            ++id;
+        }
+        EXPECT_EQ(5001, id);
+    }
+}
+
+
+TEST(FileBasedWal, FlusherPathMatch) {
+    EXPECT_TRUE(BufferFlusher::underPath("/data1", "/data1"));
+    EXPECT_TRUE(BufferFlusher::underPath("/data1/wal/1", "/data1"));
+    EXPECT_TRUE(BufferFlusher::underPath("/data1/wal/1", "/data1/"));
+    EXPECT_TRUE(BufferFlusher::underPath("/data1/wal/1", "/"));
+    EXPECT_FALSE(BufferFlusher::underPath("/data10/wal/1", "/data1"));
+    EXPECT_FALSE(BufferFlusher::underPath("/data10/wal/1", "/data1/"));
+    EXPECT_FALSE(BufferFlusher::underPath("/data", "/data1"));
+}
+
+
 TEST(FileBasedWal, Rollback) {
     // Force to make each file 1MB, each buffer is 1MB, and there are two
     // buffers at most
@@ -0,0 +1,131 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include "kvstore/wal/FileBasedWal.h"
+#include "kvstore/wal/BufferFlusher.h"
+#include "fs/TempDir.h"
+#include "fs/FileUtils.h"
+
+DEFINE_int32(replay_logs_num, 200000, "Number of logs in the wal");
+DEFINE_int32(replay_log_size, 512, "Size of each log");
+
+namespace nebula {
+namespace wal {
+
+using nebula::fs::FileUtils;
+using nebula::fs::TempDir;
+
+std::unique_ptr<BufferFlusher> flusher;
+std::unique_ptr<TempDir> walDir;
+std::shared_ptr<FileBasedWal> wal;
+
+FileBasedWalPolicy getPolicy() {
+    FileBasedWalPolicy policy;
+    policy.fileSize = 16L * 1024L * 1024L;
+    policy.bufferSize = 4L * 1024L * 1024L;
+    policy.numBuffers = 4;
+    return policy;
+}
+
+void prepareWal() {
+    walDir = std::make_unique<TempDir>("/tmp/walReplayBm.XXXXXX");
+    flusher = std::make_unique<BufferFlusher>();
+    auto preProcessor = [](LogID, TermID, ClusterID, const std::string&) {
+        return true;
+    };
+    {
+        auto w = FileBasedWal::getWal(walDir->path(), getPolicy(), flusher.get(), preProcessor);
+        std::string log(FLAGS_replay_log_size, 'a');
+        for (int i = 1; i <= FLAGS_replay_logs_num; i++) {
+            CHECK(w->appendLog(i, 1, 0, log));
+        }
+    }
+    // Reopen it, so all logs are read from the files just like recovering
+    wal = FileBasedWal::getWal(walDir->path(), getPolicy(), flusher.get(), preProcessor);
+    CHECK_EQ(FLAGS_replay_logs_num, wal->lastLogId());
+}
+
+// Read all logs with one pread call per field, the way the
+// iterator used to work
+size_t replayWithPread() {
+    size_t total = 0;
+    auto files = FileUtils::listAllFilesInDir(walDir->path(), true, "*.wal");
+    std::sort(files.begin(), files.end());
+    for (auto& file : files) {
+        int fd = open(file.c_str(), O_RDONLY);
+        CHECK_GE(fd, 0);
+        auto size = FileUtils::fileSize(file.c_str());
+        size_t pos = 0;
+        std::string log;
+        while (pos < size) {
+            LogID logId;
+            TermID term;
+            int32_t len;
+            ClusterID cluster;
+            CHECK_EQ(static_cast<ssize_t>(sizeof(LogID)),
+                     pread(fd, &logId, sizeof(LogID), pos));
+            CHECK_EQ(static_cast<ssize_t>(sizeof(TermID)),
+                     pread(fd, &term, sizeof(TermID), pos + sizeof(LogID)));
+            CHECK_EQ(static_cast<ssize_t>(sizeof(int32_t)),
+                     pread(fd, &len, sizeof(int32_t), pos + sizeof(LogID) + sizeof(TermID)));
+            CHECK_EQ(static_cast<ssize_t>(sizeof(ClusterID)),
+                     pread(fd, &cluster, sizeof(ClusterID),
+                           pos + sizeof(LogID) + sizeof(TermID) + sizeof(int32_t)));
+            log.resize(len);
+            CHECK_EQ(len,
+                     pread(fd, &log[0], len,
+                           pos + sizeof(LogID) + sizeof(TermID)
+                               + sizeof(int32_t) + sizeof(ClusterID)));
+            total += log.size();
+            pos += sizeof(LogID) + sizeof(TermID) + sizeof(int32_t) * 2
+                   + len + sizeof(ClusterID);
+        }
+        close(fd);
+    }
+    return total;
+}
+
+size_t replayWithIterator(LogID start) {
+    size_t total = 0;
+    auto it = wal->iterator(start, FLAGS_replay_logs_num);
+    while (it->valid()) {
+        total += it->logMsg().size();
+        ++(*it);
+    }
+    return total;
+}
+
+BENCHMARK(ReplayWithPread) {
+    folly::doNotOptimizeAway(replayWithPread());
+}
+
+BENCHMARK_RELATIVE(ReplayWithIterator) {
+    folly::doNotOptimizeAway(replayWithIterator(1));
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(SeekToLastLog, n) {
+    for (size_t i = 0; i < n; i++) {
+        folly::doNotOptimizeAway(replayWithIterator(FLAGS_replay_logs_num));
+    }
+}
+
+}  // namespace wal
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    folly::init(&argc, &argv, true);
+    nebula::wal::prepareWal();
+    folly::runBenchmarks();
+    nebula::wal::wal.reset();
+    nebula::wal::flusher.reset();
+    nebula::wal::walDir.reset();
+    return 0;
+}
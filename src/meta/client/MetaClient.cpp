@@ -153,6 +153,13 @@ void MetaClient::loadData() {
     decltype(localCache_) oldCache;
     {
         folly::RWSpinLock::WriteHolder holder(localCacheLock_);
+        if (spaceIndexByName != spaceIndexByName_
+                || spaceTagIndexByName != spaceTagIndexByName_
+                || spaceEdgeIndexByName != spaceEdgeIndexByName_
+                || spaceNewestTagVerMap != spaceNewestTagVerMap_
+                || spaceNewestEdgeVerMap != spaceNewestEdgeVerMap_) {
+            schemaVersion_++;
+        }
         oldCache = std::move(localCache_);
         localCache_ = std::move(cache);
         spaceIndexByName_ = std::move(spaceIndexByName);
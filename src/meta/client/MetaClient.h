@@ -98,6 +98,11 @@ public:
 
     void stop();
 
+    // Bumped every time the loaded spaces, tags or edges change
+    int64_t schemaVersion() const {
+        return schemaVersion_.load();
+    }
+
     void registerListener(MetaChangedListener* listener) {
         folly::RWSpinLock::WriteHolder holder(listenerLock_);
         CHECK(listener_ == nullptr);
@@ -340,6 +345,7 @@ private:
     std::atomic<ClusterID> clusterId_{0};
     bool                  sendHeartBeat_ = false;
     std::atomic_bool      ready_{false};
+    std::atomic<int64_t>  schemaVersion_{0};
     MetaConfigMap         metaConfigMap_;
     folly::RWSpinLock     configCacheLock_;
     cpp2::ConfigModule    gflagsModule_{cpp2::ConfigModule::UNKNOWN};
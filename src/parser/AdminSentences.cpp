@@ -30,6 +30,8 @@ std::string ShowSentence::toString() const {
             return folly::stringPrintf("SHOW CREATE TAG %s", name_.get()->c_str());
         case ShowType::kShowCreateEdge:
             return folly::stringPrintf("SHOW CREATE EDGE %s", name_.get()->c_str());
+        case ShowType::kShowQueries:
+            return std::string("SHOW QUERIES");
         case ShowType::kUnknown:
         default:
             FLOG_FATAL("Type illegal");
@@ -145,4 +147,13 @@ std::string ConfigSentence::toString() const {
     return "Unknown";
 }
 
+std::string SetSessionSentence::toString() const {
+    return folly::stringPrintf("SET SESSION %s = %s",
+                               name_->c_str(), value_->toString().c_str());
+}
+
+std::string KillQuerySentence::toString() const {
+    return folly::stringPrintf("KILL QUERY %ld", id_);
+}
+
 }   // namespace nebula
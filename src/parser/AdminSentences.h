@@ -29,7 +29,8 @@ public:
         kShowRoles,
         kShowCreateSpace,
         kShowCreateTag,
-        kShowCreateEdge
+        kShowCreateEdge,
+        kShowQueries
     };
 
     explicit ShowSentence(ShowType sType) {
@@ -354,6 +355,47 @@ private:
     std::unique_ptr<ConfigRowItem>  configItem_;
 };
 
+class SetSessionSentence final : public Sentence {
+public:
+    SetSessionSentence(std::string* name, Expression* value) {
+        kind_ = Kind::kSetSession;
+        name_.reset(name);
+        value_.reset(value);
+    }
+
+    std::string toString() const override;
+
+    const std::string* name() const {
+        return name_.get();
+    }
+
+    Expression* value() const {
+        return value_.get();
+    }
+
+private:
+    std::unique_ptr<std::string>    name_;
+    std::unique_ptr<Expression>     value_;
+};
+
+// KILL QUERY id, the id being one listed by SHOW QUERIES
+class KillQuerySentence final : public Sentence {
+public:
+    explicit KillQuerySentence(int64_t id) {
+        kind_ = Kind::kKillQuery;
+        id_ = id;
+    }
+
+    std::string toString() const override;
+
+    int64_t id() const {
+        return id_;
+    }
+
+private:
+    int64_t                         id_{0};
+};
+
 }   // namespace nebula
 
 #endif  // PARSER_ADMINSENTENCES_H_
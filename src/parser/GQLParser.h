@@ -15,7 +15,7 @@ namespace nebula {
 
 class GQLParser {
 public:
-    GQLParser() : parser_(scanner_, error_, &sentences_) {
+    GQLParser() : parser_(scanner_, error_, &sentences_, parameters_) {
         // Callback invoked by GraphScanner
         auto readBuffer = [this] (char *buf, int maxSize) -> int {
             // Reach the end
@@ -44,6 +44,7 @@ public:
         buffer_ = std::move(query);
         pos_ = &buffer_[0];
         end_ = pos_ + buffer_.size();
+        parameters_.clear();
 
         auto ok = parser_.parse() == 0;
         if (!ok) {
@@ -63,6 +64,8 @@ public:
         }
         auto *sentences = sentences_;
         sentences_ = nullptr;
+        sentences->setParameters(std::move(parameters_));
+        parameters_.clear();
         return sentences;
     }
 
@@ -74,6 +77,8 @@ private:
     nebula::GraphParser             parser_;
     std::string                     error_;
     SequentialSentences            *sentences_ = nullptr;
+    // The placeholders met during parsing, owned by `sentences_'
+    std::vector<ParameterExpression*> parameters_;
 };
 
 }   // namespace nebula
@@ -56,6 +56,11 @@ public:
         kConfig,
         kFetchVertices,
         kFetchEdges,
+        kSetSession,
+        kLimit,
+        kGroupBy,
+        kFindPath,
+        kKillQuery,
     };
 
     Kind kind() const {
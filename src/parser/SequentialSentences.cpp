@@ -12,6 +12,9 @@ namespace nebula {
 std::string SequentialSentences::toString() const {
     std::string buf;
     buf.reserve(1024);
+    if (timeoutMs_ > 0) {
+        buf += folly::stringPrintf("TIMEOUT %ld ", timeoutMs_);
+    }
     auto i = 0UL;
     buf += sentences_[i++]->toString();
     for ( ; i < sentences_.size(); i++) {
@@ -21,4 +24,32 @@ std::string SequentialSentences::toString() const {
     return buf;
 }
 
+
+void SequentialSentences::setParameters(std::vector<ParameterExpression*> parameters) {
+    parameters_ = std::move(parameters);
+    numParameters_ = 0;
+    for (auto *param : parameters_) {
+        numParameters_ = std::max(numParameters_, static_cast<size_t>(param->index()));
+    }
+}
+
+
+Status SequentialSentences::bindParameters(const std::vector<VariantType> &values) {
+    if (values.size() != numParameters_) {
+        return Status::Error("%lu parameters expected, but %lu given",
+                             numParameters_, values.size());
+    }
+    for (auto *param : parameters_) {
+        param->bind(values[param->index() - 1]);
+    }
+    return Status::OK();
+}
+
+
+void SequentialSentences::unbindParameters() {
+    for (auto *param : parameters_) {
+        param->unbind();
+    }
+}
+
 }   // namespace nebula
@@ -29,6 +29,16 @@ public:
         sentences_.emplace_back(sentence);
     }
 
+    // The timeout given by `TIMEOUT ms' ahead of the sentences, in place of the session's
+    void setTimeoutMs(int64_t ms) {
+        timeoutMs_ = ms;
+    }
+
+    // 0 if no timeout is given
+    int64_t timeoutMs() const {
+        return timeoutMs_;
+    }
+
     auto sentences() const {
         std::vector<Sentence*> result;
         result.resize(sentences_.size());
@@ -39,9 +49,32 @@ public:
 
     std::string toString() const;
 
+    void setParameters(std::vector<ParameterExpression*> parameters);
+
+    /**
+     * Number of parameters of a prepared statement,
+     * i.e. the largest N among the placeholders $N.
+     */
+    size_t numParameters() const {
+        return numParameters_;
+    }
+
+    /**
+     * Bind the values to the placeholders, the value of $N is values[N - 1].
+     * The number of values must be the same as numParameters().
+     */
+    Status bindParameters(const std::vector<VariantType> &values);
+
+    // Drop the bound values, once the sentences are done with
+    void unbindParameters();
+
 private:
     friend class nebula::graph::SequentialExecutor;
     std::vector<std::unique_ptr<Sentence>>      sentences_;
+    // The placeholders owned by the sentences
+    std::vector<ParameterExpression*>           parameters_;
+    size_t                                      numParameters_{0};
+    int64_t                                     timeoutMs_{0};
 };
 
 
@@ -36,8 +36,53 @@ std::string GoSentence::toString() const {
     return buf;
 }
 
+std::string MatchEdge::toString() const {
+    std::string buf;
+    buf.reserve(64);
+    buf += isReversely_ ? "<-[:" : "-[:";
+    buf += *edge_;
+    if (whereClause_ != nullptr) {
+        buf += " ";
+        buf += whereClause_->toString();
+    }
+    buf += isReversely_ ? "]-" : "]->";
+    return buf;
+}
+
+std::string MatchPath::toString() const {
+    std::string buf;
+    buf.reserve(256);
+    for (auto i = 0UL; i < nodes_.size(); i++) {
+        if (i > 0) {
+            buf += edges_[i - 1]->toString();
+        }
+        buf += "(";
+        buf += *nodes_[i];
+        buf += ")";
+    }
+    return buf;
+}
+
+std::string MatchPatterns::toString() const {
+    std::string buf;
+    buf.reserve(256);
+    for (auto &path : paths_) {
+        if (!buf.empty()) {
+            buf += ", ";
+        }
+        buf += path->toString();
+    }
+    return buf;
+}
+
 std::string MatchSentence::toString() const {
-    return "MATCH sentence";
+    std::string buf;
+    buf.reserve(256);
+    buf += "MATCH ";
+    buf += patterns_->toString();
+    buf += " FROM ";
+    buf += from_->toString();
+    return buf;
 }
 
 std::string FindSentence::toString() const {
@@ -54,6 +99,21 @@ std::string FindSentence::toString() const {
     return buf;
 }
 
+std::string FindPathSentence::toString() const {
+    std::string buf;
+    buf.reserve(256);
+    buf += isShortest_ ? "FIND SHORTEST PATH" : "FIND ALL PATH";
+    buf += " FROM ";
+    buf += from_->toString();
+    buf += " TO ";
+    buf += to_->toString();
+    buf += " ";
+    buf += overClause_->toString();
+    buf += " ";
+    buf += stepClause_->toString();
+    return buf;
+}
+
 std::string UseSentence::toString() const {
     return "USE " + *space_;
 }
@@ -127,6 +187,19 @@ std::string OrderBySentence::toString() const {
     return folly::stringPrintf("ORDER BY %s", orderFactors_->toString().c_str());
 }
 
+std::string LimitSentence::toString() const {
+    if (offset_ == 0) {
+        return folly::stringPrintf("LIMIT %ld", count_);
+    }
+    return folly::stringPrintf("LIMIT %ld, %ld", offset_, count_);
+}
+
+std::string GroupBySentence::toString() const {
+    return folly::stringPrintf("GROUP BY %s YIELD %s",
+                               keys_->toString().c_str(),
+                               yieldColumns_->toString().c_str());
+}
+
 std::string FetchVerticesSentence::toString() const {
     std::string buf;
     buf.reserve(256);
@@ -70,13 +70,129 @@ private:
 };
 
 
+/**
+ * An edge of a pattern, i.e. -[:edge WHERE filter]-> or <-[:edge WHERE filter]-,
+ * the filter being on the props of the edge.
+ */
+class MatchEdge final {
+public:
+    MatchEdge(std::string *edge, WhereClause *whereClause, bool isReversely) {
+        edge_.reset(edge);
+        whereClause_.reset(whereClause);
+        isReversely_ = isReversely;
+    }
+
+    const std::string* edge() const {
+        return edge_.get();
+    }
+
+    const WhereClause* whereClause() const {
+        return whereClause_.get();
+    }
+
+    // Whether the edge points from the right node to the left one
+    bool isReversely() const {
+        return isReversely_;
+    }
+
+    std::string toString() const;
+
+private:
+    std::unique_ptr<std::string>                edge_;
+    std::unique_ptr<WhereClause>                whereClause_;
+    bool                                        isReversely_{false};
+};
+
+
+/**
+ * A path of a pattern, i.e. (a)-[:edge]->(b)<-[:edge]-(c)...
+ * The nodes are named, the same name meaning the same vertex.
+ */
+class MatchPath final {
+public:
+    explicit MatchPath(std::string *node) {
+        nodes_.emplace_back(node);
+    }
+
+    void add(MatchEdge *edge, std::string *node) {
+        edges_.emplace_back(edge);
+        nodes_.emplace_back(node);
+    }
+
+    std::vector<std::string*> nodes() const {
+        std::vector<std::string*> result;
+        result.reserve(nodes_.size());
+        for (auto &node : nodes_) {
+            result.emplace_back(node.get());
+        }
+        return result;
+    }
+
+    // The i-th edge connects the i-th node and the (i+1)-th node
+    std::vector<MatchEdge*> edges() const {
+        std::vector<MatchEdge*> result;
+        result.reserve(edges_.size());
+        for (auto &edge : edges_) {
+            result.emplace_back(edge.get());
+        }
+        return result;
+    }
+
+    std::string toString() const;
+
+private:
+    std::vector<std::unique_ptr<std::string>>   nodes_;
+    std::vector<std::unique_ptr<MatchEdge>>     edges_;
+};
+
+
+class MatchPatterns final {
+public:
+    void addPath(MatchPath *path) {
+        paths_.emplace_back(path);
+    }
+
+    std::vector<MatchPath*> paths() const {
+        std::vector<MatchPath*> result;
+        result.reserve(paths_.size());
+        for (auto &path : paths_) {
+            result.emplace_back(path.get());
+        }
+        return result;
+    }
+
+    std::string toString() const;
+
+private:
+    std::vector<std::unique_ptr<MatchPath>>     paths_;
+};
+
+
+/**
+ * MATCH path, path... FROM vid_list
+ * The vertices of vid_list are taken as the first node of the first path.
+ */
 class MatchSentence final : public Sentence {
 public:
-    MatchSentence() {
+    MatchSentence(MatchPatterns *patterns, VertexIDList *from) {
         kind_ = Kind::kMatch;
+        patterns_.reset(patterns);
+        from_.reset(from);
+    }
+
+    const MatchPatterns* patterns() const {
+        return patterns_.get();
+    }
+
+    const VertexIDList* from() const {
+        return from_.get();
     }
 
     std::string toString() const override;
+
+private:
+    std::unique_ptr<MatchPatterns>              patterns_;
+    std::unique_ptr<VertexIDList>               from_;
 };
 
 
@@ -113,6 +229,63 @@ private:
 };
 
 
+/**
+ * FIND SHORTEST PATH | FIND ALL PATH FROM vid_list TO vid_list OVER edge [UPTO n STEPS]
+ */
+class FindPathSentence final : public Sentence {
+public:
+    explicit FindPathSentence(bool isShortest) {
+        kind_ = Kind::kFindPath;
+        isShortest_ = isShortest;
+    }
+
+    bool isShortest() const {
+        return isShortest_;
+    }
+
+    void setFrom(VertexIDList *from) {
+        from_.reset(from);
+    }
+
+    const VertexIDList* from() const {
+        return from_.get();
+    }
+
+    void setTo(VertexIDList *to) {
+        to_.reset(to);
+    }
+
+    const VertexIDList* to() const {
+        return to_.get();
+    }
+
+    void setOverClause(OverClause *clause) {
+        overClause_.reset(clause);
+    }
+
+    const OverClause* overClause() const {
+        return overClause_.get();
+    }
+
+    void setStepClause(StepClause *clause) {
+        stepClause_.reset(clause);
+    }
+
+    const StepClause* stepClause() const {
+        return stepClause_.get();
+    }
+
+    std::string toString() const override;
+
+private:
+    bool                                        isShortest_{true};
+    std::unique_ptr<VertexIDList>               from_;
+    std::unique_ptr<VertexIDList>               to_;
+    std::unique_ptr<OverClause>                 overClause_;
+    std::unique_ptr<StepClause>                 stepClause_;
+};
+
+
 class UseSentence final : public Sentence {
 public:
     explicit UseSentence(std::string *space) {
@@ -285,6 +458,54 @@ private:
     std::unique_ptr<OrderFactors>               orderFactors_;
 };
 
+// LIMIT [offset,] count
+class LimitSentence final : public Sentence {
+public:
+    LimitSentence(int64_t offset, int64_t count) {
+        offset_ = offset;
+        count_ = count;
+        kind_ = Kind::kLimit;
+    }
+
+    int64_t offset() const {
+        return offset_;
+    }
+
+    int64_t count() const {
+        return count_;
+    }
+
+    std::string toString() const override;
+
+private:
+    int64_t                                     offset_{0};
+    int64_t                                     count_{0};
+};
+
+// GROUP BY key [, key...] YIELD column [, column...]
+class GroupBySentence final : public Sentence {
+public:
+    GroupBySentence(YieldColumns *keys, YieldColumns *columns) {
+        keys_.reset(keys);
+        yieldColumns_.reset(columns);
+        kind_ = Kind::kGroupBy;
+    }
+
+    std::vector<YieldColumn*> keys() const {
+        return keys_->columns();
+    }
+
+    std::vector<YieldColumn*> columns() const {
+        return yieldColumns_->columns();
+    }
+
+    std::string toString() const override;
+
+private:
+    std::unique_ptr<YieldColumns>               keys_;
+    std::unique_ptr<YieldColumns>               yieldColumns_;
+};
+
 class FetchVerticesSentence final : public Sentence {
 public:
     FetchVerticesSentence(std::string  *tag,
@@ -8,6 +8,7 @@
 %parse-param { nebula::GraphScanner& scanner }
 %parse-param { std::string &errmsg }
 %parse-param { nebula::SequentialSentences** sentences }
+%parse-param { std::vector<nebula::ParameterExpression*> &parameters }
 
 %code requires {
 #include <iostream>
@@ -82,6 +83,9 @@ class GraphScanner;
     nebula::EdgeKey                        *edge_key;
     nebula::EdgeKeys                       *edge_keys;
     nebula::EdgeKeyRef                     *edge_key_ref;
+    nebula::MatchPatterns                  *match_patterns;
+    nebula::MatchPath                      *match_path;
+    nebula::MatchEdge                      *match_edge;
 }
 
 /* destructors */
@@ -103,7 +107,8 @@ class GraphScanner;
 %token KW_TTL_DURATION KW_TTL_COL
 %token KW_ORDER KW_ASC
 %token KW_FETCH KW_PROP
-%token KW_DISTINCT KW_ALL
+%token KW_DISTINCT KW_ALL KW_SESSION KW_LIMIT KW_GROUP
+%token KW_SHORTEST KW_PATH KW_KILL KW_QUERY KW_QUERIES KW_TIMEOUT
 /* symbols */
 %token L_PAREN R_PAREN L_BRACKET R_BRACKET L_BRACE R_BRACE COMMA
 %token PIPE OR AND LT LE GT GE EQ NE PLUS MINUS MUL DIV MOD NOT NEG ASSIGN
@@ -112,7 +117,7 @@ class GraphScanner;
 
 /* token type specification */
 %token <boolval> BOOL
-%token <intval> INTEGER IPV4
+%token <intval> INTEGER IPV4 PARAMETER
 %token <doubleval> DOUBLE
 %token <strval> STRING VARIABLE LABEL
 
@@ -126,18 +131,25 @@ class GraphScanner;
 %type <expr> var_ref_expression
 %type <expr> alias_ref_expression
 %type <expr> vid_ref_expression
+%type <expr> parameter_expression
 %type <expr> vid
 %type <expr> function_call_expression
 %type <argument_list> argument_list
 %type <type> type_spec
-%type <step_clause> step_clause
+%type <step_clause> step_clause find_path_upto_clause
 %type <from_clause> from_clause
 %type <vid_list> vid_list
 %type <over_clause> over_clause
 %type <where_clause> where_clause
+%type <match_patterns> match_patterns
+%type <match_path> match_path
+%type <match_edge> match_edge
+%type <strval> match_node
 %type <yield_clause> yield_clause
 %type <yield_columns> yield_columns
 %type <yield_column> yield_column
+%type <yield_columns> group_keys
+%type <yield_column> group_key
 %type <vertex_tag_list> vertex_tag_list
 %type <vertex_tag_item> vertex_tag_item
 %type <prop_list> prop_list
@@ -178,8 +190,8 @@ class GraphScanner;
 %type <role_type_clause> role_type_clause
 %type <acl_item_clause> acl_item_clause
 
-%type <sentence> go_sentence match_sentence use_sentence find_sentence
-%type <sentence> order_by_sentence
+%type <sentence> go_sentence match_sentence use_sentence find_sentence find_path_sentence
+%type <sentence> order_by_sentence limit_sentence group_by_sentence
 %type <sentence> fetch_vertices_sentence fetch_edges_sentence
 %type <sentence> create_tag_sentence create_edge_sentence
 %type <sentence> alter_tag_sentence alter_edge_sentence
@@ -195,7 +207,8 @@ class GraphScanner;
 %type <sentence> create_user_sentence alter_user_sentence drop_user_sentence change_password_sentence
 %type <sentence> grant_sentence revoke_sentence
 %type <sentence> download_sentence
-%type <sentence> set_config_sentence get_config_sentence
+%type <sentence> set_config_sentence get_config_sentence set_session_sentence
+%type <sentence> kill_query_sentence
 %type <sentence> sentence
 %type <sentences> sentences
 
@@ -224,6 +237,14 @@ unreserved_keyword
      | KW_GOD                { $$ = new std::string("god"); }
      | KW_ADMIN              { $$ = new std::string("admin"); }
      | KW_GUEST              { $$ = new std::string("guest"); }
+     | KW_SESSION            { $$ = new std::string("session"); }
+     | KW_LIMIT              { $$ = new std::string("limit"); }
+     | KW_GROUP              { $$ = new std::string("group"); }
+     | KW_PATH               { $$ = new std::string("path"); }
+     | KW_KILL               { $$ = new std::string("kill"); }
+     | KW_QUERY              { $$ = new std::string("query"); }
+     | KW_QUERIES            { $$ = new std::string("queries"); }
+     | KW_TIMEOUT            { $$ = new std::string("timeout"); }
      ;
 
 primary_expression
@@ -265,6 +286,17 @@ primary_expression
     | function_call_expression {
         $$ = $1;
     }
+    | parameter_expression {
+        $$ = $1;
+    }
+    ;
+
+parameter_expression
+    : PARAMETER {
+        auto *param = new ParameterExpression($1);
+        parameters.emplace_back(param);
+        $$ = param;
+    }
     ;
 
 input_ref_expression
@@ -320,6 +352,10 @@ function_call_expression
     : LABEL L_PAREN argument_list R_PAREN {
         $$ = new FunctionCallExpression($1, $3);
     }
+    | LABEL L_PAREN MUL R_PAREN {
+        // i.e. COUNT(*)
+        $$ = new FunctionCallExpression($1);
+    }
     ;
 
 argument_list
@@ -482,6 +518,9 @@ vid
     | function_call_expression {
         $$ = $1;
     }
+    | parameter_expression {
+        $$ = $1;
+    }
     ;
 
 unary_integer
@@ -559,7 +598,41 @@ yield_sentence
     ;
 
 match_sentence
-    : KW_MATCH { $$ = new MatchSentence; }
+    : KW_MATCH match_patterns KW_FROM vid_list {
+        $$ = new MatchSentence($2, $4);
+    }
+    ;
+
+match_patterns
+    : match_path {
+        $$ = new MatchPatterns();
+        $$->addPath($1);
+    }
+    | match_patterns COMMA match_path {
+        $$ = $1;
+        $$->addPath($3);
+    }
+    ;
+
+match_path
+    : match_node { $$ = new MatchPath($1); }
+    | match_path match_edge match_node {
+        $$ = $1;
+        $$->add($2, $3);
+    }
+    ;
+
+match_node
+    : L_PAREN name_label R_PAREN { $$ = $2; }
+    ;
+
+match_edge
+    : MINUS L_BRACKET COLON name_label where_clause R_BRACKET R_ARROW {
+        $$ = new MatchEdge($4, $5, false);
+    }
+    | L_ARROW L_BRACKET COLON name_label where_clause R_BRACKET MINUS {
+        $$ = new MatchEdge($4, $5, true);
+    }
     ;
 
 find_sentence
@@ -570,6 +643,30 @@ find_sentence
     }
     ;
 
+find_path_sentence
+    : KW_FIND KW_SHORTEST KW_PATH KW_FROM vid_list KW_TO vid_list over_clause find_path_upto_clause {
+        auto *s = new FindPathSentence(true);
+        s->setFrom($5);
+        s->setTo($7);
+        s->setOverClause($8);
+        s->setStepClause($9);
+        $$ = s;
+    }
+    | KW_FIND KW_ALL KW_PATH KW_FROM vid_list KW_TO vid_list over_clause find_path_upto_clause {
+        auto *s = new FindPathSentence(false);
+        s->setFrom($5);
+        s->setTo($7);
+        s->setOverClause($8);
+        s->setStepClause($9);
+        $$ = s;
+    }
+    ;
+
+find_path_upto_clause
+    : %empty { $$ = new StepClause(5, true); }
+    | KW_UPTO INTEGER KW_STEPS { $$ = new StepClause($2, true); }
+    ;
+
 order_factor
     : input_ref_expression {
         $$ = new OrderFactor($1, OrderFactor::ASCEND);
@@ -612,6 +709,41 @@ order_by_sentence
     }
     ;
 
+group_key
+    : input_ref_expression {
+        $$ = new YieldColumn($1);
+    }
+    | name_label {
+        $$ = new YieldColumn(new InputPropertyExpression($1));
+    }
+    ;
+
+group_keys
+    : group_key {
+        $$ = new YieldColumns();
+        $$->addColumn($1);
+    }
+    | group_keys COMMA group_key {
+        $$ = $1;
+        $$->addColumn($3);
+    }
+    ;
+
+group_by_sentence
+    : KW_GROUP KW_BY group_keys KW_YIELD yield_columns {
+        $$ = new GroupBySentence($3, $5);
+    }
+    ;
+
+limit_sentence
+    : KW_LIMIT INTEGER {
+        $$ = new LimitSentence(0, $2);
+    }
+    | KW_LIMIT INTEGER COMMA INTEGER {
+        $$ = new LimitSentence($2, $4);
+    }
+    ;
+
 fetch_vertices_sentence
     : KW_FETCH KW_PROP KW_ON name_label vid_list yield_clause {
         auto fetch = new FetchVerticesSentence($4, $5, $6);
@@ -884,7 +1016,10 @@ traverse_sentence
     : go_sentence { $$ = $1; }
     | match_sentence { $$ = $1; }
     | find_sentence { $$ = $1; }
+    | find_path_sentence { $$ = $1; }
     | order_by_sentence { $$ = $1; }
+    | limit_sentence { $$ = $1; }
+    | group_by_sentence { $$ = $1; }
     | fetch_sentence { $$ = $1; }
     | L_PAREN piped_sentence R_PAREN { $$ = $2; }
     | L_PAREN set_sentence R_PAREN { $$ = $2; }
@@ -1228,6 +1363,9 @@ show_sentence
     | KW_SHOW KW_CREATE KW_EDGE name_label {
         $$ = new ShowSentence(ShowSentence::ShowType::kShowCreateEdge, $4);
     }
+    | KW_SHOW KW_QUERIES {
+        $$ = new ShowSentence(ShowSentence::ShowType::kShowQueries);
+    }
     ;
 
 add_hosts_sentence
@@ -1483,6 +1621,18 @@ set_config_sentence
     }
     ;
 
+set_session_sentence
+    : KW_SET KW_SESSION name_label ASSIGN expression {
+        $$ = new SetSessionSentence($3, $5);
+    }
+    ;
+
+kill_query_sentence
+    : KW_KILL KW_QUERY INTEGER {
+        $$ = new KillQuerySentence($3);
+    }
+    ;
+
 mutate_sentence
     : insert_vertex_sentence { $$ = $1; }
     | insert_edge_sentence { $$ = $1; }
@@ -1523,6 +1673,8 @@ maintain_sentence
     | revoke_sentence { $$ = $1; }
     | get_config_sentence { $$ = $1; }
     | set_config_sentence { $$ = $1; }
+    | set_session_sentence { $$ = $1; }
+    | kill_query_sentence { $$ = $1; }
     ;
 
 sentence
@@ -1539,6 +1691,11 @@ sentences
         $$ = new SequentialSentences($1);
         *sentences = $$;
     }
+    | KW_TIMEOUT INTEGER sentence {
+        $$ = new SequentialSentences($3);
+        $$->setTimeoutMs($2);
+        *sentences = $$;
+    }
     | sentences SEMICOLON sentence {
         $$ = $1;
         $1->addSentence($3);
@@ -734,6 +734,67 @@ TEST(Parser, Find) {
     }
 }
 
+TEST(Parser, Match) {
+    {
+        GQLParser parser;
+        std::string query = "MATCH (a)-[:like]->(b) FROM 1";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+    }
+    {
+        GQLParser parser;
+        std::string query = "MATCH (a)-[:like WHERE like.likeness > 90]->(b)"
+                            "<-[:serve]-(c) FROM 1, 2";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+    }
+    {
+        GQLParser parser;
+        std::string query = "MATCH (a)-[:like]->(b)-[:like]->(c), (c)-[:like]->(a) FROM 1";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+    }
+    {
+        GQLParser parser;
+        std::string query = "MATCH (a)-[:like]->(b)";
+        auto result = parser.parse(query);
+        ASSERT_FALSE(result.ok());
+    }
+    {
+        GQLParser parser;
+        std::string query = "MATCH";
+        auto result = parser.parse(query);
+        ASSERT_FALSE(result.ok());
+    }
+}
+
+TEST(Parser, FindPath) {
+    {
+        GQLParser parser;
+        std::string query = "FIND SHORTEST PATH FROM 1 TO 2 OVER like";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+    }
+    {
+        GQLParser parser;
+        std::string query = "FIND SHORTEST PATH FROM 1, 2 TO 3, 4 OVER like UPTO 3 STEPS";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+    }
+    {
+        GQLParser parser;
+        std::string query = "FIND ALL PATH FROM 1 TO 2 OVER like REVERSELY UPTO 3 STEPS";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+    }
+    {
+        GQLParser parser;
+        std::string query = "FIND PATH FROM 1 TO 2 OVER like";
+        auto result = parser.parse(query);
+        ASSERT_FALSE(result.ok());
+    }
+}
+
 TEST(Parser, AdminOperation) {
     {
         GQLParser parser;
@@ -1058,6 +1119,84 @@ TEST(Parser, Agg) {
     }
 }
 
+TEST(Parser, Limit) {
+    {
+        GQLParser parser;
+        std::string query = "GO FROM 1 over friend YIELD friend.name as name | LIMIT 10";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+    }
+    {
+        GQLParser parser;
+        std::string query = "GO FROM 1 over friend "
+                            "YIELD friend.name as name, friend.age as age | "
+                            "ORDER BY $-.age DESC | LIMIT 5, 10";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+        auto sentences = result.value()->toString();
+        ASSERT_NE(std::string::npos, sentences.find("LIMIT 5, 10"));
+    }
+    {
+        GQLParser parser;
+        std::string query = "GO FROM 1 over friend | LIMIT -1";
+        auto result = parser.parse(query);
+        ASSERT_FALSE(result.ok());
+    }
+    {
+        GQLParser parser;
+        std::string query = "GO FROM 1 over friend | LIMIT";
+        auto result = parser.parse(query);
+        ASSERT_FALSE(result.ok());
+    }
+}
+
+TEST(Parser, GroupBy) {
+    {
+        GQLParser parser;
+        std::string query = "GO FROM 1 over friend YIELD friend.name as name | "
+                            "GROUP BY $-.name YIELD $-.name, COUNT(*)";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+    }
+    {
+        GQLParser parser;
+        std::string query = "GO FROM 1 over friend "
+                            "YIELD friend.name as name, friend.age as age, friend.city as city | "
+                            "GROUP BY name, $-.city YIELD $-.name AS name, $-.city AS city, "
+                            "COUNT(*) AS cnt, SUM($-.age), AVG($-.age * 2), MIN($-.age), "
+                            "MAX($-.age), COLLECT($-.age) AS ages";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+    }
+    {
+        GQLParser parser;
+        std::string query = "GO FROM 1 over friend YIELD friend.name as name | "
+                            "GROUP BY $-.name YIELD COUNT(*) AS cnt | ORDER BY $-.cnt | LIMIT 3";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+    }
+    {
+        GQLParser parser;
+        std::string query = "GROUP BY $-.name YIELD $-.name,COUNT(*) AS cnt,COUNT($-.age)";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+        auto& sentence = result.value();
+        EXPECT_EQ(query, sentence->toString());
+    }
+    {
+        GQLParser parser;
+        std::string query = "GO FROM 1 over friend | GROUP BY YIELD COUNT(*)";
+        auto result = parser.parse(query);
+        ASSERT_FALSE(result.ok());
+    }
+    {
+        GQLParser parser;
+        std::string query = "GO FROM 1 over friend | GROUP BY $-.id";
+        auto result = parser.parse(query);
+        ASSERT_FALSE(result.ok());
+    }
+}
+
 TEST(Parser, ReentrantRecoveryFromFailure) {
     GQLParser parser;
     {
@@ -1148,4 +1287,106 @@ TEST(Parser, ConfigOperation) {
     }
 }
 
+TEST(Parser, SetSession) {
+    {
+        GQLParser parser;
+        std::string query = "SET SESSION read_mode = \"read_index\"";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+    }
+    {
+        GQLParser parser;
+        std::string query = "SET SESSION max_staleness_ms = 500";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+    }
+    {
+        GQLParser parser;
+        std::string query = "SET SESSION read_mode";
+        auto result = parser.parse(query);
+        ASSERT_FALSE(result.ok());
+    }
+}
+
+TEST(Parser, KillQuery) {
+    {
+        GQLParser parser;
+        std::string query = "SHOW QUERIES";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+    }
+    {
+        GQLParser parser;
+        std::string query = "KILL QUERY 12";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+    }
+    {
+        GQLParser parser;
+        std::string query = "KILL QUERY";
+        auto result = parser.parse(query);
+        ASSERT_FALSE(result.ok());
+    }
+    {
+        GQLParser parser;
+        std::string query = "TIMEOUT 500 GO FROM 1 OVER like; GO FROM 2 OVER like";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+        ASSERT_EQ(500, result.value()->timeoutMs());
+    }
+    {
+        GQLParser parser;
+        std::string query = "GO FROM 1 OVER like; TIMEOUT 500 GO FROM 2 OVER like";
+        auto result = parser.parse(query);
+        ASSERT_FALSE(result.ok());
+    }
+    {
+        // Still usable as names
+        GQLParser parser;
+        std::string query = "CREATE TAG query(timeout int, queries string, kill int)";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+    }
+}
+
+TEST(Parser, Parameters) {
+    {
+        GQLParser parser;
+        std::string query = "GO FROM $1 OVER like WHERE like.likeness > $2";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+        ASSERT_EQ(2UL, result.value()->numParameters());
+    }
+    {
+        GQLParser parser;
+        std::string query = "FETCH PROP ON person $1, $1, $3";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+        ASSERT_EQ(3UL, result.value()->numParameters());
+    }
+    {
+        GQLParser parser;
+        std::string query = "GO FROM 1 OVER like YIELD like._dst, $1 + 1";
+        auto result = parser.parse(query);
+        ASSERT_TRUE(result.ok()) << result.status();
+        ASSERT_EQ(1UL, result.value()->numParameters());
+        ASSERT_FALSE(result.value()->bindParameters({}).ok());
+        ASSERT_TRUE(result.value()->bindParameters({int64_t(1)}).ok());
+    }
+    {
+        GQLParser parser;
+        std::string query = "GO FROM $0 OVER like";
+        auto result = parser.parse(query);
+        ASSERT_FALSE(result.ok());
+        ASSERT_NE(std::string::npos, result.status().toString().find("out of range"));
+    }
+    {
+        GQLParser parser;
+        std::string query = "GO FROM $1025 OVER like";
+        auto result = parser.parse(query);
+        ASSERT_FALSE(result.ok());
+        ASSERT_NE(std::string::npos, result.status().toString().find("out of range"));
+    }
+}
+
 }   // namespace nebula
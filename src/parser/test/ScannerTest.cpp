@@ -360,6 +360,33 @@ TEST(Scanner, Basic) {
         CHECK_SEMANTIC_TYPE("Variables", TokenType::KW_VARIABLES),
         CHECK_SEMANTIC_TYPE("ALL", TokenType::KW_ALL),
         CHECK_SEMANTIC_TYPE("all", TokenType::KW_ALL),
+        CHECK_SEMANTIC_TYPE("SESSION", TokenType::KW_SESSION),
+        CHECK_SEMANTIC_TYPE("Session", TokenType::KW_SESSION),
+        CHECK_SEMANTIC_TYPE("session", TokenType::KW_SESSION),
+        CHECK_SEMANTIC_TYPE("LIMIT", TokenType::KW_LIMIT),
+        CHECK_SEMANTIC_TYPE("Limit", TokenType::KW_LIMIT),
+        CHECK_SEMANTIC_TYPE("limit", TokenType::KW_LIMIT),
+        CHECK_SEMANTIC_TYPE("GROUP", TokenType::KW_GROUP),
+        CHECK_SEMANTIC_TYPE("Group", TokenType::KW_GROUP),
+        CHECK_SEMANTIC_TYPE("group", TokenType::KW_GROUP),
+        CHECK_SEMANTIC_TYPE("SHORTEST", TokenType::KW_SHORTEST),
+        CHECK_SEMANTIC_TYPE("Shortest", TokenType::KW_SHORTEST),
+        CHECK_SEMANTIC_TYPE("shortest", TokenType::KW_SHORTEST),
+        CHECK_SEMANTIC_TYPE("PATH", TokenType::KW_PATH),
+        CHECK_SEMANTIC_TYPE("Path", TokenType::KW_PATH),
+        CHECK_SEMANTIC_TYPE("path", TokenType::KW_PATH),
+        CHECK_SEMANTIC_TYPE("KILL", TokenType::KW_KILL),
+        CHECK_SEMANTIC_TYPE("Kill", TokenType::KW_KILL),
+        CHECK_SEMANTIC_TYPE("kill", TokenType::KW_KILL),
+        CHECK_SEMANTIC_TYPE("QUERY", TokenType::KW_QUERY),
+        CHECK_SEMANTIC_TYPE("Query", TokenType::KW_QUERY),
+        CHECK_SEMANTIC_TYPE("query", TokenType::KW_QUERY),
+        CHECK_SEMANTIC_TYPE("QUERIES", TokenType::KW_QUERIES),
+        CHECK_SEMANTIC_TYPE("Queries", TokenType::KW_QUERIES),
+        CHECK_SEMANTIC_TYPE("queries", TokenType::KW_QUERIES),
+        CHECK_SEMANTIC_TYPE("TIMEOUT", TokenType::KW_TIMEOUT),
+        CHECK_SEMANTIC_TYPE("Timeout", TokenType::KW_TIMEOUT),
+        CHECK_SEMANTIC_TYPE("timeout", TokenType::KW_TIMEOUT),
 
         CHECK_SEMANTIC_TYPE("_type", TokenType::TYPE_PROP),
         CHECK_SEMANTIC_TYPE("_id", TokenType::ID_PROP),
@@ -374,6 +401,8 @@ TEST(Scanner, Basic) {
 
         CHECK_SEMANTIC_VALUE("$var", TokenType::VARIABLE, "var"),
         CHECK_SEMANTIC_VALUE("$var123", TokenType::VARIABLE, "var123"),
+        CHECK_SEMANTIC_VALUE("$1", TokenType::PARAMETER, 1),
+        CHECK_SEMANTIC_VALUE("$12", TokenType::PARAMETER, 12),
 
         CHECK_SEMANTIC_VALUE("label", TokenType::LABEL, "label"),
         CHECK_SEMANTIC_VALUE("label123", TokenType::LABEL, "label123"),
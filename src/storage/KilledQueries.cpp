@@ -0,0 +1,54 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/KilledQueries.h"
+#include "time/WallClock.h"
+
+DEFINE_int32(killed_query_keep_secs, 60,
+             "How long the token of a killed query is kept, to refuse its requests arriving late");
+
+namespace nebula {
+namespace storage {
+
+KilledQueries& KilledQueries::instance() {
+    static KilledQueries instance;
+    return instance;
+}
+
+
+void KilledQueries::kill(int64_t token) {
+    if (token == 0) {
+        return;
+    }
+    auto now = time::WallClock::fastNowInSec();
+    std::lock_guard<std::mutex> g(lock_);
+    purge(now);
+    killed_[token] = now;
+    size_ = killed_.size();
+}
+
+
+bool KilledQueries::isKilled(int64_t token) const {
+    if (token == 0 || size_ == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> g(lock_);
+    return killed_.count(token) != 0;
+}
+
+
+void KilledQueries::purge(int64_t now) {
+    for (auto it = killed_.begin(); it != killed_.end();) {
+        if (now - it->second >= FLAGS_killed_query_keep_secs) {
+            it = killed_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}  // namespace storage
+}  // namespace nebula
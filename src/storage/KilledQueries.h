@@ -0,0 +1,45 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_KILLEDQUERIES_H_
+#define STORAGE_KILLEDQUERIES_H_
+
+#include "base/Base.h"
+#include "cpp/helpers.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * The tokens of the queries killed by graphd, which the reads of these queries
+ * check to stop early. A token is kept for a while after being killed, so the
+ * requests of the query arriving later are refused too.
+ */
+class KilledQueries final : public cpp::NonCopyable, public cpp::NonMovable {
+public:
+    static KilledQueries& instance();
+
+    void kill(int64_t token);
+
+    // Cheap if no query has been killed recently, which is the usual case
+    bool isKilled(int64_t token) const;
+
+private:
+    KilledQueries() = default;
+
+    // Pre-condition: The caller needs to hold lock_
+    void purge(int64_t now);
+
+private:
+    mutable std::mutex                          lock_;
+    // token => when it was killed, in seconds
+    std::unordered_map<int64_t, int64_t>        killed_;
+    std::atomic<size_t>                         size_{0};
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_KILLEDQUERIES_H_
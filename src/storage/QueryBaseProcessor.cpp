@@ -8,6 +8,8 @@
 
 DEFINE_int32(max_handlers_per_req, 10, "The max handlers used to handle one request");
 DEFINE_int32(min_vertices_per_bucket, 3, "The min vertices number in one bucket");
+DEFINE_int32(read_index_timeout_ms, 1000,
+             "The max time a follower waits to catch up with the read index");
 
 namespace nebula {
 namespace storage {
@@ -11,7 +11,10 @@
 #include "storage/BaseProcessor.h"
 #include "storage/Collector.h"
 #include "filter/Expressions.h"
+#include "filter/CompiledExpression.h"
 #include "storage/CommonUtils.h"
+#include "storage/KilledQueries.h"
+#include "kvstore/Part.h"
 
 namespace nebula {
 namespace storage {
@@ -29,6 +32,13 @@ enum class BoundType {
     OUT_BOUND,
 };
 
+// Where the slots of the compiled filter are read from
+enum SlotSource : uint8_t {
+    kEdgeSlot = 0,
+    kTagSlot,
+    kNumSlotSources,
+};
+
 using EdgeProcessor
     = std::function<void(RowReader* reader,
                          folly::StringPiece key,
@@ -99,18 +109,61 @@ protected:
 
     folly::Future<std::vector<OneVertexResp>> asyncProcessBucket(Bucket bucket);
 
+    // Process the buckets except the vertices of the unreadable parts
+    void processBuckets(std::vector<Bucket> buckets,
+                        std::vector<PartitionID> parts,
+                        std::unordered_set<PartitionID> unreadable,
+                        int32_t returnColumnsNum);
+
     int32_t getBucketsNum(int32_t verticesNum, int32_t minVerticesPerBucket, int32_t handlerNum);
 
     bool checkExp(const Expression* exp);
 
+    /**
+     * Evaluate the filter on one edge directly, returns false if it is filtered out.
+     * */
+    bool checkEdgeFilter(RowReader* reader, EdgeRanking rank, FilterContext* fcontext);
+
+    /**
+     * Compile the filter, so that the edges could be filtered in batches without the lock.
+     * The filter is evaluated directly if it could not be compiled.
+     * */
+    void compileExp();
+
+    /**
+     * The parts which could not be read on this replica in the mode the client
+     * asked for. Reads without options are served as before. For READ_INDEX the
+     * read indexes are asked from the leaders in one request for each leader,
+     * and the future is fulfilled once the parts have caught up.
+     * */
+    folly::Future<std::unordered_set<PartitionID>> unreadableParts(
+            std::vector<PartitionID> parts,
+            const cpp2::ReadOptions* options);
+
+    /**
+     * Whether the query of the request has been killed, or has run out of its time.
+     * The buckets check it as they go, and stop once it is true.
+     * */
+    bool isCancelled();
+
 protected:
     GraphSpaceID  spaceId_;
     BoundType     type_;
     std::unique_ptr<ExpressionContext> expCtx_;
     std::unique_ptr<Expression> exp_;
+    std::unique_ptr<CompiledExpression> compiledExp_;
+    // The edge schema and the src tag props that `compiledExp_' reads from
+    std::shared_ptr<const meta::SchemaProviderIf> compiledEdgeSchema_;
+    std::vector<TagProp> compiledTagProps_;
     std::vector<TagContext> tagContexts_;
     EdgeContext edgeContext_;
     folly::Executor* executor_ = nullptr;
+    // Parts rejected by unreadableParts(), they are skipped when processing
+    std::unordered_set<PartitionID> unreadableParts_;
+    // From the read options, 0 if not given
+    int32_t timeoutMs_{0};
+    int64_t queryToken_{0};
+    std::atomic<bool> cancelled_{false};
 };
 
 }  // namespace storage
@@ -8,9 +8,11 @@
 #include <algorithm>
 #include "dataman/RowReader.h"
 #include "dataman/RowWriter.h"
+#include "dataman/RowSlotReader.h"
 
 DECLARE_int32(max_handlers_per_req);
 DECLARE_int32(min_vertices_per_bucket);
+DECLARE_int32(read_index_timeout_ms);
 
 namespace nebula {
 namespace storage {
@@ -131,10 +133,72 @@ cpp2::ErrorCode QueryBaseProcessor<REQ, RESP>::checkAndBuildContexts(const REQ&
             LOG(FATAL) << "Unsupport get input prop " << prop;
             return false;
         };
+        compileExp();
     }
     return cpp2::ErrorCode::SUCCEEDED;
 }
 
+template<typename REQ, typename RESP>
+void QueryBaseProcessor<REQ, RESP>::compileExp() {
+    if (type_ != BoundType::OUT_BOUND) {
+        return;
+    }
+    if (edgeContext_.edgeType_ != -1) {
+        compiledEdgeSchema_ = this->schemaMan_->getEdgeSchema(spaceId_, edgeContext_.edgeType_);
+    }
+    auto resolver = [this] (const Expression* exp) -> StatusOr<CompiledExpression::Slot> {
+        std::shared_ptr<const meta::SchemaProviderIf> schema;
+        CompiledExpression::Slot slot;
+        auto* aliasProp = static_cast<const AliasPropertyExpression*>(exp);
+        switch (exp->kind()) {
+            case Expression::kAliasProp:
+            case Expression::kEdgeProp: {
+                schema = compiledEdgeSchema_;
+                slot.source = kEdgeSlot;
+                break;
+            }
+            case Expression::kSourceProp: {
+                auto tagRet = this->schemaMan_->toTagID(spaceId_, *aliasProp->alias());
+                if (!tagRet.ok()) {
+                    return tagRet.status();
+                }
+                schema = this->schemaMan_->getTagSchema(spaceId_, tagRet.value());
+                slot.source = kTagSlot;
+                break;
+            }
+            default:
+                // _src, _dst and _rank are not read from the row
+                return Status::Error("Could not resolve `%s'", exp->toString().c_str());
+        }
+        if (schema == nullptr) {
+            return Status::Error("No schema for `%s'", exp->toString().c_str());
+        }
+        auto index = schema->getFieldIndex(*aliasProp->prop());
+        if (index < 0) {
+            return Status::Error("No field for `%s'", exp->toString().c_str());
+        }
+        auto type = RowSlotReader::toSlotType(schema->getFieldType(index).get_type());
+        if (!type.ok()) {
+            return type.status();
+        }
+        slot.type = type.value();
+        if (slot.source == kEdgeSlot) {
+            slot.index = index;
+        } else {
+            slot.index = compiledTagProps_.size();
+            compiledTagProps_.emplace_back(*aliasProp->alias(), *aliasProp->prop());
+        }
+        return slot;
+    };
+    auto ret = CompiledExpression::compile(exp_.get(), resolver);
+    if (!ret.ok()) {
+        VLOG(1) << "Evaluate the filter directly: " << ret.status();
+        compiledTagProps_.clear();
+        return;
+    }
+    compiledExp_ = std::move(ret).value();
+}
+
 template<typename REQ, typename RESP>
 bool QueryBaseProcessor<REQ, RESP>::checkExp(const Expression* exp) {
     switch (exp->kind()) {
@@ -332,6 +396,37 @@ kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::collectVertexProps(
     return ret;
 }
 
+template<typename REQ, typename RESP>
+bool QueryBaseProcessor<REQ, RESP>::checkEdgeFilter(RowReader* reader,
+                                                    EdgeRanking rank,
+                                                    FilterContext* fcontext) {
+    // TODO(heng): We could remove the lock with one filter one bucket.
+    std::lock_guard<std::mutex> lg(this->lock_);
+    auto& getters = expCtx_->getters();
+    getters.getAliasProp = [&] (const std::string&, const std::string &prop) -> OptVariantType {
+        auto res = RowReader::getPropByName(reader, prop);
+        if (!ok(res)) {
+            return Status::Error("Invalid Prop");
+        }
+        return value(std::move(res));
+    };
+    getters.getEdgeRank = [&] () -> VariantType {
+        return rank;
+    };
+    getters.getSrcTagProp = [&, this] (const std::string& tag,
+                                       const std::string& prop) -> OptVariantType {
+        auto it = fcontext->tagFilters_.find(std::make_pair(tag, prop));
+        if (it == fcontext->tagFilters_.end()) {
+            return Status::Error("Invalid Tag Filter");
+        }
+        VLOG(1) << "Hit srcProp filter for tag " << tag << ", prop "
+                << prop << ", value " << it->second;
+        return it->second;
+    };
+    auto value = exp_->eval();
+    return !value.ok() || Expression::asBool(value.value());
+}
+
 template<typename REQ, typename RESP>
 kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::collectEdgeProps(
                                                PartitionID partId,
@@ -349,7 +444,89 @@ kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::collectEdgeProps(
     EdgeRanking lastRank  = -1;
     VertexID    lastDstId = 0;
     bool        firstLoop = true;
+
+    // With the compiled filter, the edges are buffered and filtered in batches
+    bool batched = exp_ != nullptr && compiledExp_ != nullptr && type_ == BoundType::OUT_BOUND;
+    // The src tag props are the same for all the edges
+    std::vector<VariantType> tagProps;
+    for (auto& tagProp : compiledTagProps_) {
+        if (!batched) {
+            break;
+        }
+        if (fcontext == nullptr) {
+            batched = false;
+            break;
+        }
+        auto it = fcontext->tagFilters_.find(tagProp);
+        if (it == fcontext->tagFilters_.end()) {
+            batched = false;
+            break;
+        }
+        tagProps.emplace_back(it->second);
+    }
+    RowSlotReader edgeReader;
+    VariantRowReader tagReader;
+    tagReader.reset(&tagProps);
+    const CompiledExpression::Reader* readers[kNumSlotSources] = {&edgeReader, &tagReader};
+    CompiledExpression::Batch batch;
+    // The buffered <key, value>s, which are reused across batches
+    std::vector<std::pair<std::string, std::string>> edges;
+    size_t numEdges = 0;
+    std::vector<std::unique_ptr<RowReader>> edgeReaders;
+    // The row of every edge in `batch', -1 if not in it
+    std::vector<int64_t> batchRows;
+    auto flush = [&] () {
+        batch.clear();
+        edgeReaders.clear();
+        batchRows.clear();
+        for (auto i = 0UL; i < numEdges; i++) {
+            auto& val = edges[i].second;
+            std::unique_ptr<RowReader> reader;
+            int64_t row = -1;
+            if (!val.empty()) {
+                reader = RowReader::getEdgePropReader(this->schemaMan_, val, spaceId_, edgeType);
+                // The slots of the edge props are resolved against the latest schema
+                if (compiledEdgeSchema_ == nullptr
+                        || reader->schemaVer() == compiledEdgeSchema_->getVersion()) {
+                    edgeReader.reset(reader.get());
+                    row = batch.size();
+                    compiledExp_->appendRow(readers, batch);
+                }
+            }
+            edgeReaders.emplace_back(std::move(reader));
+            batchRows.emplace_back(row);
+        }
+        // None of the edges is in the current schema version, e.g. just after an ALTER EDGE
+        if (batch.size() > 0) {
+            compiledExp_->evalBatch(batch);
+        }
+        for (auto i = 0UL; i < numEdges; i++) {
+            folly::StringPiece key = edges[i].first;
+            auto* reader = edgeReaders[i].get();
+            auto rank = NebulaKeyUtils::getRank(key);
+            bool matched = true;
+            if (batchRows[i] != -1) {
+                auto row = batchRows[i];
+                matched = batch.failed(row) || CompiledExpression::asBool(batch.result(row));
+            } else if (reader != nullptr) {
+                matched = checkEdgeFilter(reader, rank, fcontext);
+            }
+            if (!matched) {
+                VLOG(1) << "Filter the edge " << vId << "-> " << NebulaKeyUtils::getDstId(key)
+                        << "@" << rank << ":" << edgeType;
+                continue;
+            }
+            proc(reader, key, props);
+        }
+        numEdges = 0;
+    };
+
+    size_t scanned = 0;
     for (; iter->valid(); iter->next()) {
+        // A vertex might have a huge number of edges
+        if ((++scanned & 0x3FF) == 0 && isCancelled()) {
+            return ret;
+        }
         auto key = iter->key();
         auto val = iter->val();
         auto rank = NebulaKeyUtils::getRank(key);
@@ -360,40 +537,25 @@ kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::collectEdgeProps(
         }
         lastRank = rank;
         lastDstId = dstId;
+        if (batched) {
+            if (numEdges == edges.size()) {
+                edges.emplace_back();
+            }
+            edges[numEdges].first.assign(key.data(), key.size());
+            edges[numEdges].second.assign(val.data(), val.size());
+            if (++numEdges == CompiledExpression::kBatchSize) {
+                flush();
+            }
+            firstLoop = false;
+            continue;
+        }
         std::unique_ptr<RowReader> reader;
         if (type_ == BoundType::OUT_BOUND && !val.empty()) {
             reader = RowReader::getEdgePropReader(this->schemaMan_, val, spaceId_, edgeType);
-            if (exp_ != nullptr) {
-                // TODO(heng): We could remove the lock with one filter one bucket.
-                std::lock_guard<std::mutex> lg(this->lock_);
-                auto& getters = expCtx_->getters();
-                getters.getAliasProp =
-                    [&] (const std::string&, const std::string &prop) -> OptVariantType {
-                    auto res = RowReader::getPropByName(reader.get(), prop);
-                    if (!ok(res)) {
-                        return Status::Error("Invalid Prop");
-                    }
-                    return value(std::move(res));
-                };
-                getters.getEdgeRank = [&] () -> VariantType {
-                    return rank;
-                };
-                getters.getSrcTagProp = [&, this] (const std::string& tag,
-                                                   const std::string& prop) -> OptVariantType {
-                    auto it = fcontext->tagFilters_.find(std::make_pair(tag, prop));
-                    if (it == fcontext->tagFilters_.end()) {
-                        return Status::Error("Invalid Tag Filter");
-                    }
-                    VLOG(1) << "Hit srcProp filter for tag " << tag << ", prop "
-                            << prop << ", value " << it->second;
-                    return it->second;
-                };
-                auto value = exp_->eval();
-                if (value.ok() && !Expression::asBool(value.value())) {
-                    VLOG(1) << "Filter the edge "
-                            << vId << "-> " << dstId << "@" << rank << ":" << edgeType;
-                    continue;
-                }
+            if (exp_ != nullptr && !checkEdgeFilter(reader.get(), rank, fcontext)) {
+                VLOG(1) << "Filter the edge "
+                        << vId << "-> " << dstId << "@" << rank << ":" << edgeType;
+                continue;
             }
         }
         proc(reader.get(), key, props);
@@ -401,6 +563,9 @@ kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::collectEdgeProps(
             firstLoop = false;
         }
     }
+    if (numEdges > 0) {
+        flush();
+    }
     return ret;
 }
 
@@ -413,6 +578,12 @@ QueryBaseProcessor<REQ, RESP>::asyncProcessBucket(Bucket bucket) {
         std::vector<OneVertexResp> codes;
         codes.reserve(b.vertices_.size());
         for (auto& pv : b.vertices_) {
+            if (isCancelled()) {
+                break;
+            }
+            if (unreadableParts_.count(pv.first) > 0) {
+                continue;
+            }
             codes.emplace_back(pv.first,
                                pv.second,
                                processVertex(pv.first, pv.second));
@@ -459,6 +630,48 @@ std::vector<Bucket> QueryBaseProcessor<REQ, RESP>::genBuckets(
     return buckets;
 }
 
+template<typename REQ, typename RESP>
+folly::Future<std::unordered_set<PartitionID>>
+QueryBaseProcessor<REQ, RESP>::unreadableParts(std::vector<PartitionID> parts,
+                                               const cpp2::ReadOptions* options) {
+    std::unordered_set<PartitionID> unreadable;
+    if (options == nullptr || options->get_mode() == cpp2::ReadMode::LEADER) {
+        return unreadable;
+    }
+    std::vector<std::shared_ptr<raftex::RaftPart>> readIndexParts;
+    for (auto partId : parts) {
+        auto ret = this->kvstore_->part(spaceId_, partId);
+        if (!ok(ret)) {
+            // Let the read itself report the error
+            continue;
+        }
+        auto part = value(std::move(ret));
+        if (options->get_mode() == cpp2::ReadMode::READ_INDEX) {
+            readIndexParts.emplace_back(std::move(part));
+        } else if (!part->isFresh(options->get_max_staleness_ms())) {
+            unreadable.emplace(partId);
+        }
+    }
+    if (readIndexParts.empty()) {
+        return unreadable;
+    }
+    return raftex::RaftPart::readIndexes(std::move(readIndexParts),
+                                         FLAGS_read_index_timeout_ms);
+}
+
+template<typename REQ, typename RESP>
+bool QueryBaseProcessor<REQ, RESP>::isCancelled() {
+    if (cancelled_) {
+        return true;
+    }
+    // The time is counted from when the request is received
+    if ((timeoutMs_ > 0 && this->duration_.elapsedInMSec() > static_cast<uint64_t>(timeoutMs_))
+            || KilledQueries::instance().isKilled(queryToken_)) {
+        cancelled_ = true;
+    }
+    return cancelled_;
+}
+
 template<typename REQ, typename RESP>
 void QueryBaseProcessor<REQ, RESP>::process(const cpp2::GetNeighborsRequest& req) {
     CHECK_NOTNULL(executor_);
@@ -466,8 +679,14 @@ void QueryBaseProcessor<REQ, RESP>::process(const cpp2::GetNeighborsRequest& req
     int32_t returnColumnsNum = req.get_return_columns().size();
     VLOG(3) << "Receive request, spaceId " << spaceId_ << ", return cols " << returnColumnsNum;
     tagContexts_.reserve(returnColumnsNum);
+    auto* options = req.get_read_options();
+    if (options != nullptr) {
+        timeoutMs_ = options->get_timeout_ms();
+        queryToken_ = options->get_query_token();
+    }
 
-    auto retCode = checkAndBuildContexts(req);
+    auto retCode = isCancelled() ? cpp2::ErrorCode::E_QUERY_CANCELLED
+                                 : checkAndBuildContexts(req);
     if (retCode != cpp2::ErrorCode::SUCCEEDED) {
         for (auto& p : req.get_parts()) {
             this->pushResultCode(retCode, p.first);
@@ -476,16 +695,60 @@ void QueryBaseProcessor<REQ, RESP>::process(const cpp2::GetNeighborsRequest& req
         return;
     }
 
-    // const auto& filter = req.get_filter();
+    // The buckets are copied from the request, so the request is not needed
+    // while waiting for the read indexes
     auto buckets = genBuckets(req);
+    std::vector<PartitionID> parts;
+    for (auto& p : req.get_parts()) {
+        parts.emplace_back(p.first);
+    }
+    auto future = unreadableParts(parts, req.get_read_options());
+    if (future.isReady()) {
+        processBuckets(std::move(buckets), std::move(parts), std::move(future).get(),
+                       returnColumnsNum);
+        return;
+    }
+    std::move(future).via(executor_).thenValue([this,
+                                                returnColumnsNum,
+                                                buckets = std::move(buckets),
+                                                parts = std::move(parts)]
+                                               (auto&& unreadable) mutable {
+        processBuckets(std::move(buckets), std::move(parts), std::move(unreadable),
+                       returnColumnsNum);
+    });
+}
+
+template<typename REQ, typename RESP>
+void QueryBaseProcessor<REQ, RESP>::processBuckets(
+        std::vector<Bucket> buckets,
+        std::vector<PartitionID> parts,
+        std::unordered_set<PartitionID> unreadable,
+        int32_t returnColumnsNum) {
+    unreadableParts_ = std::move(unreadable);
+    for (auto partId : unreadableParts_) {
+        this->pushResultCode(cpp2::ErrorCode::E_STALE_REPLICA, partId);
+    }
+    parts.erase(std::remove_if(parts.begin(), parts.end(), [this] (auto partId) {
+        return unreadableParts_.count(partId) > 0;
+    }), parts.end());
+
     std::vector<folly::Future<std::vector<OneVertexResp>>> results;
     for (auto& bucket : buckets) {
         results.emplace_back(asyncProcessBucket(std::move(bucket)));
     }
     folly::collectAll(results).via(executor_).thenTry([
                      this,
-                     returnColumnsNum] (auto&& t) mutable {
+                     returnColumnsNum,
+                     parts = std::move(parts)] (auto&& t) mutable {
         CHECK(!t.hasException());
+        if (cancelled_) {
+            // Whatever has been collected is dropped along with the processor
+            for (auto partId : parts) {
+                this->pushResultCode(cpp2::ErrorCode::E_QUERY_CANCELLED, partId);
+            }
+            this->onFinished();
+            return;
+        }
         std::unordered_set<PartitionID> failedParts;
         for (auto& bucketTry : t.value()) {
             CHECK(!bucketTry.hasException());
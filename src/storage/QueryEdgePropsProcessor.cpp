@@ -59,9 +59,35 @@ void QueryEdgePropsProcessor::process(const cpp2::EdgePropRequest& req) {
         return;
     }
 
+    std::vector<PartitionID> partIds;
+    for (auto& partE : req.get_parts()) {
+        partIds.emplace_back(partE.first);
+    }
+    auto future = this->unreadableParts(std::move(partIds), req.get_read_options());
+    if (future.isReady()) {
+        processParts(req.get_parts(), std::move(future).get(), returnColumnsNum);
+        return;
+    }
+    // Keep the edge keys, the request would be gone once we return
+    if (executor_ != nullptr) {
+        future = std::move(future).via(executor_);
+    }
+    std::move(future).thenValue([this, parts = req.get_parts(), returnColumnsNum]
+                                (auto&& unreadable) {
+        processParts(parts, unreadable, returnColumnsNum);
+    });
+}
+
+void QueryEdgePropsProcessor::processParts(const PartEdges& parts,
+                                           const std::unordered_set<PartitionID>& unreadable,
+                                           int32_t returnColumnsNum) {
     RowSetWriter rsWriter;
-    std::for_each(req.get_parts().begin(), req.get_parts().end(), [&](auto& partE) {
+    std::for_each(parts.begin(), parts.end(), [&](auto& partE) {
         auto partId = partE.first;
+        if (unreadable.count(partId) > 0) {
+            this->pushResultCode(cpp2::ErrorCode::E_STALE_REPLICA, partId);
+            return;
+        }
         kvstore::ResultCode ret;
         for (auto& edgeKey : partE.second) {
             ret = this->collectEdgesProps(partId, edgeKey, this->edgeContext_.props_, rsWriter);
@@ -16,17 +16,27 @@ class QueryEdgePropsProcessor
     : public QueryBaseProcessor<cpp2::EdgePropRequest, cpp2::EdgePropResponse> {
 public:
     static QueryEdgePropsProcessor* instance(kvstore::KVStore* kvstore,
-                                             meta::SchemaManager* schemaMan) {
-        return new QueryEdgePropsProcessor(kvstore, schemaMan);
+                                             meta::SchemaManager* schemaMan,
+                                             folly::Executor* executor = nullptr) {
+        return new QueryEdgePropsProcessor(kvstore, schemaMan, executor);
     }
 
     // It is one new method for QueryBaseProcessor.process.
     void process(const cpp2::EdgePropRequest& req);
 
 private:
-    explicit QueryEdgePropsProcessor(kvstore::KVStore* kvstore, meta::SchemaManager* schemaMan)
+    using PartEdges = std::unordered_map<PartitionID, std::vector<cpp2::EdgeKey>>;
+
+    explicit QueryEdgePropsProcessor(kvstore::KVStore* kvstore,
+                                     meta::SchemaManager* schemaMan,
+                                     folly::Executor* executor)
         : QueryBaseProcessor<cpp2::EdgePropRequest,
-                             cpp2::EdgePropResponse>(kvstore, schemaMan) {}
+                             cpp2::EdgePropResponse>(kvstore, schemaMan, executor) {}
+
+    // The readable parts are served after waiting for the read indexes, if any
+    void processParts(const PartEdges& parts,
+                      const std::unordered_set<PartitionID>& unreadable,
+                      int32_t returnColumnsNum);
 
     kvstore::ResultCode collectEdgesProps(PartitionID partId,
                                           const cpp2::EdgeKey& edgeKey,
@@ -23,6 +23,9 @@ void QueryVertexPropsProcessor::process(const cpp2::VertexPropRequest& vertexReq
         tmpColumns.emplace_back(std::move(col));
     }
     req.set_return_columns(std::move(tmpColumns));
+    if (vertexReq.__isset.read_options) {
+        req.set_read_options(*vertexReq.get_read_options());
+    }
     this->onlyVertexProps_ = true;
     QueryBoundProcessor::process(req);
 }
@@ -0,0 +1,126 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/SpaceStatsProcessor.h"
+#include "base/NebulaKeyUtils.h"
+#include "storage/KilledQueries.h"
+
+namespace nebula {
+namespace storage {
+
+void SpaceStatsProcessor::process(const cpp2::SpaceStatsRequest& req) {
+    CHECK_NOTNULL(executor_);
+    spaceId_ = req.get_space_id();
+    auto* options = req.get_read_options();
+    if (options != nullptr) {
+        timeoutMs_ = options->get_timeout_ms();
+        queryToken_ = options->get_query_token();
+    }
+    VLOG(3) << "Receive SpaceStatsRequest, spaceId " << spaceId_
+            << ", parts " << req.get_parts().size();
+    std::vector<folly::Future<PartStats>> results;
+    for (auto& p : req.get_parts()) {
+        auto partId = p.first;
+        results.emplace_back(folly::via(executor_, [this, partId] () {
+            return scanPart(partId);
+        }));
+    }
+    folly::collectAll(results).via(executor_).thenTry([this] (auto&& t) {
+        CHECK(!t.hasException());
+        auto& tagVertices = resp_.tag_vertices;
+        auto& edges = resp_.edges;
+        for (auto& partTry : t.value()) {
+            CHECK(!partTry.hasException());
+            auto& part = partTry.value();
+            if (part.code != cpp2::ErrorCode::SUCCEEDED) {
+                continue;
+            }
+            for (auto& tag : part.tagVertices) {
+                tagVertices[tag.first] += tag.second;
+            }
+            for (auto& edge : part.edges) {
+                auto& stats = edges[edge.first];
+                stats.edges += edge.second.edges;
+                stats.vertices += edge.second.vertices;
+            }
+        }
+        this->onFinished();
+    });
+}
+
+
+SpaceStatsProcessor::PartStats SpaceStatsProcessor::scanPart(PartitionID partId) {
+    PartStats stats;
+    auto fail = [&] (cpp2::ErrorCode code) {
+        stats.code = code;
+        std::lock_guard<std::mutex> lg(this->lock_);
+        this->pushResultCode(code, partId);
+        return std::move(stats);
+    };
+    if (isCancelled()) {
+        return fail(cpp2::ErrorCode::E_QUERY_CANCELLED);
+    }
+    std::string prefix(reinterpret_cast<const char*>(&partId), sizeof(PartitionID));
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto ret = kvstore_->prefix(spaceId_, partId, prefix, &iter);
+    if (ret != kvstore::ResultCode::SUCCEEDED) {
+        VLOG(3) << "Error! ret = " << static_cast<int32_t>(ret)
+                << ", spaceId " << spaceId_ << ", partId " << partId;
+        return fail(this->to(ret));
+    }
+    // The versions of the same vertex or edge are next to each other,
+    // and so are the edges of the same type going out of a vertex
+    std::string lastKey;
+    VertexID lastSrc = 0;
+    EdgeType lastType = 0;
+    size_t scanned = 0;
+    for (; iter && iter->valid(); iter->next()) {
+        // The counts of a part given up halfway are not taken
+        if ((++scanned & 0x3FF) == 0 && isCancelled()) {
+            return fail(cpp2::ErrorCode::E_QUERY_CANCELLED);
+        }
+        auto key = iter->key();
+        bool isVertex = NebulaKeyUtils::isVertex(key);
+        if (!isVertex && !NebulaKeyUtils::isEdge(key)) {
+            continue;
+        }
+        auto noVersion = NebulaKeyUtils::keyWithNoVersion(key);
+        if (noVersion == lastKey) {
+            continue;
+        }
+        lastKey.assign(noVersion.data(), noVersion.size());
+        if (isVertex) {
+            stats.tagVertices[NebulaKeyUtils::getTagId(key)]++;
+            continue;
+        }
+        auto src = NebulaKeyUtils::getSrcId(key);
+        auto type = NebulaKeyUtils::getEdgeType(key);
+        auto& edgeStats = stats.edges[type];
+        edgeStats.edges++;
+        if (src != lastSrc || type != lastType) {
+            edgeStats.vertices++;
+        }
+        lastSrc = src;
+        lastType = type;
+    }
+    return stats;
+}
+
+
+bool SpaceStatsProcessor::isCancelled() {
+    if (cancelled_) {
+        return true;
+    }
+    // The time is counted from when the request is received
+    if ((timeoutMs_ > 0 && this->duration_.elapsedInMSec() > static_cast<uint64_t>(timeoutMs_))
+            || KilledQueries::instance().isKilled(queryToken_)) {
+        cancelled_ = true;
+    }
+    return cancelled_;
+}
+
+}  // namespace storage
+}  // namespace nebula
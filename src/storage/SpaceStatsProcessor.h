@@ -0,0 +1,61 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_SPACESTATSPROCESSOR_H_
+#define STORAGE_SPACESTATSPROCESSOR_H_
+
+#include "base/Base.h"
+#include "storage/BaseProcessor.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * Count the vertices per tag and the edges per edge type of the parts requested,
+ * by scanning each part as a whole on `executor', the parts in parallel.
+ * Only the latest version of a vertex or an edge is counted.
+ * A part is given up with E_QUERY_CANCELLED once the query asking for the stats
+ * has been killed, or has run out of its time.
+ */
+class SpaceStatsProcessor : public BaseProcessor<cpp2::SpaceStatsResponse> {
+public:
+    static SpaceStatsProcessor* instance(kvstore::KVStore* kvstore,
+                                         meta::SchemaManager* schemaMan,
+                                         folly::Executor* executor) {
+        return new SpaceStatsProcessor(kvstore, schemaMan, executor);
+    }
+
+    void process(const cpp2::SpaceStatsRequest& req);
+
+private:
+    explicit SpaceStatsProcessor(kvstore::KVStore* kvstore,
+                                 meta::SchemaManager* schemaMan,
+                                 folly::Executor* executor)
+            : BaseProcessor<cpp2::SpaceStatsResponse>(kvstore, schemaMan)
+            , executor_(executor) {}
+
+    struct PartStats {
+        cpp2::ErrorCode                                     code{cpp2::ErrorCode::SUCCEEDED};
+        std::unordered_map<TagID, int64_t>                  tagVertices;
+        std::unordered_map<EdgeType, cpp2::EdgeStats>       edges;
+    };
+
+    PartStats scanPart(PartitionID partId);
+
+    bool isCancelled();
+
+private:
+    folly::Executor*                                        executor_{nullptr};
+    GraphSpaceID                                            spaceId_;
+    // From the read options, 0 if not given
+    int32_t                                                 timeoutMs_{0};
+    int64_t                                                 queryToken_{0};
+    std::atomic<bool>                                       cancelled_{false};
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_SPACESTATSPROCESSOR_H_
@@ -7,6 +7,8 @@
 #include "storage/StorageHttpStatusHandler.h"
 #include "webservice/Common.h"
 #include "process/ProcessUtils.h"
+#include "kvstore/NebulaStore.h"
+#include "kvstore/raftex/LogCompressor.h"
 #include <proxygen/httpserver/RequestHandler.h>
 #include <proxygen/lib/http/ProxygenErrorEnum.h>
 #include <proxygen/httpserver/ResponseBuilder.h>
@@ -102,9 +104,40 @@ std::string StorageHttpStatusHandler::readValue(std::string& statusName) {
     folly::toLowerAscii(statusName);
     if (statusName == "status") {
         return "running";
-    } else {
-        return "unknown";
     }
+    if (folly::StringPiece(statusName).startsWith("wal_")) {
+        auto* store = dynamic_cast<kvstore::NebulaStore*>(kvstore_);
+        if (store != nullptr) {
+            auto stats = store->walFlusherStats();
+            if (statusName == "wal_flush_queue_depth") {
+                return folly::to<std::string>(stats.queueDepth);
+            } else if (statusName == "wal_flushed_buffers") {
+                return folly::to<std::string>(stats.flushedBuffers);
+            } else if (statusName == "wal_flush_latency_avg_us") {
+                return folly::to<std::string>(stats.flushedBuffers == 0
+                        ? 0 : stats.totalFlushLatencyUs / stats.flushedBuffers);
+            } else if (statusName == "wal_flush_latency_max_us") {
+                return folly::to<std::string>(stats.maxFlushLatencyUs);
+            } else if (statusName == "wal_buffer_exhausted") {
+                return folly::to<std::string>(stats.bufferExhausted);
+            }
+        }
+    }
+    if (folly::StringPiece(statusName).startsWith("raft_")) {
+        auto stats = raftex::LogCompressor::stats();
+        if (statusName == "raft_compression_ratio") {
+            // Compressed size / raw size, of the batches compressed so far
+            return folly::to<std::string>(stats.rawBytes == 0
+                    ? 1.0 : static_cast<double>(stats.compressedBytes) / stats.rawBytes);
+        } else if (statusName == "raft_compression_skipped_batches") {
+            return folly::to<std::string>(stats.skippedBatches);
+        } else if (statusName == "raft_compress_us") {
+            return folly::to<std::string>(stats.compressUs);
+        } else if (statusName == "raft_decompress_us") {
+            return folly::to<std::string>(stats.decompressUs);
+        }
+    }
+    return "unknown";
 }
 
 
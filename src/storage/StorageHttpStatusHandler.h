@@ -19,7 +19,9 @@ using nebula::HttpCode;
 
 class StorageHttpStatusHandler : public proxygen::RequestHandler {
 public:
-    StorageHttpStatusHandler() = default;
+    // The wal statistics are served only with a NebulaStore
+    explicit StorageHttpStatusHandler(kvstore::KVStore* kvstore = nullptr)
+        : kvstore_(kvstore) {}
 
     void onRequest(std::unique_ptr<proxygen::HTTPMessage> headers) noexcept override;
 
@@ -44,6 +46,7 @@ private:
     std::string toStr(folly::dynamic& vals) const;
 
 private:
+    kvstore::KVStore* kvstore_{nullptr};
     HttpCode err_{HttpCode::SUCCEEDED};
     bool returnJson_{false};
     std::vector<std::string> statusNames_;
@@ -64,8 +64,8 @@ bool StorageServer::initWebService() {
     webWorkers_->start(FLAGS_storage_http_thread_num, "http thread pool");
     LOG(INFO) << "Http Thread Pool started";
 
-    WebService::registerHandler("/status", [] {
-        return new StorageHttpStatusHandler();
+    WebService::registerHandler("/status", [this] {
+        return new StorageHttpStatusHandler(kvstore_.get());
     });
     WebService::registerHandler("/download", [this] {
         auto* handler = new storage::StorageHttpDownloadHandler();
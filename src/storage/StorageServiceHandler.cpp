@@ -12,7 +12,9 @@
 #include "storage/QueryVertexPropsProcessor.h"
 #include "storage/QueryEdgePropsProcessor.h"
 #include "storage/QueryStatsProcessor.h"
+#include "storage/SpaceStatsProcessor.h"
 #include "storage/AdminProcessor.h"
+#include "storage/KilledQueries.h"
 
 #define RETURN_FUTURE(processor) \
     auto f = processor->getFuture(); \
@@ -62,10 +64,25 @@ StorageServiceHandler::future_getProps(const cpp2::VertexPropRequest& req) {
 
 folly::Future<cpp2::EdgePropResponse>
 StorageServiceHandler::future_getEdgeProps(const cpp2::EdgePropRequest& req) {
-    auto* processor = QueryEdgePropsProcessor::instance(kvstore_, schemaMan_);
+    auto* processor = QueryEdgePropsProcessor::instance(kvstore_, schemaMan_, getThreadManager());
     RETURN_FUTURE(processor);
 }
 
+folly::Future<cpp2::SpaceStatsResponse>
+StorageServiceHandler::future_getSpaceStats(const cpp2::SpaceStatsRequest& req) {
+    auto* processor = SpaceStatsProcessor::instance(kvstore_, schemaMan_, getThreadManager());
+    RETURN_FUTURE(processor);
+}
+
+folly::Future<cpp2::ExecResponse>
+StorageServiceHandler::future_killQuery(const cpp2::KillQueryRequest& req) {
+    VLOG(1) << "Kill the query of token " << req.get_query_token();
+    KilledQueries::instance().kill(req.get_query_token());
+    cpp2::ExecResponse resp;
+    resp.set_result(cpp2::ResponseCommon());
+    return folly::makeFuture(std::move(resp));
+}
+
 folly::Future<cpp2::ExecResponse>
 StorageServiceHandler::future_addVertices(const cpp2::AddVerticesRequest& req) {
     auto* processor = AddVerticesProcessor::instance(kvstore_, schemaMan_);
@@ -43,6 +43,12 @@ public:
     folly::Future<cpp2::EdgePropResponse>
     future_getEdgeProps(const cpp2::EdgePropRequest& req) override;
 
+    folly::Future<cpp2::SpaceStatsResponse>
+    future_getSpaceStats(const cpp2::SpaceStatsRequest& req) override;
+
+    folly::Future<cpp2::ExecResponse>
+    future_killQuery(const cpp2::KillQueryRequest& req) override;
+
     folly::Future<cpp2::ExecResponse>
     future_addVertices(const cpp2::AddVerticesRequest& req) override;
 
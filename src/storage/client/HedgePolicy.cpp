@@ -0,0 +1,76 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "storage/client/HedgePolicy.h"
+
+DEFINE_int32(storage_client_hedge_percentile, 0,
+             "Hedge the reads from followers not answered within this percentile "
+             "of the recent latencies, 0 to disable hedging");
+DEFINE_int32(storage_client_hedge_budget_percent, 5,
+             "At most this percent of the reads are hedged");
+DEFINE_int32(storage_client_hedge_min_delay_ms, 5,
+             "The minimal delay before hedging a read");
+
+namespace nebula {
+namespace storage {
+
+void HedgePolicy::addLatency(int64_t latencyUs) {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (samples_.size() < kMaxSamples) {
+        samples_.emplace_back(latencyUs);
+    } else {
+        samples_[next_] = latencyUs;
+        next_ = (next_ + 1) % kMaxSamples;
+    }
+    if (++sinceUpdate_ >= kUpdateInterval) {
+        sinceUpdate_ = 0;
+        updateDelay();
+    }
+}
+
+
+int64_t HedgePolicy::delayMs() {
+    if (FLAGS_storage_client_hedge_percentile <= 0) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> guard(lock_);
+    requests_++;
+    if (requests_ >= kBudgetWindow) {
+        requests_ /= 2;
+        hedges_ /= 2;
+    }
+    if (delayUs_ < 0) {
+        return -1;
+    }
+    return std::max<int64_t>(delayUs_ / 1000, FLAGS_storage_client_hedge_min_delay_ms);
+}
+
+
+bool HedgePolicy::tryHedge() {
+    std::lock_guard<std::mutex> guard(lock_);
+    if ((hedges_ + 1) * 100 > requests_ * FLAGS_storage_client_hedge_budget_percent) {
+        return false;
+    }
+    hedges_++;
+    return true;
+}
+
+
+void HedgePolicy::updateDelay() {
+    // Not until there are enough latencies to tell the percentile
+    if (samples_.size() < kUpdateInterval) {
+        return;
+    }
+    auto percentile = std::min(FLAGS_storage_client_hedge_percentile, 100);
+    auto sorted = samples_;
+    auto nth = (sorted.size() - 1) * percentile / 100;
+    std::nth_element(sorted.begin(), sorted.begin() + nth, sorted.end());
+    delayUs_ = sorted[nth];
+}
+
+}   // namespace storage
+}   // namespace nebula
@@ -0,0 +1,65 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_CLIENT_HEDGEPOLICY_H_
+#define STORAGE_CLIENT_HEDGEPOLICY_H_
+
+#include "base/Base.h"
+
+DECLARE_int32(storage_client_hedge_percentile);
+DECLARE_int32(storage_client_hedge_budget_percent);
+DECLARE_int32(storage_client_hedge_min_delay_ms);
+
+namespace nebula {
+namespace storage {
+
+/**
+ * To decide when a read request is hedged, i.e. sent again to another replica
+ * in case the first one is slow to answer.
+ *
+ * A request is hedged if it has not been answered within the latency at
+ * FLAGS_storage_client_hedge_percentile of the recent requests, and only as long as
+ * the hedges sent are within FLAGS_storage_client_hedge_budget_percent of the requests,
+ * so that a slow cluster does not get twice the load.
+ *
+ * The class is thread-safe.
+ */
+class HedgePolicy final {
+public:
+    // Record the latency of a request, in microseconds
+    void addLatency(int64_t latencyUs);
+
+    // The delay in milliseconds before hedging a request just sent,
+    // -1 if hedging is disabled or there are not enough latencies recorded yet
+    int64_t delayMs();
+
+    // Whether a hedge could be sent within the budget, which is consumed if so
+    bool tryHedge();
+
+    static constexpr size_t kMaxSamples = 1024;
+    // The delay is updated once every so many latencies recorded
+    static constexpr size_t kUpdateInterval = 64;
+    // The counters of the budget are halved once the requests reach this
+    static constexpr uint64_t kBudgetWindow = 10000;
+
+private:
+    void updateDelay();
+
+private:
+    std::mutex                  lock_;
+    // A ring buffer of the recent latencies
+    std::vector<int64_t>        samples_;
+    size_t                      next_{0};
+    size_t                      sinceUpdate_{0};
+    int64_t                     delayUs_{-1};
+    uint64_t                    requests_{0};
+    uint64_t                    hedges_{0};
+};
+
+}   // namespace storage
+}   // namespace nebula
+
+#endif  // STORAGE_CLIENT_HEDGEPOLICY_H_
@@ -6,19 +6,72 @@
 
 #include "base/Base.h"
 #include "storage/client/StorageClient.h"
+#include <folly/futures/SharedPromise.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
 
 #define ID_HASH(id, numShards) \
     ((static_cast<uint64_t>(id)) % numShards + 1)
 
+DEFINE_int32(storage_client_retry_times, 3,
+             "Times to resend the parts failed with leader changed or rpc failure");
+DEFINE_int32(storage_client_retry_timeout_ms, 1000,
+             "No more retries after this long since the requests were sent, 0 for no limit");
+DEFINE_int32(storage_client_conn_pool_size, 1,
+             "Connections kept to each storage host for each IO thread");
+DEFINE_bool(storage_client_single_flight, false,
+            "Whether the identical reads in flight share their requests, "
+            "which are only sent for the vertices not being read yet");
+
 namespace nebula {
 namespace storage {
 
+namespace {
+
+// The reads of different queries are identical regardless of their time left and
+// tokens, so the flight is sent with those of the query starting it. A read joining
+// the flight of a query cancelled reads its vertices again with its own options.
+cpp2::ReadOptions flightKeyOptions(cpp2::ReadOptions options) {
+    options.set_timeout_ms(0);
+    options.set_query_token(0);
+    return options;
+}
+
+
+bool cancelled(StorageRpcResponse<cpp2::QueryResponse>& resp) {
+    for (auto& part : resp.failedParts()) {
+        if (part.second == cpp2::ErrorCode::E_QUERY_CANCELLED) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}   // Anonymous namespace
+
+
+struct StorageClient::Flight {
+    std::mutex lock;
+    // The reads joined. The flight could be joined only till a response arrives
+    // while none has joined, since such a response is handed to the owner alone
+    size_t joiners{0};
+    bool joinable{true};
+    // Copies of the responses, to be handed to the reads joined
+    std::vector<cpp2::QueryResponse> responses;
+    // The responses of the read starting the flight, if not passed to its `onResponse'
+    std::vector<cpp2::QueryResponse> ownResponses;
+    // Everything else of the read, set before `done' is fulfilled
+    std::unique_ptr<StorageRpcResponse<cpp2::QueryResponse>> result;
+    folly::SharedPromise<folly::Unit> done;
+};
+
+
 StorageClient::StorageClient(std::shared_ptr<folly::IOThreadPoolExecutor> threadPool,
                              meta::MetaClient *client)
         : ioThreadPool_(threadPool)
         , client_(client) {
     clientsMan_
-        = std::make_unique<thrift::ThriftClientManager<storage::cpp2::StorageServiceAsyncClient>>();
+        = std::make_unique<thrift::ThriftClientManager<storage::cpp2::StorageServiceAsyncClient>>(
+            std::max(FLAGS_storage_client_conn_pool_size, 1));
 }
 
 
@@ -98,13 +151,51 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getNei
         bool isOutBound,
         std::string filter,
         std::vector<cpp2::PropDef> returnCols,
-        folly::EventBase* evb) {
+        cpp2::ReadOptions readOptions,
+        folly::EventBase* evb,
+        std::function<void(cpp2::QueryResponse&&)> onResponse) {
+    if (!FLAGS_storage_client_single_flight || vertices.empty()) {
+        return doGetNeighbors(space, std::move(vertices), edgeType, isOutBound,
+                              std::move(filter), std::move(returnCols), std::move(readOptions),
+                              evb, std::move(onResponse));
+    }
+
+    // The request without any parts, which is the same for the identical reads
+    cpp2::GetNeighborsRequest req;
+    req.set_space_id(space);
+    req.set_edge_type(isOutBound ? edgeType : -edgeType);
+    req.set_filter(filter);
+    req.set_return_columns(returnCols);
+    req.set_read_options(flightKeyOptions(readOptions));
+    auto key = "neighbors:" + apache::thrift::CompactSerializer::serialize<std::string>(req);
+    return singleFlight(
+        space, std::move(key), std::move(vertices), evb, std::move(onResponse),
+        [this, space, edgeType, isOutBound, filter, returnCols, readOptions, evb] (
+                std::vector<VertexID> ids,
+                std::function<void(cpp2::QueryResponse&&)> onResp) {
+            return doGetNeighbors(space, std::move(ids), edgeType, isOutBound, filter,
+                                  returnCols, readOptions, evb, std::move(onResp));
+        });
+}
+
+
+folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::doGetNeighbors(
+        GraphSpaceID space,
+        std::vector<VertexID> vertices,
+        EdgeType edgeType,
+        bool isOutBound,
+        std::string filter,
+        std::vector<cpp2::PropDef> returnCols,
+        cpp2::ReadOptions readOptions,
+        folly::EventBase* evb,
+        std::function<void(cpp2::QueryResponse&&)> onResponse) {
     auto clusters = clusterIdsToHosts(
         space,
         vertices,
         [] (const VertexID& v) {
             return v;
-        });
+        },
+        readOptions.get_mode() != cpp2::ReadMode::LEADER);
 
     std::unordered_map<HostAddr, cpp2::GetNeighborsRequest> requests;
     for (auto& c : clusters) {
@@ -116,6 +207,7 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getNei
         req.set_edge_type(isOutBound ? edgeType : -edgeType);
         req.set_filter(filter);
         req.set_return_columns(returnCols);
+        req.set_read_options(readOptions);
     }
 
     return collectResponse(
@@ -127,7 +219,9 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getNei
             } else {
                 return client->future_getInBound(r);
             }
-        });
+        },
+        std::move(onResponse),
+        readOptions.get_mode() != cpp2::ReadMode::LEADER);
 }
 
 
@@ -175,13 +269,44 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getVer
         GraphSpaceID space,
         std::vector<VertexID> vertices,
         std::vector<cpp2::PropDef> returnCols,
+        cpp2::ReadOptions readOptions,
         folly::EventBase* evb) {
+    if (!FLAGS_storage_client_single_flight || vertices.empty()) {
+        return doGetVertexProps(space, std::move(vertices), std::move(returnCols),
+                                std::move(readOptions), evb, nullptr);
+    }
+
+    // The request without any parts, which is the same for the identical reads
+    cpp2::VertexPropRequest req;
+    req.set_space_id(space);
+    req.set_return_columns(returnCols);
+    req.set_read_options(flightKeyOptions(readOptions));
+    auto key = "props:" + apache::thrift::CompactSerializer::serialize<std::string>(req);
+    return singleFlight(
+        space, std::move(key), std::move(vertices), evb, nullptr,
+        [this, space, returnCols, readOptions, evb] (
+                std::vector<VertexID> ids,
+                std::function<void(cpp2::QueryResponse&&)> onResp) {
+            return doGetVertexProps(space, std::move(ids), returnCols, readOptions,
+                                    evb, std::move(onResp));
+        });
+}
+
+
+folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::doGetVertexProps(
+        GraphSpaceID space,
+        std::vector<VertexID> vertices,
+        std::vector<cpp2::PropDef> returnCols,
+        cpp2::ReadOptions readOptions,
+        folly::EventBase* evb,
+        std::function<void(cpp2::QueryResponse&&)> onResponse) {
     auto clusters = clusterIdsToHosts(
         space,
         vertices,
         [] (const VertexID& v) {
             return v;
-        });
+        },
+        readOptions.get_mode() != cpp2::ReadMode::LEADER);
 
     std::unordered_map<HostAddr, cpp2::VertexPropRequest> requests;
     for (auto& c : clusters) {
@@ -190,6 +315,7 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getVer
         req.set_space_id(space);
         req.set_parts(std::move(c.second));
         req.set_return_columns(returnCols);
+        req.set_read_options(readOptions);
     }
 
     return collectResponse(
@@ -197,7 +323,9 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getVer
         [](cpp2::StorageServiceAsyncClient* client,
            const cpp2::VertexPropRequest& r) {
             return client->future_getProps(r);
-        });
+        },
+        std::move(onResponse),
+        readOptions.get_mode() != cpp2::ReadMode::LEADER);
 }
 
 
@@ -205,13 +333,15 @@ folly::SemiFuture<StorageRpcResponse<cpp2::EdgePropResponse>> StorageClient::get
         GraphSpaceID space,
         std::vector<cpp2::EdgeKey> edges,
         std::vector<cpp2::PropDef> returnCols,
+        cpp2::ReadOptions readOptions,
         folly::EventBase* evb) {
     auto clusters = clusterIdsToHosts(
         space,
         edges,
         [] (const cpp2::EdgeKey& v) {
             return v.get_src();
-        });
+        },
+        readOptions.get_mode() != cpp2::ReadMode::LEADER);
 
     std::unordered_map<HostAddr, cpp2::EdgePropRequest> requests;
     for (auto& c : clusters) {
@@ -224,6 +354,7 @@ folly::SemiFuture<StorageRpcResponse<cpp2::EdgePropResponse>> StorageClient::get
         }
         req.set_parts(std::move(c.second));
         req.set_return_columns(returnCols);
+        req.set_read_options(readOptions);
     }
 
     return collectResponse(
@@ -231,10 +362,240 @@ folly::SemiFuture<StorageRpcResponse<cpp2::EdgePropResponse>> StorageClient::get
         [](cpp2::StorageServiceAsyncClient* client,
            const cpp2::EdgePropRequest& r) {
             return client->future_getEdgeProps(r);
+        },
+        nullptr,
+        readOptions.get_mode() != cpp2::ReadMode::LEADER);
+}
+
+
+folly::SemiFuture<StorageRpcResponse<cpp2::SpaceStatsResponse>> StorageClient::getSpaceStats(
+        GraphSpaceID space,
+        cpp2::ReadOptions readOptions,
+        folly::EventBase* evb) {
+    std::unordered_map<HostAddr, cpp2::SpaceStatsRequest> requests;
+    auto parts = partsNum(space);
+    for (PartitionID part = 1; part <= parts; part++) {
+        auto partMeta = getPartMeta(space, part);
+        CHECK_GT(partMeta.peers_.size(), 0U);
+        auto& req = requests[leader(partMeta)];
+        req.set_space_id(space);
+        req.set_read_options(readOptions);
+        req.parts.emplace(part, 0);
+    }
+
+    return collectResponse(
+        evb, std::move(requests),
+        [](cpp2::StorageServiceAsyncClient* client,
+           const cpp2::SpaceStatsRequest& r) {
+            return client->future_getSpaceStats(r);
+        });
+}
+
+
+folly::SemiFuture<StorageRpcResponse<cpp2::ExecResponse>> StorageClient::killQuery(
+        GraphSpaceID space,
+        int64_t queryToken,
+        folly::EventBase* evb) {
+    std::unordered_map<HostAddr, cpp2::KillQueryRequest> requests;
+    auto parts = partsNum(space);
+    for (PartitionID part = 1; part <= parts; part++) {
+        auto partMeta = getPartMeta(space, part);
+        for (auto& peer : partMeta.peers_) {
+            auto& req = requests[peer];
+            req.set_space_id(space);
+            req.set_query_token(queryToken);
+            req.parts.emplace(part, 0);
+        }
+    }
+
+    return collectResponse(
+        evb, std::move(requests),
+        [](cpp2::StorageServiceAsyncClient* client,
+           const cpp2::KillQueryRequest& r) {
+            return client->future_killQuery(r);
         });
 }
 
 
+folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::singleFlight(
+        GraphSpaceID space,
+        std::string key,
+        std::vector<VertexID> vertices,
+        folly::EventBase* evb,
+        std::function<void(cpp2::QueryResponse&&)> onResponse,
+        QueryFunc query) {
+    auto flight = std::make_shared<Flight>();
+    std::vector<VertexID> ids;
+    // The flights joined, with the vertices to take from each
+    std::unordered_map<std::shared_ptr<Flight>, std::unordered_set<VertexID>> joined;
+    {
+        std::lock_guard<std::mutex> g(flightsLock_);
+        auto& flights = flights_[key];
+        for (auto vId : vertices) {
+            auto it = flights.find(vId);
+            if (it == flights.end()) {
+                flights.emplace(vId, flight);
+                ids.emplace_back(vId);
+            } else if (it->second != flight) {
+                auto j = joined.find(it->second);
+                if (j == joined.end()) {
+                    std::lock_guard<std::mutex> fg(it->second->lock);
+                    if (it->second->joinable) {
+                        it->second->joiners++;
+                        j = joined.emplace(it->second, std::unordered_set<VertexID>()).first;
+                    }
+                }
+                if (j != joined.end()) {
+                    j->second.emplace(vId);
+                } else {
+                    // Some responses of that flight are gone, read the vertex anew
+                    it->second = flight;
+                    ids.emplace_back(vId);
+                }
+            }
+        }
+    }
+
+    std::vector<folly::Future<folly::Unit>> landed;
+    if (!ids.empty()) {
+        landed.emplace_back(flight->done.getFuture());
+        auto keep = [flight, onResponse] (cpp2::QueryResponse&& resp) {
+            {
+                std::lock_guard<std::mutex> g(flight->lock);
+                if (flight->joiners > 0) {
+                    // Copied only for the reads joined, the owner takes the response itself
+                    flight->responses.emplace_back(resp);
+                } else {
+                    flight->joinable = false;
+                }
+                if (!onResponse) {
+                    flight->ownResponses.emplace_back(std::move(resp));
+                    return;
+                }
+            }
+            onResponse(std::move(resp));
+        };
+        query(ids, std::move(keep))
+            .via(eventBase(evb))
+            .thenValue([this, key, ids, flight] (StorageRpcResponse<cpp2::QueryResponse>&& resp) {
+                land(key, ids, flight, std::move(resp));
+            })
+            .thenError([this, key, ids, flight] (folly::exception_wrapper&& e) {
+                LOG(ERROR) << "Read failed: " << e.what();
+                StorageRpcResponse<cpp2::QueryResponse> resp(1);
+                resp.markFailure();
+                land(key, ids, flight, std::move(resp));
+            });
+    }
+    for (auto& j : joined) {
+        landed.emplace_back(j.first->done.getFuture());
+    }
+    VLOG(2) << "Read " << ids.size() << " vertices, and join "
+            << joined.size() << " flights for the others";
+
+    auto promise = std::make_shared<folly::Promise<StorageRpcResponse<cpp2::QueryResponse>>>();
+    auto future = promise->getSemiFuture();
+    auto cb = [this, space, evb, promise, flight, own = !ids.empty(), joined = std::move(joined),
+               onResponse = std::move(onResponse), query = std::move(query)] (
+                    std::vector<folly::Try<folly::Unit>>&&) {
+        StorageRpcResponse<cpp2::QueryResponse> resp(0);
+        if (own) {
+            resp.mergeStats(*flight->result);
+            resp.responses() = std::move(flight->ownResponses);
+        }
+        // The vertices of the flights cancelled along with the queries starting them
+        std::vector<VertexID> again;
+        for (auto& j : joined) {
+            auto& from = *j.first;
+            auto& vIds = j.second;
+            if (cancelled(*from.result)) {
+                again.insert(again.end(), vIds.begin(), vIds.end());
+                continue;
+            }
+            // Only the failures of the parts asked are ours
+            std::unordered_set<PartitionID> parts;
+            for (auto vId : vIds) {
+                parts.emplace(partId(space, vId));
+            }
+            resp.mergeStats(*from.result, parts);
+            // Only the vertices asked are taken, the responses being shared
+            for (auto& r : from.responses) {
+                cpp2::QueryResponse taken;
+                taken.set_result(r.get_result());
+                if (r.__isset.vertex_schema) {
+                    taken.set_vertex_schema(r.get_vertex_schema());
+                }
+                if (r.__isset.edge_schema) {
+                    taken.set_edge_schema(r.get_edge_schema());
+                }
+                std::vector<cpp2::VertexData> vertices;
+                if (r.__isset.vertices) {
+                    for (auto& vdata : r.get_vertices()) {
+                        if (vIds.count(vdata.get_vertex_id()) > 0) {
+                            vertices.emplace_back(vdata);
+                        }
+                    }
+                }
+                if (vertices.empty()) {
+                    continue;
+                }
+                taken.set_vertices(std::move(vertices));
+                if (onResponse) {
+                    onResponse(std::move(taken));
+                } else {
+                    resp.responses().emplace_back(std::move(taken));
+                }
+            }
+        }
+        if (again.empty()) {
+            promise->setValue(std::move(resp));
+            return;
+        }
+        VLOG(2) << "Read " << again.size() << " vertices again, their flights were cancelled";
+        query(std::move(again), onResponse)
+            .via(eventBase(evb))
+            .thenValue([promise, resp = std::move(resp)] (
+                    StorageRpcResponse<cpp2::QueryResponse>&& read) mutable {
+                resp.mergeStats(read);
+                for (auto& r : read.responses()) {
+                    resp.responses().emplace_back(std::move(r));
+                }
+                promise->setValue(std::move(resp));
+            })
+            .thenError([promise] (folly::exception_wrapper&& e) {
+                promise->setException(std::move(e));
+            });
+    };
+    folly::collectAll(landed).via(eventBase(evb)).thenValue(std::move(cb));
+    return future;
+}
+
+
+void StorageClient::land(const std::string& key,
+                         const std::vector<VertexID>& vertices,
+                         std::shared_ptr<Flight> flight,
+                         StorageRpcResponse<cpp2::QueryResponse> resp) {
+    {
+        std::lock_guard<std::mutex> g(flightsLock_);
+        auto it = flights_.find(key);
+        if (it != flights_.end()) {
+            auto& flights = it->second;
+            for (auto vId : vertices) {
+                auto f = flights.find(vId);
+                if (f != flights.end() && f->second == flight) {
+                    flights.erase(f);
+                }
+            }
+            if (flights.empty()) {
+                flights_.erase(it);
+            }
+        }
+    }
+    flight->result = std::make_unique<StorageRpcResponse<cpp2::QueryResponse>>(std::move(resp));
+    flight->done.setValue();
+}
+
+
 PartitionID StorageClient::partId(GraphSpaceID spaceId, int64_t id) const {
     auto parts = partsNum(spaceId);
     auto s = ID_HASH(id, parts);
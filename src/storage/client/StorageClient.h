@@ -14,6 +14,11 @@
 #include "gen-cpp2/StorageServiceAsyncClient.h"
 #include "meta/client/MetaClient.h"
 #include "thrift/ThriftClientManager.h"
+#include "storage/client/HedgePolicy.h"
+
+DECLARE_int32(storage_client_retry_times);
+DECLARE_int32(storage_client_retry_timeout_ms);
+DECLARE_bool(storage_client_single_flight);
 
 namespace nebula {
 namespace storage {
@@ -47,6 +52,33 @@ public:
         ++failedReqs_;
     }
 
+    // Another request is sent to retry the failed parts of a previous one
+    void markRetry() {
+        ++totalReqsSent_;
+        ++retriedReqs_;
+    }
+
+    size_t retriedReqs() const {
+        return retriedReqs_;
+    }
+
+    // A request is hedged, i.e. sent again to other replicas
+    void markHedge() {
+        ++hedgedReqs_;
+    }
+
+    size_t hedgedReqs() const {
+        return hedgedReqs_;
+    }
+
+    size_t totalReqsSent() const {
+        return totalReqsSent_;
+    }
+
+    size_t failedReqs() const {
+        return failedReqs_;
+    }
+
     // A value between [0, 100], representing a precentage
     int32_t completeness() const {
         return (totalReqsSent_ - failedReqs_) * 100 / totalReqsSent_;
@@ -60,10 +92,42 @@ public:
         return responses_;
     }
 
+    // Account the requests of `other' as ours, but not its responses
+    void mergeStats(const StorageRpcResponse& other) {
+        totalReqsSent_ += other.totalReqsSent_;
+        failedReqs_ += other.failedReqs_;
+        retriedReqs_ += other.retriedReqs_;
+        hedgedReqs_ += other.hedgedReqs_;
+        if (!other.succeeded()) {
+            result_ = Result::PARTIAL_SUCCEEDED;
+        }
+        failedParts_.insert(other.failedParts_.begin(), other.failedParts_.end());
+        setLatency(other.maxLatency_);
+    }
+
+    // Account `other', a read shared with others, as a single request of ours,
+    // which failed only if some of `parts' failed, or the read failed as a whole
+    void mergeStats(const StorageRpcResponse& other,
+                    const std::unordered_set<PartitionID>& parts) {
+        ++totalReqsSent_;
+        bool failed = !other.succeeded() && other.failedParts_.empty();
+        for (auto& part : other.failedParts_) {
+            if (parts.count(part.first) > 0) {
+                failedParts_.insert(part);
+                failed = true;
+            }
+        }
+        if (failed) {
+            markFailure();
+        }
+        setLatency(other.maxLatency_);
+    }
 
 private:
-    const size_t totalReqsSent_;
+    size_t totalReqsSent_;
     size_t failedReqs_{0};
+    size_t retriedReqs_{0};
+    size_t hedgedReqs_{0};
 
     Result result_{Result::ALL_SUCCEEDED};
     std::unordered_map<PartitionID, storage::cpp2::ErrorCode> failedParts_;
@@ -72,6 +136,10 @@ private:
 };
 
 
+template<class Request, class RemoteFunc, class Response>
+struct ResponseContext;
+
+
 /**
  * A wrapper class for storage thrift API
  *
@@ -79,6 +147,8 @@ private:
  */
 class StorageClient {
     FRIEND_TEST(StorageClientTest, LeaderChangeTest);
+    FRIEND_TEST(StorageClientTest, RetryOnLeaderChangeTest);
+    FRIEND_TEST(StorageClientTest, SingleFlightTest);
 
 public:
     StorageClient(std::shared_ptr<folly::IOThreadPoolExecutor> ioThreadPool,
@@ -97,6 +167,8 @@ public:
         bool overwritable,
         folly::EventBase* evb = nullptr);
 
+    // The identical reads of getNeighbors() and getVertexProps() in flight share
+    // their requests, if FLAGS_storage_client_single_flight is on
     folly::SemiFuture<StorageRpcResponse<storage::cpp2::QueryResponse>> getNeighbors(
         GraphSpaceID space,
         std::vector<VertexID> vertices,
@@ -104,7 +176,9 @@ public:
         bool isOutBound,
         std::string filter,
         std::vector<storage::cpp2::PropDef> returnCols,
-        folly::EventBase* evb = nullptr);
+        storage::cpp2::ReadOptions readOptions = storage::cpp2::ReadOptions(),
+        folly::EventBase* evb = nullptr,
+        std::function<void(storage::cpp2::QueryResponse&&)> onResponse = nullptr);
 
     folly::SemiFuture<StorageRpcResponse<storage::cpp2::QueryStatsResponse>> neighborStats(
         GraphSpaceID space,
@@ -119,12 +193,29 @@ public:
         GraphSpaceID space,
         std::vector<VertexID> vertices,
         std::vector<storage::cpp2::PropDef> returnCols,
+        storage::cpp2::ReadOptions readOptions = storage::cpp2::ReadOptions(),
         folly::EventBase* evb = nullptr);
 
     folly::SemiFuture<StorageRpcResponse<storage::cpp2::EdgePropResponse>> getEdgeProps(
         GraphSpaceID space,
         std::vector<storage::cpp2::EdgeKey> edges,
         std::vector<storage::cpp2::PropDef> returnCols,
+        storage::cpp2::ReadOptions readOptions = storage::cpp2::ReadOptions(),
+        folly::EventBase* evb = nullptr);
+
+    // The stats of all the parts of the space, one response from each leader,
+    // which scans its parts as a whole, so it is not meant to be called per query.
+    // A part not scanned within the timeout of `readOptions' fails with E_QUERY_CANCELLED.
+    folly::SemiFuture<StorageRpcResponse<storage::cpp2::SpaceStatsResponse>> getSpaceStats(
+        GraphSpaceID space,
+        storage::cpp2::ReadOptions readOptions = storage::cpp2::ReadOptions(),
+        folly::EventBase* evb = nullptr);
+
+    // Tell all the replicas of the space to stop the reads of the query with `queryToken',
+    // since the reads might be served by any of them
+    folly::SemiFuture<StorageRpcResponse<storage::cpp2::ExecResponse>> killQuery(
+        GraphSpaceID space,
+        int64_t queryToken,
         folly::EventBase* evb = nullptr);
 
 protected:
@@ -143,6 +234,12 @@ protected:
         return partMeta.peers_[folly::Random::rand32(partMeta.peers_.size())];
     }
 
+    // Pick any replica of the part, used by the reads which could be
+    // served by followers
+    const HostAddr& replica(const PartMeta& partMeta) const {
+        return partMeta.peers_[folly::Random::rand32(partMeta.peers_.size())];
+    }
+
     void updateLeader(GraphSpaceID spaceId, PartitionID partId, const HostAddr& leader) {
         LOG(INFO) << "Update leader for " << spaceId << ", " << partId << " to " << leader;
         folly::RWSpinLock::WriteHolder wh(leadersLock_);
@@ -157,6 +254,24 @@ protected:
         }
     }
 
+    /**
+     * Send `requests' and collect their responses into the returned future.
+     *
+     * The requests are sent on `evb' if given, otherwise spread over the IO threads
+     * of the pool, one IO thread for each request, which decodes its response.
+     *
+     * The parts failed with E_LEADER_CHANGED or an RPC failure are resent to their
+     * leaders, at most FLAGS_storage_client_retry_times times, and only within
+     * FLAGS_storage_client_retry_timeout_ms since the requests were sent.
+     *
+     * If `onResponse' is given, each response is handed to it on its IO thread
+     * as soon as it arrives, possibly concurrently with the others, instead of
+     * being kept in the returned future, which then only accounts for the failures.
+     *
+     * If `anyReplica' is true, i.e. the requests could be served by any replica,
+     * a request not answered in time is hedged according to `hedgePolicy_',
+     * and the answer of either the request or its hedge is taken, whichever comes first.
+     */
     template<class Request,
              class RemoteFunc,
              class Response =
@@ -167,30 +282,76 @@ protected:
     folly::SemiFuture<StorageRpcResponse<Response>> collectResponse(
         folly::EventBase* evb,
         std::unordered_map<HostAddr, Request> requests,
-        RemoteFunc&& remoteFunc);
+        RemoteFunc&& remoteFunc,
+        std::function<void(Response&&)> onResponse = nullptr,
+        bool anyReplica = false);
+
+    // `evb' if given, otherwise the next IO thread of the pool
+    folly::EventBase* eventBase(folly::EventBase* evb) const {
+        if (evb != nullptr) {
+            return evb;
+        }
+        DCHECK(!!ioThreadPool_);
+        return ioThreadPool_->getEventBase();
+    }
+
+    template<class Request, class RemoteFunc, class Response>
+    void sendRequest(folly::EventBase* evb,
+                     std::shared_ptr<ResponseContext<Request, RemoteFunc, Response>> context,
+                     HostAddr host,
+                     size_t reqId,
+                     const Request* req,
+                     int32_t retried);
+
+    // Send the request `reqId' again to other replicas than `host',
+    // if it is still not answered and within the budget
+    template<class Request, class RemoteFunc, class Response>
+    void hedgeRequest(folly::EventBase* evb,
+                      std::shared_ptr<ResponseContext<Request, RemoteFunc, Response>> context,
+                      HostAddr host,
+                      size_t reqId);
+
+    // Resend `failedParts' of `req', grouped by their leaders
+    template<class Request, class RemoteFunc, class Response>
+    void resendParts(
+        std::shared_ptr<ResponseContext<Request, RemoteFunc, Response>> context,
+        Request& req,
+        const std::unordered_map<PartitionID, storage::cpp2::ErrorCode>& failedParts,
+        int32_t retried);
 
     // Cluster given ids into the host they belong to
     // The method returns a map
     //  host_addr (A host, but in most case, the leader will be chosen)
     //      => (partition -> [ids that belong to the shard])
+    // When anyReplica is true, a random replica is chosen for each partition
     template<class Container, class GetIdFunc>
     std::unordered_map<HostAddr,
                        std::unordered_map<PartitionID,
                                           std::vector<typename Container::value_type>
                                          >
                       >
-    clusterIdsToHosts(GraphSpaceID spaceId, Container ids, GetIdFunc f) const {
+    clusterIdsToHosts(GraphSpaceID spaceId,
+                      Container ids,
+                      GetIdFunc f,
+                      bool anyReplica = false) const {
         std::unordered_map<HostAddr,
                            std::unordered_map<PartitionID,
                                               std::vector<typename Container::value_type>
                                              >
                           > clusters;
+        // All ids of one partition go to the same host
+        std::unordered_map<PartitionID, HostAddr> hosts;
         for (auto& id : ids) {
             PartitionID part = partId(spaceId, f(id));
-            auto partMeta = getPartMeta(spaceId, part);
-            CHECK_GT(partMeta.peers_.size(), 0U);
-            const auto& leader = this->leader(partMeta);
-            clusters[leader][part].emplace_back(std::move(id));
+            auto it = hosts.find(part);
+            if (it == hosts.end()) {
+                auto partMeta = getPartMeta(spaceId, part);
+                CHECK_GT(partMeta.peers_.size(), 0U);
+                const auto& host = anyReplica ? this->replica(partMeta)
+                                              : this->leader(partMeta);
+                it = hosts.emplace(part, host).first;
+            }
+            clusters[it->second][part].emplace_back(std::move(id));
         }
         return clusters;
     }
@@ -205,6 +366,56 @@ protected:
         return client_->getPartMetaFromCache(spaceId, partId);
     }
 
+private:
+    // The read of some vertices in flight
+    struct Flight;
+
+    using QueryFunc = std::function<
+        folly::SemiFuture<StorageRpcResponse<storage::cpp2::QueryResponse>>(
+            std::vector<VertexID>, std::function<void(storage::cpp2::QueryResponse&&)>)>;
+
+    folly::SemiFuture<StorageRpcResponse<storage::cpp2::QueryResponse>> doGetNeighbors(
+        GraphSpaceID space,
+        std::vector<VertexID> vertices,
+        EdgeType edgeType,
+        bool isOutBound,
+        std::string filter,
+        std::vector<storage::cpp2::PropDef> returnCols,
+        storage::cpp2::ReadOptions readOptions,
+        folly::EventBase* evb,
+        std::function<void(storage::cpp2::QueryResponse&&)> onResponse);
+
+    folly::SemiFuture<StorageRpcResponse<storage::cpp2::QueryResponse>> doGetVertexProps(
+        GraphSpaceID space,
+        std::vector<VertexID> vertices,
+        std::vector<storage::cpp2::PropDef> returnCols,
+        storage::cpp2::ReadOptions readOptions,
+        folly::EventBase* evb,
+        std::function<void(storage::cpp2::QueryResponse&&)> onResponse);
+
+    /**
+     * Read `vertices' with the reads of the same `key' already in flight.
+     *
+     * The vertices being read by such a read are taken from its responses when it
+     * lands, and only the others are read by `query', as a new flight which the
+     * reads issued meanwhile could join in turn. The vertices of a flight cancelled
+     * with the query starting it are read by `query' again, i.e. for this read.
+     * Only the failed parts of `vertices' in `space' are reported.
+     */
+    folly::SemiFuture<StorageRpcResponse<storage::cpp2::QueryResponse>> singleFlight(
+        GraphSpaceID space,
+        std::string key,
+        std::vector<VertexID> vertices,
+        folly::EventBase* evb,
+        std::function<void(storage::cpp2::QueryResponse&&)> onResponse,
+        QueryFunc query);
+
+    // The flight lands, so it could not be joined any more
+    void land(const std::string& key,
+              const std::vector<VertexID>& vertices,
+              std::shared_ptr<Flight> flight,
+              StorageRpcResponse<storage::cpp2::QueryResponse> resp);
+
 private:
     std::shared_ptr<folly::IOThreadPoolExecutor> ioThreadPool_;
     meta::MetaClient *client_{nullptr};
@@ -212,6 +423,11 @@ private:
                         storage::cpp2::StorageServiceAsyncClient>> clientsMan_;
     mutable folly::RWSpinLock leadersLock_;
     std::unordered_map<std::pair<GraphSpaceID, PartitionID>, HostAddr> leaders_;
+    HedgePolicy hedgePolicy_;
+    std::mutex flightsLock_;
+    // key => (vertex => the flight reading it)
+    std::unordered_map<std::string,
+                       std::unordered_map<VertexID, std::shared_ptr<Flight>>> flights_;
 };
 
 }   // namespace storage
@@ -9,14 +9,29 @@
 namespace nebula {
 namespace storage {
 
-namespace {
-
 template<class Request, class RemoteFunc, class Response>
 struct ResponseContext {
 public:
-    ResponseContext(size_t reqsSent, RemoteFunc&& remoteFunc)
+    // The hedge of a request, which might be sent to several hosts
+    struct Hedge {
+        size_t pending{0};
+        bool failed{false};
+        // The hedge answered first
+        bool won{false};
+        std::vector<Response> responses;
+    };
+
+    ResponseContext(size_t reqsSent,
+                    RemoteFunc&& remoteFunc,
+                    std::function<void(Response&&)> onResp,
+                    bool replica,
+                    folly::EventBase* base)
         : resp(reqsSent)
-        , serverMethod(std::move(remoteFunc)) {}
+        , serverMethod(std::move(remoteFunc))
+        , onResponse(std::move(onResp))
+        , anyReplica(replica)
+        , evb(base)
+        , startTime(std::chrono::steady_clock::now()) {}
 
     // Return true if processed all responses
     bool finishSending() {
@@ -30,23 +45,32 @@ public:
         }
     }
 
-    std::pair<const Request*, bool> insertRequest(HostAddr host, Request&& req) {
+    // Requests are identified by id rather than by host,
+    // since the parts resent might go to a host which has one in flight
+    std::pair<size_t, const Request*> insertRequest(Request&& req) {
+        std::lock_guard<std::mutex> g(lock_);
+        auto id = nextId_++;
+        auto res = ongoingRequests_.emplace(id, std::move(req));
+        DCHECK(res.second);
+        return std::make_pair(id, &res.first->second);
+    }
+
+    bool isOngoing(size_t id) {
         std::lock_guard<std::mutex> g(lock_);
-        auto res = ongoingRequests_.emplace(host, std::move(req));
-        return std::make_pair(&res.first->second, res.second);
+        return ongoingRequests_.count(id) > 0;
     }
 
-    const Request& findRequest(HostAddr host) {
+    Request& findRequest(size_t id) {
         std::lock_guard<std::mutex> g(lock_);
-        auto it = ongoingRequests_.find(host);
+        auto it = ongoingRequests_.find(id);
         DCHECK(it != ongoingRequests_.end());
         return it->second;
     }
 
     // Return true if processed all responses
-    bool removeRequest(HostAddr host) {
+    bool removeRequest(size_t id) {
         std::lock_guard<std::mutex> g(lock_);
-        ongoingRequests_.erase(host);
+        ongoingRequests_.erase(id);
         if (finishSending_ && !fulfilled_ && ongoingRequests_.empty()) {
             fulfilled_ = true;
             return true;
@@ -55,107 +79,339 @@ public:
         }
     }
 
+    // Whether the parts failed after `retried' retries could be resent
+    bool canRetry(int32_t retried) const {
+        if (retried >= FLAGS_storage_client_retry_times) {
+            return false;
+        }
+        if (FLAGS_storage_client_retry_timeout_ms <= 0) {
+            return true;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+        return elapsed < FLAGS_storage_client_retry_timeout_ms;
+    }
+
+    // Set the promise, once all responses are processed
+    void fulfill() {
+        std::unique_lock<std::mutex> g(respLock);
+        auto value = std::move(resp);
+        g.unlock();
+        promise.setValue(std::move(value));
+    }
+
 
 public:
     folly::Promise<StorageRpcResponse<Response>> promise;
+    // The responses arrive on different IO threads,
+    // so `resp' and `hedges' are guarded by `respLock'
+    std::mutex respLock;
     StorageRpcResponse<Response> resp;
+    std::unordered_map<size_t, Hedge> hedges;
     RemoteFunc serverMethod;
+    std::function<void(Response&&)> onResponse;
+    const bool anyReplica;
+    // The IO thread given by the caller, nullptr to use any of the pool
+    folly::EventBase* const evb;
+    std::chrono::steady_clock::time_point startTime;
 
 private:
     std::mutex lock_;
-    std::unordered_map<HostAddr, Request> ongoingRequests_;
+    std::unordered_map<size_t, Request> ongoingRequests_;
+    size_t nextId_{0};
     bool finishSending_{false};
     bool fulfilled_{false};
 };
 
-}  // Anonymous namespace
-
 
 template<class Request, class RemoteFunc, class Response>
 folly::SemiFuture<StorageRpcResponse<Response>> StorageClient::collectResponse(
         folly::EventBase* evb,
         std::unordered_map<HostAddr, Request> requests,
-        RemoteFunc&& remoteFunc) {
+        RemoteFunc&& remoteFunc,
+        std::function<void(Response&&)> onResponse,
+        bool anyReplica) {
     auto context = std::make_shared<ResponseContext<Request, RemoteFunc, Response>>(
-        requests.size(), std::move(remoteFunc));
+        requests.size(), std::move(remoteFunc), std::move(onResponse), anyReplica, evb);
 
-    if (evb == nullptr) {
-        DCHECK(!!ioThreadPool_);
-        evb = ioThreadPool_->getEventBase();
+    for (auto& req : requests) {
+        auto res = context->insertRequest(std::move(req.second));
+        // Unless told which one to use, the requests are spread over the IO threads,
+        // so are the responses to decode
+        sendRequest(eventBase(evb), context, req.first, res.first, res.second, 0);
+    }  // for
+    if (context->finishSending()) {
+        // Received all responses, most likely, all rpc failed
+        context->fulfill();
     }
 
-    for (auto& req : requests) {
-        auto& host = req.first;
-        auto spaceId = req.second.get_space_id();
-        auto res = context->insertRequest(host, std::move(req.second));
-        DCHECK(res.second);
-        // Invoke the remote method
-        folly::via(evb, [this, evb, context, host, spaceId, res] () mutable {
-            auto client = clientsMan_->client(host, evb);
-            // Result is a pair of <Request&, bool>
-            context->serverMethod(client.get(), *res.first)
-            // Future process code will be executed on the IO thread
-            // Since all requests are sent using the same eventbase, all then-callback
-            // will be executed on the same IO thread
-            .then(evb, [this, context, host, spaceId] (folly::Try<Response>&& val) {
-                auto& r = context->findRequest(host);
-                if (val.hasException()) {
-                    LOG(ERROR) << "Request to " << host << " failed: " << val.exception().what();
-                    for (auto& part : r.parts) {
-                        VLOG(3) << "Exception! Failed part " << part.first;
-                        context->resp.failedParts().emplace(
-                            part.first,
-                            storage::cpp2::ErrorCode::E_RPC_FAILURE);
-                        invalidLeader(spaceId, part.first);
+    return context->promise.getSemiFuture();
+}
+
+
+template<class Request, class RemoteFunc, class Response>
+void StorageClient::sendRequest(
+        folly::EventBase* evb,
+        std::shared_ptr<ResponseContext<Request, RemoteFunc, Response>> context,
+        HostAddr host,
+        size_t reqId,
+        const Request* req,
+        int32_t retried) {
+    auto spaceId = req->get_space_id();
+    // Invoke the remote method
+    folly::via(evb, [this, evb, context, host, spaceId, reqId, req, retried] () mutable {
+        // Only the first tries are hedged, and measured for the hedging delay
+        bool hedgeable = retried == 0 && context->anyReplica;
+        auto sendTime = std::chrono::steady_clock::now();
+        auto client = clientsMan_->client(host, evb);
+        context->serverMethod(client.get(), *req)
+        // Future process code will be executed on the IO thread of the request,
+        // so are its hedges
+        .then(evb, [this, context, host, spaceId, reqId, retried, hedgeable, sendTime]
+                   (folly::Try<Response>&& val) {
+            if (hedgeable && !val.hasException()) {
+                hedgePolicy_.addLatency(std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - sendTime).count());
+            }
+            {
+                std::lock_guard<std::mutex> g(context->respLock);
+                auto hedge = context->hedges.find(reqId);
+                if (hedge != context->hedges.end()) {
+                    if (hedge->second.won) {
+                        // The request has been done with by its hedge
+                        return;
                     }
-                    context->resp.markFailure();
-                } else {
-                    auto resp = std::move(val.value());
-                    auto& result = resp.get_result();
-                    bool hasFailure{false};
-                    for (auto& code : result.get_failed_codes()) {
-                        VLOG(3) << "Failure! Failed part " << code.get_part_id()
-                                << ", failed code " << static_cast<int32_t>(code.get_code());
-                        hasFailure = true;
-                        if (code.get_code() == storage::cpp2::ErrorCode::E_LEADER_CHANGED) {
-                            auto* leader = code.get_leader();
-                            if (leader != nullptr
-                                    && leader->get_ip() != 0
-                                    && leader->get_port() != 0) {
-                                updateLeader(spaceId,
-                                             code.get_part_id(),
-                                             HostAddr(leader->get_ip(), leader->get_port()));
-                            }
+                    // Drop the hedge, whose responses are ignored from now on
+                    context->hedges.erase(hedge);
+                }
+            }
+            auto& r = context->findRequest(reqId);
+            bool hasFailure{false};
+            // The parts to resend, with the codes to report if they could not be
+            std::unordered_map<PartitionID, storage::cpp2::ErrorCode> failedParts;
+            if (val.hasException()) {
+                LOG(ERROR) << "Request to " << host << " failed: " << val.exception().what();
+                for (auto& part : r.parts) {
+                    VLOG(3) << "Exception! Failed part " << part.first;
+                    failedParts.emplace(part.first, storage::cpp2::ErrorCode::E_RPC_FAILURE);
+                    invalidLeader(spaceId, part.first);
+                }
+            } else {
+                auto resp = std::move(val.value());
+                auto& result = resp.get_result();
+                // The parts failed for good
+                std::vector<std::pair<PartitionID, storage::cpp2::ErrorCode>> errors;
+                for (auto& code : result.get_failed_codes()) {
+                    VLOG(3) << "Failure! Failed part " << code.get_part_id()
+                            << ", failed code " << static_cast<int32_t>(code.get_code());
+                    if (code.get_code() == storage::cpp2::ErrorCode::E_LEADER_CHANGED) {
+                        auto* leader = code.get_leader();
+                        if (leader != nullptr
+                                && leader->get_ip() != 0
+                                && leader->get_port() != 0) {
+                            updateLeader(spaceId,
+                                         code.get_part_id(),
+                                         HostAddr(leader->get_ip(), leader->get_port()));
                         } else {
-                            // Simply keep the result
-                            context->resp.failedParts().emplace(code.get_part_id(),
-                                                                code.get_code());
+                            invalidLeader(spaceId, code.get_part_id());
                         }
+                        failedParts.emplace(code.get_part_id(), code.get_code());
+                    } else if (code.get_code() == storage::cpp2::ErrorCode::E_STALE_REPLICA) {
+                        // The replica picked could not serve the read for now,
+                        // the part is resent to its leader
+                        failedParts.emplace(code.get_part_id(), code.get_code());
+                    } else {
+                        hasFailure = true;
+                        errors.emplace_back(code.get_part_id(), code.get_code());
                     }
-                    if (hasFailure) {
-                        context->resp.markFailure();
-                    }
+                }
 
+                auto latency = result.get_latency_in_us();
+                {
+                    std::lock_guard<std::mutex> g(context->respLock);
+                    // Simply keep the result
+                    for (auto& error : errors) {
+                        context->resp.failedParts().emplace(error.first, error.second);
+                    }
                     // Adjust the latency
-                    context->resp.setLatency(result.get_latency_in_us());
+                    context->resp.setLatency(latency);
+                    if (!context->onResponse) {
+                        // Keep the response
+                        context->resp.responses().emplace_back(std::move(resp));
+                    }
+                }
+                if (context->onResponse) {
+                    context->onResponse(std::move(resp));
+                }
+            }
 
-                    // Keep the response
-                    context->resp.responses().emplace_back(std::move(resp));
+            if (!failedParts.empty()) {
+                if (context->canRetry(retried)) {
+                    resendParts(context, r, failedParts, retried + 1);
+                } else {
+                    LOG(ERROR) << "Give up " << failedParts.size() << " parts after "
+                               << retried << " retries";
+                    hasFailure = true;
+                    std::lock_guard<std::mutex> g(context->respLock);
+                    for (auto& part : failedParts) {
+                        context->resp.failedParts().emplace(part.first, part.second);
+                    }
                 }
+            }
+            if (hasFailure) {
+                std::lock_guard<std::mutex> g(context->respLock);
+                context->resp.markFailure();
+            }
+
+            if (context->removeRequest(reqId)) {
+                // Received all responses
+                context->fulfill();
+            }
+        });
+
+        if (hedgeable) {
+            auto delay = hedgePolicy_.delayMs();
+            if (delay >= 0) {
+                evb->runAfterDelay([this, evb, context, host, reqId] () {
+                    hedgeRequest(evb, context, host, reqId);
+                }, delay);
+            }
+        }
+    });  // via
+}
+
 
-                if (context->removeRequest(host)) {
-                    // Received all responses
-                    context->promise.setValue(std::move(context->resp));
+template<class Request, class RemoteFunc, class Response>
+void StorageClient::hedgeRequest(
+        folly::EventBase* evb,
+        std::shared_ptr<ResponseContext<Request, RemoteFunc, Response>> context,
+        HostAddr host,
+        size_t reqId) {
+    if (!context->isOngoing(reqId)) {
+        return;
+    }
+    const auto& r = context->findRequest(reqId);
+    auto spaceId = r.get_space_id();
+    Request proto = r;
+    proto.parts.clear();
+    // Each part goes to another replica of its own
+    std::unordered_map<HostAddr, Request> requests;
+    for (auto& part : r.parts) {
+        auto partMeta = getPartMeta(spaceId, part.first);
+        std::vector<HostAddr> peers;
+        for (auto& peer : partMeta.peers_) {
+            if (peer != host) {
+                peers.emplace_back(peer);
+            }
+        }
+        if (peers.empty()) {
+            VLOG(2) << "No other replica of part " << part.first << " to hedge";
+            return;
+        }
+        auto peer = peers[folly::Random::rand32(peers.size())];
+        auto it = requests.find(peer);
+        if (it == requests.end()) {
+            it = requests.emplace(peer, proto).first;
+        }
+        it->second.parts.emplace(part.first, part.second);
+    }
+    if (!hedgePolicy_.tryHedge()) {
+        return;
+    }
+
+    VLOG(1) << "Hedge the request to " << host << " with " << requests.size() << " requests";
+    {
+        std::lock_guard<std::mutex> g(context->respLock);
+        context->resp.markHedge();
+        context->hedges[reqId].pending = requests.size();
+    }
+    for (auto& request : requests) {
+        auto peer = request.first;
+        auto req = std::make_shared<Request>(std::move(request.second));
+        auto client = clientsMan_->client(peer, evb);
+        context->serverMethod(client.get(), *req)
+        .then(evb, [context, reqId, peer, req] (folly::Try<Response>&& val) {
+            std::vector<Response> responses;
+            {
+                std::lock_guard<std::mutex> g(context->respLock);
+                auto it = context->hedges.find(reqId);
+                if (it == context->hedges.end() || it->second.failed) {
+                    // The request has answered first, or the hedge failed elsewhere
+                    return;
                 }
-            });
-        });  // via
-    }  // for
-    if (context->finishSending()) {
-        // Received all responses, most likely, all rpc failed
-        context->promise.setValue(std::move(context->resp));
+                auto& hedge = it->second;
+                if (val.hasException() || !val.value().get_result().get_failed_codes().empty()) {
+                    VLOG(1) << "Hedge to " << peer << " failed, wait for the request";
+                    hedge.failed = true;
+                    hedge.responses.clear();
+                    return;
+                }
+                hedge.responses.emplace_back(std::move(val.value()));
+                if (--hedge.pending > 0) {
+                    return;
+                }
+
+                hedge.won = true;
+                responses = std::move(hedge.responses);
+                hedge.responses.clear();
+                for (auto& resp : responses) {
+                    context->resp.setLatency(resp.get_result().get_latency_in_us());
+                }
+                if (!context->onResponse) {
+                    for (auto& resp : responses) {
+                        context->resp.responses().emplace_back(std::move(resp));
+                    }
+                    responses.clear();
+                }
+            }
+            for (auto& resp : responses) {
+                context->onResponse(std::move(resp));
+            }
+            if (context->removeRequest(reqId)) {
+                // Received all responses
+                context->fulfill();
+            }
+        });
+    }
+}
+
+
+template<class Request, class RemoteFunc, class Response>
+void StorageClient::resendParts(
+        std::shared_ptr<ResponseContext<Request, RemoteFunc, Response>> context,
+        Request& req,
+        const std::unordered_map<PartitionID, storage::cpp2::ErrorCode>& failedParts,
+        int32_t retried) {
+    auto spaceId = req.get_space_id();
+    // `req' is done with, so its parts are moved, and the rest is copied
+    auto parts = std::move(req.parts);
+    req.parts.clear();
+    std::unordered_map<HostAddr, Request> requests;
+    for (auto& part : parts) {
+        if (failedParts.count(part.first) == 0) {
+            continue;
+        }
+        auto partMeta = getPartMeta(spaceId, part.first);
+        CHECK_GT(partMeta.peers_.size(), 0U);
+        auto host = leader(partMeta);
+        auto it = requests.find(host);
+        if (it == requests.end()) {
+            it = requests.emplace(host, req).first;
+        }
+        it->second.parts.emplace(part.first, std::move(part.second));
     }
 
-    return context->promise.getSemiFuture();
+    for (auto& request : requests) {
+        VLOG(1) << "Resend " << request.second.parts.size() << " parts to "
+                << request.first << ", retry " << retried;
+        {
+            std::lock_guard<std::mutex> g(context->respLock);
+            context->resp.markRetry();
+        }
+        auto res = context->insertRequest(std::move(request.second));
+        sendRequest(eventBase(context->evb), context, request.first,
+                    res.first, res.second, retried);
+    }
 }
 
 }   // namespace storage
@@ -19,10 +19,10 @@ void AdHocSchemaManager::addTagSchema(GraphSpaceID space,
 
 void AdHocSchemaManager::addEdgeSchema(GraphSpaceID space,
                                        EdgeType edge,
-                                       std::shared_ptr<nebula::meta::SchemaProviderIf> schema) {
+                                       std::shared_ptr<nebula::meta::SchemaProviderIf> schema,
+                                       SchemaVer ver) {
     folly::RWSpinLock::WriteHolder wh(edgeLock_);
-    // Only version 0
-    edgeSchemas_[std::make_pair(space, edge)][0] = schema;
+    edgeSchemas_[std::make_pair(space, edge)][ver] = schema;
 }
 
 void AdHocSchemaManager::removeTagSchema(GraphSpaceID space, TagID tag) {
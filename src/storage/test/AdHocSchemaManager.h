@@ -27,7 +27,8 @@ public:
 
     void addEdgeSchema(GraphSpaceID space,
                        EdgeType edge,
-                       std::shared_ptr<nebula::meta::SchemaProviderIf> schema);
+                       std::shared_ptr<nebula::meta::SchemaProviderIf> schema,
+                       SchemaVer ver = 0);
 
     void removeTagSchema(GraphSpaceID space, TagID tag);
 
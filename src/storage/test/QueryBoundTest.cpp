@@ -12,8 +12,10 @@
 #include "fs/TempDir.h"
 #include "storage/test/TestUtils.h"
 #include "storage/QueryBoundProcessor.h"
+#include "storage/KilledQueries.h"
 #include "dataman/RowSetReader.h"
 #include "dataman/RowReader.h"
+#include "dataman/SchemaWriter.h"
 
 DECLARE_int32(max_handlers_per_req);
 DECLARE_int32(min_vertices_per_bucket);
@@ -257,6 +259,44 @@ TEST(QueryBoundTest, FilterTest_OnlyEdgeFilter) {
     checkResponse(resp, 30, 12, 10007, 1, true);
 }
 
+TEST(QueryBoundTest, FilterTest_OldSchemaVersion) {
+    fs::TempDir rootPath("/tmp/QueryBoundTest.XXXXXX");
+    std::unique_ptr<kvstore::KVStore> kv(TestUtils::initKV(rootPath.path()));
+    auto schemaMan = TestUtils::mockSchemaMan();
+    mockData(kv.get());
+    // As if the edge has been altered, the edges written are all of the version 0
+    auto schema = std::make_shared<SchemaWriter>(1);
+    for (auto i = 0; i < 10; i++) {
+        schema->appendCol(folly::stringPrintf("col_%d", i), nebula::cpp2::SupportedType::INT);
+    }
+    for (auto i = 10; i < 20; i++) {
+        schema->appendCol(folly::stringPrintf("col_%d", i), nebula::cpp2::SupportedType::STRING);
+    }
+    static_cast<AdHocSchemaManager*>(schemaMan.get())->addEdgeSchema(0, 101, schema, 1);
+
+    auto* edgeProp = new std::string("col_0");
+    auto* alias = new std::string("e101");
+    auto* edgeExp = new AliasPropertyExpression(new std::string(""), alias, edgeProp);
+    auto* priExp = new PrimaryExpression(10007L);
+    auto relExp = std::make_unique<RelationalExpression>(edgeExp,
+                                                         RelationalExpression::Operator::GE,
+                                                         priExp);
+    cpp2::GetNeighborsRequest req;
+    buildRequest(req);
+    req.set_filter(Expression::encode(relExp.get()));
+
+    // None of the edges is filtered by the compiled filter, but one by one
+    auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(3);
+    auto* processor = QueryBoundProcessor::instance(kv.get(),
+                                                    schemaMan.get(),
+                                                    executor.get(),
+                                                    BoundType::OUT_BOUND);
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    checkResponse(resp, 30, 12, 10007, 1, true);
+}
+
 TEST(QueryBoundTest, FilterTest_OnlyTagFilter) {
     fs::TempDir rootPath("/tmp/QueryBoundTest.XXXXXX");
     LOG(INFO) << "Prepare meta...";
@@ -414,6 +454,47 @@ TEST(QueryBoundTest, FilterTest_InvalidFilter) {
     EXPECT_TRUE(nebula::storage::cpp2::ErrorCode::E_INVALID_FILTER
                     == resp.result.failed_codes[0].code);
 }
+
+
+TEST(QueryBoundTest, KilledQueryTest) {
+    fs::TempDir rootPath("/tmp/QueryBoundTest.XXXXXX");
+    std::unique_ptr<kvstore::KVStore> kv(TestUtils::initKV(rootPath.path()));
+    auto schemaMan = TestUtils::mockSchemaMan();
+    mockData(kv.get());
+    auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(3);
+    KilledQueries::instance().kill(100);
+    {
+        LOG(INFO) << "The requests of the query killed are refused...";
+        cpp2::GetNeighborsRequest req;
+        buildRequest(req);
+        cpp2::ReadOptions options;
+        options.set_query_token(100);
+        req.set_read_options(options);
+        auto* processor = QueryBoundProcessor::instance(kv.get(), schemaMan.get(), executor.get());
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+        ASSERT_EQ(3, resp.result.failed_codes.size());
+        for (auto& code : resp.result.failed_codes) {
+            EXPECT_EQ(cpp2::ErrorCode::E_QUERY_CANCELLED, code.code);
+        }
+        EXPECT_FALSE(resp.__isset.vertices);
+    }
+    {
+        LOG(INFO) << "The other queries go on...";
+        cpp2::GetNeighborsRequest req;
+        buildRequest(req);
+        cpp2::ReadOptions options;
+        options.set_query_token(101);
+        options.set_timeout_ms(60000);
+        req.set_read_options(options);
+        auto* processor = QueryBoundProcessor::instance(kv.get(), schemaMan.get(), executor.get());
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+        checkResponse(resp, 30, 12, 10001, 7, true);
+    }
+}
 }  // namespace storage
 }  // namespace nebula
 
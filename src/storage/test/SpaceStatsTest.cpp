@@ -0,0 +1,118 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "base/NebulaKeyUtils.h"
+#include <gtest/gtest.h>
+#include <rocksdb/db.h>
+#include "fs/TempDir.h"
+#include "storage/test/TestUtils.h"
+#include "storage/SpaceStatsProcessor.h"
+#include "storage/KilledQueries.h"
+
+namespace nebula {
+namespace storage {
+
+void mockData(kvstore::KVStore* kv) {
+    for (auto partId = 0; partId < 3; partId++) {
+        std::vector<kvstore::KV> data;
+        for (auto vertexId = partId * 10; vertexId < (partId + 1) * 10; vertexId++) {
+            // Two versions of each vertex and each edge
+            for (auto version = 0; version < 2; version++) {
+                for (auto tagId = 3001; tagId < 3003; tagId++) {
+                    auto key = NebulaKeyUtils::vertexKey(partId, vertexId, tagId, version);
+                    data.emplace_back(std::move(key), "");
+                }
+                // 3 out-edges and 1 in-edge for each vertex
+                for (auto dstId = 10001; dstId <= 10003; dstId++) {
+                    auto key = NebulaKeyUtils::edgeKey(partId, vertexId, 101, 0, dstId, version);
+                    data.emplace_back(std::move(key), "");
+                }
+                auto key = NebulaKeyUtils::edgeKey(partId, vertexId, -101, 0, 10001, version);
+                data.emplace_back(std::move(key), "");
+            }
+        }
+        folly::Baton<true, std::atomic> baton;
+        kv->asyncMultiPut(0, partId, std::move(data), [&](kvstore::ResultCode code) {
+            EXPECT_EQ(code, kvstore::ResultCode::SUCCEEDED);
+            baton.post();
+        });
+        baton.wait();
+    }
+}
+
+
+TEST(SpaceStatsTest, SimpleTest) {
+    fs::TempDir rootPath("/tmp/SpaceStatsTest.XXXXXX");
+    std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
+    auto schemaMan = TestUtils::mockSchemaMan();
+    mockData(kv.get());
+
+    cpp2::SpaceStatsRequest req;
+    req.set_space_id(0);
+    for (auto partId = 0; partId < 3; partId++) {
+        req.parts.emplace(partId, 0);
+    }
+
+    auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(3);
+    auto* processor = SpaceStatsProcessor::instance(kv.get(), schemaMan.get(), executor.get());
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+
+    EXPECT_EQ(0, resp.result.failed_codes.size());
+    ASSERT_EQ(2, resp.tag_vertices.size());
+    EXPECT_EQ(30, resp.tag_vertices[3001]);
+    EXPECT_EQ(30, resp.tag_vertices[3002]);
+    ASSERT_EQ(2, resp.edges.size());
+    EXPECT_EQ(90, resp.edges[101].edges);
+    EXPECT_EQ(30, resp.edges[101].vertices);
+    EXPECT_EQ(30, resp.edges[-101].edges);
+    EXPECT_EQ(30, resp.edges[-101].vertices);
+}
+
+
+TEST(SpaceStatsTest, KilledTest) {
+    fs::TempDir rootPath("/tmp/SpaceStatsTest.XXXXXX");
+    std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
+    auto schemaMan = TestUtils::mockSchemaMan();
+    mockData(kv.get());
+
+    cpp2::SpaceStatsRequest req;
+    req.set_space_id(0);
+    for (auto partId = 0; partId < 3; partId++) {
+        req.parts.emplace(partId, 0);
+    }
+    cpp2::ReadOptions options;
+    options.set_query_token(20191201);
+    req.set_read_options(std::move(options));
+    KilledQueries::instance().kill(20191201);
+
+    auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(3);
+    auto* processor = SpaceStatsProcessor::instance(kv.get(), schemaMan.get(), executor.get());
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+
+    ASSERT_EQ(3, resp.result.failed_codes.size());
+    for (auto& code : resp.result.failed_codes) {
+        EXPECT_EQ(cpp2::ErrorCode::E_QUERY_CANCELLED, code.code);
+    }
+    EXPECT_EQ(0, resp.tag_vertices.size());
+    EXPECT_EQ(0, resp.edges.size());
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    return RUN_ALL_TESTS();
+}
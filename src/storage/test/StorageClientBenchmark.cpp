@@ -0,0 +1,151 @@
+/* Copyright (c) 2019 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include "test/ServerContext.h"
+#include "storage/client/StorageClient.h"
+#include "network/NetworkUtils.h"
+
+DEFINE_int32(hosts, 8, "Number of the mocked storage hosts");
+DEFINE_int32(vertices_per_host, 100, "Vertices answered by each host");
+DEFINE_int32(edge_bytes, 1024, "Bytes of the edge data of each vertex");
+DEFINE_int32(concurrency, 16, "Requests in flight at a time");
+
+namespace nebula {
+namespace storage {
+
+/**
+ * A storage host answering every getNeighbors with the same response,
+ * whose size is what the client spends its time on decoding.
+ */
+class FanOutStorageService : public cpp2::StorageServiceSvIf {
+public:
+    FanOutStorageService() {
+        resp_.set_result(cpp2::ResponseCommon());
+        std::vector<cpp2::VertexData> vertices(FLAGS_vertices_per_host);
+        for (auto i = 0; i < FLAGS_vertices_per_host; i++) {
+            vertices[i].set_vertex_id(i);
+            vertices[i].set_edge_data(std::string(FLAGS_edge_bytes, 'x'));
+        }
+        resp_.set_vertices(std::move(vertices));
+    }
+
+    folly::Future<cpp2::QueryResponse>
+    future_getOutBound(const cpp2::GetNeighborsRequest& req) override {
+        UNUSED(req);
+        return folly::makeFuture(resp_);
+    }
+
+private:
+    cpp2::QueryResponse resp_;
+};
+
+
+/**
+ * One part on each host, with no meta service involved.
+ */
+class FanOutStorageClient : public StorageClient {
+public:
+    FanOutStorageClient(std::shared_ptr<folly::IOThreadPoolExecutor> ioThreadPool,
+                        std::vector<HostAddr> hosts)
+        : StorageClient(ioThreadPool, nullptr)
+        , hosts_(std::move(hosts)) {}
+
+    int32_t partsNum(GraphSpaceID) const override {
+        return hosts_.size();
+    }
+
+    PartMeta getPartMeta(GraphSpaceID, PartitionID partId) const override {
+        PartMeta pm;
+        pm.spaceId_ = 0;
+        pm.partId_ = partId;
+        pm.peers_.emplace_back(hosts_[partId - 1]);
+        return pm;
+    }
+
+private:
+    std::vector<HostAddr> hosts_;
+};
+
+
+std::vector<std::unique_ptr<test::ServerContext>> gServers;
+std::vector<HostAddr> gHosts;
+
+void setUp() {
+    IPv4 localIp;
+    network::NetworkUtils::ipv4ToInt("127.0.0.1", localIp);
+    for (auto i = 0; i < FLAGS_hosts; i++) {
+        auto sc = std::make_unique<test::ServerContext>();
+        sc->mockCommon("storage", 0, std::make_shared<FanOutStorageService>());
+        gHosts.emplace_back(localIp, sc->port_);
+        gServers.emplace_back(std::move(sc));
+    }
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+// Each request goes to every host, `concurrency' requests at a time
+void run(int32_t iters, int32_t ioThreads) {
+    std::shared_ptr<folly::IOThreadPoolExecutor> ioThreadPool;
+    std::unique_ptr<nebula::storage::FanOutStorageClient> client;
+    std::vector<nebula::VertexID> vertices;
+    BENCHMARK_SUSPEND {
+        ioThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(ioThreads);
+        client = std::make_unique<nebula::storage::FanOutStorageClient>(
+            ioThreadPool, nebula::storage::gHosts);
+        for (auto i = 0; i < FLAGS_hosts; i++) {
+            vertices.emplace_back(i);
+        }
+        // Warm up the connections
+        client->getNeighbors(0, vertices, 0, true, "", {}).get();
+    }
+    for (auto i = 0; i < iters; i++) {
+        std::vector<folly::SemiFuture<nebula::storage::StorageRpcResponse<
+            nebula::storage::cpp2::QueryResponse>>> futures;
+        for (auto j = 0; j < FLAGS_concurrency; j++) {
+            futures.emplace_back(client->getNeighbors(0, vertices, 0, true, "", {}));
+        }
+        for (auto& f : futures) {
+            auto resp = std::move(f).get();
+            CHECK_EQ(100, resp.completeness());
+        }
+    }
+    BENCHMARK_SUSPEND {
+        client.reset();
+        ioThreadPool.reset();
+    }
+}
+
+BENCHMARK(fan_out_1_io_thread, iters) {
+    run(iters, 1);
+}
+
+BENCHMARK_RELATIVE(fan_out_2_io_threads, iters) {
+    run(iters, 2);
+}
+
+BENCHMARK_RELATIVE(fan_out_4_io_threads, iters) {
+    run(iters, 4);
+}
+
+BENCHMARK_RELATIVE(fan_out_8_io_threads, iters) {
+    run(iters, 8);
+}
+/*************************
+ * End of benchmarks
+ ************************/
+
+
+int main(int argc, char** argv) {
+    folly::init(&argc, &argv, true);
+    nebula::storage::setUp();
+    folly::runBenchmarks();
+    nebula::storage::gServers.clear();
+    return 0;
+}
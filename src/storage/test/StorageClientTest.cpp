@@ -18,6 +18,8 @@
 DECLARE_string(meta_server_addrs);
 DECLARE_int32(load_data_interval_secs);
 DECLARE_int32(heartbeat_interval_secs);
+DECLARE_int32(storage_client_retry_times);
+DECLARE_bool(storage_client_single_flight);
 
 namespace nebula {
 namespace storage {
@@ -314,6 +316,87 @@ private:
     nebula::cpp2::HostAddr leader_;
 };
 
+class TestStorageServiceLeader : public storage::cpp2::StorageServiceSvIf {
+public:
+    folly::Future<cpp2::QueryResponse>
+    future_getOutBound(const cpp2::GetNeighborsRequest& req) override {
+        UNUSED(req);
+        storage::cpp2::QueryResponse resp;
+        resp.set_result(storage::cpp2::ResponseCommon());
+        return folly::makeFuture(std::move(resp));
+    }
+};
+
+// Answers the requests only when asked to, with the vertices requested,
+// or fails the parts of the queries killed
+class TestStorageServiceHeld : public storage::cpp2::StorageServiceSvIf {
+public:
+    folly::Future<cpp2::QueryResponse>
+    future_getOutBound(const cpp2::GetNeighborsRequest& req) override {
+        std::vector<VertexID> vIds;
+        std::vector<PartitionID> parts;
+        for (auto& part : req.get_parts()) {
+            vIds.insert(vIds.end(), part.second.begin(), part.second.end());
+            parts.emplace_back(part.first);
+        }
+        std::sort(vIds.begin(), vIds.end());
+        auto* options = req.get_read_options();
+        std::lock_guard<std::mutex> g(lock_);
+        requested_.emplace_back(std::move(vIds));
+        parts_.emplace_back(std::move(parts));
+        tokens_.emplace_back(options == nullptr ? 0 : options->get_query_token());
+        promises_.emplace_back();
+        return promises_.back().getFuture();
+    }
+
+    std::vector<std::vector<VertexID>> requested() {
+        std::lock_guard<std::mutex> g(lock_);
+        return requested_;
+    }
+
+    void kill(int64_t token) {
+        std::lock_guard<std::mutex> g(lock_);
+        killed_.emplace(token);
+    }
+
+    // Answer the requests received since last time
+    void answer() {
+        std::lock_guard<std::mutex> g(lock_);
+        for (; answered_ < promises_.size(); answered_++) {
+            auto i = answered_;
+            cpp2::QueryResponse resp;
+            resp.set_result(storage::cpp2::ResponseCommon());
+            if (killed_.count(tokens_[i]) > 0) {
+                for (auto partId : parts_[i]) {
+                    cpp2::ResultCode code;
+                    code.set_code(cpp2::ErrorCode::E_QUERY_CANCELLED);
+                    code.set_part_id(partId);
+                    resp.result.failed_codes.emplace_back(std::move(code));
+                }
+                promises_[i].setValue(std::move(resp));
+                continue;
+            }
+            std::vector<cpp2::VertexData> vertices;
+            for (auto vId : requested_[i]) {
+                cpp2::VertexData vdata;
+                vdata.set_vertex_id(vId);
+                vertices.emplace_back(std::move(vdata));
+            }
+            resp.set_vertices(std::move(vertices));
+            promises_[i].setValue(std::move(resp));
+        }
+    }
+
+private:
+    std::mutex lock_;
+    std::vector<std::vector<VertexID>> requested_;
+    std::vector<std::vector<PartitionID>> parts_;
+    std::vector<int64_t> tokens_;
+    std::vector<folly::Promise<cpp2::QueryResponse>> promises_;
+    size_t answered_{0};
+    std::unordered_set<int64_t> killed_;
+};
+
 class TestStorageClient : public StorageClient {
 public:
     explicit TestStorageClient(std::shared_ptr<folly::IOThreadPoolExecutor> ioThreadPool)
@@ -333,6 +416,9 @@ public:
 };
 
 TEST(StorageClientTest, LeaderChangeTest) {
+    gflags::FlagSaver flagSaver;
+    // The leader returned does not exist, so don't resend to it
+    FLAGS_storage_client_retry_times = 0;
     IPv4 localIp;
     network::NetworkUtils::ipv4ToInt("127.0.0.1", localIp);
 
@@ -358,6 +444,177 @@ TEST(StorageClientTest, LeaderChangeTest) {
     ASSERT_EQ(HostAddr(localIp, 10010), tsc.leaders_[std::make_pair(0, 1)]);
 }
 
+TEST(StorageClientTest, RetryOnLeaderChangeTest) {
+    gflags::FlagSaver flagSaver;
+    FLAGS_storage_client_retry_times = 3;
+    IPv4 localIp;
+    network::NetworkUtils::ipv4ToInt("127.0.0.1", localIp);
+
+    auto leaderSc = std::make_unique<test::ServerContext>();
+    leaderSc->mockCommon("storage", 0, std::make_shared<TestStorageServiceLeader>());
+    auto sc = std::make_unique<test::ServerContext>();
+    sc->mockCommon("storage", 0,
+                   std::make_shared<TestStorageServiceRetry>(localIp, leaderSc->port_));
+    LOG(INFO) << "Start storage servers on " << sc->port_ << " and " << leaderSc->port_;
+
+    auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(1);
+    TestStorageClient tsc(threadPool);
+    PartMeta pm;
+    pm.spaceId_ = 1;
+    pm.partId_ = 1;
+    pm.peers_.emplace_back(HostAddr(localIp, sc->port_));
+    tsc.parts_.emplace(1, std::move(pm));
+
+    // The part is resent to the new leader within the same future
+    auto resp = tsc.getNeighbors(0, {1, 2, 3}, 0, true, "", {}).get();
+    ASSERT_EQ(100, resp.completeness());
+    ASSERT_TRUE(resp.failedParts().empty());
+    ASSERT_EQ(1UL, resp.retriedReqs());
+    ASSERT_EQ(2UL, resp.responses().size());
+    ASSERT_EQ(HostAddr(localIp, leaderSc->port_), tsc.leaders_[std::make_pair(0, 1)]);
+}
+
+TEST(StorageClientTest, SingleFlightTest) {
+    gflags::FlagSaver flagSaver;
+    FLAGS_storage_client_single_flight = true;
+    IPv4 localIp;
+    network::NetworkUtils::ipv4ToInt("127.0.0.1", localIp);
+
+    auto handler = std::make_shared<TestStorageServiceHeld>();
+    auto sc = std::make_unique<test::ServerContext>();
+    sc->mockCommon("storage", 0, handler);
+    LOG(INFO) << "Start storage server on " << sc->port_;
+
+    auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(1);
+    TestStorageClient tsc(threadPool);
+    PartMeta pm;
+    pm.spaceId_ = 1;
+    pm.partId_ = 1;
+    pm.peers_.emplace_back(HostAddr(localIp, sc->port_));
+    tsc.parts_.emplace(1, std::move(pm));
+
+    auto getVIds = [] (StorageRpcResponse<cpp2::QueryResponse>& resp) {
+        std::vector<VertexID> vIds;
+        for (auto& r : resp.responses()) {
+            for (auto& vdata : r.get_vertices()) {
+                vIds.emplace_back(vdata.get_vertex_id());
+            }
+        }
+        std::sort(vIds.begin(), vIds.end());
+        return vIds;
+    };
+
+    auto f1 = tsc.getNeighbors(0, {1, 2, 3}, 0, true, "", {});
+    auto f2 = tsc.getNeighbors(0, {2, 3, 4}, 0, true, "", {});
+    // Another filter, so not shared
+    auto f3 = tsc.getNeighbors(0, {1}, 0, true, "filter", {});
+    while (handler->requested().size() < 3UL) {
+        usleep(1000);
+    }
+    handler->answer();
+
+    auto resp1 = std::move(f1).get();
+    auto resp2 = std::move(f2).get();
+    auto resp3 = std::move(f3).get();
+    auto requested = handler->requested();
+    std::sort(requested.begin(), requested.end());
+    std::vector<std::vector<VertexID>> expected = {{1}, {1, 2, 3}, {4}};
+    ASSERT_EQ(expected, requested);
+
+    ASSERT_EQ(100, resp1.completeness());
+    ASSERT_EQ(std::vector<VertexID>({1, 2, 3}), getVIds(resp1));
+    ASSERT_EQ(100, resp2.completeness());
+    ASSERT_EQ(std::vector<VertexID>({2, 3, 4}), getVIds(resp2));
+    ASSERT_EQ(std::vector<VertexID>({1}), getVIds(resp3));
+    ASSERT_TRUE(tsc.flights_.empty());
+}
+
+TEST(StorageClientTest, SingleFlightKilledTest) {
+    gflags::FlagSaver flagSaver;
+    FLAGS_storage_client_single_flight = true;
+    IPv4 localIp;
+    network::NetworkUtils::ipv4ToInt("127.0.0.1", localIp);
+
+    auto handler = std::make_shared<TestStorageServiceHeld>();
+    auto sc = std::make_unique<test::ServerContext>();
+    sc->mockCommon("storage", 0, handler);
+    LOG(INFO) << "Start storage server on " << sc->port_;
+
+    auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(1);
+    TestStorageClient tsc(threadPool);
+    PartMeta pm;
+    pm.spaceId_ = 1;
+    pm.partId_ = 1;
+    pm.peers_.emplace_back(HostAddr(localIp, sc->port_));
+    tsc.parts_.emplace(1, std::move(pm));
+
+    cpp2::ReadOptions killed;
+    killed.set_query_token(1);
+    cpp2::ReadOptions alive;
+    alive.set_query_token(2);
+    // The second read joins the flight of the first one for 2 and 3
+    auto f1 = tsc.getNeighbors(0, {1, 2, 3}, 0, true, "", {}, killed);
+    auto f2 = tsc.getNeighbors(0, {2, 3, 4}, 0, true, "", {}, alive);
+    while (handler->requested().size() < 2UL) {
+        usleep(1000);
+    }
+    handler->kill(1);
+    handler->answer();
+    // Which are read again with the token of the second query
+    while (handler->requested().size() < 3UL) {
+        usleep(1000);
+    }
+    handler->answer();
+
+    auto resp1 = std::move(f1).get();
+    auto resp2 = std::move(f2).get();
+    auto requested = handler->requested();
+    std::sort(requested.begin(), requested.end());
+    std::vector<std::vector<VertexID>> expected = {{1, 2, 3}, {2, 3}, {4}};
+    ASSERT_EQ(expected, requested);
+
+    ASSERT_EQ(1UL, resp1.failedParts().size());
+    ASSERT_EQ(cpp2::ErrorCode::E_QUERY_CANCELLED, resp1.failedParts()[1]);
+    ASSERT_EQ(100, resp2.completeness());
+    ASSERT_TRUE(resp2.failedParts().empty());
+    std::vector<VertexID> vIds;
+    for (auto& r : resp2.responses()) {
+        for (auto& vdata : r.get_vertices()) {
+            vIds.emplace_back(vdata.get_vertex_id());
+        }
+    }
+    std::sort(vIds.begin(), vIds.end());
+    ASSERT_EQ(std::vector<VertexID>({2, 3, 4}), vIds);
+    ASSERT_TRUE(tsc.flights_.empty());
+}
+
+TEST(StorageClientTest, HedgePolicyTest) {
+    // The hedge flags are restored for the other tests
+    gflags::FlagSaver flagSaver;
+    FLAGS_storage_client_hedge_percentile = 0;
+    HedgePolicy policy;
+    ASSERT_EQ(-1, policy.delayMs());
+
+    FLAGS_storage_client_hedge_percentile = 90;
+    FLAGS_storage_client_hedge_budget_percent = 5;
+    // Not enough latencies recorded yet
+    ASSERT_EQ(-1, policy.delayMs());
+    for (auto i = 1; i <= 128; i++) {
+        policy.addLatency(i * 1000);
+    }
+    ASSERT_EQ(115, policy.delayMs());
+    FLAGS_storage_client_hedge_min_delay_ms = 200;
+    ASSERT_EQ(200, policy.delayMs());
+
+    // 3 requests so far, not enough for a hedge within 5%
+    ASSERT_FALSE(policy.tryHedge());
+    for (auto i = 0; i < 17; i++) {
+        policy.delayMs();
+    }
+    ASSERT_TRUE(policy.tryHedge());
+    ASSERT_FALSE(policy.tryHedge());
+}
+
 }  // namespace storage
 }  // namespace nebula
 